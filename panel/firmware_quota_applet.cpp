@@ -36,6 +36,8 @@
 #include <syslog.h>
 
 #include "quota_common.h"
+#include "quota_ticker.h"
+#include "quota_retry.h"
 
 static constexpr const char* kFactoryId = "FirmwareQuotaAppletFactory";
 static constexpr const char* kAppletId = "FirmwareQuotaApplet";
@@ -50,6 +52,14 @@ static constexpr int kTimeLineDefaultPx = 2;
 static constexpr int kTimeLineMaxPx = 10;
 
 static constexpr const char* kEnvFileRelPath = "/.config/firmware-quota/env";
+// Optional multi-account key file: one "name=key" per line.
+static constexpr const char* kKeysFileRelPath = "/.config/firmware-quota/keys";
+
+// Quota service exported by show_quota_gui / show_quota --gui. While it is on
+// the session bus the applet follows it instead of polling the API itself.
+static constexpr const char* kQuotaDbusName = "org.firmware.Quota";
+static constexpr const char* kQuotaDbusPath = "/org/firmware/Quota";
+static constexpr const char* kQuotaDbusInterface = "org.firmware.Quota";
 
 static const char* get_home_dir_fallback() {
     const char* home = getenv("HOME");
@@ -76,9 +86,7 @@ static void panel_log(const char* fmt, ...) {
     FILE* f = fopen(path.c_str(), "a");
     if (!f) return;
 
-    std::time_t t = std::time(nullptr);
-    std::tm tmv{};
-    localtime_r(&t, &tmv);
+    const std::tm tmv = clock_localtime(clock_now());
     char ts[32];
     strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", &tmv);
 
@@ -101,6 +109,17 @@ static void panel_log(const char* fmt, ...) {
     closelog();
 }
 
+// One monitored key when the multi-account key file is present.
+struct PanelAccount {
+    std::string name;
+    std::string api_key;
+    std::string token;
+    std::optional<AuthMethod> preferred_auth_method;
+    bool ok = false;
+    QuotaData quota{};
+    std::string error;
+};
+
 struct AppletState {
     MatePanelApplet* applet = nullptr;
     GtkWidget* drawing = nullptr;
@@ -120,8 +139,14 @@ struct AppletState {
     std::atomic<int> refcount{1};
     std::atomic<bool> destroy_requested{false};
 
-    guint refresh_timer_id = 0;
-    guint ui_tick_id = 0;
+    guint refresh_timer_id = 0;     // periodic, or a one-shot retry after a failure
+    UiTicker* ui_ticker = nullptr;  // shared UI tick (time line, hovered tooltip)
+
+    // org.firmware.Quota subscription (quota_proxy set while the service runs)
+    guint dbus_watch_id = 0;
+    GDBusProxy* quota_proxy = nullptr;
+    gulong quota_proxy_signal_id = 0;
+    gulong network_handler = 0;     // GNetworkMonitor::network-changed
     int refresh_interval_s = 30;
     gint64 next_refresh_us = 0;
 
@@ -129,6 +154,10 @@ struct AppletState {
     std::string token;
     std::optional<AuthMethod> preferred_auth_method;
 
+    // Multi-account mode: the bar shows the account closest to its limit and
+    // the tooltip lists all of them. Empty when a single key is used.
+    std::vector<PanelAccount> accounts;
+
     bool fetching = false;
     bool have_quota = false;
     QuotaData current_quota{};
@@ -147,9 +176,41 @@ struct AppletState {
     std::array<time_t, kDeltaHistN> delta_hist_ts{};
     int delta_hist_count = 0;
     int delta_hist_next = 0;
+
+    // Everything on_draw paints except the time line; compared on each draw
+    // to decide whether the cached layers are still current.
+    struct LayerKey {
+        int w = 0;
+        int h = 0;
+        int orient = -1;
+        bool have = false;
+        bool have_good = false;
+        bool has_error = false;
+        double pct = 0.0;
+        int delta_count = 0;
+        int delta_next = 0;
+        std::array<double, kDeltaHistN> delta_pp{};
+
+        bool operator==(const LayerKey& o) const {
+            return w == o.w && h == o.h && orient == o.orient && have == o.have &&
+                   have_good == o.have_good && has_error == o.has_error && pct == o.pct &&
+                   delta_count == o.delta_count && delta_next == o.delta_next && delta_pp == o.delta_pp;
+        }
+    };
+
+    // Cached bar layers (main thread only): below and above the time line.
+    cairo_surface_t* base_layer = nullptr;
+    cairo_surface_t* top_layer = nullptr;
+    LayerKey layer_key;
+
+    // Tooltip text cache (main thread only), see on_query_tooltip.
+    std::string tooltip_text;
+    gint64 tooltip_built_s = -1;    // monotonic second it was built in, -1 = stale
+    bool pointer_inside = false;
+
     time_t last_success_ts = 0;
     time_t last_failure_ts = 0;
-    int consecutive_failures = 0;
+    RetryState retry;               // backoff / circuit breaker (main thread)
     long last_http_code = 0;
     CURLcode last_curl_code = CURLE_OK;
     std::string last_curl_error;
@@ -390,8 +451,9 @@ static void save_time_line_px_for_prefs_path(const std::string& prefs_path, int
     save_int_for_key(time_line_key_for_prefs_path(prefs_path), normalize_time_line_px(px), kTimeLineMaxPx);
 }
 
-static bool read_key_from_env_file(std::string* out_key) {
-    if (!out_key) return false;
+// Value of NAME=value in ~/.config/firmware-quota/env (first non-empty match)
+static bool read_env_file_value(const char* name, std::string* out_value) {
+    if (!out_value) return false;
 
     const char* home = getenv("HOME");
     if (!home || !*home) return false;
@@ -409,8 +471,8 @@ static bool read_key_from_env_file(std::string* out_key) {
         if (pos == std::string::npos) continue;
         std::string key = line.substr(0, pos);
         std::string val = line.substr(pos + 1);
-        if (key == "FIRMWARE_API_KEY" && !val.empty()) {
-            *out_key = val;
+        if (key == name && !val.empty()) {
+            *out_value = val;
             return true;
         }
     }
@@ -418,6 +480,70 @@ static bool read_key_from_env_file(std::string* out_key) {
     return false;
 }
 
+// Request budgets: FIRMWARE_*TIMEOUT from the env file, overridden by the
+// applet's own environment.
+static void load_request_timeouts() {
+    RequestTimeouts timeouts;
+    const struct {
+        const char* name;
+        long* budget;
+    } keys[] = {
+        {"FIRMWARE_CONNECT_TIMEOUT", &timeouts.connect_ms},
+        {"FIRMWARE_FIRST_BYTE_TIMEOUT", &timeouts.first_byte_ms},
+        {"FIRMWARE_TIMEOUT", &timeouts.total_ms},
+    };
+    for (const auto& key : keys) {
+        std::string value;
+        if (read_env_file_value(key.name, &value) && !parse_timeout_seconds(value, key.budget)) {
+            panel_log("env file: ignoring %s=%s", key.name, value.c_str());
+        }
+    }
+    apply_timeout_env(&timeouts);
+    set_request_timeouts(timeouts);
+    panel_log("timeouts: connect=%ldms first_byte=%ldms total=%ldms",
+              timeouts.connect_ms, timeouts.first_byte_ms, timeouts.total_ms);
+}
+
+// Endpoint, proxy, unix socket, CA bundle, HTTP version and pinned
+// addresses: FIRMWARE_API_URL etc. from the env file, then the applet's own
+// environment.
+static void load_request_transport() {
+    RequestTransport transport;
+    for (const TransportSetting& setting : kTransportSettings) {
+        std::string value;
+        if (read_env_file_value(setting.env, &value) && !set_transport_value(&transport, setting.key, value)) {
+            panel_log("env file: ignoring %s=%s", setting.env, value.c_str());
+        }
+    }
+    apply_transport_env(&transport);
+    set_request_transport(transport);
+    panel_log("transport: %s", describe_request_transport(transport).c_str());
+}
+
+// Simulated clock for window-scale testing: FIRMWARE_TIME_SCALE and
+// FIRMWARE_TIME_START from the applet's environment, then the env file.
+// Once per process, before the first fetch.
+static void load_clock() {
+    static bool loaded = false;
+    if (loaded) return;
+    loaded = true;
+
+    std::string scale;
+    std::string start_text;
+    double rate = 0.0;
+    time_t start = time(nullptr);
+    if (!apply_clock_env() && read_env_file_value("FIRMWARE_TIME_SCALE", &scale) &&
+        parse_clock_rate(scale, &rate)) {
+        if (read_env_file_value("FIRMWARE_TIME_START", &start_text) && !parse_clock_start(start_text, &start)) {
+            panel_log("env file: ignoring FIRMWARE_TIME_START=%s", start_text.c_str());
+        }
+        clock_simulate(start, rate);
+    }
+    if (clock_simulated()) {
+        panel_log("simulated clock: now %s", get_timestamp_string().c_str());
+    }
+}
+
 static std::string get_env_file_path() {
     const char* home = get_home_dir_fallback();
     if (home && *home) {
@@ -433,12 +559,26 @@ static bool write_api_key_env_file(const std::string& api_key) {
     const std::string path = get_env_file_path();
     const std::string tmp = path + ".tmp";
 
+    // Keep other settings (e.g. FIRMWARE_TIMEOUT) across key changes
+    std::vector<std::string> kept;
+    {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.rfind("#", 0) == 0 || line.rfind("FIRMWARE_API_KEY=", 0) == 0) continue;
+            if (line.find('=') != std::string::npos) kept.push_back(line);
+        }
+    }
+
     {
         std::ofstream out(tmp, std::ios::trunc);
         if (!out.is_open()) return false;
         out << "# Managed by firmware-quota panel applet\n";
         out << "# NOTE: this is a plaintext key file. chmod 600 recommended.\n";
         out << "FIRMWARE_API_KEY=" << api_key << "\n";
+        for (const std::string& line : kept) {
+            out << line << "\n";
+        }
     }
 
     if (rename(tmp.c_str(), path.c_str()) != 0) {
@@ -455,9 +595,40 @@ static void delete_api_key_env_file() {
     (void)remove(path.c_str());
 }
 
+static void load_accounts(AppletState* state) {
+    state->accounts.clear();
+
+    const char* home = get_home_dir_fallback();
+    if (!home || !*home) return;
+
+    std::vector<AccountKey> keys;
+    std::string error;
+    const std::string path = std::string(home) + kKeysFileRelPath;
+    if (!load_key_file(path, &keys, &error)) {
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            panel_log("key file ignored: %s", error.c_str());
+        }
+        return;
+    }
+
+    for (const AccountKey& key : keys) {
+        PanelAccount acct;
+        acct.name = key.name;
+        acct.api_key = key.api_key;
+        acct.token = extract_token(key.api_key);
+        state->accounts.push_back(std::move(acct));
+    }
+    panel_log("multi-account mode: %zu keys", state->accounts.size());
+}
+
 static bool load_api_key(AppletState* state) {
     if (!state) return false;
 
+    load_accounts(state);
+    load_request_timeouts();
+    load_request_transport();
+
     const char* env = getenv("FIRMWARE_API_KEY");
     if (env && *env) {
         state->api_key = env;
@@ -466,7 +637,7 @@ static bool load_api_key(AppletState* state) {
     }
 
     std::string key;
-    if (read_key_from_env_file(&key)) {
+    if (read_env_file_value("FIRMWARE_API_KEY", &key)) {
         state->api_key = key;
         state->token = extract_token(state->api_key);
         return true;
@@ -481,21 +652,20 @@ static void reload_api_key(AppletState* state) {
     // Clear so we don't keep using a stale value.
     state->api_key.clear();
     state->token.clear();
+    state->accounts.clear();
 
     (void)load_api_key(state);
 }
 
-static void set_tooltip(AppletState* state) {
-    if (!state || !state->drawing) return;
-
+static void build_tooltip_text(AppletState* state, std::string* out) {
     std::lock_guard<std::mutex> lock(state->mu);
 
-    const gint64 now = g_get_monotonic_time();
+    const gint64 now = clock_monotonic_us();
     gint64 remaining_us = state->next_refresh_us - now;
     if (remaining_us < 0) remaining_us = 0;
     int remaining_s = (int)((remaining_us + 999999) / 1000000);
 
-    char tip[512];
+    char tip[2048];
 
     const bool stale = !state->last_error.empty();
     const bool have = state->have_last_good || state->have_quota;
@@ -515,7 +685,7 @@ static void set_tooltip(AppletState* state) {
 
         char last_ok_buf[64];
         if (state->last_success_ts != 0) {
-            const int64_t age_s = (int64_t)difftime(time(nullptr), state->last_success_ts);
+            const int64_t age_s = (int64_t)difftime(clock_now(), state->last_success_ts);
             snprintf(last_ok_buf, sizeof(last_ok_buf), "Last OK: %s ago", format_duration_compact(age_s).c_str());
         } else {
             snprintf(last_ok_buf, sizeof(last_ok_buf), "Last OK: --");
@@ -526,7 +696,7 @@ static void set_tooltip(AppletState* state) {
         if (q.reset_time != "N/A" && !q.reset_time.empty()) {
             time_t reset_utc;
             if (parse_iso8601_utc_to_time_t(q.reset_time, &reset_utc)) {
-                time_t now_s = time(nullptr);
+                time_t now_s = clock_now();
                 int64_t until_reset = static_cast<int64_t>(difftime(reset_utc, now_s));
                 if (until_reset < 0) until_reset = 0;
                 reset_line = "Reset: " + format_duration_compact(until_reset);
@@ -553,17 +723,51 @@ static void set_tooltip(AppletState* state) {
         }
 
         if (state->last_window_reset_ts != 0) {
-            const int64_t age_s = (int64_t)difftime(time(nullptr), state->last_window_reset_ts);
+            const int64_t age_s = (int64_t)difftime(clock_now(), state->last_window_reset_ts);
             extra += "\n" + (std::string("Window reset: ") + format_duration_compact(age_s) + " ago");
         }
     }
 
+    if (!state->accounts.empty() && !state->quota_proxy) {
+        // Aggregated view across all accounts.
+        double sum_pct = 0.0;
+        int ok_count = 0;
+        std::string lines;
+        for (const PanelAccount& acct : state->accounts) {
+            char b[160];
+            if (acct.ok) {
+                std::string reset = "--";
+                time_t reset_utc;
+                if (parse_iso8601_utc_to_time_t(acct.quota.reset_time, &reset_utc)) {
+                    reset = format_duration_compact((int64_t)difftime(reset_utc, clock_now()));
+                }
+                snprintf(b, sizeof(b), "\n  %s: %.1f%% (reset %s)", acct.name.c_str(), acct.quota.percentage, reset.c_str());
+                sum_pct += acct.quota.percentage;
+                ok_count++;
+            } else {
+                snprintf(b, sizeof(b), "\n  %s: %s", acct.name.c_str(),
+                         acct.error.empty() ? "--" : truncate_for_display(acct.error, 60).c_str());
+            }
+            lines += b;
+        }
+        char head[96];
+        if (ok_count > 0) {
+            snprintf(head, sizeof(head), "Accounts: %d/%zu OK, avg %.1f%%", ok_count, state->accounts.size(), sum_pct / ok_count);
+        } else {
+            snprintf(head, sizeof(head), "Accounts: 0/%zu OK", state->accounts.size());
+        }
+        if (!extra.empty()) {
+            extra += "\n";
+        }
+        extra += head + lines;
+    }
+
     if (stale) {
         char err_meta[256];
         const char* curl_name = curl_easy_strerror(state->last_curl_code);
         snprintf(err_meta, sizeof(err_meta),
                  "Failures: %d\nLast error: %s\nHTTP: %ld\nCURL: %d (%s)",
-                 state->consecutive_failures,
+                 state->retry.failures,
                  truncate_for_display(state->last_error, 120).c_str(),
                  state->last_http_code,
                  (int)state->last_curl_code,
@@ -574,21 +778,66 @@ static void set_tooltip(AppletState* state) {
         extra += err_meta;
     }
 
+    char next_line[96];
+    if (state->quota_proxy) {
+        snprintf(next_line, sizeof(next_line), "Source: %s (D-Bus)", kQuotaDbusName);
+    } else if (retry_waiting(&state->retry)) {
+        snprintf(next_line, sizeof(next_line), "%s", retry_describe(&state->retry, remaining_s).c_str());
+    } else {
+        snprintf(next_line, sizeof(next_line), "Next refresh: %ds", remaining_s);
+    }
+
     if (!have) {
         snprintf(tip, sizeof(tip),
-                 "Firmware Quota (panel)\nStatus: %s\nNext refresh: %ds",
+                 "Firmware Quota (panel)\nStatus: %s\n%s",
                  status.c_str(),
-                 remaining_s);
+                 next_line);
     } else {
         snprintf(tip, sizeof(tip),
-                 "Firmware Quota (panel)\nStatus: %s\nUsage: %.1f%%\n%s\nNext refresh: %ds",
+                 "Firmware Quota (panel)\nStatus: %s\nUsage: %.1f%%%s\n%s\n%s",
                  status.c_str(),
                  q.percentage,
+                 state->accounts.empty() ? "" : " (max)",
                  extra.c_str(),
-                 remaining_s);
+                 next_line);
     }
 
-    gtk_widget_set_tooltip_text(state->drawing, tip);
+    out->assign(tip);
+}
+
+// Tooltips are built on demand from query-tooltip and cached for the current
+// second, so an applet nobody hovers does no string work and takes no lock.
+static gboolean on_query_tooltip(GtkWidget*, gint, gint, gboolean, GtkTooltip* tooltip, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!state || state->destroy_requested.load(std::memory_order_relaxed)) return FALSE;
+
+    const gint64 now_s = clock_monotonic_us() / 1000000;
+    if (state->tooltip_built_s != now_s) {
+        build_tooltip_text(state, &state->tooltip_text);
+        state->tooltip_built_s = now_s;
+    }
+    gtk_tooltip_set_text(tooltip, state->tooltip_text.c_str());
+    return TRUE;
+}
+
+static gboolean on_pointer_crossing(GtkWidget*, GdkEventCrossing* event, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!state || !event) return FALSE;
+    state->pointer_inside = (event->type == GDK_ENTER_NOTIFY);
+    if (state->pointer_inside) {
+        // The tooltip counts seconds; on_ui_tick relaxes this again on leave.
+        ui_ticker_set_period(state->ui_ticker, 1);
+    }
+    return FALSE;
+}
+
+// Drop the cached text; a tooltip on screen is re-queried right away.
+static void invalidate_tooltip(AppletState* state) {
+    if (!state || !state->drawing) return;
+    state->tooltip_built_s = -1;
+    if (state->pointer_inside) {
+        gtk_widget_trigger_tooltip_query(state->drawing);
+    }
 }
 
 static void pick_color(double pct, double* r, double* g, double* b) {
@@ -617,42 +866,13 @@ static bool compute_window_start_utc(const std::string& reset_time, time_t* out_
     return true;
 }
 
-static gboolean on_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
-    AppletState* state = (AppletState*)user_data;
-    if (!state) return FALSE;
-
-    static bool logged = false;
-    if (!logged) {
-        logged = true;
-        panel_log("on_draw first call");
-    }
-
-    GtkAllocation a;
-    gtk_widget_get_allocation(widget, &a);
-    const int w = a.width;
-    const int h = a.height;
-    if (w <= 0 || h <= 0) return FALSE;
-
-    double pct = 0.0;
-    std::string err;
-    bool have = false;
-    bool have_good = false;
-    std::string reset_time;
-    time_t last_window_reset_ts = 0;
-    int time_line_px = 0;
-    {
-        std::lock_guard<std::mutex> lock(state->mu);
-        have_good = state->have_last_good;
-        have = have_good || state->have_quota;
-        const QuotaData q = have_good ? state->last_good_quota : state->current_quota;
-        pct = clamp_pct(q.percentage);
-        err = state->last_error;
-        reset_time = q.reset_time;
-        last_window_reset_ts = state->last_window_reset_ts;
-        time_line_px = state->time_line_px;
-    }
-
-    const bool stale = (!err.empty()) && have_good;
+// Background, fill, delta history and stale hatch: everything below the time line.
+static void draw_base_layer(cairo_t* cr, const AppletState::LayerKey& k) {
+    const int w = k.w;
+    const int h = k.h;
+    const double pct = k.pct;
+    const bool stale = k.has_error && k.have_good;
+    const bool vertical = (k.orient == MATE_PANEL_APPLET_ORIENT_LEFT || k.orient == MATE_PANEL_APPLET_ORIENT_RIGHT);
 
     // Background (make it very visible against the panel).
     cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.55);
@@ -661,13 +881,12 @@ static gboolean on_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
 
     // Fill.
     double fr = 0.6, fg = 0.6, fb = 0.6;
-    if (have) {
+    if (k.have) {
         pick_color(pct, &fr, &fg, &fb);
     }
-    const double fill_frac = have ? (pct / 100.0) : 0.0;
+    const double fill_frac = k.have ? (pct / 100.0) : 0.0;
 
-    MatePanelAppletOrient orient = mate_panel_applet_get_orient(state->applet);
-    if (orient == MATE_PANEL_APPLET_ORIENT_LEFT || orient == MATE_PANEL_APPLET_ORIENT_RIGHT) {
+    if (vertical) {
         // Vertical panel: fill from bottom.
         int filled = (int)std::lround(fill_frac * h);
         cairo_set_source_rgba(cr, fr, fg, fb, 0.95);
@@ -682,112 +901,97 @@ static gboolean on_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
     }
 
     // Delta history overlay (last 5 successful refreshes), stacked from the leading edge.
-    if (have_good) {
-        std::array<double, AppletState::kDeltaHistN> dpp{};
-        std::array<time_t, AppletState::kDeltaHistN> dts{};
-        int n = 0;
-        int next = 0;
-        {
-            std::lock_guard<std::mutex> lock(state->mu);
-            n = state->delta_hist_count;
-            next = state->delta_hist_next;
-            dpp = state->delta_hist_pp;
-            dts = state->delta_hist_ts;
-        }
+    if (k.have_good && k.delta_count > 0) {
+        const int n = k.delta_count;
+        const double fill_px = vertical ? (pct / 100.0) * h : (pct / 100.0) * w;
+
+        const double max_hist_px = std::min(fill_px, (vertical ? h : w) * 0.35);
+        if (max_hist_px > 0.0) {
+            // Oldest->newest indices from ring.
+            int start = k.delta_next - n;
+            while (start < 0) start += AppletState::kDeltaHistN;
 
-        if (n > 0) {
-            const double fill_px = (orient == MATE_PANEL_APPLET_ORIENT_LEFT || orient == MATE_PANEL_APPLET_ORIENT_RIGHT)
-                                       ? (pct / 100.0) * h
-                                       : (pct / 100.0) * w;
-
-            const double max_hist_px = std::min(fill_px, ((orient == MATE_PANEL_APPLET_ORIENT_LEFT || orient == MATE_PANEL_APPLET_ORIENT_RIGHT) ? h : w) * 0.35);
-            if (max_hist_px > 0.0) {
-                // Oldest->newest indices from ring.
-                int start = next - n;
-                while (start < 0) start += AppletState::kDeltaHistN;
-
-                struct Seg { double px; double delta; int age_rank; };
-                std::vector<Seg> segs;
-                segs.reserve(n);
-
-                const double max_pp_per_seg = 15.0;
-                const double min_px = 2.0;
-                const double axis_px = (orient == MATE_PANEL_APPLET_ORIENT_LEFT || orient == MATE_PANEL_APPLET_ORIENT_RIGHT) ? (double)h : (double)w;
-
-                for (int i = 0; i < n; i++) {
-                    const int idx = (start + i) % AppletState::kDeltaHistN;
-                    const double delta = dpp[idx];
-                    if (std::fabs(delta) < 0.05) continue;
-
-                    const double pp = std::min(std::fabs(delta), max_pp_per_seg);
-                    double px = (pp / 100.0) * axis_px;
-                    if (px < min_px) px = min_px;
-                    segs.push_back({px, delta, i});
-                }
+            struct Seg { double px; double delta; int age_rank; };
+            std::vector<Seg> segs;
+            segs.reserve(n);
 
-                // Fit to available space.
-                double sum_px = 0.0;
-                for (const auto& s : segs) sum_px += s.px;
-                if (sum_px > 0.0) {
-                    const double scale = std::min(1.0, max_hist_px / sum_px);
-                    for (auto& s : segs) s.px *= scale;
-
-                    // Draw from newest to oldest, starting at leading edge.
-                    double cursor = 0.0;
-                    for (int i = (int)segs.size() - 1; i >= 0; i--) {
-                        const auto& s = segs[i];
-                        const bool inc = s.delta > 0.0;
-
-                        // Recency alpha: newest strongest.
-                        const int newest_rank = (int)segs.size() - 1;
-                        const double t = newest_rank > 0 ? (double)i / (double)newest_rank : 1.0;
-                        const double alpha = 0.90 - (1.0 - t) * 0.60; // ~0.30..0.90
-
-                        const double dr = inc ? 0.25 : 0.98;
-                        const double dg = inc ? 0.65 : 0.55;
-                        const double db = inc ? 0.98 : 0.15;
-
-                        cairo_set_source_rgba(cr, dr, dg, db, alpha);
-
-                        if (orient == MATE_PANEL_APPLET_ORIENT_LEFT || orient == MATE_PANEL_APPLET_ORIENT_RIGHT) {
-                            // Leading edge is the top (since fill grows from bottom). Place near fill top.
-                            const double lead_y = h - fill_px;
-                            const double y0 = lead_y + cursor;
-                            const double y1 = y0 + s.px;
-                            if (y0 < h) {
-                                cairo_rectangle(cr, 0, y0, w, std::min((double)h, y1) - y0);
-                                cairo_fill(cr);
-                            }
-                        } else {
-                            const double lead_x = fill_px;
-                            const double x1 = lead_x - cursor;
-                            const double x0 = x1 - s.px;
-                            if (x1 > 0) {
-                                cairo_rectangle(cr, std::max(0.0, x0), 0, x1 - std::max(0.0, x0), h);
-                                cairo_fill(cr);
-                            }
-                        }
+            const double max_pp_per_seg = 15.0;
+            const double min_px = 2.0;
+            const double axis_px = vertical ? (double)h : (double)w;
 
-                        // Subtle separator.
-                        cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.12);
-                        cairo_set_line_width(cr, 1.0);
-                        if (orient == MATE_PANEL_APPLET_ORIENT_LEFT || orient == MATE_PANEL_APPLET_ORIENT_RIGHT) {
-                            const double lead_y = h - fill_px;
-                            const double y = lead_y + cursor;
-                            cairo_move_to(cr, 0, y);
-                            cairo_line_to(cr, w, y);
-                            cairo_stroke(cr);
-                        } else {
-                            const double lead_x = fill_px;
-                            const double x = lead_x - cursor;
-                            cairo_move_to(cr, x, 0);
-                            cairo_line_to(cr, x, h);
-                            cairo_stroke(cr);
+            for (int i = 0; i < n; i++) {
+                const int idx = (start + i) % AppletState::kDeltaHistN;
+                const double delta = k.delta_pp[idx];
+                if (std::fabs(delta) < 0.05) continue;
+
+                const double pp = std::min(std::fabs(delta), max_pp_per_seg);
+                double px = (pp / 100.0) * axis_px;
+                if (px < min_px) px = min_px;
+                segs.push_back({px, delta, i});
+            }
+
+            // Fit to available space.
+            double sum_px = 0.0;
+            for (const auto& s : segs) sum_px += s.px;
+            if (sum_px > 0.0) {
+                const double scale = std::min(1.0, max_hist_px / sum_px);
+                for (auto& s : segs) s.px *= scale;
+
+                // Draw from newest to oldest, starting at leading edge.
+                double cursor = 0.0;
+                for (int i = (int)segs.size() - 1; i >= 0; i--) {
+                    const auto& s = segs[i];
+                    const bool inc = s.delta > 0.0;
+
+                    // Recency alpha: newest strongest.
+                    const int newest_rank = (int)segs.size() - 1;
+                    const double t = newest_rank > 0 ? (double)i / (double)newest_rank : 1.0;
+                    const double alpha = 0.90 - (1.0 - t) * 0.60; // ~0.30..0.90
+
+                    const double dr = inc ? 0.25 : 0.98;
+                    const double dg = inc ? 0.65 : 0.55;
+                    const double db = inc ? 0.98 : 0.15;
+
+                    cairo_set_source_rgba(cr, dr, dg, db, alpha);
+
+                    if (vertical) {
+                        // Leading edge is the top (since fill grows from bottom). Place near fill top.
+                        const double lead_y = h - fill_px;
+                        const double y0 = lead_y + cursor;
+                        const double y1 = y0 + s.px;
+                        if (y0 < h) {
+                            cairo_rectangle(cr, 0, y0, w, std::min((double)h, y1) - y0);
+                            cairo_fill(cr);
+                        }
+                    } else {
+                        const double lead_x = fill_px;
+                        const double x1 = lead_x - cursor;
+                        const double x0 = x1 - s.px;
+                        if (x1 > 0) {
+                            cairo_rectangle(cr, std::max(0.0, x0), 0, x1 - std::max(0.0, x0), h);
+                            cairo_fill(cr);
                         }
+                    }
 
-                        cursor += s.px;
-                        if (cursor >= max_hist_px) break;
+                    // Subtle separator.
+                    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.12);
+                    cairo_set_line_width(cr, 1.0);
+                    if (vertical) {
+                        const double lead_y = h - fill_px;
+                        const double y = lead_y + cursor;
+                        cairo_move_to(cr, 0, y);
+                        cairo_line_to(cr, w, y);
+                        cairo_stroke(cr);
+                    } else {
+                        const double lead_x = fill_px;
+                        const double x = lead_x - cursor;
+                        cairo_move_to(cr, x, 0);
+                        cairo_line_to(cr, x, h);
+                        cairo_stroke(cr);
                     }
+
+                    cursor += s.px;
+                    if (cursor >= max_hist_px) break;
                 }
             }
         }
@@ -804,62 +1008,13 @@ static gboolean on_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
         }
         cairo_stroke(cr);
     }
+}
 
-    // 5h window remaining time line (bottom edge), independent from usage.
-    // Uses server-provided reset_time when available; falls back to:
-    //   - local reset detection timestamp (best effort), then
-    //   - an epoch-aligned 5h window (always available).
-    {
-        const int px = clamp_time_line_px(time_line_px);
-        if (px > 0) {
-            int64_t remaining_s = -1;
-            if (!reset_time.empty() && reset_time != "N/A") {
-                time_t reset_utc = 0;
-                if (parse_iso8601_utc_to_time_t(reset_time, &reset_utc)) {
-                    int64_t until_reset = (int64_t)difftime(reset_utc, time(nullptr));
-                    if (until_reset < 0) until_reset = 0;
-                    if (until_reset > kQuotaWindowSeconds) until_reset = kQuotaWindowSeconds;
-                    remaining_s = until_reset;
-                }
-            }
-            if (remaining_s < 0 && last_window_reset_ts != 0) {
-                int64_t age_s = (int64_t)difftime(time(nullptr), last_window_reset_ts);
-                if (age_s < 0) age_s = 0;
-                int64_t until_reset = (int64_t)kQuotaWindowSeconds - age_s;
-                if (until_reset < 0) until_reset = 0;
-                if (until_reset > kQuotaWindowSeconds) until_reset = kQuotaWindowSeconds;
-                remaining_s = until_reset;
-            }
-
-            // Last-resort fallback: epoch-aligned 5h window so we always have a countdown.
-            if (remaining_s < 0) {
-                const time_t now_s = time(nullptr);
-                const time_t window_start = (now_s / (time_t)kQuotaWindowSeconds) * (time_t)kQuotaWindowSeconds;
-                int64_t age_s = (int64_t)difftime(now_s, window_start);
-                if (age_s < 0) age_s = 0;
-                int64_t until_reset = (int64_t)kQuotaWindowSeconds - age_s;
-                if (until_reset < 0) until_reset = 0;
-                if (until_reset > kQuotaWindowSeconds) until_reset = kQuotaWindowSeconds;
-                remaining_s = until_reset;
-            }
-
-            if (remaining_s >= 0) {
-                // If the remaining time is *very* close to the full 5h window, the most
-                // likely case is that we don't have a server reset_time yet. In that case
-                // don't draw the line (prevents drawing a full-width red bar all the time).
-                if (remaining_s > (int64_t)kQuotaWindowSeconds - 5) {
-                    // Leave it hidden until we have a meaningful countdown.
-                } else {
-                const double frac = (double)remaining_s / (double)kQuotaWindowSeconds;
-                const double len = std::max(0.0, std::min(1.0, frac)) * (double)w;
-                const int y0 = std::max(0, h - px);
-                cairo_set_source_rgba(cr, 0.95, 0.10, 0.10, 0.95);
-                cairo_rectangle(cr, 0, y0, len, std::min(px, h));
-                cairo_fill(cr);
-                }
-            }
-        }
-    }
+// Border and percent text: everything above the time line.
+static void draw_top_layer(cairo_t* cr, const AppletState::LayerKey& k) {
+    const int w = k.w;
+    const int h = k.h;
+    const bool stale = k.has_error && k.have_good;
 
     // Border.
     if (stale) {
@@ -873,13 +1028,13 @@ static gboolean on_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
 
     // Tiny percent text overlay.
     char text[16];
-    if (!have) {
+    if (!k.have) {
         snprintf(text, sizeof(text), "--");
     } else {
-        int pct_i = (int)std::llround(pct);
-        if (!err.empty() && have_good) {
+        int pct_i = (int)std::llround(k.pct);
+        if (k.has_error && k.have_good) {
             snprintf(text, sizeof(text), "%d%%*", pct_i);
-        } else if (!err.empty() && !have_good) {
+        } else if (k.has_error && !k.have_good) {
             snprintf(text, sizeof(text), "ERR");
         } else {
             snprintf(text, sizeof(text), "%d%%", pct_i);
@@ -903,6 +1058,156 @@ static gboolean on_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
     cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, 0.92);
     cairo_move_to(cr, tx, ty);
     cairo_show_text(cr, text);
+}
+
+// Seconds left in the 5h window for the time line, independent from usage.
+// Uses server-provided reset_time when available; falls back to:
+//   - local reset detection timestamp (best effort), then
+//   - an epoch-aligned 5h window (always available).
+static int64_t time_line_remaining_s(const std::string& reset_time, time_t last_window_reset_ts) {
+    int64_t remaining_s = -1;
+    if (!reset_time.empty() && reset_time != "N/A") {
+        time_t reset_utc = 0;
+        if (parse_iso8601_utc_to_time_t(reset_time, &reset_utc)) {
+            int64_t until_reset = (int64_t)difftime(reset_utc, clock_now());
+            if (until_reset < 0) until_reset = 0;
+            if (until_reset > kQuotaWindowSeconds) until_reset = kQuotaWindowSeconds;
+            remaining_s = until_reset;
+        }
+    }
+    if (remaining_s < 0 && last_window_reset_ts != 0) {
+        int64_t age_s = (int64_t)difftime(clock_now(), last_window_reset_ts);
+        if (age_s < 0) age_s = 0;
+        int64_t until_reset = (int64_t)kQuotaWindowSeconds - age_s;
+        if (until_reset < 0) until_reset = 0;
+        if (until_reset > kQuotaWindowSeconds) until_reset = kQuotaWindowSeconds;
+        remaining_s = until_reset;
+    }
+
+    // Last-resort fallback: epoch-aligned 5h window so we always have a countdown.
+    if (remaining_s < 0) {
+        const time_t now_s = clock_now();
+        const time_t window_start = (now_s / (time_t)kQuotaWindowSeconds) * (time_t)kQuotaWindowSeconds;
+        int64_t age_s = (int64_t)difftime(now_s, window_start);
+        if (age_s < 0) age_s = 0;
+        int64_t until_reset = (int64_t)kQuotaWindowSeconds - age_s;
+        if (until_reset < 0) until_reset = 0;
+        if (until_reset > kQuotaWindowSeconds) until_reset = kQuotaWindowSeconds;
+        remaining_s = until_reset;
+    }
+    return remaining_s;
+}
+
+// 5h window remaining time line (bottom edge).
+static void draw_time_line(cairo_t* cr, int w, int h, int time_line_px,
+                           const std::string& reset_time, time_t last_window_reset_ts) {
+    const int px = clamp_time_line_px(time_line_px);
+    if (px <= 0) return;
+
+    const int64_t remaining_s = time_line_remaining_s(reset_time, last_window_reset_ts);
+
+    // If the remaining time is *very* close to the full 5h window, the most
+    // likely case is that we don't have a server reset_time yet. In that case
+    // don't draw the line (prevents drawing a full-width red bar all the time).
+    if (remaining_s > (int64_t)kQuotaWindowSeconds - 5) {
+        return;
+    }
+
+    const double frac = (double)remaining_s / (double)kQuotaWindowSeconds;
+    const double len = std::max(0.0, std::min(1.0, frac)) * (double)w;
+    const int y0 = std::max(0, h - px);
+    cairo_set_source_rgba(cr, 0.95, 0.10, 0.10, 0.95);
+    cairo_rectangle(cr, 0, y0, len, std::min(px, h));
+    cairo_fill(cr);
+}
+
+static void free_draw_layers(AppletState* state) {
+    if (state->base_layer) {
+        cairo_surface_destroy(state->base_layer);
+        state->base_layer = nullptr;
+    }
+    if (state->top_layer) {
+        cairo_surface_destroy(state->top_layer);
+        state->top_layer = nullptr;
+    }
+}
+
+static void render_draw_layer(cairo_surface_t* layer, const AppletState::LayerKey& k,
+                              void (*draw)(cairo_t*, const AppletState::LayerKey&)) {
+    cairo_t* lcr = cairo_create(layer);
+    cairo_set_operator(lcr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(lcr);
+    cairo_set_operator(lcr, CAIRO_OPERATOR_OVER);
+    draw(lcr, k);
+    cairo_destroy(lcr);
+}
+
+static void rebuild_draw_layers(AppletState* state, GtkWidget* widget, const AppletState::LayerKey& k) {
+    // Surfaces are reused until the size changes; otherwise only repainted.
+    if (state->base_layer && (state->layer_key.w != k.w || state->layer_key.h != k.h)) {
+        free_draw_layers(state);
+    }
+    if (!state->base_layer) {
+        GdkWindow* window = gtk_widget_get_window(widget);
+        state->base_layer = gdk_window_create_similar_surface(window, CAIRO_CONTENT_COLOR_ALPHA, k.w, k.h);
+        state->top_layer = gdk_window_create_similar_surface(window, CAIRO_CONTENT_COLOR_ALPHA, k.w, k.h);
+    }
+    render_draw_layer(state->base_layer, k, draw_base_layer);
+    render_draw_layer(state->top_layer, k, draw_top_layer);
+    state->layer_key = k;
+}
+
+static gboolean on_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!state) return FALSE;
+
+    static bool logged = false;
+    if (!logged) {
+        logged = true;
+        panel_log("on_draw first call");
+    }
+
+    GtkAllocation a;
+    gtk_widget_get_allocation(widget, &a);
+    const int w = a.width;
+    const int h = a.height;
+    if (w <= 0 || h <= 0) return FALSE;
+
+    AppletState::LayerKey key;
+    key.w = w;
+    key.h = h;
+    std::string reset_time;
+    time_t last_window_reset_ts = 0;
+    int time_line_px = 0;
+    {
+        std::lock_guard<std::mutex> lock(state->mu);
+        key.have_good = state->have_last_good;
+        key.have = key.have_good || state->have_quota;
+        const QuotaData& q = key.have_good ? state->last_good_quota : state->current_quota;
+        key.pct = clamp_pct(q.percentage);
+        key.has_error = !state->last_error.empty();
+        key.delta_count = state->delta_hist_count;
+        key.delta_next = state->delta_hist_next;
+        key.delta_pp = state->delta_hist_pp;
+        reset_time = q.reset_time;
+        last_window_reset_ts = state->last_window_reset_ts;
+        time_line_px = state->time_line_px;
+    }
+    key.orient = (int)mate_panel_applet_get_orient(state->applet);
+
+    // Only the time line moves between refreshes: everything else is kept in
+    // two cached layers (below and above the line) that are rebuilt when the
+    // data, size or orientation change, so a UI tick is two surface blits
+    // and one rectangle.
+    if (!state->base_layer || !(state->layer_key == key)) {
+        rebuild_draw_layers(state, widget, key);
+    }
+
+    cairo_set_source_surface(cr, state->base_layer, 0, 0);
+    cairo_paint(cr);
+    draw_time_line(cr, w, h, time_line_px, reset_time, last_window_reset_ts);
+    cairo_set_source_surface(cr, state->top_layer, 0, 0);
+    cairo_paint(cr);
 
     return FALSE;
 }
@@ -922,74 +1227,110 @@ struct FetchThreadData {
     QuotaData quota_data;
     std::optional<AuthMethod> used_method;
     std::string error_message;
+    long rate_limit_s = -1;     // server-requested delay, -1 when not throttled
+    bool unchanged = false;     // same response as before: last sample reused
+
+    // Multi-account snapshot taken in start_fetch(), updated by the thread.
+    std::vector<PanelAccount> accounts;
 };
 
 static void apply_width(AppletState* state, int width_px);
 
-static gboolean on_fetch_complete(gpointer user_data) {
-    FetchThreadData* data = (FetchThreadData*)user_data;
-    AppletState* state = data->state;
-
-    {
-        std::lock_guard<std::mutex> lock(state->mu);
-        state->fetching = false;
-        if (data->success) {
-            const time_t now = time(nullptr);
-
-            // Detect 5h window boundary and clear delta history when it changes.
-            time_t window_start_utc = 0;
-            const bool have_window = compute_window_start_utc(data->quota_data.reset_time, &window_start_utc);
-            const int64_t tol_s = 60;
-            if (have_window) {
-                if (state->last_window_start_utc != 0 && std::llabs((long long)window_start_utc - (long long)state->last_window_start_utc) > tol_s) {
-                    delta_hist_clear(state);
-                    state->last_window_reset_ts = now;
-                }
-                state->last_window_start_utc = window_start_utc;
-            }
-
-            const double new_pct = data->quota_data.percentage;
-            const double prev_pct = state->have_last_good ? state->last_good_quota.percentage : new_pct;
-            state->prev_good_pct = prev_pct;
-            state->last_delta_pp = new_pct - prev_pct;
+// Fold one fetch outcome into the applet state. Caller holds state->mu.
+static void apply_fetch_result_locked(AppletState* state, const FetchThreadData* data) {
+    if (!data->accounts.empty() && data->accounts.size() == state->accounts.size()) {
+        state->accounts = data->accounts;
+    }
+    if (data->success) {
+        const time_t now = clock_now();
 
-            // Heuristic: if reset_time is missing, but we see a large negative jump, treat it as a window reset.
-            if (!have_window && state->have_last_good && state->last_delta_pp <= -10.0) {
+        // Detect 5h window boundary and clear delta history when it changes.
+        time_t window_start_utc = 0;
+        const bool have_window = compute_window_start_utc(data->quota_data.reset_time, &window_start_utc);
+        const int64_t tol_s = 60;
+        if (have_window) {
+            if (state->last_window_start_utc != 0 && std::llabs((long long)window_start_utc - (long long)state->last_window_start_utc) > tol_s) {
                 delta_hist_clear(state);
                 state->last_window_reset_ts = now;
             }
+            state->last_window_start_utc = window_start_utc;
+        }
 
-            // Push delta into history (only after potential reset handling).
-            delta_hist_push(state, state->last_delta_pp, now);
+        const double new_pct = data->quota_data.percentage;
+        const double prev_pct = state->have_last_good ? state->last_good_quota.percentage : new_pct;
+        state->prev_good_pct = prev_pct;
+        state->last_delta_pp = new_pct - prev_pct;
 
-            state->current_quota = data->quota_data;
-            state->have_quota = true;
+        // Heuristic: if reset_time is missing, but we see a large negative jump, treat it as a window reset.
+        if (!have_window && state->have_last_good && state->last_delta_pp <= -10.0) {
+            delta_hist_clear(state);
+            state->last_window_reset_ts = now;
+        }
 
-            state->last_good_quota = data->quota_data;
-            state->have_last_good = true;
-            state->last_success_ts = now;
-            state->consecutive_failures = 0;
-            state->last_http_code = data->result.http_code;
-            state->last_curl_code = data->result.curl_code;
-            state->last_curl_error = data->result.curl_error;
+        // Push delta into history (only after potential reset handling).
+        delta_hist_push(state, state->last_delta_pp, now);
 
-            state->last_error.clear();
-            if (data->used_method.has_value()) {
-                state->preferred_auth_method = data->used_method;
-            }
-        } else {
-            state->last_error = data->error_message;
-            state->last_failure_ts = time(nullptr);
-            state->consecutive_failures += 1;
-            state->last_http_code = data->result.http_code;
-            state->last_curl_code = data->result.curl_code;
-            state->last_curl_error = data->result.curl_error;
+        state->current_quota = data->quota_data;
+        state->have_quota = true;
+
+        state->last_good_quota = data->quota_data;
+        state->have_last_good = true;
+        state->last_success_ts = now;
+        retry_on_success(&state->retry);
+        state->last_http_code = data->result.http_code;
+        state->last_curl_code = data->result.curl_code;
+        state->last_curl_error = data->result.curl_error;
+
+        state->last_error.clear();
+        if (data->used_method.has_value()) {
+            state->preferred_auth_method = data->used_method;
+        }
+    } else {
+        state->last_error = data->error_message;
+        state->last_failure_ts = clock_now();
+        state->last_http_code = data->result.http_code;
+        state->last_curl_code = data->result.curl_code;
+        state->last_curl_error = data->result.curl_error;
+    }
+}
+
+static void schedule_retry(AppletState* state, int delay_s);
+
+static gboolean on_fetch_complete(gpointer user_data) {
+    FetchThreadData* data = (FetchThreadData*)user_data;
+    AppletState* state = data->state;
+
+    int retry_delay_s = 0;
+    bool was_ok = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mu);
+        state->fetching = false;
+        was_ok = !retry_waiting(&state->retry);
+        apply_fetch_result_locked(state, data);
+        if (data->rate_limit_s >= 0) {
+            // Throttled: the server's delay wins, even after a usable answer
+            retry_delay_s = retry_on_rate_limit(&state->retry, data->rate_limit_s, state->refresh_interval_s);
+        } else if (!data->success) {
+            retry_delay_s = retry_on_failure(&state->retry, state->refresh_interval_s);
         }
     }
+    if (data->rate_limit_s >= 0) {
+        panel_log("rate limited (HTTP %ld), server asked for %lds, next try in %ds",
+                  data->result.http_code, data->rate_limit_s, retry_delay_s);
+    }
+
+    // Back off on our own schedule (not while following the D-Bus service)
+    if (retry_delay_s > 0 && !state->destroy_requested.load(std::memory_order_relaxed) && !state->quota_proxy) {
+        schedule_retry(state, retry_delay_s);
+    }
 
     if (!state->destroy_requested.load(std::memory_order_relaxed) && state->drawing) {
-        set_tooltip(state);
-        gtk_widget_queue_draw(state->drawing);
+        invalidate_tooltip(state);
+        // Same sample after a good fetch: the bar is current (the UI tick
+        // moves the time line)
+        if (!data->unchanged || !was_ok) {
+            gtk_widget_queue_draw(state->drawing);
+        }
     }
 
     delete data;
@@ -997,12 +1338,58 @@ static gboolean on_fetch_complete(gpointer user_data) {
     return G_SOURCE_REMOVE;
 }
 
+// Fetch all accounts concurrently; the headline sample is the account
+// closest to its limit.
+static void fetch_accounts(FetchThreadData* data) {
+    std::vector<AuthJob> jobs(data->accounts.size());
+    for (size_t i = 0; i < data->accounts.size(); i++) {
+        jobs[i].api_key = data->accounts[i].api_key;
+        jobs[i].token = data->accounts[i].token;
+        jobs[i].preferred_method = data->accounts[i].preferred_auth_method;
+    }
+
+    try_auth_methods_concurrent(jobs);
+
+    for (size_t i = 0; i < data->accounts.size(); i++) {
+        PanelAccount& acct = data->accounts[i];
+        acct.preferred_auth_method = jobs[i].preferred_method;
+        long throttle_s = 0;
+        if (request_rate_limited(jobs[i].result, &throttle_s)) {
+            data->rate_limit_s = std::max(data->rate_limit_s, throttle_s);
+        }
+        // Unchanged body: keep the account's sample instead of parsing
+        if (jobs[i].result.unchanged && acct.ok && acct.quota.timestamp > 0) {
+            acct.quota.timestamp = clock_now();
+        } else {
+            acct.ok = parse_quota_result(jobs[i].result, &acct.quota, &acct.error);
+        }
+        if (!acct.ok) {
+            if (data->error_message.empty()) {
+                data->error_message = acct.name + ": " + acct.error;
+                data->result = jobs[i].result;
+            }
+            continue;
+        }
+        if (!data->success || acct.quota.percentage > data->quota_data.percentage) {
+            data->quota_data = acct.quota;
+            data->result = jobs[i].result;
+        }
+        data->success = true;
+    }
+}
+
 static void* fetch_quota_thread(void* arg) {
     FetchThreadData* data = (FetchThreadData*)arg;
     AppletState* state = data->state;
 
     data->success = false;
 
+    if (!data->accounts.empty()) {
+        fetch_accounts(data);
+        g_idle_add(on_fetch_complete, data);
+        return nullptr;
+    }
+
     if (state->api_key.empty()) {
         data->error_message = "Missing FIRMWARE_API_KEY";
         g_idle_add(on_fetch_complete, data);
@@ -1016,11 +1403,13 @@ static void* fetch_quota_thread(void* arg) {
         &data->used_method
     );
 
+    long throttle_s = 0;
+    if (request_rate_limited(data->result, &throttle_s)) {
+        data->rate_limit_s = throttle_s;
+    }
+
     if (data->result.curl_code != CURLE_OK) {
-        data->error_message = std::string("Request failed: ") + curl_easy_strerror(data->result.curl_code);
-        if (!data->result.curl_error.empty()) {
-            data->error_message += " (" + data->result.curl_error + ")";
-        }
+        data->error_message = describe_request_failure(data->result);
         g_idle_add(on_fetch_complete, data);
         return nullptr;
     }
@@ -1034,6 +1423,21 @@ static void* fetch_quota_thread(void* arg) {
         return nullptr;
     }
 
+    // Unchanged body: the last sample stands, nothing to parse
+    if (data->result.unchanged) {
+        std::lock_guard<std::mutex> lock(state->mu);
+        if (state->have_quota) {
+            data->quota_data = state->current_quota;
+            data->quota_data.timestamp = clock_now();
+            data->unchanged = true;
+            data->success = true;
+        }
+    }
+    if (data->unchanged) {
+        g_idle_add(on_fetch_complete, data);
+        return nullptr;
+    }
+
     try {
         json j = json::parse(data->result.body);
         if (!j.contains("used") || j["used"].is_null()) {
@@ -1048,7 +1452,7 @@ static void* fetch_quota_thread(void* arg) {
         data->quota_data.used = used;
         data->quota_data.percentage = used * 100.0;
         data->quota_data.reset_time = reset.empty() ? "N/A" : reset;
-        data->quota_data.timestamp = time(nullptr);
+        data->quota_data.timestamp = clock_now();
         data->success = true;
     } catch (const std::exception& e) {
         data->error_message = std::string("Parse error: ") + e.what();
@@ -1072,10 +1476,15 @@ static void start_fetch(AppletState* state) {
         }
         state->fetching = true;
         state->last_error.clear();
+        retry_attempt_started(&state->retry);
     }
 
     FetchThreadData* data = new FetchThreadData();
     data->state = state;
+    {
+        std::lock_guard<std::mutex> lock(state->mu);
+        data->accounts = state->accounts;
+    }
 
     // Hold a ref until on_fetch_complete runs.
     state_ref(state);
@@ -1094,26 +1503,238 @@ static void start_fetch(AppletState* state) {
     state_unref(state);
 }
 
+// ============================================================================
+// org.firmware.Quota subscription
+// ============================================================================
+
+static std::string iso8601_from_epoch(int64_t epoch) {
+    const time_t t = (time_t)epoch;
+    struct tm tm_utc;
+    if (!gmtime_r(&t, &tm_utc)) return "N/A";
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S.000Z", &tm_utc);
+    return buf;
+}
+
+// Convert the service's cached properties into a sample and apply it exactly
+// like a local fetch result.
+static void apply_remote_state(AppletState* state) {
+    if (!state->quota_proxy) return;
+
+    double usage = 0.0;
+    int64_t reset_epoch = -1;
+    int64_t last_update = 0;
+    std::string last_error;
+
+    GVariant* v = g_dbus_proxy_get_cached_property(state->quota_proxy, "Usage");
+    if (v) { usage = g_variant_get_double(v); g_variant_unref(v); }
+    v = g_dbus_proxy_get_cached_property(state->quota_proxy, "ResetEpoch");
+    if (v) { reset_epoch = g_variant_get_int64(v); g_variant_unref(v); }
+    v = g_dbus_proxy_get_cached_property(state->quota_proxy, "LastUpdate");
+    if (v) { last_update = g_variant_get_int64(v); g_variant_unref(v); }
+    v = g_dbus_proxy_get_cached_property(state->quota_proxy, "LastError");
+    if (v) { last_error = g_variant_get_string(v, nullptr); g_variant_unref(v); }
+
+    FetchThreadData data;
+    data.state = state;
+    data.success = false;
+    if (!last_error.empty()) {
+        data.error_message = last_error;
+    } else if (last_update > 0) {
+        data.success = true;
+        data.quota_data.used = usage / 100.0;
+        data.quota_data.percentage = usage;
+        data.quota_data.reset_time = (reset_epoch >= 0) ? iso8601_from_epoch(reset_epoch) : "N/A";
+        data.quota_data.timestamp = (time_t)last_update;
+    } else {
+        return;  // service has not completed a fetch yet
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state->mu);
+        apply_fetch_result_locked(state, &data);
+    }
+
+    if (!state->destroy_requested.load(std::memory_order_relaxed) && state->drawing) {
+        invalidate_tooltip(state);
+        gtk_widget_queue_draw(state->drawing);
+    }
+}
+
+static void on_quota_properties_changed(GDBusProxy*, GVariant*, const gchar* const*, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!state || state->destroy_requested.load(std::memory_order_relaxed)) return;
+    apply_remote_state(state);
+}
+
+static void drop_quota_proxy(AppletState* state) {
+    if (!state->quota_proxy) return;
+    if (state->quota_proxy_signal_id > 0) {
+        g_signal_handler_disconnect(state->quota_proxy, state->quota_proxy_signal_id);
+        state->quota_proxy_signal_id = 0;
+    }
+    g_object_unref(state->quota_proxy);
+    state->quota_proxy = nullptr;
+}
+
+static void on_quota_proxy_ready(GObject*, GAsyncResult* res, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+
+    GError* error = nullptr;
+    GDBusProxy* proxy = g_dbus_proxy_new_finish(res, &error);
+    if (!proxy) {
+        panel_log("quota service proxy failed: %s", error ? error->message : "?");
+        g_clear_error(&error);
+        state_unref(state);
+        return;
+    }
+    if (state->destroy_requested.load(std::memory_order_relaxed)) {
+        g_object_unref(proxy);
+        state_unref(state);
+        return;
+    }
+
+    drop_quota_proxy(state);
+    state->quota_proxy = proxy;
+    state->quota_proxy_signal_id =
+        g_signal_connect(proxy, "g-properties-changed", G_CALLBACK(on_quota_properties_changed), state);
+
+    // One poll serves every consumer: stop our own timer while following.
+    if (state->refresh_timer_id > 0) {
+        g_source_remove(state->refresh_timer_id);
+        state->refresh_timer_id = 0;
+    }
+    panel_log("following %s", kQuotaDbusName);
+
+    apply_remote_state(state);
+    state_unref(state);
+}
+
+static void on_quota_name_appeared(GDBusConnection* connection, const gchar* name, const gchar*, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!state || state->destroy_requested.load(std::memory_order_relaxed)) return;
+
+    // Held until on_quota_proxy_ready runs.
+    state_ref(state);
+    g_dbus_proxy_new(connection, G_DBUS_PROXY_FLAGS_NONE, nullptr, name, kQuotaDbusPath,
+                     kQuotaDbusInterface, nullptr, on_quota_proxy_ready, state);
+}
+
+static gboolean on_refresh_timer(gpointer user_data);
+
+// Timer for a delay in clock seconds: whole seconds batched by GLib on the
+// real clock, a precise real-time equivalent on a simulated one
+static guint add_clock_timeout(int seconds, GSourceFunc fn, gpointer data) {
+    if (!clock_simulated()) {
+        return g_timeout_add_seconds(seconds, fn, data);
+    }
+    return g_timeout_add((guint)clock_real_ms(seconds), fn, data);
+}
+
+static void on_quota_name_vanished(GDBusConnection*, const gchar*, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!state || !state->quota_proxy) return;
+
+    drop_quota_proxy(state);
+    if (state->destroy_requested.load(std::memory_order_relaxed)) return;
+
+    // Service went away: fall back to polling on our own.
+    panel_log("%s vanished, polling again", kQuotaDbusName);
+    if (state->refresh_timer_id == 0) {
+        state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval_s * 1000000;
+        state->refresh_timer_id = add_clock_timeout(state->refresh_interval_s, on_refresh_timer, state);
+    }
+    start_fetch(state);
+}
+
 static gboolean on_refresh_timer(gpointer user_data) {
     AppletState* state = (AppletState*)user_data;
     if (!state) return G_SOURCE_REMOVE;
     if (state->destroy_requested.load(std::memory_order_relaxed)) return G_SOURCE_REMOVE;
 
-    state->next_refresh_us = g_get_monotonic_time() + (gint64)state->refresh_interval_s * 1000000;
-    set_tooltip(state);
+    state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval_s * 1000000;
+    invalidate_tooltip(state);
     start_fetch(state);
     return G_SOURCE_CONTINUE;
 }
 
-static gboolean on_ui_tick(gpointer user_data) {
+// Fetch now and restart the periodic timer
+static void restart_refresh(AppletState* state) {
+    if (state->refresh_timer_id > 0) {
+        g_source_remove(state->refresh_timer_id);
+    }
+    state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval_s * 1000000;
+    state->refresh_timer_id = add_clock_timeout(state->refresh_interval_s, on_refresh_timer, state);
+    invalidate_tooltip(state);
+    start_fetch(state);
+}
+
+static gboolean on_retry_timer(gpointer user_data) {
     AppletState* state = (AppletState*)user_data;
-    if (!state) return G_SOURCE_REMOVE;
-    if (state->destroy_requested.load(std::memory_order_relaxed)) return G_SOURCE_REMOVE;
-    set_tooltip(state);
-    if (state->drawing) {
-        gtk_widget_queue_draw(state->drawing);
+    state->refresh_timer_id = 0;
+    if (!state->destroy_requested.load(std::memory_order_relaxed) && !state->quota_proxy) {
+        restart_refresh(state);
     }
-    return G_SOURCE_CONTINUE;
+    return G_SOURCE_REMOVE;
+}
+
+// After a failed or throttled fetch the periodic timer makes way for one delay.
+static void schedule_retry(AppletState* state, int delay_s) {
+    if (state->refresh_timer_id > 0) {
+        g_source_remove(state->refresh_timer_id);
+    }
+    state->next_refresh_us = clock_monotonic_us() + (gint64)delay_s * 1000000;
+    state->refresh_timer_id = add_clock_timeout(delay_s, on_retry_timer, state);
+}
+
+// Network back: retry at once instead of waiting out the backoff.
+static void on_network_changed(GNetworkMonitor*, gboolean available, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!available || state->quota_proxy) return;
+    if (state->destroy_requested.load(std::memory_order_relaxed)) return;
+    if (retry_on_connectivity(&state->retry)) {
+        panel_log("network changed, retrying after %d failures", state->retry.failures);
+        restart_refresh(state);
+    }
+}
+
+// Shared UI tick: moves the time line and keeps a hovered tooltip current.
+// With the reset more than an hour away and nobody hovering, once a minute
+// is enough (the line moves by about a pixel per minute at most).
+static void on_ui_tick(void* user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (!state || !state->drawing) return;
+    if (state->destroy_requested.load(std::memory_order_relaxed)) return;
+
+    // Keep the countdown of a visible tooltip ticking; otherwise no tooltip work.
+    if (state->pointer_inside) {
+        gtk_widget_trigger_tooltip_query(state->drawing);
+    }
+    gtk_widget_queue_draw(state->drawing);
+
+    int period_s = 1;
+    if (!state->pointer_inside) {
+        std::string reset_time;
+        time_t last_window_reset_ts = 0;
+        {
+            std::lock_guard<std::mutex> lock(state->mu);
+            reset_time = state->have_last_good ? state->last_good_quota.reset_time : state->current_quota.reset_time;
+            last_window_reset_ts = state->last_window_reset_ts;
+        }
+        period_s = ui_tick_period_for_reset(time_line_remaining_s(reset_time, last_window_reset_ts));
+    }
+    ui_ticker_set_period(state->ui_ticker, period_s);
+}
+
+// No ticks while the panel (or the applet) is hidden.
+static void on_drawing_map(GtkWidget*, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (state) ui_ticker_set_visible(state->ui_ticker, true);
+}
+
+static void on_drawing_unmap(GtkWidget*, gpointer user_data) {
+    AppletState* state = (AppletState*)user_data;
+    if (state) ui_ticker_set_visible(state->ui_ticker, false);
 }
 
 static void change_refresh_rate(AppletState* state, int new_interval_s) {
@@ -1121,23 +1742,31 @@ static void change_refresh_rate(AppletState* state, int new_interval_s) {
     if (new_interval_s < 5) new_interval_s = 5;
 
     state->refresh_interval_s = new_interval_s;
-    state->next_refresh_us = g_get_monotonic_time() + (gint64)state->refresh_interval_s * 1000000;
+    state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval_s * 1000000;
 
     if (state->refresh_timer_id > 0) {
         g_source_remove(state->refresh_timer_id);
         state->refresh_timer_id = 0;
     }
-    state->refresh_timer_id = g_timeout_add_seconds(state->refresh_interval_s, on_refresh_timer, state);
+    // While following the D-Bus service its own timer drives refreshes.
+    if (!state->quota_proxy) {
+        state->refresh_timer_id = add_clock_timeout(state->refresh_interval_s, on_refresh_timer, state);
+    }
 
-    set_tooltip(state);
+    invalidate_tooltip(state);
 }
 
 static void on_action_refresh_now(GtkAction*, gpointer user_data) {
     AppletState* state = (AppletState*)user_data;
     if (!state) return;
+    if (state->quota_proxy) {
+        // Ask the service; the result arrives via PropertiesChanged.
+        g_dbus_proxy_call(state->quota_proxy, "Refresh", nullptr, G_DBUS_CALL_FLAGS_NONE, -1, nullptr, nullptr, nullptr);
+        return;
+    }
     // Reset countdown to full interval after manual refresh.
-    state->next_refresh_us = g_get_monotonic_time() + (gint64)state->refresh_interval_s * 1000000;
-    set_tooltip(state);
+    state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval_s * 1000000;
+    invalidate_tooltip(state);
     start_fetch(state);
 }
 
@@ -1274,7 +1903,7 @@ static void on_action_api_key_set(GtkAction*, gpointer user_data) {
     gtk_widget_destroy(dialog);
 
     if (!state->destroy_requested.load(std::memory_order_relaxed) && state->drawing) {
-        set_tooltip(state);
+        invalidate_tooltip(state);
         gtk_widget_queue_draw(state->drawing);
     }
 }
@@ -1294,7 +1923,7 @@ static void on_action_api_key_clear(GtkAction*, gpointer user_data) {
     }
 
     if (state->drawing) {
-        set_tooltip(state);
+        invalidate_tooltip(state);
         gtk_widget_queue_draw(state->drawing);
     }
 }
@@ -1307,7 +1936,7 @@ static void on_action_api_key_reload(GtkAction*, gpointer user_data) {
     {
         std::lock_guard<std::mutex> lock(state->mu);
         reload_api_key(state);
-        if (state->api_key.empty()) {
+        if (state->api_key.empty() && state->accounts.empty()) {
             state->last_error = "Missing FIRMWARE_API_KEY";
             state->have_quota = false;
         } else {
@@ -1520,15 +2149,25 @@ static void on_applet_destroy(GtkWidget*, gpointer user_data) {
     if (state->refresh_timer_id > 0) {
         g_source_remove(state->refresh_timer_id);
     }
-    if (state->ui_tick_id > 0) {
-        g_source_remove(state->ui_tick_id);
+    ui_ticker_remove(state->ui_ticker);
+    state->ui_ticker = nullptr;
+    if (state->network_handler > 0) {
+        g_signal_handler_disconnect(g_network_monitor_get_default(), state->network_handler);
+        state->network_handler = 0;
     }
+    if (state->dbus_watch_id > 0) {
+        g_bus_unwatch_name(state->dbus_watch_id);
+        state->dbus_watch_id = 0;
+    }
+    drop_quota_proxy(state);
 
     if (state->action_group) {
         g_object_unref(state->action_group);
         state->action_group = nullptr;
     }
 
+    free_draw_layers(state);
+
     // Prevent any pending UI callback from touching destroyed widgets.
     state->drawing = nullptr;
     state->applet = nullptr;
@@ -1567,6 +2206,7 @@ static gboolean applet_fill(MatePanelApplet* applet, const gchar* iid, gpointer)
             }
         }
 
+        load_clock();
         load_api_key(state);
 
         // Fixed-width applet; don't request major-axis expansion.
@@ -1599,6 +2239,11 @@ static gboolean applet_fill(MatePanelApplet* applet, const gchar* iid, gpointer)
         on_change_size(applet, size, state);
 
         g_signal_connect(drawing, "draw", G_CALLBACK(on_draw), state);
+        gtk_widget_set_has_tooltip(drawing, TRUE);
+        gtk_widget_add_events(drawing, GDK_ENTER_NOTIFY_MASK | GDK_LEAVE_NOTIFY_MASK);
+        g_signal_connect(drawing, "query-tooltip", G_CALLBACK(on_query_tooltip), state);
+        g_signal_connect(drawing, "enter-notify-event", G_CALLBACK(on_pointer_crossing), state);
+        g_signal_connect(drawing, "leave-notify-event", G_CALLBACK(on_pointer_crossing), state);
         gtk_container_add(GTK_CONTAINER(applet), drawing);
         gtk_widget_show(drawing);
 
@@ -1610,17 +2255,27 @@ static gboolean applet_fill(MatePanelApplet* applet, const gchar* iid, gpointer)
         // Do this via idle callback to avoid UI manager timing issues.
         g_idle_add(setup_panel_menu_idle, state);
 
-        // Initialize countdown + tooltip.
-        state->next_refresh_us = g_get_monotonic_time() + (gint64)state->refresh_interval_s * 1000000;
-        set_tooltip(state);
+        // Initialize countdown (the tooltip is built on first hover).
+        state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval_s * 1000000;
 
         // Initial fetch.
+        retry_init(&state->retry);
         start_fetch(state);
 
         // Refresh timer.
-        state->refresh_timer_id = g_timeout_add_seconds(state->refresh_interval_s, on_refresh_timer, state);
-        // Tooltip countdown updates.
-        state->ui_tick_id = g_timeout_add_seconds(1, on_ui_tick, state);
+        state->refresh_timer_id = add_clock_timeout(state->refresh_interval_s, on_refresh_timer, state);
+        // Time line and tooltip countdown updates.
+        state->ui_ticker = ui_ticker_add(on_ui_tick, state);
+        ui_ticker_set_visible(state->ui_ticker, gtk_widget_get_mapped(drawing));
+        g_signal_connect(drawing, "map", G_CALLBACK(on_drawing_map), state);
+        g_signal_connect(drawing, "unmap", G_CALLBACK(on_drawing_unmap), state);
+
+        state->network_handler = g_signal_connect(g_network_monitor_get_default(), "network-changed",
+                                                  G_CALLBACK(on_network_changed), state);
+
+        // Follow org.firmware.Quota whenever a GUI instance exports it.
+        state->dbus_watch_id = g_bus_watch_name(G_BUS_TYPE_SESSION, kQuotaDbusName, G_BUS_NAME_WATCHER_FLAGS_NONE,
+                                                on_quota_name_appeared, on_quota_name_vanished, state, nullptr);
 
         // In out-of-process mode, the toplevel is typically a GtkPlug.
         GtkWidget* toplevel = gtk_widget_get_toplevel(GTK_WIDGET(applet));
@@ -15,6 +15,7 @@
 #include <sys/stat.h>
 #include <optional>
 #include <cmath>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -24,6 +25,11 @@ using json = nlohmann::json;
 
 static constexpr int kQuotaWindowSeconds = 5 * 60 * 60;
 
+static constexpr const char* kDefaultQuotaUrl = "https://app.firmware.ai/api/v1/quota";
+
+// While responses are unchanged the log gets one row per this many seconds
+static constexpr int kLogHeartbeatSeconds = 5 * 60;
+
 // ============================================================================
 // Data Structures
 // ============================================================================
@@ -36,12 +42,107 @@ struct QuotaData {
     time_t timestamp;
 };
 
+// Which budget ended a request (see RequestTimeouts)
+enum class RequestTimeout {
+    None,
+    Connect,        // no connection (TCP + TLS) within the connect budget
+    FirstByte,      // connected, but no response within the first-byte budget
+    Total,          // the refresh deadline ran out
+};
+
+// Where a request came from and how long each phase took (cumulative from
+// the start of the attempt, like curl -w; 0 for phases that did not happen)
+struct RequestTimings {
+    double dns_ms = 0.0;
+    double connect_ms = 0.0;
+    double tls_ms = 0.0;
+    double first_byte_ms = 0.0;
+    double total_ms = 0.0;
+    long http_version = 0;          // CURL_HTTP_VERSION_*, 0 if unknown
+    std::string remote;             // "address:port", empty over a unix socket
+};
+
+// Throttling hints from the final response headers (-1 = header absent).
+// Delays are relative: HTTP dates and epoch resets are converted against
+// the server's Date header when present, else the local clock.
+struct RateLimitInfo {
+    long retry_after_s = -1;        // Retry-After
+    long limit = -1;                // RateLimit-Limit / X-RateLimit-Limit
+    long remaining = -1;            // RateLimit-Remaining / X-RateLimit-Remaining
+    long reset_s = -1;              // RateLimit-Reset / X-RateLimit-Reset
+    time_t server_date = 0;         // Date, 0 if absent
+};
+
 // Structure to hold HTTP request results
 struct RequestResult {
     CURLcode curl_code = CURLE_OK;
     long http_code = 0;
     std::string body;
     std::string curl_error;
+    RequestTimeout timeout = RequestTimeout::None;  // curl_code is then CURLE_OPERATION_TIMEDOUT
+    long elapsed_ms = 0;                            // since the refresh started
+    RequestTimings timings;                         // of the attempt that produced this result
+    RateLimitInfo rate_limit;
+
+    // Conditional requests (see try_auth_methods)
+    std::string etag;                               // ETag of the response
+    std::string last_modified;                      // Last-Modified of the response
+    bool not_modified = false;                      // 304: body restored from the last 2xx
+    bool unchanged = false;                         // same body as the previous 2xx for this key
+};
+
+// Time budgets of one refresh in milliseconds, 0 = no limit. The connect and
+// first-byte budgets apply to every attempt; the total budget is a deadline
+// shared by all auth-method attempts of the refresh.
+struct RequestTimeouts {
+    long connect_ms = 5000;
+    long first_byte_ms = 10000;
+    long total_ms = 15000;
+};
+
+enum class HttpVersion {
+    Default,        // libcurl's choice (HTTP/2 over TLS when offered)
+    Http1_1,
+    Http2,
+    Http3,          // only with a libcurl built with HTTP/3
+};
+
+// How requests reach the API. Empty strings keep libcurl's defaults (the
+// proxy then still follows https_proxy / no_proxy).
+struct RequestTransport {
+    std::string url = kDefaultQuotaUrl;
+    std::string proxy;                  // CURLOPT_PROXY, e.g. http://egress:3128
+    std::string unix_socket;            // CURLOPT_UNIX_SOCKET_PATH (sidecar)
+    std::string ca_bundle;              // CURLOPT_CAINFO
+    HttpVersion http_version = HttpVersion::Default;
+    std::vector<std::string> resolve;   // CURLOPT_RESOLVE, "host:port:address"
+};
+
+// Transport settings by name: config file key, environment variable and
+// command-line option
+struct TransportSetting {
+    const char* key;
+    const char* env;
+    const char* option;
+};
+
+static constexpr TransportSetting kTransportSettings[] = {
+    {"api_url", "FIRMWARE_API_URL", "--url"},
+    {"proxy", "FIRMWARE_PROXY", "--proxy"},
+    {"unix_socket", "FIRMWARE_UNIX_SOCKET", "--unix-socket"},
+    {"ca_bundle", "FIRMWARE_CA_BUNDLE", "--cacert"},
+    {"http_version", "FIRMWARE_HTTP_VERSION", "--http"},
+    {"resolve", "FIRMWARE_RESOLVE", "--resolve"},
+};
+
+// Hedged requests (opt-in, see set_request_hedging). Counters cover the
+// requests made while hedging was enabled.
+struct HedgeStats {
+    bool enabled = false;
+    uint64_t requests = 0;          // attempts while enabled
+    uint64_t hedged = 0;            // duplicates sent
+    uint64_t hedge_wins = 0;        // duplicates that answered first
+    double threshold_ms = 0.0;      // current p95 trigger, 0 until enough samples
 };
 
 // Authentication methods enumeration
@@ -52,6 +153,23 @@ enum class AuthMethod {
     AuthorizationRaw,
 };
 
+// One named API key loaded from a --key-file
+struct AccountKey {
+    std::string name;
+    std::string api_key;
+};
+
+// One account's slot in a concurrent refresh. preferred_method is read and
+// updated in place, exactly like try_auth_methods(); used_method and result
+// are outputs.
+struct AuthJob {
+    std::string api_key;
+    std::string token;
+    std::optional<AuthMethod> preferred_method;
+    std::optional<AuthMethod> used_method;
+    RequestResult result;
+};
+
 // ============================================================================
 // Function Declarations - CURL Utilities
 // ============================================================================
@@ -62,6 +180,65 @@ size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* use
 // Make HTTP request with given auth header
 RequestResult make_request(const std::string& auth_header);
 
+// Optional process-wide check polled while a request is in flight; returning
+// true aborts the transfer (CURLE_ABORTED_BY_CALLBACK). nullptr disables it.
+typedef bool (*RequestAbortCheck)();
+void set_request_abort_check(RequestAbortCheck check);
+
+// Budgets for every following request (process-wide, defaults above)
+void set_request_timeouts(const RequestTimeouts& timeouts);
+const RequestTimeouts& get_request_timeouts();
+
+// Parse a budget in seconds ("5", "2.5", "0" = no limit) into milliseconds
+bool parse_timeout_seconds(const std::string& text, long* ms_out);
+
+// Override budgets from FIRMWARE_CONNECT_TIMEOUT, FIRMWARE_FIRST_BYTE_TIMEOUT
+// and FIRMWARE_TIMEOUT (seconds); unset or invalid variables are ignored.
+// Returns true if any budget was set.
+bool apply_timeout_env(RequestTimeouts* timeouts);
+
+// Transport for every following request (process-wide, defaults above)
+void set_request_transport(const RequestTransport& transport);
+const RequestTransport& get_request_transport();
+
+// Set one setting by its kTransportSettings key. http_version takes
+// "1.1", "2", "3" or "default"; resolve takes comma-separated entries and
+// adds to the list. False for an unknown key or an invalid value.
+bool set_transport_value(RequestTransport* transport, const std::string& key, const std::string& value);
+
+// The setting behind a command-line option, nullptr if it is none
+const TransportSetting* find_transport_option(const std::string& option);
+
+// A setting's current value in the form set_transport_value accepts
+std::string get_transport_value(const RequestTransport& transport, const std::string& key);
+
+// Override settings from the FIRMWARE_* variables of kTransportSettings;
+// unset or invalid variables are ignored. Returns true if any was set.
+bool apply_transport_env(RequestTransport* transport);
+
+// "https://host/path, HTTP/2, proxy http://egress:3128, ..." (only what is set)
+std::string describe_request_transport(const RequestTransport& transport);
+
+// "dns 1.2ms  connect 3.4ms  tls 20.1ms  first byte 80.3ms  total 81.0ms  HTTP/2 203.0.113.5:443"
+std::string format_request_timings(const RequestTimings& timings);
+
+// Hedging: once enough latencies are recorded, an attempt still outstanding
+// after the running p95 gets one duplicate on a fresh connection and the
+// first usable answer wins. Duplicates are capped at 5% of attempts.
+// Applies to single-key fetches (try_auth_methods); off by default.
+void set_request_hedging(bool enabled);
+HedgeStats get_hedge_stats();
+
+// Message for a failed transfer: "Timed out after 5.0s (connect)" for a
+// timeout, otherwise "Request failed: <curl error> (<details>)"
+std::string describe_request_failure(const RequestResult& r);
+
+// True if the server asked us to slow down: HTTP 429, a 503 with
+// Retry-After, or a success that used up the window (remaining == 0 with a
+// known reset). delay_out gets the requested wait in seconds, 0 if the
+// server gave none.
+bool request_rate_limited(const RequestResult& r, long* delay_out);
+
 // Build authentication header based on method
 std::string build_auth_header(AuthMethod method, const std::string& api_key, const std::string& token);
 
@@ -74,12 +251,25 @@ bool is_unauthorized(const std::string& response);
 // Check if result indicates auth failure
 bool is_auth_failure(const RequestResult& r);
 
-// Try different authentication methods
+// Try different authentication methods. Requests are conditional: the last
+// 2xx response per API key is kept, its ETag / Last-Modified are sent as
+// If-None-Match / If-Modified-Since, and a 304 comes back as that 2xx with
+// not_modified set. Servers without validators are covered by a hash of the
+// body. Either way `unchanged` tells the caller it may reuse the previous
+// sample instead of parsing the body again.
 RequestResult try_auth_methods(const std::string& api_key,
                                const std::string& token,
                                std::optional<AuthMethod>& preferred_method,
                                std::optional<AuthMethod>* used_method_out);
 
+// Run try_auth_methods() for every job at once on a single curl multi handle,
+// so a refresh of N accounts takes about as long as the slowest request
+void try_auth_methods_concurrent(std::vector<AuthJob>& jobs);
+
+// Validate a response and extract quota data. On failure returns false and
+// describes the problem in error_out (body truncated for display).
+bool parse_quota_result(const RequestResult& r, QuotaData* out, std::string* error_out);
+
 // ============================================================================
 // Function Declarations - Token/Key Utilities
 // ============================================================================
@@ -90,6 +280,62 @@ std::string extract_token(const std::string& api_key);
 // Truncate string for display
 std::string truncate_for_display(const std::string& s, size_t max_len);
 
+// ============================================================================
+// Function Declarations - Accounts
+// ============================================================================
+
+// Load "name=key" lines ('#' comments and blank lines ignored). Names may
+// not contain '/', '..', whitespace, control characters, '#[' or '%{'
+bool load_key_file(const std::string& path, std::vector<AccountKey>* out, std::string* error_out);
+
+// Per-account log path: show_quota.log -> show_quota.<name>.log
+std::string account_log_path(const std::string& log_file, const std::string& account_name);
+
+// ============================================================================
+// Function Declarations - Clock
+// ============================================================================
+//
+// Every reading of the current time goes through these, so a run can switch
+// to a simulated clock: it starts at a chosen instant and runs `rate` times
+// faster than real time (at 720 a kQuotaWindowSeconds window passes in 25 s),
+// or stands still at rate 0 between clock_advance_to() jumps. Wall-clock and
+// monotonic readings move together. OS timers (timerfd, g_timeout_add) still
+// count real time: delays in clock seconds go through clock_real_ms() or
+// clock_real_span() before arming one. Request budgets, the UI tick and
+// keepalives stay on real time.
+
+// Switch to simulated time: the clock reads `start` now and runs at `rate`
+// (call before starting threads)
+void clock_simulate(time_t start, double rate);
+bool clock_simulated();
+
+// Jump a simulated clock forward to epoch_ms; never moves it back
+void clock_advance_to(int64_t epoch_ms);
+
+// time(nullptr), milliseconds since the epoch, g_get_monotonic_time()
+time_t clock_now();
+int64_t clock_now_ms();
+int64_t clock_monotonic_us();
+
+// localtime() without the shared buffer
+struct tm clock_localtime(time_t t);
+
+// Real delay for a span of clock seconds. A stopped clock maps every span to
+// 0 ms, or to 1 ns for a timespec (a zero itimerspec would disarm the timer).
+long clock_real_ms(double seconds);
+struct timespec clock_real_span(double seconds);
+
+// Clock seconds that pass in real_ms
+double clock_seconds(long real_ms);
+
+// --time-scale (a rate > 0) and --time-start (unix seconds or ISO 8601 UTC)
+bool parse_clock_rate(const std::string& text, double* rate_out);
+bool parse_clock_start(const std::string& text, time_t* start_out);
+
+// Simulate from FIRMWARE_TIME_SCALE and FIRMWARE_TIME_START (default: now)
+// if the scale is set and valid. Returns true if the clock was switched.
+bool apply_clock_env();
+
 // ============================================================================
 // Function Declarations - Time Utilities
 // ============================================================================
@@ -103,6 +349,11 @@ std::string format_duration_compact(int64_t seconds);
 // Format duration in tight form (XhYm or YmZs)
 std::string format_duration_tight(int64_t seconds);
 
+// Projected usage percentage at window reset if the burn rate since the
+// window opened continues. -1 when there is no active window or it is too
+// young (< 1 minute) to extrapolate.
+double forecast_usage_at_reset(const QuotaData& data, time_t now);
+
 // Format ISO 8601 timestamp to readable format in local timezone
 std::string format_timestamp(const std::string& iso_timestamp);
 
@@ -113,6 +364,10 @@ std::string get_timestamp_string();
 // Function Declarations - Logging
 // ============================================================================
 
+// Parse one "Timestamp,Used,Percentage,Reset,Event" log line (false for the
+// header or a malformed line). event_out may be null.
+bool parse_log_line(const std::string& line, QuotaData* data, std::string* event_out);
+
 // Read last quota entry from log file
 QuotaData read_last_log_entry(const std::string& log_file);
 
@@ -122,4 +377,12 @@ std::string detect_event(const QuotaData& current, const QuotaData& previous);
 // Write log entry
 void write_log_entry(const std::string& log_file, const QuotaData& data, const std::string& event);
 
+// For unchanged samples: true once the log's last row is kLogHeartbeatSeconds
+// old on the clock (rows written by this process, else the file's last row)
+bool log_heartbeat_due(const std::string& log_file, time_t now);
+
+// Record a throttling event as a row without a sample
+// ("<timestamp>,,,,RATE_LIMITED http=429 wait=30s"); readers skip it
+void write_log_rate_limited(const std::string& log_file, const RequestResult& r, long delay_s);
+
 #endif // QUOTA_COMMON_H
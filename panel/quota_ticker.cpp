@@ -0,0 +1,237 @@
+#include "quota_ticker.h"
+
+#include <gio/gio.h>
+
+#include <algorithm>
+#include <vector>
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+struct UiTicker {
+    UiTickFn fn = nullptr;
+    void* user_data = nullptr;
+    int period_s = 1;
+    bool visible = true;
+    bool removed = false;       // freed after the current dispatch
+    gint64 last_fire_us = 0;
+};
+
+struct TickScheduler {
+    std::vector<UiTicker*> tickers;
+    guint source_id = 0;
+    int source_period_s = 0;
+    bool dispatching = false;
+
+    // Screen saver watch
+    bool session_idle = false;
+    GDBusConnection* bus = nullptr;
+    std::vector<guint> signal_ids;
+    GCancellable* bus_cancel = nullptr;
+};
+
+static TickScheduler g_scheduler;
+
+// Interfaces whose ActiveChanged(b) announces a screen saver / lock
+static const char* const kScreenSaverInterfaces[] = {
+    "org.freedesktop.ScreenSaver",
+    "org.gnome.ScreenSaver",
+    "org.mate.ScreenSaver",
+};
+
+// g_timeout_add_seconds may fire slightly early; accept ticks this close
+static constexpr gint64 kTickSlackUs = 500000;
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+static gboolean on_scheduler_tick(gpointer user_data);
+
+static void reschedule() {
+    TickScheduler& s = g_scheduler;
+
+    int period = 0;
+    if (!s.session_idle) {
+        for (const UiTicker* t : s.tickers) {
+            if (t->visible && !t->removed && (period == 0 || t->period_s < period)) {
+                period = t->period_s;
+            }
+        }
+    }
+    if (period == s.source_period_s && (period == 0) == (s.source_id == 0)) {
+        return;
+    }
+
+    if (s.source_id > 0) {
+        g_source_remove(s.source_id);
+        s.source_id = 0;
+    }
+    s.source_period_s = period;
+    if (period > 0) {
+        s.source_id = g_timeout_add_seconds((guint)period, on_scheduler_tick, nullptr);
+    }
+}
+
+static void fire(UiTicker* t, gint64 now_us) {
+    t->last_fire_us = now_us;
+    t->fn(t->user_data);
+}
+
+// Call every due (or, with force, every visible) subscriber, then free the
+// ones removed meanwhile.
+static void dispatch(bool force) {
+    TickScheduler& s = g_scheduler;
+    const gint64 now_us = g_get_monotonic_time();
+
+    s.dispatching = true;
+    // Index loop: callbacks may subscribe new tickers
+    for (size_t i = 0; i < s.tickers.size(); i++) {
+        UiTicker* t = s.tickers[i];
+        if (!t->visible || t->removed) continue;
+        if (force || now_us - t->last_fire_us >= (gint64)t->period_s * 1000000 - kTickSlackUs) {
+            fire(t, now_us);
+        }
+    }
+    s.dispatching = false;
+
+    auto dead = std::remove_if(s.tickers.begin(), s.tickers.end(), [](UiTicker* t) {
+        if (!t->removed) return false;
+        delete t;
+        return true;
+    });
+    s.tickers.erase(dead, s.tickers.end());
+}
+
+static gboolean on_scheduler_tick(gpointer) {
+    TickScheduler& s = g_scheduler;
+    const guint self = s.source_id;
+
+    dispatch(false);
+    reschedule();
+
+    // reschedule() replaced (or dropped) this source when the period changed
+    if (s.source_id != self) {
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+// ============================================================================
+// Screen Saver Watch
+// ============================================================================
+
+static void on_screensaver_active_changed(GDBusConnection*, const gchar*, const gchar*, const gchar*,
+                                          const gchar*, GVariant* parameters, gpointer) {
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(b)"))) return;
+
+    gboolean active = FALSE;
+    g_variant_get(parameters, "(b)", &active);
+    if ((bool)active == g_scheduler.session_idle) return;
+
+    g_scheduler.session_idle = active;
+    if (!active) {
+        dispatch(true);
+    }
+    reschedule();
+}
+
+static void on_session_bus(GObject*, GAsyncResult* res, gpointer) {
+    TickScheduler& s = g_scheduler;
+    GDBusConnection* bus = g_bus_get_finish(res, nullptr);
+    if (!bus) return;   // no session bus (or cancelled): never paused
+
+    if (s.tickers.empty()) {
+        g_object_unref(bus);
+        return;
+    }
+    s.bus = bus;
+    for (const char* iface : kScreenSaverInterfaces) {
+        s.signal_ids.push_back(g_dbus_connection_signal_subscribe(
+            bus, nullptr, iface, "ActiveChanged", nullptr, nullptr, G_DBUS_SIGNAL_FLAGS_NONE,
+            on_screensaver_active_changed, nullptr, nullptr));
+    }
+}
+
+static void watch_screensaver() {
+    TickScheduler& s = g_scheduler;
+    if (s.bus || s.bus_cancel) return;
+    s.bus_cancel = g_cancellable_new();
+    g_bus_get(G_BUS_TYPE_SESSION, s.bus_cancel, on_session_bus, nullptr);
+}
+
+static void unwatch_screensaver() {
+    TickScheduler& s = g_scheduler;
+    if (s.bus_cancel) {
+        g_cancellable_cancel(s.bus_cancel);
+        g_object_unref(s.bus_cancel);
+        s.bus_cancel = nullptr;
+    }
+    if (s.bus) {
+        for (guint id : s.signal_ids) {
+            g_dbus_connection_signal_unsubscribe(s.bus, id);
+        }
+        s.signal_ids.clear();
+        g_object_unref(s.bus);
+        s.bus = nullptr;
+    }
+    s.session_idle = false;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+UiTicker* ui_ticker_add(UiTickFn fn, void* user_data) {
+    UiTicker* t = new UiTicker();
+    t->fn = fn;
+    t->user_data = user_data;
+    g_scheduler.tickers.push_back(t);
+
+    watch_screensaver();
+    reschedule();
+    return t;
+}
+
+void ui_ticker_set_period(UiTicker* ticker, int period_s) {
+    if (!ticker) return;
+    period_s = std::min(60, std::max(1, period_s));
+    if (ticker->period_s == period_s) return;
+    ticker->period_s = period_s;
+    reschedule();
+}
+
+void ui_ticker_set_visible(UiTicker* ticker, bool visible) {
+    if (!ticker || ticker->visible == visible) return;
+    ticker->visible = visible;
+    if (visible && !g_scheduler.session_idle) {
+        fire(ticker, g_get_monotonic_time());
+    }
+    reschedule();
+}
+
+void ui_ticker_remove(UiTicker* ticker) {
+    if (!ticker) return;
+    TickScheduler& s = g_scheduler;
+
+    if (s.dispatching) {
+        ticker->removed = true;
+    } else {
+        s.tickers.erase(std::remove(s.tickers.begin(), s.tickers.end(), ticker), s.tickers.end());
+        delete ticker;
+    }
+
+    bool any_left = false;
+    for (const UiTicker* t : s.tickers) {
+        any_left = any_left || !t->removed;
+    }
+    if (!any_left) {
+        unwatch_screensaver();
+    }
+    reschedule();
+}
+
+int ui_tick_period_for_reset(int64_t seconds_to_reset) {
+    return seconds_to_reset > 3600 ? 60 : 1;
+}
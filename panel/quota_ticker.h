@@ -0,0 +1,50 @@
+#ifndef QUOTA_TICKER_H
+#define QUOTA_TICKER_H
+
+#include <cstdint>
+
+// ============================================================================
+// Shared UI Tick
+// ============================================================================
+//
+// One timer source per process drives every periodic UI update (countdown
+// labels, the panel's time line, a visible tooltip) instead of one 1 s timer
+// per widget:
+//
+//   - each subscriber asks for a period: 1 s while a seconds countdown is on
+//     screen, 60 s when the next visible change is minutes away
+//   - the shared source runs at the shortest period of the visible
+//     subscribers, on g_timeout_add_seconds so GLib batches it with the
+//     process' other second-granularity timers, and is removed altogether
+//     when nothing is visible
+//   - while the session's screen saver is active (ActiveChanged from
+//     org.freedesktop, org.gnome or org.mate ScreenSaver) all subscribers
+//     are paused; each fires once when the session comes back
+//
+// Requires a running GLib main loop; GIO only, like quota_dbus.
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+struct UiTicker;
+
+typedef void (*UiTickFn)(void* user_data);
+
+// Subscribe; starts visible with a 1 s period
+UiTicker* ui_ticker_add(UiTickFn fn, void* user_data);
+
+// Change the period (seconds, clamped to 1..60)
+void ui_ticker_set_period(UiTicker* ticker, int period_s);
+
+// Pause while hidden; becoming visible fires the callback right away so
+// the widget is current when it shows up
+void ui_ticker_set_visible(UiTicker* ticker, bool visible);
+
+// Unsubscribe and free (safe from inside the callback)
+void ui_ticker_remove(UiTicker* ticker);
+
+// Period for a countdown to a window reset: 60 s above one hour, else 1 s
+int ui_tick_period_for_reset(int64_t seconds_to_reset);
+
+#endif // QUOTA_TICKER_H
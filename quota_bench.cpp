@@ -0,0 +1,468 @@
+// End-to-end load harness: runs the fetch engine, then the text binary,
+// against the loopback mock (quota_mock.h) and reports refresh latency
+// percentiles, CPU time and peak RSS for each.
+//
+// The mock runs in a forked child so its threads do not count toward the
+// engine's CPU time or RSS; the text binary is measured with wait4().
+
+#include "quota_common.h"
+#include "quota_mock.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+static const char* const kBenchDefaultScript = "latency lognormal 15 0.5\n";
+static const char* const kBenchApiKey = "fw_api_bench";
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+struct BenchReport {
+    std::string title;
+    std::vector<double> latencies_ms;       // one per refresh
+    std::map<std::string, int> outcomes;    // "200", "429", "curl error", ...
+    double user_s = 0.0;
+    double sys_s = 0.0;
+    long max_rss_kb = 0;
+    double wall_s = 0.0;
+};
+
+// Child process serving the mock; the parent closes `control` to stop it
+struct MockChild {
+    pid_t pid = -1;
+    int control = -1;           // parent -> child (EOF = stop)
+    int results = -1;           // child -> parent (port, then MockStats)
+    int port = 0;
+    std::string url;
+    std::chrono::steady_clock::time_point started;
+};
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static double seconds_of(const timeval& tv) {
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+    rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+    return sorted[rank - 1];
+}
+
+static bool read_full(int fd, void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        const ssize_t n = read(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static std::string outcome_of(const RequestResult& r) {
+    if (r.timeout != RequestTimeout::None) return "timeout";
+    if (r.curl_code != CURLE_OK) return "curl error";
+    return std::to_string(r.http_code);
+}
+
+static void print_report(const BenchReport& report) {
+    std::vector<double> sorted = report.latencies_ms;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::printf("%s\n", report.title.c_str());
+    std::printf("  refreshes   %zu in %.1f s\n", sorted.size(), report.wall_s);
+    if (!sorted.empty()) {
+        std::printf("  latency ms  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n", percentile(sorted, 50),
+                    percentile(sorted, 90), percentile(sorted, 99), sorted.back());
+    }
+    std::string outcomes;
+    for (const auto& entry : report.outcomes) {
+        outcomes += (outcomes.empty() ? "" : ", ") + entry.first + " x" + std::to_string(entry.second);
+    }
+    if (!outcomes.empty()) {
+        std::printf("  outcomes    %s\n", outcomes.c_str());
+    }
+    const double cpu_s = report.user_s + report.sys_s;
+    std::printf("  CPU         %.3f s (user %.3f, sys %.3f)", cpu_s, report.user_s, report.sys_s);
+    if (!sorted.empty()) {
+        std::printf(", %.2f ms per refresh", cpu_s * 1000.0 / sorted.size());
+    }
+    std::printf("\n  max RSS     %.1f MB\n\n", report.max_rss_kb / 1024.0);
+}
+
+// ============================================================================
+// Mock Child
+// ============================================================================
+
+static bool start_mock_child(const MockScript& script, const std::string& cert_file,
+                             const std::string& key_file, MockChild* out) {
+    int control[2], results[2];
+    if (pipe2(control, O_CLOEXEC) != 0 || pipe2(results, O_CLOEXEC) != 0) {
+        perror("pipe");
+        return false;
+    }
+    std::fflush(nullptr);
+
+    out->started = std::chrono::steady_clock::now();
+    const pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        close(control[1]);
+        close(results[0]);
+        signal(SIGPIPE, SIG_IGN);
+        std::string error;
+        MockServer* server = mock_server_start(script, 0, cert_file, key_file, &error);
+        int port = server ? mock_server_port(server) : -1;
+        if (!server) std::cerr << "Error: " << error << std::endl;
+        (void)!write(results[1], &port, sizeof(port));
+        if (!server) _exit(1);
+
+        char byte;
+        while (read(control[0], &byte, 1) > 0) {
+        }
+        const MockStats stats = mock_server_stats(server);
+        (void)!write(results[1], &stats, sizeof(stats));
+        mock_server_stop(server);
+        _exit(0);
+    }
+
+    close(control[0]);
+    close(results[1]);
+    out->pid = pid;
+    out->control = control[1];
+    out->results = results[0];
+    if (!read_full(out->results, &out->port, sizeof(out->port)) || out->port <= 0) {
+        waitpid(pid, nullptr, 0);
+        return false;
+    }
+    out->url = std::string(cert_file.empty() ? "http" : "https") + "://127.0.0.1:" +
+               std::to_string(out->port) + "/api/v1/quota";
+    return true;
+}
+
+static MockStats stop_mock_child(MockChild* child) {
+    MockStats stats;
+    close(child->control);
+    read_full(child->results, &stats, sizeof(stats));
+    close(child->results);
+    waitpid(child->pid, nullptr, 0);
+    return stats;
+}
+
+// ============================================================================
+// Fetch Engine
+// ============================================================================
+
+// `refreshes` rounds of `accounts` concurrent fetches (one try_auth_methods()
+// when accounts == 1), each parsed like a frontend refresh
+static BenchReport bench_engine(int refreshes, int accounts) {
+    BenchReport report;
+    report.title = "Fetch engine (" + std::to_string(refreshes) + " refreshes x " +
+                   std::to_string(accounts) + (accounts == 1 ? " account)" : " accounts, concurrent)");
+
+    const std::string token = extract_token(kBenchApiKey);
+    std::optional<AuthMethod> preferred;
+    std::vector<AuthJob> jobs(static_cast<size_t>(accounts));
+
+    rusage before, after;
+    getrusage(RUSAGE_SELF, &before);
+    const auto bench_start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < refreshes; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<const RequestResult*> results;
+        RequestResult single;
+        if (accounts == 1) {
+            single = try_auth_methods(kBenchApiKey, token, preferred, nullptr);
+            results.push_back(&single);
+        } else {
+            for (AuthJob& job : jobs) {
+                job.api_key = kBenchApiKey;
+                job.token = token;
+                job.result = RequestResult();
+            }
+            try_auth_methods_concurrent(jobs);
+            for (const AuthJob& job : jobs) results.push_back(&job.result);
+        }
+        for (const RequestResult* r : results) {
+            QuotaData data;
+            std::string error;
+            if (!r->unchanged) parse_quota_result(*r, &data, &error);
+            report.outcomes[outcome_of(*r)]++;
+        }
+        report.latencies_ms.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    report.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - bench_start).count();
+    getrusage(RUSAGE_SELF, &after);
+    report.user_s = seconds_of(after.ru_utime) - seconds_of(before.ru_utime);
+    report.sys_s = seconds_of(after.ru_stime) - seconds_of(before.ru_stime);
+    report.max_rss_kb = after.ru_maxrss;
+    return report;
+}
+
+// ============================================================================
+// Text Binary
+// ============================================================================
+
+// Run `binary --url <mock> --timings --refresh 1` for `seconds` and collect
+// the "total" of every "Timings:" line it prints. With a script clock the
+// binary gets the same one (--time-scale/--time-start at the mock's current
+// script time), so --refresh 1 means one fetch per simulated second.
+static bool bench_text_binary(const std::string& binary, const MockChild& mock, const MockScript& script,
+                              const std::string& cert_file, int seconds, BenchReport* report) {
+    report->title = "Text binary (" + binary + ", " + std::to_string(seconds) + " s at --refresh 1";
+    std::string time_scale, time_start;
+    if (script.clock_start >= 0) {
+        const double mock_elapsed_s =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - mock.started).count();
+        char scale[32];
+        snprintf(scale, sizeof(scale), "%g", script.clock_rate);
+        time_scale = scale;
+        time_start = std::to_string(script.clock_start + static_cast<long long>(mock_elapsed_s * script.clock_rate));
+        report->title += ", clock x" + time_scale;
+    }
+    report->title += ")";
+
+    int err_pipe[2];
+    if (pipe2(err_pipe, O_CLOEXEC) != 0) {
+        perror("pipe");
+        return false;
+    }
+    std::fflush(nullptr);
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        const int null_fd = open("/dev/null", O_RDWR);
+        dup2(null_fd, STDIN_FILENO);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(err_pipe[1], STDERR_FILENO);
+        setenv("FIRMWARE_API_KEY", kBenchApiKey, 1);
+        std::vector<const char*> args = {binary.c_str(), "--url", mock.url.c_str(), "--timings",
+                                         "--no-log", "--refresh", "1"};
+        if (!time_scale.empty()) {
+            args.insert(args.end(), {"--time-scale", time_scale.c_str(), "--time-start", time_start.c_str()});
+        }
+        if (!cert_file.empty()) {
+            args.push_back("--cacert");
+            args.push_back(cert_file.c_str());
+        }
+        args.push_back(nullptr);
+        execv(binary.c_str(), const_cast<char* const*>(args.data()));
+        _exit(127);
+    }
+    close(err_pipe[1]);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::seconds(seconds);
+    std::string pending;
+    char buf[4096];
+    while (true) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) break;
+        pollfd pfd = {err_pipe[0], POLLIN, 0};
+        if (poll(&pfd, 1, static_cast<int>(left)) <= 0) continue;
+        const ssize_t n = read(err_pipe[0], buf, sizeof(buf));
+        if (n <= 0) break;
+        pending.append(buf, static_cast<size_t>(n));
+
+        size_t eol;
+        while ((eol = pending.find('\n')) != std::string::npos) {
+            const std::string line = pending.substr(0, eol);
+            pending.erase(0, eol + 1);
+            const size_t total = line.find("total ");
+            if (line.compare(0, 8, "Timings:") == 0 && total != std::string::npos) {
+                report->latencies_ms.push_back(std::atof(line.c_str() + total + 6));
+            } else if (line.find("rror") != std::string::npos) {
+                report->outcomes[line.substr(0, 60)]++;
+            }
+        }
+    }
+
+    kill(pid, SIGTERM);
+    int status = 0;
+    rusage usage;
+    wait4(pid, &status, 0, &usage);
+    close(err_pipe[0]);
+
+    report->wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report->user_s = seconds_of(usage.ru_utime);
+    report->sys_s = seconds_of(usage.ru_stime);
+    report->max_rss_kb = usage.ru_maxrss;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 127) {
+        std::cerr << "Error: cannot run " << binary << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Usage
+// ============================================================================
+
+static void print_usage(const char* program_name) {
+    std::cerr << "Usage: " << program_name << " [OPTIONS]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Benchmarks the refresh pipeline against a loopback mock of the quota API." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --script <file>     Mock behaviour (default: lognormal latency, median 15 ms)" << std::endl;
+    std::cerr << "  --refreshes <n>     Fetch-engine refreshes (default: 200)" << std::endl;
+    std::cerr << "  --accounts <n>      Concurrent fetches per refresh (default: 1)" << std::endl;
+    std::cerr << "  --text <binary>     Text binary to drive (default: ./show_quota_text)" << std::endl;
+    std::cerr << "  --duration <sec>    How long to run the text binary (default: 10)" << std::endl;
+    std::cerr << "  --no-text           Skip the text binary" << std::endl;
+    std::cerr << "  --no-engine         Skip the fetch engine" << std::endl;
+    std::cerr << "  --time-scale <x>    Run the mock's and the text binary's clocks x times faster" << std::endl;
+    std::cerr << "  --cert <pem>        Serve HTTPS with this certificate ..." << std::endl;
+    std::cerr << "  --key <pem>         ... and key (the certificate is also the CA bundle)" << std::endl;
+    std::cerr << "  --help              Show this help message" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Run quota_mock --help for the script format." << std::endl;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    std::string script_file;
+    int refreshes = 200;
+    int accounts = 1;
+    std::string text_binary = "./show_quota_text";
+    int duration = 10;
+    bool run_engine = true;
+    std::string cert_file;
+    std::string key_file;
+    double time_scale = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--script" && has_value) {
+            script_file = argv[++i];
+        } else if (arg == "--refreshes" && has_value) {
+            refreshes = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--accounts" && has_value) {
+            accounts = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--text" && has_value) {
+            text_binary = argv[++i];
+        } else if (arg == "--duration" && has_value) {
+            duration = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--no-text") {
+            text_binary.clear();
+        } else if (arg == "--no-engine") {
+            run_engine = false;
+        } else if (arg == "--time-scale" && has_value) {
+            time_scale = std::atof(argv[++i]);
+            if (!(time_scale > 0.0)) {
+                std::cerr << "Error: --time-scale requires a factor > 0" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--cert" && has_value) {
+            cert_file = argv[++i];
+        } else if (arg == "--key" && has_value) {
+            key_file = argv[++i];
+        } else {
+            std::cerr << "Unknown option or missing value: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cert_file.empty() != key_file.empty()) {
+        std::cerr << "Error: --cert and --key go together" << std::endl;
+        return 1;
+    }
+
+    MockScript script;
+    std::string error;
+    const bool loaded = script_file.empty() ? mock_script_parse(kBenchDefaultScript, &script, &error)
+                                            : mock_script_load(script_file, &script, &error);
+    if (!loaded) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    if (time_scale > 0.0) {
+        script.clock_rate = time_scale;
+    }
+    // A scaled clock needs a start both processes agree on
+    if (script.clock_rate != 1.0 && script.clock_start < 0) {
+        script.clock_start = time(nullptr);
+    }
+
+    // Fork the mock before libcurl starts any threads
+    MockChild mock;
+    if (!start_mock_child(script, cert_file, key_file, &mock)) {
+        std::cerr << "Error: could not start the mock server" << std::endl;
+        return 1;
+    }
+    std::printf("Mock: %s\n\n", mock.url.c_str());
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    RequestTransport transport;
+    transport.url = mock.url;
+    transport.ca_bundle = cert_file;
+    set_request_transport(transport);
+
+    bool ok = true;
+    if (run_engine) {
+        print_report(bench_engine(refreshes, accounts));
+    }
+    if (!text_binary.empty() && access(text_binary.c_str(), X_OK) != 0) {
+        std::printf("Skipping the text binary: %s not found (make text, or --text <binary>)\n\n",
+                    text_binary.c_str());
+    } else if (!text_binary.empty()) {
+        BenchReport report;
+        if (bench_text_binary(text_binary, mock, script, cert_file, duration, &report)) {
+            print_report(report);
+        } else {
+            ok = false;
+        }
+    }
+
+    const MockStats stats = stop_mock_child(&mock);
+    std::printf("Mock server\n  requests    %llu on %llu connections (200 x%llu, 401 x%llu, 429 x%llu, "
+                "5xx x%llu, other x%llu)\n",
+                (unsigned long long)stats.requests, (unsigned long long)stats.connections,
+                (unsigned long long)stats.ok, (unsigned long long)stats.unauthorized,
+                (unsigned long long)stats.rate_limited, (unsigned long long)stats.server_errors,
+                (unsigned long long)stats.other);
+
+    curl_global_cleanup();
+    return ok ? 0 : 1;
+}
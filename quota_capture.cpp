@@ -0,0 +1,316 @@
+#include "quota_capture.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+// ============================================================================
+// Internal State
+// ============================================================================
+
+static constexpr int kCaptureVersion = 1;
+
+struct CapturedResult {
+    int64_t captured_ms = 0;            // clock_now_ms() when the result was handed over
+    double latency_ms = 0.0;            // the whole try_auth_methods call, fallbacks included
+    RequestResult result;
+    std::optional<AuthMethod> used_method;
+};
+
+struct CaptureState {
+    std::mutex mu;
+
+    // Recording
+    FILE* record_file = nullptr;
+
+    // Latency of the last result recorded or replayed
+    double last_latency_ms = 0.0;
+
+    // Replaying
+    bool replaying = false;
+    double speed = 1.0;
+    std::vector<CapturedResult> results;
+    size_t next = 0;
+    std::chrono::steady_clock::time_point origin;   // when results[0] was replayed
+};
+
+static CaptureState g_capture;
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+static std::string to_hex(const std::string& bytes) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        hex += kDigits[c >> 4];
+        hex += kDigits[c & 0x0f];
+    }
+    return hex;
+}
+
+static bool from_hex(const std::string& hex, std::string* out) {
+    if (hex.size() % 2 != 0) return false;
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    out->clear();
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        const int hi = nibble(hex[i]), lo = nibble(hex[i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        out->push_back(static_cast<char>(hi << 4 | lo));
+    }
+    return true;
+}
+
+// Short keys keep a line per fetch small; defaults are omitted
+static std::string encode_result(const CapturedResult& c) {
+    const RequestResult& r = c.result;
+    json j;
+    j["t"] = c.captured_ms;
+    j["lat"] = c.latency_ms;
+    j["h"] = r.http_code;
+    if (r.curl_code != CURLE_OK) j["c"] = static_cast<int>(r.curl_code);
+    if (!r.curl_error.empty()) j["ce"] = r.curl_error;
+    if (r.timeout != RequestTimeout::None) j["to"] = static_cast<int>(r.timeout);
+    j["el"] = r.elapsed_ms;
+    j["tm"] = {r.timings.dns_ms, r.timings.connect_ms, r.timings.tls_ms, r.timings.first_byte_ms,
+               r.timings.total_ms};
+    if (r.timings.http_version) j["hv"] = r.timings.http_version;
+    if (!r.timings.remote.empty()) j["ip"] = r.timings.remote;
+    const RateLimitInfo& rl = r.rate_limit;
+    if (rl.retry_after_s >= 0 || rl.limit >= 0 || rl.remaining >= 0 || rl.reset_s >= 0 || rl.server_date) {
+        j["rl"] = {rl.retry_after_s, rl.limit, rl.remaining, rl.reset_s, static_cast<int64_t>(rl.server_date)};
+    }
+    if (!r.etag.empty()) j["et"] = r.etag;
+    if (!r.last_modified.empty()) j["lm"] = r.last_modified;
+    if (r.not_modified) j["nm"] = 1;
+    if (r.unchanged) j["u"] = 1;
+    if (c.used_method) j["m"] = static_cast<int>(*c.used_method);
+
+    // nlohmann rejects invalid UTF-8 on dump: fall back to hex for the body
+    j["b"] = r.body;
+    try {
+        return j.dump();
+    } catch (const json::type_error&) {
+        j.erase("b");
+        j["bx"] = to_hex(r.body);
+        return j.dump();
+    }
+}
+
+static bool decode_result(const std::string& line, CapturedResult* out) {
+    try {
+        const json j = json::parse(line);
+        CapturedResult c;
+        RequestResult& r = c.result;
+        c.captured_ms = j.at("t").get<int64_t>();
+        c.latency_ms = j.value("lat", 0.0);
+        r.http_code = j.at("h").get<long>();
+        r.curl_code = static_cast<CURLcode>(j.value("c", 0));
+        r.curl_error = j.value("ce", std::string());
+        r.timeout = static_cast<RequestTimeout>(j.value("to", 0));
+        r.elapsed_ms = j.value("el", 0L);
+        if (j.contains("tm")) {
+            const json& tm = j["tm"];
+            r.timings.dns_ms = tm.at(0).get<double>();
+            r.timings.connect_ms = tm.at(1).get<double>();
+            r.timings.tls_ms = tm.at(2).get<double>();
+            r.timings.first_byte_ms = tm.at(3).get<double>();
+            r.timings.total_ms = tm.at(4).get<double>();
+        }
+        r.timings.http_version = j.value("hv", 0L);
+        r.timings.remote = j.value("ip", std::string());
+        if (j.contains("rl")) {
+            const json& rl = j["rl"];
+            r.rate_limit.retry_after_s = rl.at(0).get<long>();
+            r.rate_limit.limit = rl.at(1).get<long>();
+            r.rate_limit.remaining = rl.at(2).get<long>();
+            r.rate_limit.reset_s = rl.at(3).get<long>();
+            r.rate_limit.server_date = static_cast<time_t>(rl.at(4).get<int64_t>());
+        }
+        r.etag = j.value("et", std::string());
+        r.last_modified = j.value("lm", std::string());
+        r.not_modified = j.value("nm", 0) != 0;
+        r.unchanged = j.value("u", 0) != 0;
+        if (j.contains("m")) {
+            const int m = j["m"].get<int>();
+            if (m < 0 || m > static_cast<int>(AuthMethod::AuthorizationRaw)) return false;
+            c.used_method = static_cast<AuthMethod>(m);
+        }
+        if (j.contains("bx")) {
+            if (!from_hex(j["bx"].get<std::string>(), &r.body)) return false;
+        } else {
+            r.body = j.value("b", std::string());
+        }
+        *out = std::move(c);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool capture_record_open(const std::string& path, std::string* error_out) {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        *error_out = "cannot write " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    json header;
+    header["capture"] = kCaptureVersion;
+    header["started"] = clock_now_ms();
+    std::fprintf(f, "%s\n", header.dump().c_str());
+    std::fflush(f);
+    g_capture.record_file = f;
+    return true;
+}
+
+bool capture_replay_open(const std::string& path, double speed, std::string* error_out) {
+    std::ifstream file(path);
+    if (!file) {
+        *error_out = "cannot open " + path;
+        return false;
+    }
+
+    std::vector<CapturedResult> results;
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        line_no++;
+        if (line.empty()) continue;
+        if (line_no == 1) {
+            // Header: only the version matters
+            try {
+                if (json::parse(line).value("capture", 0) == kCaptureVersion) continue;
+            } catch (const std::exception&) {
+            }
+            *error_out = path + ": not a capture file (or an unsupported version)";
+            return false;
+        }
+        CapturedResult c;
+        if (!decode_result(line, &c)) {
+            *error_out = path + ": line " + std::to_string(line_no) + " is damaged";
+            return false;
+        }
+        results.push_back(std::move(c));
+    }
+    if (results.empty()) {
+        *error_out = path + ": no responses recorded";
+        return false;
+    }
+
+    // The clock follows the capture: it starts at the first recorded fetch,
+    // runs at the replay pace and is moved up to each replayed result
+    clock_simulate(static_cast<time_t>(results[0].captured_ms / 1000), speed);
+
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    g_capture.results = std::move(results);
+    g_capture.next = 0;
+    g_capture.speed = speed;
+    g_capture.replaying = true;
+    return true;
+}
+
+void capture_close() {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    if (g_capture.record_file) {
+        std::fclose(g_capture.record_file);
+        g_capture.record_file = nullptr;
+    }
+    g_capture.replaying = false;
+    g_capture.results.clear();
+}
+
+bool capture_replaying() {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    return g_capture.replaying;
+}
+
+long capture_replay_delay_ms() {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    const CaptureState& s = g_capture;
+    if (s.next >= s.results.size()) {
+        return -1;
+    }
+    if (s.next == 0 || s.speed <= 0.0) {
+        return 0;
+    }
+
+    // Against the first replayed fetch, so rounding does not accumulate
+    const double offset_ms = (s.results[s.next].captured_ms - s.results[0].captured_ms) / s.speed;
+    const double elapsed_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s.origin).count();
+    return std::max(0L, static_cast<long>(std::ceil(offset_ms - elapsed_ms)));
+}
+
+size_t capture_replay_position() {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    return g_capture.next;
+}
+
+size_t capture_replay_size() {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    return g_capture.results.size();
+}
+
+double capture_latency_ms(double measured_ms) {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    return (g_capture.replaying || g_capture.record_file) ? g_capture.last_latency_ms : measured_ms;
+}
+
+void capture_record(const RequestResult& r, const std::optional<AuthMethod>& used_method,
+                    double latency_ms) {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    if (!g_capture.record_file) {
+        return;
+    }
+    CapturedResult c;
+    c.captured_ms = clock_now_ms();
+    c.result = r;
+    c.used_method = used_method;
+    c.latency_ms = latency_ms;
+    g_capture.last_latency_ms = latency_ms;
+    std::fprintf(g_capture.record_file, "%s\n", encode_result(c).c_str());
+    std::fflush(g_capture.record_file);
+}
+
+bool capture_replay_next(RequestResult* out, std::optional<AuthMethod>* preferred_method,
+                         std::optional<AuthMethod>* used_method_out) {
+    std::lock_guard<std::mutex> lock(g_capture.mu);
+    CaptureState& s = g_capture;
+    if (!s.replaying) {
+        return false;
+    }
+    if (s.next >= s.results.size()) {
+        *out = RequestResult();
+        out->curl_code = CURLE_READ_ERROR;
+        out->curl_error = "End of replayed capture";
+        return true;
+    }
+
+    if (s.next == 0) {
+        s.origin = std::chrono::steady_clock::now();
+    }
+    const CapturedResult& c = s.results[s.next++];
+    clock_advance_to(c.captured_ms);
+    *out = c.result;
+    s.last_latency_ms = c.latency_ms;
+    if (c.used_method) {
+        *preferred_method = c.used_method;
+    }
+    if (used_method_out) {
+        *used_method_out = c.used_method;
+    }
+    return true;
+}
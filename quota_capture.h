@@ -0,0 +1,74 @@
+#ifndef QUOTA_CAPTURE_H
+#define QUOTA_CAPTURE_H
+
+#include "quota_common.h"
+
+// ============================================================================
+// Response Capture (--record / --replay)
+// ============================================================================
+//
+// --record <file> appends every RequestResult that try_auth_methods() and
+// try_auth_methods_concurrent() hand to a frontend: status, curl error,
+// body, phase timings, the parsed rate-limit and validator headers, the
+// unchanged/304 flags and the auth method that answered. --replay <file>
+// makes those two functions return the recorded results in order instead
+// of touching the network, so parsing, event detection, logging and
+// rendering run exactly as they did.
+//
+// The file is JSON Lines: a header object, then one compact object per
+// result with its capture time in ms. Bodies that are not valid UTF-8 are
+// stored as hex, so every body replays byte for byte.
+//
+// Pace: at speed 1 the replayed fetches are spaced like the recorded ones,
+// at speed N N times faster, at 0 back to back. Frontends ask for the delay
+// to the next fetch (capture_replay_delay_ms) instead of using their refresh
+// interval and retry backoff, which the recording already reflects. A replay
+// runs on the simulated clock (see quota_common.h): it starts at the first
+// recorded fetch, runs at the replay speed and reads each result's capture
+// time when that result is replayed, so countdowns, reset detection and log
+// timestamps match the recording.
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Start recording to path (truncated). False with error_out on failure.
+bool capture_record_open(const std::string& path, std::string* error_out);
+
+// Load a capture for replay at the given speed (0 = as fast as possible)
+bool capture_replay_open(const std::string& path, double speed, std::string* error_out);
+
+// Flush and close whichever is open
+void capture_close();
+
+bool capture_replaying();
+
+// Milliseconds until the next recorded fetch is due at the replay pace
+// (0 when due), -1 once every result has been replayed
+long capture_replay_delay_ms();
+
+// Results replayed so far / in the capture
+size_t capture_replay_position();
+size_t capture_replay_size();
+
+// Fetch latency to report: the one in the capture while recording or
+// replaying (so both runs report the same value; the replayed call itself
+// takes no time), measured_ms otherwise
+double capture_latency_ms(double measured_ms);
+
+// ----------------------------------------------------------------------------
+// Hooks for quota_common
+// ----------------------------------------------------------------------------
+
+// While recording: append one result and the latency of the call that
+// produced it (thread-safe)
+void capture_record(const RequestResult& r, const std::optional<AuthMethod>& used_method,
+                    double latency_ms);
+
+// While replaying: fill in the next result, update the preferred method
+// like a live fetch would and return true (an exhausted capture yields a
+// read error). False when not replaying.
+bool capture_replay_next(RequestResult* out, std::optional<AuthMethod>* preferred_method,
+                         std::optional<AuthMethod>* used_method_out);
+
+#endif // QUOTA_CAPTURE_H
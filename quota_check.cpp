@@ -0,0 +1,109 @@
+// Regression checks for the fetch engine, run against the loopback mock
+// (quota_mock.h) with `make check`. Each check starts its own mock so the
+// request numbers in its script start at 1.
+
+#include "quota_common.h"
+#include "quota_mock.h"
+
+#include <cstdio>
+#include <iostream>
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+static const char* const kCheckApiKey = "fw_api_check";
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static int g_failures = 0;
+
+static void expect(bool ok, const char* check, const char* what) {
+    if (!ok) {
+        std::printf("FAIL %s: %s\n", check, what);
+        g_failures++;
+    }
+}
+
+// One single-key refresh, as the frontends do it: an unchanged response
+// reuses the previous sample, anything else is parsed
+struct CheckFetch {
+    bool ok = false;
+    bool unchanged = false;
+    std::string error;
+};
+
+static CheckFetch check_fetch(const std::string& api_key, std::optional<AuthMethod>& preferred) {
+    CheckFetch out;
+    const RequestResult r = try_auth_methods(api_key, extract_token(api_key), preferred, nullptr);
+    out.unchanged = r.unchanged;
+    QuotaData data;
+    out.ok = r.unchanged || parse_quota_result(r, &data, &out.error);
+    return out;
+}
+
+// Start a mock for `script` and point the engine at it; nullptr on failure
+static MockServer* check_mock(const char* check, const char* script) {
+    MockScript parsed;
+    std::string error;
+    MockServer* server = nullptr;
+    if (mock_script_parse(script, &parsed, &error)) {
+        server = mock_server_start(parsed, 0, "", "", &error);
+    }
+    if (!server) {
+        std::printf("FAIL %s: mock: %s\n", check, error.c_str());
+        g_failures++;
+        return nullptr;
+    }
+    RequestTransport transport;
+    transport.url = mock_server_url(server);
+    set_request_transport(transport);
+    return server;
+}
+
+// ============================================================================
+// Checks
+// ============================================================================
+
+// The same malformed 200 twice: the repeat must fail again, not pass as an
+// unchanged copy of the last good sample
+static void check_malformed_repeat() {
+    const char* check = "malformed body repeated";
+    MockServer* server = check_mock(check, "usage constant 0.42\nat 2-3 malformed\n");
+    if (!server) {
+        return;
+    }
+    const std::string api_key = std::string(kCheckApiKey) + "_malformed";
+    std::optional<AuthMethod> preferred;
+
+    const CheckFetch good = check_fetch(api_key, preferred);
+    expect(good.ok, check, "first fetch failed");
+    const CheckFetch bad = check_fetch(api_key, preferred);
+    expect(!bad.ok, check, "malformed body accepted");
+    const CheckFetch again = check_fetch(api_key, preferred);
+    expect(!again.ok && !again.unchanged, check, "repeated malformed body reported as unchanged");
+    const CheckFetch recovered = check_fetch(api_key, preferred);
+    expect(recovered.ok, check, "fetch after the malformed bodies failed");
+
+    mock_server_stop(server);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    check_malformed_repeat();
+
+    curl_global_cleanup();
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
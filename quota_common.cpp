@@ -1,4 +1,11 @@
 #include "quota_common.h"
+#include "quota_capture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
 
 // ============================================================================
 // CURL Utilities Implementation
@@ -10,49 +17,769 @@ size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* use
     return total_size;
 }
 
-RequestResult make_request(const std::string& auth_header) {
+// State for one in-flight request. Kept separate from make_request() so the
+// same setup is shared by the blocking path and the curl multi path.
+using RequestClock = std::chrono::steady_clock;
+
+struct RequestHandle {
+    CURL* curl = nullptr;
+    struct curl_slist* headers = nullptr;
+    struct curl_slist* resolve = nullptr;
+    std::string response;
+    char errbuf[CURL_ERROR_SIZE];
+
+    // Budgets of the refresh this attempt belongs to
+    RequestClock::time_point refresh_started;
+    RequestClock::time_point attempt_started;
+    RequestClock::time_point deadline;      // time_point::max() without a total budget
+    bool first_byte_expired = false;
+
+    // Rate-limit headers of the current response; absolute times are
+    // resolved against Date once the transfer is done
+    RateLimitInfo rate_limit;
+    time_t retry_after_at = 0;
+    time_t reset_at = 0;
+
+    // Validators of the current response
+    std::string etag;
+    std::string last_modified;
+};
+
+// Last 2xx response with a sample per API key, for conditional requests
+struct CachedResponse {
+    bool valid = false;
+    std::string etag;
+    std::string last_modified;
+    std::string body;
+    uint64_t body_hash = 0;
+};
+
+static std::mutex g_response_cache_mu;
+static std::map<std::string, CachedResponse> g_response_cache;
+
+static RequestAbortCheck g_request_abort_check = nullptr;
+static RequestTimeouts g_request_timeouts;
+static RequestTransport g_request_transport;
+
+void set_request_abort_check(RequestAbortCheck check) {
+    g_request_abort_check = check;
+}
+
+static long ms_since(RequestClock::time_point since, RequestClock::time_point now) {
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - since).count());
+}
+
+static RequestClock::time_point refresh_deadline(RequestClock::time_point started) {
+    if (g_request_timeouts.total_ms <= 0) {
+        return RequestClock::time_point::max();
+    }
+    return started + std::chrono::milliseconds(g_request_timeouts.total_ms);
+}
+
+// libcurl calls this at least once per second while a transfer is running
+static int request_progress_callback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    RequestHandle* h = static_cast<RequestHandle*>(clientp);
+    if (g_request_abort_check && g_request_abort_check()) {
+        return 1;
+    }
+
+    // No connect/first-byte split in libcurl: abort here once the budget is
+    // spent without the first response byte.
+    if (g_request_timeouts.first_byte_ms > 0) {
+        curl_off_t first_byte_us = 0;
+        curl_easy_getinfo(h->curl, CURLINFO_STARTTRANSFER_TIME_T, &first_byte_us);
+        if (first_byte_us == 0 &&
+            ms_since(h->attempt_started, RequestClock::now()) >= g_request_timeouts.first_byte_ms) {
+            h->first_byte_expired = true;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Leading integer of a header value ("30", "100, 100;w=3600"); -1 if none
+static long leading_number(const std::string& value) {
+    if (value.empty() || !isdigit(static_cast<unsigned char>(value[0]))) {
+        return -1;
+    }
+    return strtol(value.c_str(), nullptr, 10);
+}
+
+// Integer parameter of a structured RateLimit header ("limit=100, remaining=0,
+// reset=30" or the newer ";r=0;t=30"); -1 if absent
+static long header_param(const std::string& value, const char* key) {
+    const size_t key_len = strlen(key);
+    for (size_t pos = value.find(key); pos != std::string::npos; pos = value.find(key, pos + 1)) {
+        const bool at_token_start = pos == 0 || value[pos - 1] == ',' || value[pos - 1] == ';' || value[pos - 1] == ' ';
+        if (at_token_start && pos + key_len < value.size() && value[pos + key_len] == '=') {
+            return leading_number(value.substr(pos + key_len + 1));
+        }
+    }
+    return -1;
+}
+
+// Called by libcurl once per response header line, including the status
+// line of every response in a redirect chain
+static size_t request_header_callback(char* buffer, size_t size, size_t nitems, void* userdata) {
+    RequestHandle* h = static_cast<RequestHandle*>(userdata);
+    const size_t len = size * nitems;
+    std::string line(buffer, len);
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' ')) {
+        line.pop_back();
+    }
+
+    // A new response: only the final one counts
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        h->rate_limit = RateLimitInfo();
+        h->retry_after_at = 0;
+        h->reset_at = 0;
+        h->etag.clear();
+        h->last_modified.clear();
+        return len;
+    }
+
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+        return len;
+    }
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    size_t start = colon + 1;
+    while (start < line.size() && (line[start] == ' ' || line[start] == '\t')) {
+        start++;
+    }
+    const std::string value = line.substr(start);
+
+    RateLimitInfo& rl = h->rate_limit;
+    if (name == "retry-after") {
+        // delta-seconds or an HTTP date
+        const long seconds = leading_number(value);
+        if (seconds >= 0 && value.find_first_not_of("0123456789") == std::string::npos) {
+            rl.retry_after_s = seconds;
+        } else {
+            const time_t at = curl_getdate(value.c_str(), nullptr);
+            if (at > 0) {
+                h->retry_after_at = at;
+            }
+        }
+    } else if (name == "etag") {
+        h->etag = value;
+    } else if (name == "last-modified") {
+        h->last_modified = value;
+    } else if (name == "date") {
+        const time_t date = curl_getdate(value.c_str(), nullptr);
+        if (date > 0) {
+            rl.server_date = date;
+        }
+    } else if (name == "ratelimit-limit" || name == "x-ratelimit-limit") {
+        rl.limit = leading_number(value);
+    } else if (name == "ratelimit-remaining" || name == "x-ratelimit-remaining") {
+        rl.remaining = leading_number(value);
+    } else if (name == "ratelimit-reset" || name == "x-ratelimit-reset") {
+        // Seconds, or (common for X-RateLimit-Reset) a Unix timestamp
+        const long reset = leading_number(value);
+        if (reset > 1000000000L) {
+            h->reset_at = static_cast<time_t>(reset);
+        } else {
+            rl.reset_s = reset;
+        }
+    } else if (name == "ratelimit") {
+        long v;
+        if ((v = header_param(value, "limit")) >= 0) rl.limit = v;
+        if ((v = header_param(value, "remaining")) >= 0 || (v = header_param(value, "r")) >= 0) rl.remaining = v;
+        if ((v = header_param(value, "reset")) >= 0 || (v = header_param(value, "t")) >= 0) rl.reset_s = v;
+    }
+    return len;
+}
+
+static void set_timeout_result(RequestTimeout kind, const RequestHandle* h, RequestResult* out) {
+    out->curl_code = CURLE_OPERATION_TIMEDOUT;
+    out->timeout = kind;
+    out->elapsed_ms = ms_since(h->refresh_started, RequestClock::now());
+}
+
+static bool request_handle_init(RequestHandle* h, const std::string& auth_header,
+                                RequestClock::time_point refresh_started, const CachedResponse* cached,
+                                RequestResult* out) {
+    const RequestClock::time_point now = RequestClock::now();
+    h->refresh_started = refresh_started;
+    h->attempt_started = now;
+    h->deadline = refresh_deadline(refresh_started);
+    h->first_byte_expired = false;
+    h->rate_limit = RateLimitInfo();
+    h->retry_after_at = 0;
+    h->reset_at = 0;
+    h->etag.clear();
+    h->last_modified.clear();
+
+    // Connect budget, capped by what is left of the refresh deadline
+    long connect_ms = g_request_timeouts.connect_ms;
+    long remaining_ms = 0;
+    if (h->deadline != RequestClock::time_point::max()) {
+        remaining_ms = ms_since(now, h->deadline);
+        if (remaining_ms <= 0) {
+            set_timeout_result(RequestTimeout::Total, h, out);
+            out->curl_error = "refresh deadline reached before the request started";
+            return false;
+        }
+        if (connect_ms <= 0 || connect_ms > remaining_ms) {
+            connect_ms = remaining_ms;
+        }
+    }
+
+    h->curl = curl_easy_init();
+    if (!h->curl) {
+        out->curl_code = CURLE_FAILED_INIT;
+        out->curl_error = "curl_easy_init failed";
+        return false;
+    }
+
+    h->response.clear();
+    h->headers = curl_slist_append(nullptr, auth_header.c_str());
+    if (cached && cached->valid) {
+        if (!cached->etag.empty()) {
+            h->headers = curl_slist_append(h->headers, ("If-None-Match: " + cached->etag).c_str());
+        }
+        if (!cached->last_modified.empty()) {
+            h->headers = curl_slist_append(h->headers, ("If-Modified-Since: " + cached->last_modified).c_str());
+        }
+    }
+    h->errbuf[0] = '\0';
+
+    const RequestTransport& transport = g_request_transport;
+    curl_easy_setopt(h->curl, CURLOPT_URL, transport.url.c_str());
+    curl_easy_setopt(h->curl, CURLOPT_HTTPHEADER, h->headers);
+    if (!transport.proxy.empty()) {
+        curl_easy_setopt(h->curl, CURLOPT_PROXY, transport.proxy.c_str());
+    }
+    if (!transport.unix_socket.empty()) {
+        curl_easy_setopt(h->curl, CURLOPT_UNIX_SOCKET_PATH, transport.unix_socket.c_str());
+    }
+    if (!transport.ca_bundle.empty()) {
+        curl_easy_setopt(h->curl, CURLOPT_CAINFO, transport.ca_bundle.c_str());
+    }
+    switch (transport.http_version) {
+        case HttpVersion::Http1_1:
+            curl_easy_setopt(h->curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_1_1);
+            break;
+        case HttpVersion::Http2:
+            curl_easy_setopt(h->curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+            break;
+        case HttpVersion::Http3:
+#if LIBCURL_VERSION_NUM >= 0x074200
+            curl_easy_setopt(h->curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_3);
+#endif
+            break;
+        case HttpVersion::Default:
+            break;
+    }
+    h->resolve = nullptr;
+    for (const std::string& entry : transport.resolve) {
+        h->resolve = curl_slist_append(h->resolve, entry.c_str());
+    }
+    if (h->resolve) {
+        curl_easy_setopt(h->curl, CURLOPT_RESOLVE, h->resolve);
+    }
+    curl_easy_setopt(h->curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(h->curl, CURLOPT_WRITEDATA, &h->response);
+    curl_easy_setopt(h->curl, CURLOPT_HEADERFUNCTION, request_header_callback);
+    curl_easy_setopt(h->curl, CURLOPT_HEADERDATA, h);
+    curl_easy_setopt(h->curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(h->curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    curl_easy_setopt(h->curl, CURLOPT_SSL_VERIFYHOST, 2L);
+    curl_easy_setopt(h->curl, CURLOPT_ERRORBUFFER, h->errbuf);
+    if (connect_ms > 0) {
+        curl_easy_setopt(h->curl, CURLOPT_CONNECTTIMEOUT_MS, connect_ms);
+    }
+    if (remaining_ms > 0) {
+        curl_easy_setopt(h->curl, CURLOPT_TIMEOUT_MS, remaining_ms);
+    }
+    if (g_request_abort_check || g_request_timeouts.first_byte_ms > 0) {
+        curl_easy_setopt(h->curl, CURLOPT_XFERINFOFUNCTION, request_progress_callback);
+        curl_easy_setopt(h->curl, CURLOPT_XFERINFODATA, h);
+        curl_easy_setopt(h->curl, CURLOPT_NOPROGRESS, 0L);
+    }
+    return true;
+}
+
+static void request_handle_finish(RequestHandle* h, CURLcode code, RequestResult* out) {
+    out->curl_code = code;
+    out->body = std::move(h->response);
+
+    if (code == CURLE_ABORTED_BY_CALLBACK && h->first_byte_expired) {
+        set_timeout_result(RequestTimeout::FirstByte, h, out);
+    } else if (code == CURLE_OPERATION_TIMEDOUT) {
+        // Still connecting (TCP or TLS) when the connect budget ran out, or
+        // the refresh deadline, which also caps the connect phase
+        curl_off_t pretransfer_us = 0;
+        curl_easy_getinfo(h->curl, CURLINFO_PRETRANSFER_TIME_T, &pretransfer_us);
+        const long connect_ms = g_request_timeouts.connect_ms;
+        const bool connect_budget_spent =
+            connect_ms > 0 && ms_since(h->attempt_started, RequestClock::now()) + 50 >= connect_ms;
+        set_timeout_result(pretransfer_us == 0 && connect_budget_spent ? RequestTimeout::Connect : RequestTimeout::Total,
+                           h, out);
+    }
+
+    long http_code = 0;
+    curl_easy_getinfo(h->curl, CURLINFO_RESPONSE_CODE, &http_code);
+    out->http_code = http_code;
+    if (h->errbuf[0] != '\0') {
+        out->curl_error = h->errbuf;
+    }
+
+    out->rate_limit = h->rate_limit;
+    out->etag = std::move(h->etag);
+    out->last_modified = std::move(h->last_modified);
+    const time_t now = out->rate_limit.server_date > 0 ? out->rate_limit.server_date : clock_now();
+    if (h->retry_after_at > 0) {
+        out->rate_limit.retry_after_s = std::max<long>(static_cast<long>(h->retry_after_at - now), 0);
+    }
+    if (h->reset_at > 0) {
+        out->rate_limit.reset_s = std::max<long>(static_cast<long>(h->reset_at - now), 0);
+    }
+
+    // Phase timings (microseconds from libcurl)
+    RequestTimings& t = out->timings;
+    const struct {
+        CURLINFO info;
+        double* ms;
+    } phases[] = {
+        {CURLINFO_NAMELOOKUP_TIME_T, &t.dns_ms},
+        {CURLINFO_CONNECT_TIME_T, &t.connect_ms},
+        {CURLINFO_APPCONNECT_TIME_T, &t.tls_ms},
+        {CURLINFO_STARTTRANSFER_TIME_T, &t.first_byte_ms},
+        {CURLINFO_TOTAL_TIME_T, &t.total_ms},
+    };
+    for (const auto& phase : phases) {
+        curl_off_t us = 0;
+        curl_easy_getinfo(h->curl, phase.info, &us);
+        *phase.ms = us / 1000.0;
+    }
+    curl_easy_getinfo(h->curl, CURLINFO_HTTP_VERSION, &t.http_version);
+    char* ip = nullptr;
+    long port = 0;
+    curl_easy_getinfo(h->curl, CURLINFO_PRIMARY_IP, &ip);
+    curl_easy_getinfo(h->curl, CURLINFO_PRIMARY_PORT, &port);
+    t.remote.clear();
+    if (ip && *ip) {
+        t.remote = (strchr(ip, ':') ? "[" + std::string(ip) + "]" : std::string(ip)) + ":" + std::to_string(port);
+    }
+
+    curl_slist_free_all(h->headers);
+    curl_slist_free_all(h->resolve);
+    curl_easy_cleanup(h->curl);
+    h->headers = nullptr;
+    h->resolve = nullptr;
+    h->curl = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// Hedged requests
+// ----------------------------------------------------------------------------
+
+static constexpr size_t kHedgeSamples = 100;        // latencies behind the p95
+static constexpr size_t kHedgeMinSamples = 20;      // no hedging before this
+static constexpr double kHedgeMaxFraction = 0.05;   // duplicates per attempt
+
+// Shared by the GUI's fetch worker and the UI thread reading the stats
+struct HedgeState {
+    std::mutex mu;
+    double samples[kHedgeSamples];      // ring of successful attempt latencies (ms)
+    size_t sample_count = 0;
+    size_t sample_next = 0;
+    HedgeStats stats;
+};
+
+static HedgeState g_hedge;
+
+void set_request_hedging(bool enabled) {
+    std::lock_guard<std::mutex> lock(g_hedge.mu);
+    g_hedge.stats.enabled = enabled;
+}
+
+HedgeStats get_hedge_stats() {
+    std::lock_guard<std::mutex> lock(g_hedge.mu);
+    return g_hedge.stats;
+}
+
+// Count an attempt; false with hedging disabled. *hedge_after_ms is the
+// trigger (0 while too few latencies are recorded).
+static bool hedge_begin(double* hedge_after_ms) {
+    std::lock_guard<std::mutex> lock(g_hedge.mu);
+    if (!g_hedge.stats.enabled) {
+        return false;
+    }
+    g_hedge.stats.requests++;
+    *hedge_after_ms = g_hedge.stats.threshold_ms;
+    return true;
+}
+
+// Take one duplicate from the budget, if any is left
+static bool hedge_take() {
+    std::lock_guard<std::mutex> lock(g_hedge.mu);
+    HedgeStats& s = g_hedge.stats;
+    if (static_cast<double>(s.hedged + 1) > kHedgeMaxFraction * static_cast<double>(s.requests)) {
+        return false;
+    }
+    s.hedged++;
+    return true;
+}
+
+// Record an attempt's outcome and refresh the p95 trigger
+static void hedge_finish(double latency_ms, const RequestResult& r, bool hedge_won) {
+    std::lock_guard<std::mutex> lock(g_hedge.mu);
+    if (hedge_won) {
+        g_hedge.stats.hedge_wins++;
+    }
+    if (r.curl_code != CURLE_OK) {
+        return;
+    }
+
+    g_hedge.samples[g_hedge.sample_next] = latency_ms;
+    g_hedge.sample_next = (g_hedge.sample_next + 1) % kHedgeSamples;
+    g_hedge.sample_count = std::min(g_hedge.sample_count + 1, kHedgeSamples);
+    if (g_hedge.sample_count < kHedgeMinSamples) {
+        return;
+    }
+
+    // Nearest-rank p95
+    double sorted[kHedgeSamples];
+    std::copy(g_hedge.samples, g_hedge.samples + g_hedge.sample_count, sorted);
+    const size_t rank = (g_hedge.sample_count * 95 + 99) / 100;
+    std::nth_element(sorted, sorted + rank - 1, sorted + g_hedge.sample_count);
+    g_hedge.stats.threshold_ms = sorted[rank - 1];
+}
+
+// Run the attempt on a multi handle; if it is still outstanding after
+// hedge_after_ms, start a duplicate on a new connection. The first transfer
+// to complete wins, unless it failed and the other one is still running.
+static RequestResult make_request_hedged(const std::string& auth_header, RequestClock::time_point refresh_started,
+                                         const CachedResponse* cached, double hedge_after_ms, bool* hedge_won) {
     RequestResult out;
+    RequestHandle primary;
+    if (!request_handle_init(&primary, auth_header, refresh_started, cached, &out)) {
+        return out;
+    }
 
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        out.curl_code = CURLE_FAILED_INIT;
-        out.curl_error = "curl_easy_init failed";
+    CURLM* multi = curl_multi_init();
+    if (!multi) {
+        request_handle_finish(&primary, curl_easy_perform(primary.curl), &out);
         return out;
     }
+    curl_multi_add_handle(multi, primary.curl);
 
-    std::string response;
+    const RequestClock::time_point hedge_at =
+        primary.attempt_started + std::chrono::microseconds(static_cast<long>(hedge_after_ms * 1000.0));
+    RequestHandle hedge;
+    RequestResult hedge_out;
+    bool primary_done = false;
+    bool hedge_pending = true;      // not started yet
+    RequestResult* winner = nullptr;
 
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, auth_header.c_str());
+    while (!winner) {
+        int running = 0;
+        if (curl_multi_perform(multi, &running) != CURLM_OK) {
+            break;
+        }
 
-    char errbuf[CURL_ERROR_SIZE];
-    errbuf[0] = '\0';
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE || winner) {
+                continue;
+            }
+            const bool is_primary = (msg->easy_handle == primary.curl);
+            RequestHandle* h = is_primary ? &primary : &hedge;
+            RequestResult* r = is_primary ? &out : &hedge_out;
+            const CURLcode code = msg->data.result;
+            curl_multi_remove_handle(multi, h->curl);
+            request_handle_finish(h, code, r);
+            primary_done = primary_done || is_primary;
 
-    curl_easy_setopt(curl, CURLOPT_URL, "https://app.firmware.ai/api/v1/quota");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
-    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
+            const bool other_running = is_primary ? hedge.curl != nullptr : primary.curl != nullptr;
+            if (r->curl_code == CURLE_OK || !other_running) {
+                winner = r;
+            }
+        }
+        if (winner) {
+            break;
+        }
 
-    out.curl_code = curl_easy_perform(curl);
-    out.body = std::move(response);
+        // Primary still outstanding at the p95: send the duplicate
+        const RequestClock::time_point now = RequestClock::now();
+        if (hedge_pending && !primary_done && now >= hedge_at) {
+            hedge_pending = false;
+            if (hedge_take() && request_handle_init(&hedge, auth_header, refresh_started, cached, &hedge_out)) {
+                curl_easy_setopt(hedge.curl, CURLOPT_FRESH_CONNECT, 1L);
+                curl_multi_add_handle(multi, hedge.curl);
+            }
+        }
 
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    out.http_code = http_code;
-    if (errbuf[0] != '\0') {
-        out.curl_error = errbuf;
+        int wait_ms = 1000;
+        if (hedge_pending) {
+            wait_ms = static_cast<int>(std::min<long>(std::max<long>(ms_since(now, hedge_at), 0), 1000));
+        }
+        curl_multi_wait(multi, nullptr, 0, wait_ms, nullptr);
     }
 
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+    // Cancel the loser (or both after a multi-level error)
+    for (RequestHandle* h : {&primary, &hedge}) {
+        if (h->curl) {
+            RequestResult* r = (h == &primary) ? &out : &hedge_out;
+            curl_multi_remove_handle(multi, h->curl);
+            request_handle_finish(h, CURLE_ABORTED_BY_CALLBACK, r);
+        }
+    }
+    curl_multi_cleanup(multi);
+
+    if (winner == &hedge_out) {
+        *hedge_won = true;
+        return hedge_out;
+    }
+    return out;
+}
+
+// One attempt of a refresh that started at refresh_started
+static RequestResult make_request_once(const std::string& auth_header, RequestClock::time_point refresh_started,
+                                       const CachedResponse* cached) {
+    RequestResult out;
+
+    RequestHandle h;
+    if (!request_handle_init(&h, auth_header, refresh_started, cached, &out)) {
+        return out;
+    }
 
+    request_handle_finish(&h, curl_easy_perform(h.curl), &out);
     return out;
 }
 
+static RequestResult make_request_within(const std::string& auth_header, RequestClock::time_point refresh_started,
+                                         const CachedResponse* cached) {
+    double hedge_after_ms = 0.0;
+    if (!hedge_begin(&hedge_after_ms)) {
+        return make_request_once(auth_header, refresh_started, cached);
+    }
+
+    const RequestClock::time_point started = RequestClock::now();
+    bool hedge_won = false;
+    RequestResult out = (hedge_after_ms > 0.0)
+        ? make_request_hedged(auth_header, refresh_started, cached, hedge_after_ms, &hedge_won)
+        : make_request_once(auth_header, refresh_started, cached);
+    hedge_finish(std::chrono::duration<double, std::milli>(RequestClock::now() - started).count(), out, hedge_won);
+    return out;
+}
+
+RequestResult make_request(const std::string& auth_header) {
+    return make_request_within(auth_header, RequestClock::now(), nullptr);
+}
+
+void set_request_timeouts(const RequestTimeouts& timeouts) {
+    g_request_timeouts = timeouts;
+}
+
+const RequestTimeouts& get_request_timeouts() {
+    return g_request_timeouts;
+}
+
+void set_request_transport(const RequestTransport& transport) {
+    g_request_transport = transport;
+}
+
+const RequestTransport& get_request_transport() {
+    return g_request_transport;
+}
+
+bool set_transport_value(RequestTransport* transport, const std::string& key, const std::string& value) {
+    if (key == "api_url") {
+        if (value.empty()) {
+            return false;
+        }
+        transport->url = value;
+    } else if (key == "proxy") {
+        transport->proxy = value;
+    } else if (key == "unix_socket") {
+        transport->unix_socket = value;
+    } else if (key == "ca_bundle") {
+        transport->ca_bundle = value;
+    } else if (key == "http_version") {
+        if (value.empty() || value == "default") {
+            transport->http_version = HttpVersion::Default;
+        } else if (value == "1.1") {
+            transport->http_version = HttpVersion::Http1_1;
+        } else if (value == "2") {
+            transport->http_version = HttpVersion::Http2;
+        } else if (value == "3") {
+#ifdef CURL_VERSION_HTTP3
+            if (!(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP3)) {
+                return false;
+            }
+            transport->http_version = HttpVersion::Http3;
+#else
+            return false;
+#endif
+        } else {
+            return false;
+        }
+    } else if (key == "resolve") {
+        std::stringstream entries(value);
+        std::string entry;
+        while (std::getline(entries, entry, ',')) {
+            // Entries are comma-separated, so one address each (host:port:address)
+            if (std::count(entry.begin(), entry.end(), ':') < 2) {
+                return false;
+            }
+            transport->resolve.push_back(entry);
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const TransportSetting* find_transport_option(const std::string& option) {
+    for (const TransportSetting& setting : kTransportSettings) {
+        if (option == setting.option) {
+            return &setting;
+        }
+    }
+    return nullptr;
+}
+
+std::string get_transport_value(const RequestTransport& transport, const std::string& key) {
+    if (key == "api_url") {
+        return transport.url;
+    } else if (key == "proxy") {
+        return transport.proxy;
+    } else if (key == "unix_socket") {
+        return transport.unix_socket;
+    } else if (key == "ca_bundle") {
+        return transport.ca_bundle;
+    } else if (key == "http_version") {
+        switch (transport.http_version) {
+            case HttpVersion::Http1_1: return "1.1";
+            case HttpVersion::Http2: return "2";
+            case HttpVersion::Http3: return "3";
+            case HttpVersion::Default: break;
+        }
+        return "default";
+    } else if (key == "resolve") {
+        std::string joined;
+        for (const std::string& entry : transport.resolve) {
+            joined += (joined.empty() ? "" : ",") + entry;
+        }
+        return joined;
+    }
+    return std::string();
+}
+
+bool apply_transport_env(RequestTransport* transport) {
+    bool applied = false;
+    for (const TransportSetting& setting : kTransportSettings) {
+        const char* value = std::getenv(setting.env);
+        if (value && *value && set_transport_value(transport, setting.key, value)) {
+            applied = true;
+        }
+    }
+    return applied;
+}
+
+std::string describe_request_transport(const RequestTransport& transport) {
+    std::string text = transport.url;
+    if (transport.http_version != HttpVersion::Default) {
+        text += ", HTTP/" + get_transport_value(transport, "http_version");
+    }
+    if (!transport.proxy.empty()) {
+        text += ", proxy " + transport.proxy;
+    }
+    if (!transport.unix_socket.empty()) {
+        text += ", unix socket " + transport.unix_socket;
+    }
+    if (!transport.ca_bundle.empty()) {
+        text += ", CA " + transport.ca_bundle;
+    }
+    if (!transport.resolve.empty()) {
+        text += ", resolve " + get_transport_value(transport, "resolve");
+    }
+    return text;
+}
+
+std::string format_request_timings(const RequestTimings& t) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << "dns " << t.dns_ms << "ms  connect " << t.connect_ms << "ms";
+    if (t.tls_ms > 0.0) {
+        out << "  tls " << t.tls_ms << "ms";
+    }
+    out << "  first byte " << t.first_byte_ms << "ms  total " << t.total_ms << "ms";
+    switch (t.http_version) {
+        case CURL_HTTP_VERSION_1_0: out << "  HTTP/1.0"; break;
+        case CURL_HTTP_VERSION_1_1: out << "  HTTP/1.1"; break;
+        case CURL_HTTP_VERSION_2_0: out << "  HTTP/2"; break;
+#if LIBCURL_VERSION_NUM >= 0x074200
+        case CURL_HTTP_VERSION_3: out << "  HTTP/3"; break;
+#endif
+        default: break;
+    }
+    if (!t.remote.empty()) {
+        out << "  " << t.remote;
+    } else if (!g_request_transport.unix_socket.empty()) {
+        out << "  unix socket";
+    }
+    return out.str();
+}
+
+bool parse_timeout_seconds(const std::string& text, long* ms_out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    const double seconds = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0' || !(seconds >= 0.0) || seconds > 86400.0) {
+        return false;
+    }
+    *ms_out = static_cast<long>(std::lround(seconds * 1000.0));
+    return true;
+}
+
+bool apply_timeout_env(RequestTimeouts* timeouts) {
+    const struct {
+        const char* name;
+        long* budget;
+    } vars[] = {
+        {"FIRMWARE_CONNECT_TIMEOUT", &timeouts->connect_ms},
+        {"FIRMWARE_FIRST_BYTE_TIMEOUT", &timeouts->first_byte_ms},
+        {"FIRMWARE_TIMEOUT", &timeouts->total_ms},
+    };
+    bool applied = false;
+    for (const auto& var : vars) {
+        const char* value = std::getenv(var.name);
+        if (value && parse_timeout_seconds(value, var.budget)) {
+            applied = true;
+        }
+    }
+    return applied;
+}
+
+std::string describe_request_failure(const RequestResult& r) {
+    const char* phase = nullptr;
+    switch (r.timeout) {
+        case RequestTimeout::Connect: phase = " (connect)"; break;
+        case RequestTimeout::FirstByte: phase = " (no response)"; break;
+        case RequestTimeout::Total: phase = ""; break;
+        case RequestTimeout::None: break;
+    }
+    if (phase) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "Timed out after %.1fs%s", r.elapsed_ms / 1000.0, phase);
+        return buf;
+    }
+
+    std::string message = std::string("Request failed: ") + curl_easy_strerror(r.curl_code);
+    if (!r.curl_error.empty()) {
+        message += " (" + r.curl_error + ")";
+    }
+    return message;
+}
+
 std::string build_auth_header(AuthMethod method, const std::string& api_key, const std::string& token) {
     switch (method) {
         case AuthMethod::BearerFullKey:
@@ -83,74 +810,375 @@ bool is_auth_failure(const RequestResult& r) {
     return is_unauthorized(r.body);
 }
 
+static const AuthMethod kAllAuthMethods[] = {
+    AuthMethod::BearerFullKey,
+    AuthMethod::BearerToken,
+    AuthMethod::XApiKey,
+    AuthMethod::AuthorizationRaw,
+};
+
+// ----------------------------------------------------------------------------
+// Conditional requests
+// ----------------------------------------------------------------------------
+
+// FNV-1a: the fallback change check for servers without validators
+static uint64_t body_hash(const std::string& body) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : body) {
+        h = (h ^ c) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static CachedResponse response_cache_lookup(const std::string& api_key) {
+    std::lock_guard<std::mutex> lock(g_response_cache_mu);
+    auto it = g_response_cache.find(api_key);
+    return it != g_response_cache.end() ? it->second : CachedResponse();
+}
+
+// Resolve a 304 against the cached response, flag an unchanged 2xx body and
+// remember the newest 2xx that parses to a sample for the next request
+static void response_cache_apply(const std::string& api_key, const CachedResponse& cached, RequestResult* r) {
+    if (r->curl_code != CURLE_OK) {
+        return;
+    }
+    if (r->http_code == 304 && cached.valid) {
+        r->http_code = 200;
+        r->body = cached.body;
+        r->not_modified = true;
+        r->unchanged = true;
+        if (r->etag.empty()) {
+            r->etag = cached.etag;
+        }
+        if (r->last_modified.empty()) {
+            r->last_modified = cached.last_modified;
+        }
+        return;
+    }
+    if (!is_http_success(r->http_code) || is_unauthorized(r->body)) {
+        return;
+    }
+
+    const uint64_t hash = body_hash(r->body);
+    r->unchanged = cached.valid && hash == cached.body_hash && r->body.size() == cached.body.size();
+    if (r->unchanged && r->etag == cached.etag && r->last_modified == cached.last_modified) {
+        return;
+    }
+    // A body without a sample must not stand in for the next one: repeated,
+    // it has to fail again rather than pass as the previous good sample
+    QuotaData sample;
+    std::string error;
+    if (!r->unchanged && !parse_quota_result(*r, &sample, &error)) {
+        return;
+    }
+
+    CachedResponse entry;
+    entry.valid = true;
+    entry.etag = r->etag;
+    entry.last_modified = r->last_modified;
+    entry.body = r->body;
+    entry.body_hash = hash;
+    std::lock_guard<std::mutex> lock(g_response_cache_mu);
+    g_response_cache[api_key] = std::move(entry);
+}
+
+static bool attempt_succeeded(const RequestResult& r) {
+    if (r.curl_code != CURLE_OK) {
+        return false;
+    }
+    if (!is_http_success(r.http_code)) {
+        return false;
+    }
+    if (is_auth_failure(r)) {
+        return false;
+    }
+    return true;
+}
+
+bool request_rate_limited(const RequestResult& r, long* delay_out) {
+    if (r.curl_code != CURLE_OK) {
+        return false;
+    }
+    const RateLimitInfo& rl = r.rate_limit;
+    long delay = 0;
+    if (r.http_code == 429) {
+        delay = rl.retry_after_s >= 0 ? rl.retry_after_s : std::max(rl.reset_s, 0L);
+    } else if (r.http_code == 503 && rl.retry_after_s >= 0) {
+        delay = rl.retry_after_s;
+    } else if (is_http_success(r.http_code) && rl.remaining == 0 && rl.reset_s > 0) {
+        delay = rl.reset_s;
+    } else {
+        return false;
+    }
+    if (delay_out) {
+        *delay_out = delay;
+    }
+    return true;
+}
+
+// A failure that another auth method cannot fix (network, 5xx, 404, ...)
+static bool is_terminal_failure(const RequestResult& r) {
+    return r.curl_code != CURLE_OK || (!is_auth_failure(r) && !is_http_success(r.http_code));
+}
+
+static RequestResult try_auth_methods_live(const std::string& api_key,
+                                          const std::string& token,
+                                          std::optional<AuthMethod>& preferred_method,
+                                          std::optional<AuthMethod>* used_method_out) {
+    // One deadline for the whole fallback chain
+    const RequestClock::time_point started = RequestClock::now();
+    const CachedResponse cached = response_cache_lookup(api_key);
+    auto attempt = [&](AuthMethod m) -> RequestResult {
+        RequestResult r = make_request_within(build_auth_header(m, api_key, token), started, &cached);
+        response_cache_apply(api_key, cached, &r);
+        return r;
+    };
+
+    RequestResult last;
+
+    // First try the cached method (if any).
+    if (preferred_method.has_value()) {
+        last = attempt(*preferred_method);
+        if (attempt_succeeded(last)) {
+            if (used_method_out) {
+                *used_method_out = *preferred_method;
+            }
+            return last;
+        }
+
+        // If it wasn't an auth failure, don't spam other auth methods.
+        if (is_terminal_failure(last)) {
+            return last;
+        }
+    }
+
+    // Fall back through all auth methods.
+    for (AuthMethod m : kAllAuthMethods) {
+        if (preferred_method.has_value() && m == *preferred_method) {
+            continue;
+        }
+
+        last = attempt(m);
+        if (attempt_succeeded(last)) {
+            preferred_method = m;
+            if (used_method_out) {
+                *used_method_out = m;
+            }
+            return last;
+        }
+
+        // Stop early if the failure isn't auth-related.
+        if (is_terminal_failure(last)) {
+            break;
+        }
+    }
+
+    return last;
+}
+
 RequestResult try_auth_methods(const std::string& api_key,
                                const std::string& token,
                                std::optional<AuthMethod>& preferred_method,
                                std::optional<AuthMethod>* used_method_out) {
-    auto attempt = [&](AuthMethod m) -> RequestResult {
-        return make_request(build_auth_header(m, api_key, token));
-    };
+    RequestResult r;
+    if (capture_replay_next(&r, &preferred_method, used_method_out)) {
+        return r;
+    }
+    std::optional<AuthMethod> used;
+    const auto start = std::chrono::steady_clock::now();
+    r = try_auth_methods_live(api_key, token, preferred_method, &used);
+    capture_record(r, used,
+                   std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    if (used_method_out && used) {
+        *used_method_out = used;
+    }
+    return r;
+}
 
-    const AuthMethod all_methods[] = {
-        AuthMethod::BearerFullKey,
-        AuthMethod::BearerToken,
-        AuthMethod::XApiKey,
-        AuthMethod::AuthorizationRaw,
-    };
+// ----------------------------------------------------------------------------
+// Concurrent fetch (multi-account)
+// ----------------------------------------------------------------------------
 
-    auto check_success = [&](const RequestResult& r) {
-        if (r.curl_code != CURLE_OK) {
-            return false;
+// Per-job progress through the auth method fallback chain
+struct ConcurrentAttempt {
+    RequestHandle handle;
+    CachedResponse cached;
+    AuthMethod candidates[4];
+    int candidate_count = 0;
+    int next_candidate = 0;
+    AuthMethod current = AuthMethod::BearerFullKey;
+    bool done = false;
+};
+
+static void try_auth_methods_concurrent_live(std::vector<AuthJob>& jobs) {
+    CURLM* multi = (jobs.size() > 1) ? curl_multi_init() : nullptr;
+    if (!multi) {
+        // Single key (or no multi support): the blocking path is equivalent.
+        for (AuthJob& job : jobs) {
+            job.result = try_auth_methods_live(job.api_key, job.token, job.preferred_method, &job.used_method);
+        }
+        return;
+    }
+
+    // Sized once: handles keep pointers into their attempt (errbuf, response).
+    std::vector<ConcurrentAttempt> attempts(jobs.size());
+    const RequestClock::time_point started = RequestClock::now();
+    size_t pending = 0;
+
+    // Same order as try_auth_methods(): cached method first, then the rest.
+    for (size_t i = 0; i < jobs.size(); i++) {
+        ConcurrentAttempt& a = attempts[i];
+        a.cached = response_cache_lookup(jobs[i].api_key);
+        if (jobs[i].preferred_method.has_value()) {
+            a.candidates[a.candidate_count++] = *jobs[i].preferred_method;
+        }
+        for (AuthMethod m : kAllAuthMethods) {
+            if (jobs[i].preferred_method.has_value() && m == *jobs[i].preferred_method) {
+                continue;
+            }
+            a.candidates[a.candidate_count++] = m;
         }
-        if (!is_http_success(r.http_code)) {
+    }
+
+    // Queue the next candidate for job i; false once the chain is exhausted
+    // or the handle could not be created (result already filled in).
+    auto start_next = [&](size_t i) -> bool {
+        ConcurrentAttempt& a = attempts[i];
+        AuthJob& job = jobs[i];
+        if (a.next_candidate >= a.candidate_count) {
             return false;
         }
-        if (is_auth_failure(r)) {
+        a.current = a.candidates[a.next_candidate++];
+        if (!request_handle_init(&a.handle, build_auth_header(a.current, job.api_key, job.token), started,
+                                 &a.cached, &job.result)) {
             return false;
         }
+        curl_easy_setopt(a.handle.curl, CURLOPT_PRIVATE, &a);
+        curl_multi_add_handle(multi, a.handle.curl);
         return true;
     };
 
-    RequestResult last;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (start_next(i)) {
+            pending++;
+        } else {
+            attempts[i].done = true;
+        }
+    }
 
-    // First try the cached method (if any).
-    if (preferred_method.has_value()) {
-        last = attempt(*preferred_method);
-        if (check_success(last)) {
-            if (used_method_out) {
-                *used_method_out = *preferred_method;
+    while (pending > 0) {
+        int running = 0;
+        CURLMcode mc = curl_multi_perform(multi, &running);
+        if (mc != CURLM_OK) {
+            break;
+        }
+
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            ConcurrentAttempt* a = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&a));
+            const size_t i = static_cast<size_t>(a - attempts.data());
+            AuthJob& job = jobs[i];
+
+            const CURLcode code = msg->data.result;
+            curl_multi_remove_handle(multi, a->handle.curl);
+            job.result = RequestResult();
+            request_handle_finish(&a->handle, code, &job.result);
+            response_cache_apply(job.api_key, a->cached, &job.result);
+
+            if (attempt_succeeded(job.result)) {
+                job.preferred_method = a->current;
+                job.used_method = a->current;
+                a->done = true;
+                pending--;
+                continue;
+            }
+
+            // Only auth failures move on to the next method.
+            if (is_terminal_failure(job.result) || !start_next(i)) {
+                a->done = true;
+                pending--;
             }
-            return last;
         }
 
-        // If it wasn't an auth failure, don't spam other auth methods.
-        if (last.curl_code != CURLE_OK || (!is_auth_failure(last) && !is_http_success(last.http_code))) {
-            return last;
+        if (pending > 0) {
+            curl_multi_wait(multi, nullptr, 0, 1000, nullptr);
         }
     }
 
-    // Fall back through all auth methods.
-    for (AuthMethod m : all_methods) {
-        if (preferred_method.has_value() && m == *preferred_method) {
-            continue;
+    // Abort anything left behind by a multi-level error.
+    for (size_t i = 0; i < attempts.size(); i++) {
+        ConcurrentAttempt& a = attempts[i];
+        if (a.handle.curl) {
+            curl_multi_remove_handle(multi, a.handle.curl);
+            request_handle_finish(&a.handle, CURLE_ABORTED_BY_CALLBACK, &jobs[i].result);
         }
+    }
 
-        last = attempt(m);
-        if (check_success(last)) {
-            preferred_method = m;
-            if (used_method_out) {
-                *used_method_out = m;
-            }
-            return last;
+    curl_multi_cleanup(multi);
+}
+
+void try_auth_methods_concurrent(std::vector<AuthJob>& jobs) {
+    // Recorded and replayed per job, in job order
+    bool replayed = false;
+    for (AuthJob& job : jobs) {
+        replayed = capture_replay_next(&job.result, &job.preferred_method, &job.used_method);
+    }
+    if (replayed || jobs.empty()) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    try_auth_methods_concurrent_live(jobs);
+    const double latency_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    for (const AuthJob& job : jobs) {
+        capture_record(job.result, job.used_method, latency_ms);
+    }
+}
+
+bool parse_quota_result(const RequestResult& r, QuotaData* out, std::string* error_out) {
+    if (r.curl_code != CURLE_OK) {
+        *error_out = describe_request_failure(r);
+        return false;
+    }
+
+    if (!is_http_success(r.http_code)) {
+        *error_out = "HTTP error: " + std::to_string(r.http_code);
+        if (!r.body.empty()) {
+            *error_out += ": " + truncate_for_display(r.body, 200);
         }
+        return false;
+    }
 
-        // Stop early if the failure isn't auth-related.
-        if (last.curl_code != CURLE_OK || (!is_auth_failure(last) && !is_http_success(last.http_code))) {
-            break;
+    if (is_auth_failure(r)) {
+        *error_out = "Unauthorized after trying all auth methods";
+        return false;
+    }
+
+    try {
+        json j = json::parse(r.body);
+        if (!j.contains("used") || j["used"].is_null()) {
+            *error_out = "Failed to parse response (missing 'used')";
+            return false;
         }
+
+        double used = j["used"].get<double>();
+        std::string reset = (j.contains("reset") && !j["reset"].is_null()) ? j["reset"].get<std::string>() : "";
+
+        out->used = used;
+        out->percentage = used * 100.0;
+        out->reset_time = reset.empty() ? "N/A" : reset;
+        out->timestamp = clock_now();
+    } catch (const std::exception& e) {
+        *error_out = std::string("Failed to parse response: ") + e.what();
+        return false;
     }
 
-    return last;
+    return true;
 }
 
 // ============================================================================
@@ -171,6 +1199,231 @@ std::string truncate_for_display(const std::string& s, size_t max_len) {
     return s.substr(0, max_len) + "...";
 }
 
+// ============================================================================
+// Accounts Implementation
+// ============================================================================
+
+static std::string trim_copy(const std::string& s) {
+    const size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) {
+        return "";
+    }
+    const size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+// Account names end up in log file names and unescaped in tmux/polybar
+// status markup: nullptr if usable, else what is wrong with it
+static const char* account_name_problem(const std::string& name) {
+    if (name.find('/') != std::string::npos || name.find("..") != std::string::npos) {
+        return "must not contain '/' or '..'";
+    }
+    for (unsigned char c : name) {
+        if (c <= 0x20 || c == 0x7f) {
+            return "must not contain whitespace or control characters";
+        }
+    }
+    if (name.find("#[") != std::string::npos || name.find("%{") != std::string::npos) {
+        return "must not contain '#[' or '%{'";
+    }
+    return nullptr;
+}
+
+bool load_key_file(const std::string& path, std::vector<AccountKey>* out, std::string* error_out) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        *error_out = "cannot open " + path;
+        return false;
+    }
+
+    out->clear();
+    std::string line;
+    int line_no = 0;
+    while (std::getline(in, line)) {
+        line_no++;
+        line = trim_copy(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        const size_t eq = line.find('=');
+        AccountKey acct;
+        if (eq != std::string::npos) {
+            acct.name = trim_copy(line.substr(0, eq));
+            acct.api_key = trim_copy(line.substr(eq + 1));
+        }
+        if (acct.name.empty() || acct.api_key.empty()) {
+            *error_out = path + ":" + std::to_string(line_no) + ": expected name=key";
+            return false;
+        }
+        if (const char* problem = account_name_problem(acct.name)) {
+            *error_out = path + ":" + std::to_string(line_no) + ": account name '" + acct.name + "' " + problem;
+            return false;
+        }
+        for (const AccountKey& other : *out) {
+            if (other.name == acct.name) {
+                *error_out = path + ":" + std::to_string(line_no) + ": duplicate account '" + acct.name + "'";
+                return false;
+            }
+        }
+        out->push_back(std::move(acct));
+    }
+
+    if (out->empty()) {
+        *error_out = path + ": no keys found";
+        return false;
+    }
+    return true;
+}
+
+std::string account_log_path(const std::string& log_file, const std::string& account_name) {
+    if (log_file.empty()) {
+        return log_file;
+    }
+
+    // Insert before the extension, but only within the last path component.
+    const size_t slash = log_file.find_last_of('/');
+    const size_t dot = log_file.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash) || dot == slash + 1) {
+        return log_file + "." + account_name;
+    }
+    return log_file.substr(0, dot) + "." + account_name + log_file.substr(dot);
+}
+
+// ============================================================================
+// Clock Implementation
+// ============================================================================
+
+// Simulated time: start_ms on the wall clock and origin_us on the monotonic
+// clock correspond to real_origin_us; from there both advance by `rate` real
+// microseconds, plus whatever clock_advance_to() added.
+struct SimulatedClock {
+    bool enabled = false;
+    double rate = 1.0;
+    int64_t start_ms = 0;
+    int64_t real_origin_us = 0;
+    std::atomic<int64_t> jumped_us{0};
+};
+
+static SimulatedClock g_clock;
+
+static int64_t real_monotonic_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t simulated_elapsed_us() {
+    const double real_us = static_cast<double>(real_monotonic_us() - g_clock.real_origin_us);
+    return static_cast<int64_t>(real_us * g_clock.rate) + g_clock.jumped_us.load();
+}
+
+void clock_simulate(time_t start, double rate) {
+    g_clock.enabled = true;
+    g_clock.rate = std::max(rate, 0.0);
+    g_clock.start_ms = static_cast<int64_t>(start) * 1000;
+    g_clock.real_origin_us = real_monotonic_us();
+    g_clock.jumped_us = 0;
+}
+
+bool clock_simulated() {
+    return g_clock.enabled;
+}
+
+void clock_advance_to(int64_t epoch_ms) {
+    if (!g_clock.enabled) {
+        return;
+    }
+    const int64_t ahead_us = (epoch_ms - g_clock.start_ms) * 1000 - simulated_elapsed_us();
+    if (ahead_us > 0) {
+        g_clock.jumped_us += ahead_us;
+    }
+}
+
+time_t clock_now() {
+    return static_cast<time_t>(clock_now_ms() / 1000);
+}
+
+int64_t clock_now_ms() {
+    if (g_clock.enabled) {
+        return g_clock.start_ms + simulated_elapsed_us() / 1000;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int64_t clock_monotonic_us() {
+    if (g_clock.enabled) {
+        return g_clock.real_origin_us + simulated_elapsed_us();
+    }
+    return real_monotonic_us();
+}
+
+struct tm clock_localtime(time_t t) {
+    struct tm local_tm = {};
+    localtime_r(&t, &local_tm);
+    return local_tm;
+}
+
+long clock_real_ms(double seconds) {
+    if (g_clock.rate <= 0.0 || seconds <= 0.0) {
+        return 0;
+    }
+    return std::lround(seconds * 1000.0 / g_clock.rate);
+}
+
+struct timespec clock_real_span(double seconds) {
+    struct timespec span = {0, 1};
+    if (g_clock.rate > 0.0 && seconds > 0.0) {
+        const int64_t ns = std::llround(seconds * 1e9 / g_clock.rate);
+        span.tv_sec = static_cast<time_t>(ns / 1000000000);
+        span.tv_nsec = std::max<long>(static_cast<long>(ns % 1000000000), span.tv_sec > 0 ? 0 : 1);
+    }
+    return span;
+}
+
+double clock_seconds(long real_ms) {
+    return real_ms / 1000.0 * g_clock.rate;
+}
+
+bool parse_clock_rate(const std::string& text, double* rate_out) {
+    char* end = nullptr;
+    const double rate = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0' || !(rate > 0.0) || rate > 1e6) {
+        return false;
+    }
+    *rate_out = rate;
+    return true;
+}
+
+bool parse_clock_start(const std::string& text, time_t* start_out) {
+    if (parse_iso8601_utc_to_time_t(text, start_out)) {
+        return true;
+    }
+    char* end = nullptr;
+    const long long seconds = std::strtoll(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0' || seconds < 0) {
+        return false;
+    }
+    *start_out = static_cast<time_t>(seconds);
+    return true;
+}
+
+bool apply_clock_env() {
+    const char* scale = std::getenv("FIRMWARE_TIME_SCALE");
+    double rate = 0.0;
+    if (!scale || !parse_clock_rate(scale, &rate)) {
+        return false;
+    }
+    const char* start_text = std::getenv("FIRMWARE_TIME_START");
+    time_t start = time(nullptr);
+    if (start_text && !parse_clock_start(start_text, &start)) {
+        start = time(nullptr);
+    }
+    clock_simulate(start, rate);
+    return true;
+}
+
 // ============================================================================
 // Time Utilities Implementation
 // ============================================================================
@@ -246,6 +1499,19 @@ std::string format_duration_tight(int64_t seconds) {
     return out.str();
 }
 
+double forecast_usage_at_reset(const QuotaData& data, time_t now) {
+    time_t reset_utc = 0;
+    if (!parse_iso8601_utc_to_time_t(data.reset_time, &reset_utc)) {
+        return -1.0;
+    }
+
+    const double elapsed = difftime(now, reset_utc - kQuotaWindowSeconds);
+    if (elapsed < 60.0 || elapsed > kQuotaWindowSeconds) {
+        return -1.0;
+    }
+    return data.percentage * kQuotaWindowSeconds / elapsed;
+}
+
 std::string format_timestamp(const std::string& iso_timestamp) {
     // Simple parsing for ISO 8601 format: YYYY-MM-DDTHH:MM:SS.sssZ
     if (iso_timestamp.length() < 19) {
@@ -270,22 +1536,18 @@ std::string format_timestamp(const std::string& iso_timestamp) {
     }
     
     // Convert to local time
-    struct tm* local_tm = localtime(&utc_time);
-    if (!local_tm) {
-        return iso_timestamp; // Return original if conversion fails
-    }
+    const struct tm local_tm = clock_localtime(utc_time);
     
     char buffer[80];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S %Z", local_tm);
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S %Z", &local_tm);
     
     return std::string(buffer);
 }
 
 std::string get_timestamp_string() {
-    time_t now = time(nullptr);
-    struct tm* local_tm = localtime(&now);
+    const struct tm local_tm = clock_localtime(clock_now());
     char buffer[80];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", local_tm);
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_tm);
     return std::string(buffer);
 }
 
@@ -293,6 +1555,37 @@ std::string get_timestamp_string() {
 // Logging Implementation
 // ============================================================================
 
+bool parse_log_line(const std::string& line, QuotaData* data, std::string* event_out) {
+    // Parse CSV: Timestamp,Used,Percentage,Reset,Event
+    std::istringstream ss(line);
+    std::string timestamp_str, used_str, percentage_str, reset_str, event;
+    
+    std::getline(ss, timestamp_str, ',');
+    std::getline(ss, used_str, ',');
+    std::getline(ss, percentage_str, ',');
+    std::getline(ss, reset_str, ',');
+    std::getline(ss, event);
+    
+    try {
+        data->used = std::stod(used_str);
+        data->percentage = std::stod(percentage_str);
+        data->reset_time = reset_str;
+        
+        // Parse timestamp to time_t
+        struct tm tm_info = {};
+        strptime(timestamp_str.c_str(), "%Y-%m-%d %H:%M:%S", &tm_info);
+        data->timestamp = mktime(&tm_info);
+    } catch (...) {
+        // Parsing failed (header or truncated line)
+        return false;
+    }
+    
+    if (event_out) {
+        *event_out = event;
+    }
+    return true;
+}
+
 QuotaData read_last_log_entry(const std::string& log_file) {
     QuotaData last_data = {0.0, 0.0, "", 0};
     
@@ -310,9 +1603,10 @@ QuotaData read_last_log_entry(const std::string& log_file) {
         last_line = line; // First line is data, not header
     }
     
-    // Read to end to get last line
+    // Read to end to get last sample (event-only rows have no Used value)
     while (std::getline(file, line)) {
-        if (!line.empty()) {
+        const size_t comma = line.find(',');
+        if (comma != std::string::npos && comma + 1 < line.size() && line[comma + 1] != ',') {
             last_line = line;
         }
     }
@@ -322,28 +1616,7 @@ QuotaData read_last_log_entry(const std::string& log_file) {
         return last_data;
     }
     
-    // Parse CSV: Timestamp,Used,Percentage,Reset,Event
-    std::istringstream ss(last_line);
-    std::string timestamp_str, used_str, percentage_str, reset_str, event;
-    
-    std::getline(ss, timestamp_str, ',');
-    std::getline(ss, used_str, ',');
-    std::getline(ss, percentage_str, ',');
-    std::getline(ss, reset_str, ',');
-    
-    try {
-        last_data.used = std::stod(used_str);
-        last_data.percentage = std::stod(percentage_str);
-        last_data.reset_time = reset_str;
-        
-        // Parse timestamp to time_t
-        struct tm tm_info = {};
-        strptime(timestamp_str.c_str(), "%Y-%m-%d %H:%M:%S", &tm_info);
-        last_data.timestamp = mktime(&tm_info);
-    } catch (...) {
-        // Parsing failed, return empty data
-    }
-    
+    parse_log_line(last_line, &last_data, nullptr);
     return last_data;
 }
 
@@ -374,30 +1647,140 @@ std::string detect_event(const QuotaData& current, const QuotaData& previous) {
     return "UPDATE";
 }
 
-void write_log_entry(const std::string& log_file, const QuotaData& data, const std::string& event) {
+// Open the log for appending, writing the header into a new file
+static bool open_log_for_append(const std::string& log_file, std::ofstream& file) {
     bool file_exists = false;
     struct stat buffer;
     if (stat(log_file.c_str(), &buffer) == 0) {
         file_exists = true;
     }
     
-    std::ofstream file(log_file, std::ios::app);
+    file.open(log_file, std::ios::app);
     if (!file.is_open()) {
         std::cerr << "Warning: Could not open log file: " << log_file << std::endl;
-        return;
+        return false;
     }
     
     // Write header if new file
     if (!file_exists) {
         file << "Timestamp,Used,Percentage,Reset,Event" << std::endl;
     }
+    return true;
+}
+
+// Clock time of the last row in each log, for log_heartbeat_due. Kept on
+// the clock rather than taken from the file's mtime, so simulated and
+// replayed runs get their heartbeat rows at the recorded spacing.
+static std::mutex g_log_rows_mu;
+static std::map<std::string, time_t> g_log_last_row;
+
+static void note_log_row(const std::string& log_file, time_t when) {
+    std::lock_guard<std::mutex> lock(g_log_rows_mu);
+    g_log_last_row[log_file] = when;
+}
+
+static std::string format_log_timestamp(time_t t) {
+    const struct tm local_tm = clock_localtime(t);
+    char buffer[32];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_tm);
+    return buffer;
+}
+
+// Timestamp of the file's last row (sample or event-only), 0 if none. Only
+// the tail is read; rows are far shorter than 4 KiB.
+static time_t read_last_log_row_time(const std::string& log_file) {
+    std::ifstream file(log_file, std::ios::ate);
+    if (!file.is_open()) {
+        return 0;
+    }
+    const std::streamoff size = file.tellg();
+    file.seekg(std::max<std::streamoff>(size - 4096, 0));
+    std::string line;
+    std::string last_line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.find("Timestamp") == std::string::npos) {
+            last_line = line;
+        }
+    }
+    struct tm tm_info = {};
+    const std::string timestamp = last_line.substr(0, last_line.find(','));
+    if (timestamp.empty() || !strptime(timestamp.c_str(), "%Y-%m-%d %H:%M:%S", &tm_info)) {
+        return 0;
+    }
+    tm_info.tm_isdst = -1;
+    return mktime(&tm_info);
+}
+
+void write_log_entry(const std::string& log_file, const QuotaData& data, const std::string& event) {
+    std::ofstream file;
+    if (!open_log_for_append(log_file, file)) {
+        return;
+    }
     
     // Write data
-    file << get_timestamp_string() << ","
+    const time_t now = clock_now();
+    file << format_log_timestamp(now) << ","
          << std::fixed << std::setprecision(4) << data.used << ","
          << std::fixed << std::setprecision(2) << data.percentage << ","
          << data.reset_time << ","
          << event << std::endl;
     
     file.close();
+    note_log_row(log_file, now);
+}
+
+void write_log_rate_limited(const std::string& log_file, const RequestResult& r, long delay_s) {
+    std::ofstream file;
+    if (!open_log_for_append(log_file, file)) {
+        return;
+    }
+    
+    const time_t now = clock_now();
+    file << format_log_timestamp(now) << ",,,,RATE_LIMITED http=" << r.http_code;
+    if (delay_s > 0) {
+        file << " wait=" << delay_s << "s";
+    }
+    if (r.rate_limit.limit >= 0) {
+        file << " limit=" << r.rate_limit.limit;
+    }
+    file << std::endl;
+    
+    file.close();
+    note_log_row(log_file, now);
+}
+
+bool log_heartbeat_due(const std::string& log_file, time_t now) {
+    std::lock_guard<std::mutex> lock(g_log_rows_mu);
+    auto it = g_log_last_row.find(log_file);
+    if (it == g_log_last_row.end()) {
+        it = g_log_last_row.emplace(log_file, read_last_log_row_time(log_file)).first;
+    }
+    // A clock behind the last row (a replay into an older log) is due once;
+    // that row then restarts the spacing
+    return it->second == 0 || now < it->second || difftime(now, it->second) >= kLogHeartbeatSeconds;
+}
+
+// ============================================================================
+// Snapshot Export Implementation
+// ============================================================================
+
+JsonlRecord make_snapshot_record(const QuotaData& data, const std::string& event, double latency_ms) {
+    JsonlRecord rec;
+    rec.timestamp = static_cast<int64_t>(data.timestamp);
+    rec.ok = true;
+    rec.used = data.used;
+    rec.percentage = data.percentage;
+    time_t reset_utc = 0;
+    if (data.reset_time != "N/A" && parse_iso8601_utc_to_time_t(data.reset_time, &reset_utc)) {
+        rec.reset = data.reset_time.c_str();
+        rec.reset_epoch = static_cast<int64_t>(reset_utc);
+    }
+    rec.event = event.c_str();
+    rec.latency_ms = latency_ms;
+    return rec;
+}
+
+std::string format_snapshot_json(const QuotaData& data, const std::string& event, double latency_ms) {
+    thread_local JsonlWriter writer;
+    return jsonl_format_record(&writer, make_snapshot_record(data, event, latency_ms));
 }
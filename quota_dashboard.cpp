@@ -0,0 +1,180 @@
+#include "quota_dashboard.h"
+
+#include <algorithm>
+
+// ============================================================================
+// Fetch Statistics
+// ============================================================================
+
+FetchError classify_fetch_error(const RequestResult& r) {
+    if (r.timeout != RequestTimeout::None) {
+        return FetchError::Timeout;
+    }
+    if (r.curl_code != CURLE_OK) {
+        return FetchError::Network;
+    }
+    if (!is_http_success(r.http_code)) {
+        return FetchError::Http;
+    }
+    if (is_auth_failure(r)) {
+        return FetchError::Auth;
+    }
+    return FetchError::Parse;
+}
+
+const char* fetch_error_name(FetchError kind) {
+    switch (kind) {
+        case FetchError::Network: return "Network";
+        case FetchError::Timeout: return "Timeout";
+        case FetchError::Http: return "HTTP";
+        case FetchError::Auth: return "Auth";
+        case FetchError::Parse: return "Parse";
+    }
+    return "Other";
+}
+
+static void record_latency(DashboardStats* stats, double latency_ms) {
+    if (stats->latencies.size() < kDashboardLatencySamples) {
+        stats->latencies.push_back(latency_ms);
+    } else {
+        stats->latencies[stats->latency_total % kDashboardLatencySamples] = latency_ms;
+    }
+    stats->latency_total++;
+}
+
+void dashboard_record_success(DashboardStats* stats, double latency_ms,
+                              const QuotaData& data, const std::string& event) {
+    stats->fetches++;
+    record_latency(stats, latency_ms);
+
+    if (event != "UPDATE") {
+        stats->events.push_front(DashboardEvent{data.timestamp, data.percentage, event});
+        if (stats->events.size() > kDashboardEventCapacity) {
+            stats->events.pop_back();
+        }
+    }
+}
+
+void dashboard_record_failure(DashboardStats* stats, double latency_ms,
+                              const RequestResult& r, const std::string& error) {
+    stats->fetches++;
+    stats->failures++;
+    stats->errors[static_cast<int>(classify_fetch_error(r))]++;
+    stats->last_error = error;
+    stats->last_error_time = clock_now();
+    record_latency(stats, latency_ms);
+}
+
+LatencySummary dashboard_latency_summary(const DashboardStats* stats) {
+    LatencySummary summary;
+    if (stats->latencies.empty()) {
+        return summary;
+    }
+
+    std::vector<double> sorted(stats->latencies);
+    std::sort(sorted.begin(), sorted.end());
+    auto rank = [&](double p) {
+        size_t i = static_cast<size_t>(std::ceil(p * sorted.size()));
+        return sorted[std::min(std::max<size_t>(i, 1), sorted.size()) - 1];
+    };
+
+    summary.count = sorted.size();
+    summary.last = stats->latencies[(stats->latency_total - 1) % kDashboardLatencySamples];
+    summary.min = sorted.front();
+    summary.p50 = rank(0.50);
+    summary.p95 = rank(0.95);
+    summary.max = sorted.back();
+    return summary;
+}
+
+// ============================================================================
+// Pane Composition
+// ============================================================================
+
+size_t dashboard_visible_width(const std::string& s) {
+    size_t columns = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == 0x1B && i + 1 < s.size() && s[i + 1] == '[') {
+            i += 2;
+            while (i < s.size() && (static_cast<unsigned char>(s[i]) < 0x40 ||
+                                    static_cast<unsigned char>(s[i]) > 0x7E)) {
+                i++;
+            }
+            continue;
+        }
+        if ((c & 0xC0) != 0x80) {
+            columns++; // Lead byte (continuation bytes do not count)
+        }
+    }
+    return columns;
+}
+
+// Append s clipped and space-padded to exactly `width` columns
+static void append_cell(std::string* frame, const std::string& s, int width) {
+    size_t columns = 0;
+    bool styled = false;
+    size_t i = 0;
+    for (; i < s.size(); i++) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == 0x1B) {
+            styled = true;
+        } else if ((c & 0xC0) != 0x80) {
+            if (columns == static_cast<size_t>(width)) {
+                break;
+            }
+            columns++;
+        }
+        frame->push_back(static_cast<char>(c));
+    }
+    // Escape sequences cut off by the clip are dropped by the SGR parser; an
+    // open style must not leak into the padding or the next pane.
+    if (styled) {
+        frame->append("\033[0m");
+    }
+    frame->append(static_cast<size_t>(width) - columns, ' ');
+}
+
+// "── Title ─────" rule spanning width columns
+static void append_title(std::string* frame, const std::string& title, int width, bool utf8) {
+    const char* rule = utf8 ? "─" : "-";
+    std::string head;
+    head.append(rule).append(rule).append(" ").append(title).append(" ");
+    const int used = static_cast<int>(dashboard_visible_width(head));
+    for (int i = used; i < width; i++) {
+        head.append(rule);
+    }
+    append_cell(frame, head, width);
+}
+
+static void trim_trailing_spaces(std::string* frame) {
+    while (!frame->empty() && frame->back() == ' ') {
+        frame->pop_back();
+    }
+}
+
+void dashboard_append_row(std::string* frame, const DashboardPane& left, const DashboardPane* right,
+                          int width, int rows, bool utf8) {
+    static const std::string kEmpty;
+    const int left_width = right ? (width - 1) / 2 : width;
+    const int right_width = right ? width - 1 - left_width : 0;
+
+    append_title(frame, left.title, left_width, utf8);
+    if (right) {
+        frame->push_back(' ');
+        append_title(frame, right->title, right_width, utf8);
+    }
+    frame->push_back('\n');
+
+    for (int r = 0; r < rows; r++) {
+        const size_t i = static_cast<size_t>(r);
+        append_cell(frame, i < left.lines.size() ? left.lines[i] : kEmpty, left_width);
+        if (right) {
+            frame->push_back(' ');
+            append_cell(frame, i < right->lines.size() ? right->lines[i] : kEmpty, right_width);
+        }
+        // Trailing blanks would only be diffed against blanks.
+        trim_trailing_spaces(frame);
+        frame->push_back('\n');
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef QUOTA_DASHBOARD_H
+#define QUOTA_DASHBOARD_H
+
+#include "quota_common.h"
+
+#include <deque>
+
+// ============================================================================
+// Dashboard Model
+// ============================================================================
+//
+// Frontend-independent parts of the --dashboard TUI: fetch statistics (latency
+// percentiles, error counts by class, recent events) and the composition of
+// panes into one frame. The frontends render the pane contents (they own the
+// bar renderers) and hand the frame to the differential renderer.
+//
+// A pane keeps its rendered lines until it is marked dirty, so a 1 Hz redraw
+// rebuilds only the panes whose inputs changed; everything else is reused
+// as-is and produces no terminal output.
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+// Latency samples kept for the percentiles (~30 min at the default interval)
+static constexpr size_t kDashboardLatencySamples = 128;
+
+// Events kept for the "Events" pane (newest first)
+static constexpr size_t kDashboardEventCapacity = 16;
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+enum class FetchError {
+    Network,        // curl failure (DNS, connect, TLS, aborted)
+    Timeout,        // connect, first-byte or total budget ran out
+    Http,           // non-2xx status
+    Auth,           // unauthorized with every auth method
+    Parse,          // 2xx with an unusable body
+};
+
+static constexpr int kFetchErrorKinds = 5;
+
+struct DashboardEvent {
+    time_t timestamp;
+    double percentage;
+    std::string name;           // detect_event() result
+};
+
+struct DashboardStats {
+    uint64_t fetches = 0;
+    uint64_t failures = 0;
+    uint64_t errors[kFetchErrorKinds] = {};
+    std::string last_error;
+    time_t last_error_time = 0;
+
+    std::vector<double> latencies;      // ring of recent latencies (ms)
+    uint64_t latency_total = 0;         // latencies ever recorded
+
+    std::deque<DashboardEvent> events;  // newest first
+};
+
+struct LatencySummary {
+    size_t count = 0;
+    double last = 0.0;
+    double min = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double max = 0.0;
+};
+
+// Rendered pane: lines may contain SGR sequences; composition clips and pads
+// them to the pane width.
+struct DashboardPane {
+    std::string title;
+    std::vector<std::string> lines;
+    bool dirty = true;
+};
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Class of a failed request (r must not be a usable quota response)
+FetchError classify_fetch_error(const RequestResult& r);
+
+// Short label for the error counters
+const char* fetch_error_name(FetchError kind);
+
+// Record one fetch. Every event except a plain UPDATE is kept for the pane.
+void dashboard_record_success(DashboardStats* stats, double latency_ms,
+                              const QuotaData& data, const std::string& event);
+void dashboard_record_failure(DashboardStats* stats, double latency_ms,
+                              const RequestResult& r, const std::string& error);
+
+// Nearest-rank percentiles over the retained latency samples
+LatencySummary dashboard_latency_summary(const DashboardStats* stats);
+
+// Terminal columns taken by s (SGR sequences skipped, one column per code point)
+size_t dashboard_visible_width(const std::string& s);
+
+// Append one pane row to frame: a title rule and exactly `rows` content lines.
+// With right != nullptr the two panes share the width side by side.
+void dashboard_append_row(std::string* frame, const DashboardPane& left, const DashboardPane* right,
+                          int width, int rows, bool utf8);
+
+#endif // QUOTA_DASHBOARD_H
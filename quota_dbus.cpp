@@ -0,0 +1,209 @@
+#include "quota_dbus.h"
+
+#include <gio/gio.h>
+
+#include <cmath>
+#include <iostream>
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+static const gchar kIntrospectionXml[] =
+    "<node>"
+    "  <interface name='org.firmware.Quota'>"
+    "    <method name='Refresh'/>"
+    "    <property name='Usage' type='d' access='read'/>"
+    "    <property name='ResetEpoch' type='x' access='read'/>"
+    "    <property name='LastError' type='s' access='read'/>"
+    "    <property name='Forecast' type='d' access='read'/>"
+    "    <property name='LastUpdate' type='x' access='read'/>"
+    "  </interface>"
+    "</node>";
+
+struct QuotaDbusService {
+    guint owner_id = 0;
+    guint registration_id = 0;
+    GDBusConnection* connection = nullptr;
+    GDBusNodeInfo* node_info = nullptr;
+
+    QuotaDbusRefreshFn on_refresh = nullptr;
+    void* user_data = nullptr;
+
+    double usage = 0.0;
+    gint64 reset_epoch = -1;
+    std::string last_error;
+    double forecast = -1.0;
+    gint64 last_update = 0;
+};
+
+// ============================================================================
+// Interface Implementation
+// ============================================================================
+
+static void handle_method_call(GDBusConnection*, const gchar*, const gchar*, const gchar*,
+                               const gchar* method_name, GVariant*,
+                               GDBusMethodInvocation* invocation, gpointer user_data) {
+    QuotaDbusService* svc = (QuotaDbusService*)user_data;
+
+    if (g_strcmp0(method_name, "Refresh") == 0) {
+        g_dbus_method_invocation_return_value(invocation, nullptr);
+        if (svc->on_refresh) {
+            svc->on_refresh(svc->user_data);
+        }
+        return;
+    }
+
+    g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD,
+                                          "Unknown method %s", method_name);
+}
+
+static GVariant* property_value(const QuotaDbusService* svc, const gchar* name) {
+    if (g_strcmp0(name, "Usage") == 0) return g_variant_new_double(svc->usage);
+    if (g_strcmp0(name, "ResetEpoch") == 0) return g_variant_new_int64(svc->reset_epoch);
+    if (g_strcmp0(name, "LastError") == 0) return g_variant_new_string(svc->last_error.c_str());
+    if (g_strcmp0(name, "Forecast") == 0) return g_variant_new_double(svc->forecast);
+    if (g_strcmp0(name, "LastUpdate") == 0) return g_variant_new_int64(svc->last_update);
+    return nullptr;
+}
+
+static GVariant* handle_get_property(GDBusConnection*, const gchar*, const gchar*, const gchar*,
+                                     const gchar* property_name, GError** error, gpointer user_data) {
+    GVariant* value = property_value((const QuotaDbusService*)user_data, property_name);
+    if (!value) {
+        g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY, "Unknown property %s", property_name);
+    }
+    return value;
+}
+
+static const GDBusInterfaceVTable kInterfaceVTable = {
+    handle_method_call,
+    handle_get_property,
+    nullptr,
+    {nullptr},
+};
+
+// Emit PropertiesChanged for the given names (nullptr-terminated).
+static void emit_changed(QuotaDbusService* svc, const char* const* names) {
+    if (!svc->connection || svc->registration_id == 0 || !names[0]) {
+        return;
+    }
+
+    GVariantBuilder changed;
+    g_variant_builder_init(&changed, G_VARIANT_TYPE("a{sv}"));
+    for (int i = 0; names[i]; i++) {
+        g_variant_builder_add(&changed, "{sv}", names[i], property_value(svc, names[i]));
+    }
+
+    g_dbus_connection_emit_signal(svc->connection, nullptr, kQuotaDbusPath,
+                                  "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                                  g_variant_new("(sa{sv}as)", kQuotaDbusInterface, &changed, nullptr),
+                                  nullptr);
+}
+
+// ============================================================================
+// Bus Ownership
+// ============================================================================
+
+static void on_bus_acquired(GDBusConnection* connection, const gchar*, gpointer user_data) {
+    QuotaDbusService* svc = (QuotaDbusService*)user_data;
+
+    GError* error = nullptr;
+    svc->registration_id = g_dbus_connection_register_object(connection, kQuotaDbusPath,
+                                                             svc->node_info->interfaces[0],
+                                                             &kInterfaceVTable, svc, nullptr, &error);
+    if (svc->registration_id == 0) {
+        std::cerr << "Warning: D-Bus export failed: " << (error ? error->message : "unknown error") << std::endl;
+        g_clear_error(&error);
+        return;
+    }
+    svc->connection = (GDBusConnection*)g_object_ref(connection);
+}
+
+static void on_name_lost(GDBusConnection*, const gchar* name, gpointer user_data) {
+    QuotaDbusService* svc = (QuotaDbusService*)user_data;
+
+    // Another instance already serves the name (or there is no session bus):
+    // keep running, just without the export.
+    if (svc->connection && svc->registration_id != 0) {
+        g_dbus_connection_unregister_object(svc->connection, svc->registration_id);
+        svc->registration_id = 0;
+    }
+    std::cerr << "Note: D-Bus name " << name << " not available; not exporting quota state" << std::endl;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+QuotaDbusService* quota_dbus_start(QuotaDbusRefreshFn on_refresh, void* user_data) {
+    QuotaDbusService* svc = new QuotaDbusService();
+    svc->on_refresh = on_refresh;
+    svc->user_data = user_data;
+
+    svc->node_info = g_dbus_node_info_new_for_xml(kIntrospectionXml, nullptr);
+    if (!svc->node_info) {
+        delete svc;
+        return nullptr;
+    }
+
+    svc->owner_id = g_bus_own_name(G_BUS_TYPE_SESSION, kQuotaDbusName, G_BUS_NAME_OWNER_FLAGS_NONE,
+                                   on_bus_acquired, nullptr, on_name_lost, svc, nullptr);
+    return svc;
+}
+
+void quota_dbus_update(QuotaDbusService* svc, double usage_pct, int64_t reset_epoch,
+                       double forecast_pct, int64_t updated_epoch) {
+    if (!svc) return;
+
+    const char* names[6] = {nullptr};
+    int n = 0;
+    if (usage_pct != svc->usage) {
+        svc->usage = usage_pct;
+        names[n++] = "Usage";
+    }
+    if (reset_epoch != svc->reset_epoch) {
+        svc->reset_epoch = reset_epoch;
+        names[n++] = "ResetEpoch";
+    }
+    if (!svc->last_error.empty()) {
+        svc->last_error.clear();
+        names[n++] = "LastError";
+    }
+    // Forecast is a float estimate; ignore jitter below 0.1pp.
+    if (std::fabs(forecast_pct - svc->forecast) >= 0.1) {
+        svc->forecast = forecast_pct;
+        names[n++] = "Forecast";
+    }
+    if (updated_epoch != svc->last_update) {
+        svc->last_update = updated_epoch;
+        names[n++] = "LastUpdate";
+    }
+    emit_changed(svc, names);
+}
+
+void quota_dbus_set_error(QuotaDbusService* svc, const std::string& error) {
+    if (!svc || error == svc->last_error) return;
+
+    svc->last_error = error;
+    const char* names[] = {"LastError", nullptr};
+    emit_changed(svc, names);
+}
+
+void quota_dbus_stop(QuotaDbusService* svc) {
+    if (!svc) return;
+
+    if (svc->connection) {
+        if (svc->registration_id != 0) {
+            g_dbus_connection_unregister_object(svc->connection, svc->registration_id);
+        }
+        g_object_unref(svc->connection);
+    }
+    if (svc->owner_id != 0) {
+        g_bus_unown_name(svc->owner_id);
+    }
+    if (svc->node_info) {
+        g_dbus_node_info_unref(svc->node_info);
+    }
+    delete svc;
+}
@@ -0,0 +1,61 @@
+#ifndef QUOTA_DBUS_H
+#define QUOTA_DBUS_H
+
+#include <cstdint>
+#include <string>
+
+// ============================================================================
+// D-Bus Service (org.firmware.Quota)
+// ============================================================================
+//
+// Exports the fetching process' quota state on the session bus so desktop
+// consumers (panel applet, widgets, scripts) can subscribe instead of polling
+// the API themselves:
+//
+//   bus name   org.firmware.Quota
+//   object     /org/firmware/Quota
+//   interface  org.firmware.Quota
+//
+//   Usage       d  usage percentage (0-100)
+//   ResetEpoch  x  window reset as Unix epoch, -1 when no active window
+//   LastError   s  last fetch error, "" after a successful fetch
+//   Forecast    d  projected usage percentage at reset, -1 when unknown
+//   LastUpdate  x  Unix epoch of the last successful fetch, 0 before that
+//   Refresh()      request an immediate fetch
+//
+// Changes are announced with org.freedesktop.DBus.Properties.PropertiesChanged
+// (only the properties that actually changed). Requires a running GLib main
+// loop; GIO only, so this module is linked into the GUI builds.
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+static constexpr const char* kQuotaDbusName = "org.firmware.Quota";
+static constexpr const char* kQuotaDbusPath = "/org/firmware/Quota";
+static constexpr const char* kQuotaDbusInterface = "org.firmware.Quota";
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+struct QuotaDbusService;
+
+// Called on the main loop when a client invokes Refresh()
+typedef void (*QuotaDbusRefreshFn)(void* user_data);
+
+// Request the bus name and export the object. Ownership is asynchronous; if
+// another process already owns the name the service stays silent.
+QuotaDbusService* quota_dbus_start(QuotaDbusRefreshFn on_refresh, void* user_data);
+
+// Publish a successful sample (clears LastError)
+void quota_dbus_update(QuotaDbusService* svc, double usage_pct, int64_t reset_epoch,
+                       double forecast_pct, int64_t updated_epoch);
+
+// Publish a fetch failure (previous Usage/ResetEpoch are kept)
+void quota_dbus_set_error(QuotaDbusService* svc, const std::string& error);
+
+// Unexport, release the name and free the service
+void quota_dbus_stop(QuotaDbusService* svc);
+
+#endif // QUOTA_DBUS_H
@@ -0,0 +1,243 @@
+#include "quota_follow.h"
+
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+// ============================================================================
+// Internal Types
+// ============================================================================
+
+struct LogFollower {
+    std::string path;
+    std::string dir;
+    std::string name;
+
+    int inotify_fd = -1;
+    int dir_wd = -1;
+    int file_wd = -1;
+    int file_fd = -1;
+
+    off_t offset = 0;           // bytes of the current file already consumed
+    std::string partial;        // trailing bytes without a newline yet
+    bool skip_partial_line = false;
+    bool seeded = false;        // first read done
+};
+
+static constexpr uint32_t kFileWatchMask = IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF;
+static constexpr uint32_t kDirWatchMask = IN_CREATE | IN_MOVED_TO | IN_ONLYDIR;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static void detach_file(LogFollower* f) {
+    if (f->file_wd >= 0) {
+        inotify_rm_watch(f->inotify_fd, f->file_wd);
+        f->file_wd = -1;
+    }
+    if (f->file_fd >= 0) {
+        close(f->file_fd);
+        f->file_fd = -1;
+    }
+    f->offset = 0;
+    f->partial.clear();
+    f->skip_partial_line = false;
+}
+
+// Open the log (if it exists) and watch it. With seed_from_tail only the last
+// kFollowSeedBytes are read, otherwise the whole (new) file is.
+static void attach_file(LogFollower* f, bool seed_from_tail) {
+    detach_file(f);
+
+    f->file_fd = open(f->path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (f->file_fd < 0) {
+        return; // Not created yet; the directory watch will tell us.
+    }
+    f->file_wd = inotify_add_watch(f->inotify_fd, f->path.c_str(), kFileWatchMask);
+
+    struct stat st;
+    if (seed_from_tail && fstat(f->file_fd, &st) == 0 && st.st_size > static_cast<off_t>(kFollowSeedBytes)) {
+        f->offset = st.st_size - static_cast<off_t>(kFollowSeedBytes);
+        f->skip_partial_line = true;
+    }
+}
+
+// Read everything appended since the last call and split it into lines
+static void read_appended(LogFollower* f, std::vector<std::string>* lines) {
+    if (f->file_fd < 0) {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(f->file_fd, &st) == 0 && st.st_size < f->offset) {
+        // Truncated in place: start over.
+        f->offset = 0;
+        f->partial.clear();
+        f->skip_partial_line = false;
+    }
+
+    char buf[16 * 1024];
+    while (true) {
+        ssize_t n = pread(f->file_fd, buf, sizeof(buf), f->offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        f->offset += n;
+
+        const char* p = buf;
+        const char* end = buf + n;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!nl) {
+                f->partial.append(p, static_cast<size_t>(end - p));
+                break;
+            }
+            f->partial.append(p, static_cast<size_t>(nl - p));
+            if (f->skip_partial_line) {
+                f->skip_partial_line = false;
+            } else {
+                if (!f->partial.empty() && f->partial.back() == '\r') {
+                    f->partial.pop_back();
+                }
+                if (!f->partial.empty()) {
+                    lines->push_back(f->partial);
+                }
+            }
+            f->partial.clear();
+            p = nl + 1;
+        }
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+LogFollower* log_follower_open(const std::string& path, std::string* error_out) {
+    LogFollower* f = new LogFollower();
+    f->path = path;
+
+    const size_t slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        f->dir = ".";
+        f->name = path;
+    } else {
+        f->dir = (slash == 0) ? "/" : path.substr(0, slash);
+        f->name = path.substr(slash + 1);
+    }
+    if (f->name.empty()) {
+        if (error_out) *error_out = "not a file path: " + path;
+        delete f;
+        return nullptr;
+    }
+
+    f->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (f->inotify_fd < 0) {
+        if (error_out) *error_out = std::string("inotify_init1: ") + std::strerror(errno);
+        delete f;
+        return nullptr;
+    }
+
+    f->dir_wd = inotify_add_watch(f->inotify_fd, f->dir.c_str(), kDirWatchMask);
+    if (f->dir_wd < 0) {
+        if (error_out) *error_out = f->dir + ": " + std::strerror(errno);
+        close(f->inotify_fd);
+        delete f;
+        return nullptr;
+    }
+
+    attach_file(f, true);
+    return f;
+}
+
+int log_follower_fd(const LogFollower* follower) {
+    return follower ? follower->inotify_fd : -1;
+}
+
+bool log_follower_read(LogFollower* f, std::vector<std::string>* lines, std::string* error_out) {
+    if (!f->seeded) {
+        f->seeded = true;
+        read_appended(f, lines);
+    }
+
+    bool modified = false;
+    bool reopen = false;
+    bool gone = false;
+
+    alignas(struct inotify_event) char buf[4096];
+    while (true) {
+        ssize_t n = read(f->inotify_fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+
+        for (char* p = buf; p < buf + n;) {
+            const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                // Lost events: re-read and re-check the path.
+                modified = true;
+                reopen = true;
+                continue;
+            }
+            if (ev->wd == f->dir_wd) {
+                if (ev->mask & IN_IGNORED) {
+                    if (error_out) *error_out = f->dir + ": directory removed";
+                    return false;
+                }
+                if (ev->len > 0 && f->name == ev->name) {
+                    reopen = true;
+                }
+            } else if (ev->wd == f->file_wd) {
+                if (ev->mask & IN_MODIFY) {
+                    modified = true;
+                }
+                if (ev->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) {
+                    gone = true;
+                }
+            }
+        }
+    }
+
+    if (modified || gone || reopen) {
+        // Finish the old file first so no record written before a rotation
+        // is lost.
+        read_appended(f, lines);
+    }
+    if (reopen) {
+        struct stat by_path, by_fd;
+        const bool same_file = f->file_fd >= 0 &&
+                               stat(f->path.c_str(), &by_path) == 0 &&
+                               fstat(f->file_fd, &by_fd) == 0 &&
+                               by_path.st_ino == by_fd.st_ino && by_path.st_dev == by_fd.st_dev;
+        if (!same_file) {
+            attach_file(f, false);
+            read_appended(f, lines);
+        }
+    } else if (gone) {
+        detach_file(f);
+    }
+    return true;
+}
+
+void log_follower_close(LogFollower* f) {
+    if (!f) return;
+
+    detach_file(f);
+    if (f->inotify_fd >= 0) {
+        close(f->inotify_fd);
+    }
+    delete f;
+}
@@ -0,0 +1,49 @@
+#ifndef QUOTA_FOLLOW_H
+#define QUOTA_FOLLOW_H
+
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Log Follower (inotify)
+// ============================================================================
+//
+// Tails a show_quota.log written by another instance. The follower keeps the
+// byte offset of the last complete line and, when inotify reports a write,
+// reads only the bytes appended since then. Nothing is polled: the caller
+// blocks on log_follower_fd() and the process sleeps until the writer appends
+// a record (or the file is truncated, replaced or created).
+//
+// Truncation restarts from the beginning of the file; rotation (rename or
+// delete + create) is picked up through a watch on the parent directory.
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+// Bytes read from the end of an existing log to find the latest record
+static constexpr size_t kFollowSeedBytes = 4096;
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+struct LogFollower;
+
+// Start watching path. The file itself may not exist yet, its directory must.
+// Returns nullptr on failure.
+LogFollower* log_follower_open(const std::string& path, std::string* error_out);
+
+// inotify descriptor: readable when log_follower_read() has something to do
+int log_follower_fd(const LogFollower* follower);
+
+// Drain pending inotify events and append every new complete line to lines
+// (a partial trailing line is kept until its newline arrives). The first call
+// returns the lines of the last kFollowSeedBytes of an existing file. Never
+// blocks. Returns false if the watch is no longer usable.
+bool log_follower_read(LogFollower* follower, std::vector<std::string>* lines, std::string* error_out);
+
+// Remove the watches and free the follower
+void log_follower_close(LogFollower* follower);
+
+#endif // QUOTA_FOLLOW_H
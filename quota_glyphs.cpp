@@ -0,0 +1,142 @@
+#include "quota_glyphs.h"
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// ============================================================================
+// Glyph Tables
+// ============================================================================
+
+// Longest bar drawn with a single append; wider bars take several.
+static constexpr int kRunCells = 256;
+
+// Partial cells, 1/8 to 7/8 filled from the left
+static const char* const kEighthBlocks[8] = {"", "▏", "▎", "▍", "▌", "▋", "▊", "▉"};
+
+struct GlyphTables {
+    TermCaps caps;
+    std::string full_run[2];        // [utf8] kRunCells filled cells
+    std::string empty_run[2];       // [utf8] kRunCells empty cells
+    size_t cell_bytes[2];           // [utf8] bytes per full/empty cell
+    std::string usage_color[101];   // SGR per whole percent
+};
+
+static bool contains_utf8(const char* s) {
+    return s && (std::strstr(s, "UTF-8") || std::strstr(s, "utf8") ||
+                 std::strstr(s, "utf-8") || std::strstr(s, "UTF8"));
+}
+
+static TermCaps detect_caps() {
+    TermCaps caps;
+
+    // Initialize locale from environment
+    std::setlocale(LC_CTYPE, "");
+    const char* locale = std::setlocale(LC_CTYPE, nullptr);
+    caps.utf8 = locale ? contains_utf8(locale) : contains_utf8(std::getenv("LANG"));
+
+    const char* colorterm = std::getenv("COLORTERM");
+    const char* term = std::getenv("TERM");
+    if (colorterm && (std::strcmp(colorterm, "truecolor") == 0 || std::strcmp(colorterm, "24bit") == 0)) {
+        caps.color_depth = ColorDepth::TrueColor;
+    } else if (term && std::strstr(term, "256color")) {
+        caps.color_depth = ColorDepth::Ansi256;
+    }
+    return caps;
+}
+
+// Green -> yellow -> red, centered on the basic thresholds (50% / 80%)
+static void gradient_rgb(int percentage, int* r, int* g, int* b) {
+    const double t = std::min(1.0, std::max(0.0, (percentage - 35.0) / 60.0));
+    if (t < 0.5) {
+        *r = static_cast<int>(std::lround(220.0 * t * 2.0));
+        *g = 200;
+    } else {
+        *r = 220;
+        *g = static_cast<int>(std::lround(200.0 * (1.0 - (t - 0.5) * 2.0)));
+    }
+    *b = 0;
+}
+
+static std::string color_sgr(int percentage, ColorDepth depth) {
+    if (depth == ColorDepth::Basic) {
+        if (percentage < 50) return "\033[32m"; // Green
+        if (percentage < 80) return "\033[33m"; // Yellow
+        return "\033[31m";                      // Red
+    }
+
+    int r, g, b;
+    gradient_rgb(percentage, &r, &g, &b);
+    if (depth == ColorDepth::TrueColor) {
+        return "\033[38;2;" + std::to_string(r) + ";" + std::to_string(g) + ";" + std::to_string(b) + "m";
+    }
+    // 6x6x6 color cube of the 256-color palette
+    auto level = [](int c) { return static_cast<int>(std::lround(c / 255.0 * 5.0)); };
+    return "\033[38;5;" + std::to_string(16 + 36 * level(r) + 6 * level(g) + level(b)) + "m";
+}
+
+static const GlyphTables& glyph_tables() {
+    static const GlyphTables tables = [] {
+        GlyphTables t;
+        t.caps = detect_caps();
+
+        const char* full[2] = {"#", "█"};
+        const char* empty[2] = {"-", "░"};
+        for (int u = 0; u < 2; u++) {
+            t.cell_bytes[u] = std::strlen(full[u]);
+            for (int i = 0; i < kRunCells; i++) {
+                t.full_run[u].append(full[u]);
+                t.empty_run[u].append(empty[u]);
+            }
+        }
+        for (int p = 0; p <= 100; p++) {
+            t.usage_color[p] = color_sgr(p, t.caps.color_depth);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+const TermCaps& term_caps() {
+    return glyph_tables().caps;
+}
+
+static void append_run(std::string* out, const std::string& run, size_t cell_bytes, int cells) {
+    while (cells > 0) {
+        const int n = std::min(cells, kRunCells);
+        out->append(run, 0, static_cast<size_t>(n) * cell_bytes);
+        cells -= n;
+    }
+}
+
+void append_bar(std::string* out, double fraction, int width, bool utf8) {
+    const GlyphTables& t = glyph_tables();
+    const int u = utf8 ? 1 : 0;
+    width = std::max(width, 0);
+    fraction = std::min(1.0, std::max(0.0, fraction));
+
+    const int resolution = utf8 ? 8 : 1;
+    const int units = static_cast<int>(fraction * width * resolution);
+    const int filled = units / resolution;
+    const int partial = units % resolution;
+
+    append_run(out, t.full_run[u], t.cell_bytes[u], filled);
+    int empty = width - filled;
+    if (partial > 0) {
+        out->append(kEighthBlocks[partial]);
+        empty--;
+    }
+    append_run(out, t.empty_run[u], t.cell_bytes[u], empty);
+}
+
+const std::string& usage_color_sgr(double percentage) {
+    // Truncated, so the basic colors switch exactly at 50.0 and 80.0
+    const int p = static_cast<int>(std::min(100.0, std::max(0.0, percentage)));
+    return glyph_tables().usage_color[p];
+}
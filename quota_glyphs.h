@@ -0,0 +1,48 @@
+#ifndef QUOTA_GLYPHS_H
+#define QUOTA_GLYPHS_H
+
+#include <string>
+
+// ============================================================================
+// Terminal Capabilities and Bar Glyphs
+// ============================================================================
+//
+// The terminal's capabilities (UTF-8 locale, color depth) are detected once,
+// on first use, together with every glyph and color sequence the bars need:
+// runs of full/empty cells, the eighth-block partial cells and one SGR
+// sequence per whole percent. Drawing a bar then only appends ready-made
+// bytes to the caller's (reused) buffer.
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+enum class ColorDepth {
+    Basic,          // 8 ANSI colors
+    Ansi256,        // xterm 256-color palette (TERM=*-256color)
+    TrueColor,      // 24-bit (COLORTERM=truecolor/24bit)
+};
+
+struct TermCaps {
+    bool utf8 = false;
+    ColorDepth color_depth = ColorDepth::Basic;
+};
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Capabilities of the controlling terminal, detected on the first call
+const TermCaps& term_caps();
+
+// Append a bar of exactly width cells with fraction (0..1) of it filled.
+// UTF-8 bars have 1/8-cell resolution (a partial block in the boundary cell),
+// ASCII bars whole cells.
+void append_bar(std::string* out, double fraction, int width, bool utf8);
+
+// SGR sequence for a usage percentage: green below 50%, yellow below 80%,
+// red above. 256-color and truecolor terminals get a smooth gradient along
+// the same scale.
+const std::string& usage_color_sgr(double percentage);
+
+#endif // QUOTA_GLYPHS_H
@@ -0,0 +1,119 @@
+#include "quota_history.h"
+#include "quota_common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+// ============================================================================
+// Ring Buffer
+// ============================================================================
+
+void history_push(QuotaHistory* history, time_t timestamp, double percentage) {
+    if (history->ring.size() != kHistoryCapacity) {
+        history->ring.resize(kHistoryCapacity);
+    }
+    history->ring[history->total % kHistoryCapacity] = HistorySample{timestamp, percentage};
+    history->total++;
+    if (history->count < kHistoryCapacity) {
+        history->count++;
+    }
+}
+
+const HistorySample& history_at(const QuotaHistory* history, size_t i) {
+    const uint64_t seq = history->total - history->count + i;
+    return history->ring[seq % kHistoryCapacity];
+}
+
+size_t history_seed_from_log(QuotaHistory* history, const std::string& log_file, time_t since) {
+    std::ifstream file(log_file, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    const std::streamoff start = std::max<std::streamoff>(0, size - static_cast<std::streamoff>(kHistorySeedBytes));
+    file.seekg(start);
+
+    std::string line;
+    if (start > 0) {
+        std::getline(file, line); // Partial record
+    }
+
+    size_t added = 0;
+    while (std::getline(file, line)) {
+        QuotaData data;
+        if (!parse_log_line(line, &data, nullptr) || data.timestamp < since) {
+            continue; // Header, malformed line or an earlier window
+        }
+        history_push(history, data.timestamp, data.percentage);
+        added++;
+    }
+    return added;
+}
+
+// ============================================================================
+// Strip Rendering
+// ============================================================================
+
+// Fill levels in eighths of a cell, empty to full
+static const char* const kBlockLevels[9] = {" ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+static const char* const kAsciiLevels[9] = {" ", "_", "_", ".", "-", "-", "=", "=", "#"};
+
+static size_t utf8_length(unsigned char c) {
+    if ((c & 0xE0) == 0xC0) return 2;
+    if ((c & 0xF0) == 0xE0) return 3;
+    if ((c & 0xF8) == 0xF0) return 4;
+    return 1;
+}
+
+// Shift every row left by one column and add the sample's column on the right
+static void strip_append(HistoryStrip* strip, double percentage) {
+    const char* const* levels = strip->utf8 ? kBlockLevels : kAsciiLevels;
+
+    const double clamped = std::min(100.0, std::max(0.0, percentage));
+    long eighths = std::lround(clamped / 100.0 * strip->height * 8);
+    if (eighths < 1) {
+        eighths = 1; // Keep a baseline so a 0% sample is distinguishable from no sample
+    }
+
+    for (int r = 0; r < strip->height; r++) {
+        std::string& row = strip->rows[static_cast<size_t>(r)];
+        row.erase(0, utf8_length(static_cast<unsigned char>(row[0])));
+
+        // Row 0 is the top; the bottom row fills first.
+        const long base = static_cast<long>(strip->height - 1 - r) * 8;
+        const long fill = std::min(8L, std::max(0L, eighths - base));
+        row.append(levels[fill]);
+    }
+}
+
+const std::vector<std::string>& history_render(const QuotaHistory* history, HistoryStrip* strip,
+                                               int width, int height, bool utf8) {
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+
+    // Samples that are no longer in the ring (or never drawn) force a rebuild.
+    const uint64_t oldest_available = history->total - history->count;
+    const bool stale = strip->width != width || strip->height != height || strip->utf8 != utf8 ||
+                       strip->consumed < oldest_available;
+    if (stale) {
+        strip->width = width;
+        strip->height = height;
+        strip->utf8 = utf8;
+        strip->rows.assign(static_cast<size_t>(height), std::string(static_cast<size_t>(width), ' '));
+        const uint64_t visible = std::min<uint64_t>(history->count, static_cast<uint64_t>(width));
+        strip->consumed = history->total - visible;
+    }
+
+    // Only samples added since the last call, at most one screen width.
+    const uint64_t max_new = std::min<uint64_t>(history->count, static_cast<uint64_t>(width));
+    if (history->total - strip->consumed > max_new) {
+        strip->consumed = history->total - max_new;
+    }
+    for (; strip->consumed < history->total; strip->consumed++) {
+        strip_append(strip, history->ring[strip->consumed % kHistoryCapacity].percentage);
+    }
+    return strip->rows;
+}
@@ -0,0 +1,77 @@
+#ifndef QUOTA_HISTORY_H
+#define QUOTA_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Sample History
+// ============================================================================
+//
+// Fixed-capacity ring buffer of recent usage samples, seeded from the tail of
+// the CSV log at startup, plus incrementally maintained block renderings of it
+// (a one-row sparkline and a multi-row chart).
+//
+// The renderings use a fixed 0-100% scale, so an existing column never changes:
+// each new sample drops the leftmost column and appends one on the right.
+// Only a width/height/charset change rebuilds a strip from the ring.
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+static constexpr size_t kHistoryCapacity = 1024;
+
+// Bytes read from the end of the log when seeding (~1000 records)
+static constexpr size_t kHistorySeedBytes = 64 * 1024;
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+struct HistorySample {
+    time_t timestamp;
+    double percentage;
+};
+
+// One rendering of the newest samples: `height` rows of exactly `width`
+// columns, top row first, newest sample in the rightmost column.
+struct HistoryStrip {
+    int width = 0;
+    int height = 0;
+    bool utf8 = false;
+    uint64_t consumed = 0;              // samples already appended
+    std::vector<std::string> rows;
+};
+
+struct QuotaHistory {
+    std::vector<HistorySample> ring;
+    size_t count = 0;                   // valid samples in ring
+    uint64_t total = 0;                 // samples ever pushed
+    HistoryStrip sparkline;
+    HistoryStrip chart;
+};
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Append a sample (overwrites the oldest one when full)
+void history_push(QuotaHistory* history, time_t timestamp, double percentage);
+
+// Oldest-first access: i in [0, count)
+const HistorySample& history_at(const QuotaHistory* history, size_t i);
+
+// Load the log records newer than `since` from the end of log_file.
+// Returns the number of samples added.
+size_t history_seed_from_log(QuotaHistory* history, const std::string& log_file, time_t since);
+
+// Bring strip up to date with the history and return its rows. Columns not
+// yet covered by samples are blank.
+const std::vector<std::string>& history_render(const QuotaHistory* history, HistoryStrip* strip,
+                                               int width, int height, bool utf8);
+
+#endif // QUOTA_HISTORY_H
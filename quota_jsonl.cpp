@@ -0,0 +1,129 @@
+#include "quota_jsonl.h"
+
+#include <charconv>
+#include <cmath>
+
+// ============================================================================
+// Primitive Writers
+// ============================================================================
+
+void jsonl_append_string(std::string* out, const char* value) {
+    static const char kHex[] = "0123456789abcdef";
+
+    out->push_back('"');
+    for (const char* p = value; *p; p++) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        switch (c) {
+            case '"':  out->append("\\\""); break;
+            case '\\': out->append("\\\\"); break;
+            case '\n': out->append("\\n"); break;
+            case '\r': out->append("\\r"); break;
+            case '\t': out->append("\\t"); break;
+            default:
+                if (c < 0x20) {
+                    out->append("\\u00");
+                    out->push_back(kHex[c >> 4]);
+                    out->push_back(kHex[c & 0x0f]);
+                } else {
+                    out->push_back(static_cast<char>(c));
+                }
+        }
+    }
+    out->push_back('"');
+}
+
+void jsonl_begin(JsonlWriter* w) {
+    w->buf.clear();
+    w->buf.push_back('{');
+    w->first_field = true;
+}
+
+void jsonl_key(JsonlWriter* w, const char* key) {
+    if (!w->first_field) {
+        w->buf.push_back(',');
+    }
+    w->first_field = false;
+    jsonl_append_string(&w->buf, key);
+    w->buf.push_back(':');
+}
+
+void jsonl_field_string(JsonlWriter* w, const char* key, const char* value) {
+    jsonl_key(w, key);
+    if (value) {
+        jsonl_append_string(&w->buf, value);
+    } else {
+        w->buf.append("null");
+    }
+}
+
+void jsonl_field_number(JsonlWriter* w, const char* key, double value) {
+    jsonl_key(w, key);
+    if (!std::isfinite(value)) {
+        w->buf.append("null");
+        return;
+    }
+    // Shortest round-trip representation, formatted in place.
+    char tmp[32];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    w->buf.append(tmp, res.ptr);
+}
+
+void jsonl_field_int(JsonlWriter* w, const char* key, int64_t value) {
+    jsonl_key(w, key);
+    char tmp[24];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    w->buf.append(tmp, res.ptr);
+}
+
+void jsonl_field_bool(JsonlWriter* w, const char* key, bool value) {
+    jsonl_key(w, key);
+    w->buf.append(value ? "true" : "false");
+}
+
+void jsonl_field_null(JsonlWriter* w, const char* key) {
+    jsonl_key(w, key);
+    w->buf.append("null");
+}
+
+void jsonl_end(JsonlWriter* w) {
+    w->buf.push_back('}');
+}
+
+// ============================================================================
+// Record Formatting
+// ============================================================================
+
+const std::string& jsonl_format_record(JsonlWriter* w, const JsonlRecord& rec) {
+    jsonl_begin(w);
+    if (rec.account) {
+        jsonl_field_string(w, "account", rec.account);
+    }
+    jsonl_field_int(w, "timestamp", rec.timestamp);
+    jsonl_field_bool(w, "ok", rec.ok);
+
+    if (rec.ok) {
+        // Round away binary noise (0.12000000000000001) so lines stay short.
+        jsonl_field_number(w, "used", std::round(rec.used * 1e6) / 1e6);
+        jsonl_field_number(w, "percentage", std::round(rec.percentage * 1e4) / 1e4);
+        jsonl_field_string(w, "reset", rec.reset);
+        if (rec.reset_epoch >= 0) {
+            jsonl_field_int(w, "reset_epoch", rec.reset_epoch);
+        } else {
+            jsonl_field_null(w, "reset_epoch");
+        }
+        jsonl_field_string(w, "event", rec.event);
+    } else {
+        jsonl_field_string(w, "error", rec.error ? rec.error : "unknown error");
+        if (rec.http_code != 0) {
+            jsonl_field_int(w, "http_code", rec.http_code);
+        }
+    }
+
+    if (rec.latency_ms >= 0.0) {
+        // A tenth of a millisecond is plenty; keeps lines short.
+        jsonl_field_number(w, "latency_ms", std::round(rec.latency_ms * 10.0) / 10.0);
+    }
+
+    jsonl_end(w);
+    return w->buf;
+}
@@ -0,0 +1,64 @@
+#ifndef QUOTA_JSONL_H
+#define QUOTA_JSONL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ============================================================================
+// JSON Lines Serializer
+// ============================================================================
+//
+// Streaming writer for one-object-per-line output (--jsonl, --serve). Fields are
+// appended straight into a reusable buffer: no JSON DOM is built and, once the
+// buffer has grown to its working size, formatting a line does not allocate.
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+// One refresh worth of output. Pointers may be null; null/negative fields are
+// emitted as JSON null (or omitted, for error-only fields).
+struct JsonlRecord {
+    const char* account = nullptr;     // --key-file account name (omitted if null)
+    int64_t timestamp = 0;
+    bool ok = false;
+    double used = 0.0;
+    double percentage = 0.0;
+    const char* reset = nullptr;       // ISO 8601 reset time
+    int64_t reset_epoch = -1;          // reset time as Unix epoch
+    const char* event = nullptr;       // detect_event() result
+    double latency_ms = -1.0;          // fetch latency
+    long http_code = 0;
+    const char* error = nullptr;       // set when ok == false
+};
+
+struct JsonlWriter {
+    std::string buf;
+    bool first_field = true;
+
+    JsonlWriter() { buf.reserve(512); }
+};
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Low-level field writers (used by jsonl_format_record and status formatters)
+void jsonl_begin(JsonlWriter* w);
+void jsonl_key(JsonlWriter* w, const char* key);
+void jsonl_field_string(JsonlWriter* w, const char* key, const char* value);
+void jsonl_field_number(JsonlWriter* w, const char* key, double value);
+void jsonl_field_int(JsonlWriter* w, const char* key, int64_t value);
+void jsonl_field_bool(JsonlWriter* w, const char* key, bool value);
+void jsonl_field_null(JsonlWriter* w, const char* key);
+void jsonl_end(JsonlWriter* w);
+
+// Append a JSON string literal (quoted and escaped)
+void jsonl_append_string(std::string* out, const char* value);
+
+// Format a record as one compact JSON object (no trailing newline).
+// The returned reference stays valid until the next call on the same writer.
+const std::string& jsonl_format_record(JsonlWriter* w, const JsonlRecord& rec);
+
+#endif // QUOTA_JSONL_H
@@ -0,0 +1,702 @@
+#include "quota_mock.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifdef MOCK_TLS
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+// ============================================================================
+// Internal Types
+// ============================================================================
+
+// Auth methods in try_auth_methods() order; bit i of MockScript::auth_methods
+static const char* const kMockAuthNames[] = {"bearer-key", "bearer-token", "x-api-key", "raw"};
+static constexpr int kMockAuthMethods = 4;
+
+static constexpr size_t kMockMaxRequestBytes = 16 * 1024;
+
+struct MockServer {
+    MockScript script;
+    int listen_fd = -1;
+    int port = 0;
+    bool tls = false;
+    std::thread accept_thread;
+    time_t started_at = 0;                          // on the script's clock
+    std::chrono::steady_clock::time_point started;  // ... and in real time
+
+#ifdef MOCK_TLS
+    SSL_CTX* ssl_ctx = nullptr;
+#endif
+
+    std::mutex mu;
+    std::condition_variable cv;         // stop, and connection threads exiting
+    bool stop = false;
+    std::set<int> conn_fds;             // open connections (shut down on stop)
+    int active = 0;                     // running connection threads
+    MockStats stats;
+
+    std::atomic<uint64_t> request_seq{0};
+};
+
+// One accepted connection (plain or TLS)
+struct MockConn {
+    int fd = -1;
+#ifdef MOCK_TLS
+    SSL* ssl = nullptr;
+#endif
+};
+
+// ============================================================================
+// Script Parsing
+// ============================================================================
+
+static bool parse_number(const std::string& word, double* out) {
+    if (word.empty()) return false;
+    char* end = nullptr;
+    const double v = std::strtod(word.c_str(), &end);
+    if (*end != '\0' || !std::isfinite(v) || v < 0.0) return false;
+    *out = v;
+    return true;
+}
+
+static bool parse_count(const std::string& word, uint64_t* out) {
+    double v = 0.0;
+    if (!parse_number(word, &v) || v != std::floor(v)) return false;
+    *out = static_cast<uint64_t>(v);
+    return true;
+}
+
+// "fixed 20" / "uniform 10 80" / "normal 40 10" / "lognormal 40 0.6"
+static bool parse_latency(const std::vector<std::string>& w, size_t i, MockLatency* out, size_t* next) {
+    if (i >= w.size()) return false;
+    const std::string& kind = w[i];
+    double a = 0.0, b = 0.0;
+    if (kind == "fixed" && i + 1 < w.size() && parse_number(w[i + 1], &a)) {
+        *out = {MockLatencyKind::Fixed, a, 0.0};
+        *next = i + 2;
+        return true;
+    }
+    if (i + 2 >= w.size() || !parse_number(w[i + 1], &a) || !parse_number(w[i + 2], &b)) {
+        return false;
+    }
+    if (kind == "uniform" && b >= a) {
+        *out = {MockLatencyKind::Uniform, a, b};
+    } else if (kind == "normal") {
+        *out = {MockLatencyKind::Normal, a, b};
+    } else if (kind == "lognormal" && a > 0.0) {
+        *out = {MockLatencyKind::LogNormal, a, b};
+    } else {
+        return false;
+    }
+    *next = i + 3;
+    return true;
+}
+
+// status <code> [retry-after <s>] | drip <bytes> <ms> | malformed | latency ...
+static bool parse_action(const std::vector<std::string>& w, size_t i, MockAction* out) {
+    while (i < w.size()) {
+        uint64_t a = 0, b = 0;
+        if (w[i] == "status" && i + 1 < w.size() && parse_count(w[i + 1], &a) && a >= 100 && a < 600) {
+            out->status = static_cast<int>(a);
+            i += 2;
+        } else if (w[i] == "retry-after" && i + 1 < w.size() && parse_count(w[i + 1], &a)) {
+            out->retry_after_s = static_cast<long>(a);
+            i += 2;
+        } else if (w[i] == "drip" && i + 2 < w.size() && parse_count(w[i + 1], &a) && a > 0 &&
+                   parse_count(w[i + 2], &b)) {
+            out->drip_bytes = static_cast<size_t>(a);
+            out->drip_interval_ms = static_cast<int>(b);
+            i += 3;
+        } else if (w[i] == "malformed") {
+            out->malformed = true;
+            i++;
+        } else if (w[i] == "latency" && parse_latency(w, i + 1, &out->latency, &i)) {
+            out->has_latency = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// "10", "10-12", "50-" (open-ended)
+static bool parse_range(const std::string& word, MockRule* rule) {
+    const size_t dash = word.find('-');
+    if (dash == std::string::npos) {
+        return parse_count(word, &rule->from) && rule->from > 0 && (rule->to = rule->from, true);
+    }
+    if (!parse_count(word.substr(0, dash), &rule->from) || rule->from == 0) return false;
+    const std::string rest = word.substr(dash + 1);
+    if (rest.empty()) {
+        rule->to = 0;
+        return true;
+    }
+    return parse_count(rest, &rule->to) && rule->to >= rule->from;
+}
+
+// "100" or "100+5"
+static bool parse_period(const std::string& word, MockRule* rule) {
+    const size_t plus = word.find('+');
+    if (!parse_count(word.substr(0, plus), &rule->period) || rule->period == 0) return false;
+    rule->burst = 1;
+    if (plus != std::string::npos && (!parse_count(word.substr(plus + 1), &rule->burst) || rule->burst == 0)) {
+        return false;
+    }
+    return rule->burst <= rule->period;
+}
+
+static bool parse_line(const std::vector<std::string>& w, MockScript* s) {
+    const std::string& cmd = w[0];
+    size_t next = 0;
+    double a = 0.0, b = 0.0, c = 0.0;
+
+    if (cmd == "latency") {
+        return parse_latency(w, 1, &s->latency, &next) && next == w.size();
+    }
+    if (cmd == "auth") {
+        s->auth_methods = 0;
+        for (size_t i = 1; i < w.size(); i++) {
+            if (w[i] == "any") {
+                s->auth_methods = 0;
+                return w.size() == 2;
+            }
+            const char* const* it = std::find(kMockAuthNames, kMockAuthNames + kMockAuthMethods, w[i]);
+            if (it == kMockAuthNames + kMockAuthMethods) return false;
+            s->auth_methods |= 1u << (it - kMockAuthNames);
+        }
+        return s->auth_methods != 0;
+    }
+    if (cmd == "usage" && w.size() == 3 && w[1] == "constant" && parse_number(w[2], &a)) {
+        s->usage = MockUsageKind::Constant;
+        s->usage_from = s->usage_to = a;
+        return true;
+    }
+    if (cmd == "usage" && w.size() == 5 && w[1] == "linear" && parse_number(w[2], &a) &&
+        parse_number(w[3], &b) && parse_number(w[4], &c) && c >= 1.0) {
+        s->usage = MockUsageKind::Linear;
+        s->usage_from = a;
+        s->usage_to = b;
+        s->usage_seconds = static_cast<long>(c);
+        return true;
+    }
+    if (cmd == "clock" && (w.size() == 2 || w.size() == 3) && parse_number(w[1], &a) && a > 0.0) {
+        s->clock_rate = a;
+        if (w.size() == 3) {
+            if (!parse_number(w[2], &b) || b < 0.0) return false;
+            s->clock_start = static_cast<long long>(b);
+        }
+        return true;
+    }
+    if (cmd == "reset" && w.size() == 3 && parse_number(w[2], &a)) {
+        if (w[1] == "every" && a >= 1.0) {
+            s->reset_every_s = static_cast<long>(a);
+            return true;
+        }
+        if (w[1] == "at") {
+            s->reset_at_s = static_cast<long>(a);
+            return true;
+        }
+        return false;
+    }
+    if ((cmd == "at" || cmd == "every") && w.size() >= 3) {
+        MockRule rule;
+        if (!(cmd == "at" ? parse_range(w[1], &rule) : parse_period(w[1], &rule))) return false;
+        if (!parse_action(w, 2, &rule.action)) return false;
+        s->rules.push_back(rule);
+        return true;
+    }
+    return false;
+}
+
+bool mock_script_parse(const std::string& text, MockScript* out, std::string* error_out) {
+    MockScript script;
+    std::istringstream lines(text);
+    std::string line;
+    int line_no = 0;
+
+    while (std::getline(lines, line)) {
+        line_no++;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream words(line);
+        std::vector<std::string> w;
+        for (std::string word; words >> word;) w.push_back(word);
+        if (w.empty()) continue;
+
+        if (!parse_line(w, &script)) {
+            if (error_out) *error_out = "line " + std::to_string(line_no) + ": cannot parse '" + line + "'";
+            return false;
+        }
+    }
+    *out = script;
+    return true;
+}
+
+bool mock_script_load(const std::string& path, MockScript* out, std::string* error_out) {
+    std::ifstream file(path);
+    if (!file) {
+        if (error_out) *error_out = "cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    if (!mock_script_parse(text.str(), out, error_out)) {
+        if (error_out) *error_out = path + ": " + *error_out;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Responses
+// ============================================================================
+
+static bool rule_matches(const MockRule& rule, uint64_t n) {
+    if (rule.period > 0) {
+        return (n - 1) % rule.period < rule.burst;
+    }
+    return n >= rule.from && (rule.to == 0 || n <= rule.to);
+}
+
+// Merge every rule matching request n over the script defaults
+static MockAction resolve_action(const MockScript& s, uint64_t n) {
+    MockAction action;
+    action.latency = s.latency;
+    for (const MockRule& rule : s.rules) {
+        if (!rule_matches(rule, n)) continue;
+        const MockAction& r = rule.action;
+        if (r.status) {
+            action.status = r.status;
+            action.retry_after_s = r.retry_after_s;
+        }
+        if (r.drip_bytes) {
+            action.drip_bytes = r.drip_bytes;
+            action.drip_interval_ms = r.drip_interval_ms;
+        }
+        if (r.malformed) {
+            action.malformed = true;
+        }
+        if (r.has_latency) {
+            action.latency = r.latency;
+        }
+    }
+    return action;
+}
+
+static double sample_latency_ms(const MockLatency& l, std::mt19937_64& rng) {
+    switch (l.kind) {
+        case MockLatencyKind::None:
+            return 0.0;
+        case MockLatencyKind::Fixed:
+            return l.a;
+        case MockLatencyKind::Uniform:
+            return std::uniform_real_distribution<double>(l.a, l.b)(rng);
+        case MockLatencyKind::Normal:
+            return std::max(0.0, std::normal_distribution<double>(l.a, l.b)(rng));
+        case MockLatencyKind::LogNormal:
+            return std::lognormal_distribution<double>(std::log(l.a), l.b)(rng);
+    }
+    return 0.0;
+}
+
+// Auth method a request used, from its headers (lower-cased names)
+static int request_auth_method(const std::string& authorization, const std::string& x_api_key) {
+    if (!x_api_key.empty()) return 2;
+    if (authorization.empty()) return -1;
+    if (authorization.compare(0, 7, "Bearer ") == 0) {
+        return authorization.compare(7, 7, "fw_api_") == 0 ? 0 : 1;
+    }
+    return 3;
+}
+
+static std::string iso8601_utc(time_t t) {
+    char buf[32];
+    struct tm tm_utc;
+    gmtime_r(&t, &tm_utc);
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+    return buf;
+}
+
+static std::string http_date(time_t t) {
+    char buf[64];
+    struct tm tm_utc;
+    gmtime_r(&t, &tm_utc);
+    strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tm_utc);
+    return buf;
+}
+
+// Current time on the script's clock (real time unless scaled by `clock`)
+static time_t mock_now(const MockServer* server) {
+    const double elapsed_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - server->started).count();
+    return server->started_at + static_cast<time_t>(elapsed_s * server->script.clock_rate);
+}
+
+// {"used":..,"reset":..} for the current point of the usage curve
+static std::string quota_body(const MockScript& s, time_t started_at, time_t now) {
+    const long elapsed = static_cast<long>(now - started_at);
+    long window_start = 0;
+    long next_reset = -1;
+    if (s.reset_every_s > 0) {
+        window_start = elapsed / s.reset_every_s * s.reset_every_s;
+        next_reset = window_start + s.reset_every_s;
+    } else if (s.reset_at_s >= 0) {
+        if (elapsed < s.reset_at_s) {
+            next_reset = s.reset_at_s;
+        } else {
+            window_start = s.reset_at_s;
+        }
+    }
+
+    double used = s.usage_from;
+    if (s.usage == MockUsageKind::Linear) {
+        const double f = std::min(1.0, static_cast<double>(elapsed - window_start) / s.usage_seconds);
+        used = s.usage_from + (s.usage_to - s.usage_from) * f;
+    }
+
+    char used_text[32];
+    snprintf(used_text, sizeof(used_text), "%.4f", used);
+    std::string body = std::string("{\"used\":") + used_text + ",\"reset\":";
+    body += next_reset >= 0 ? "\"" + iso8601_utc(started_at + next_reset) + "\"" : "null";
+    return body + "}";
+}
+
+static const char* reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 401: return "Unauthorized";
+        case 404: return "Not Found";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default: return "Status";
+    }
+}
+
+// ============================================================================
+// Connection I/O
+// ============================================================================
+
+static ssize_t conn_read(MockConn* c, char* buf, size_t len) {
+#ifdef MOCK_TLS
+    if (c->ssl) {
+        const int n = SSL_read(c->ssl, buf, static_cast<int>(len));
+        return n > 0 ? n : -1;
+    }
+#endif
+    return recv(c->fd, buf, len, 0);
+}
+
+static bool conn_write(MockConn* c, const char* data, size_t len) {
+    while (len > 0) {
+#ifdef MOCK_TLS
+        if (c->ssl) {
+            const int n = SSL_write(c->ssl, data, static_cast<int>(len));
+            if (n <= 0) return false;
+            data += n;
+            len -= static_cast<size_t>(n);
+            continue;
+        }
+#endif
+        const ssize_t n = send(c->fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Sleep unless the server stops first; false when stopping
+static bool wait_ms(MockServer* server, double ms) {
+    if (ms <= 0.0) return true;
+    std::unique_lock<std::mutex> lock(server->mu);
+    return !server->cv.wait_for(lock, std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0)),
+                                [server] { return server->stop; });
+}
+
+// ============================================================================
+// Request Handling
+// ============================================================================
+
+// Serve one parsed request; false when the connection must close
+static bool serve_request(MockServer* server, MockConn* conn, const std::string& head, std::mt19937_64& rng) {
+    std::istringstream lines(head);
+    std::string request_line;
+    std::getline(lines, request_line);
+    std::string method, path, version;
+    std::istringstream(request_line) >> method >> path >> version;
+
+    std::string authorization, x_api_key, connection;
+    for (std::string line; std::getline(lines, line);) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        std::string value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        if (name == "authorization") authorization = value;
+        else if (name == "x-api-key") x_api_key = value;
+        else if (name == "connection") connection = value;
+    }
+    const bool keep_alive = version == "HTTP/1.1" && connection != "close";
+
+    const uint64_t n = ++server->request_seq;
+    const MockScript& s = server->script;
+    MockAction action = resolve_action(s, n);
+    const time_t now = mock_now(server);
+
+    int status = 200;
+    std::string body;
+    std::string extra_headers;
+    const int auth = request_auth_method(authorization, x_api_key);
+    if (method != "GET" || path.compare(0, 13, "/api/v1/quota") != 0) {
+        status = 404;
+        body = "{\"error\":\"Not Found\"}";
+    } else if (auth < 0 || (s.auth_methods != 0 && !(s.auth_methods & (1u << auth)))) {
+        status = 401;
+        body = "{\"error\":\"Unauthorized\"}";
+    } else if (action.status != 0 && action.status != 200) {
+        status = action.status;
+        body = std::string("{\"error\":\"") + reason_phrase(status) + "\"}";
+        if (action.retry_after_s >= 0) {
+            extra_headers += "Retry-After: " + std::to_string(action.retry_after_s) + "\r\n";
+        }
+    } else {
+        body = quota_body(s, server->started_at, now);
+        if (action.malformed) {
+            body.resize(body.size() / 2);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(server->mu);
+        MockStats& st = server->stats;
+        st.requests++;
+        if (status == 200) st.ok++;
+        else if (status == 401) st.unauthorized++;
+        else if (status == 429) st.rate_limited++;
+        else if (status >= 500) st.server_errors++;
+        else st.other++;
+    }
+
+    if (!wait_ms(server, sample_latency_ms(action.latency, rng))) {
+        return false;
+    }
+
+    std::string response = "HTTP/1.1 " + std::to_string(status) + " " + reason_phrase(status) + "\r\n";
+    response += "Date: " + http_date(now) + "\r\n";
+    response += "Content-Type: application/json\r\n";
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    response += extra_headers;
+    response += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+
+    if (action.drip_bytes == 0) {
+        response += body;
+        return conn_write(conn, response.data(), response.size()) && keep_alive;
+    }
+
+    // Slow-drip body: headers now, then one chunk per interval
+    if (!conn_write(conn, response.data(), response.size())) return false;
+    for (size_t off = 0; off < body.size(); off += action.drip_bytes) {
+        if (off > 0 && !wait_ms(server, action.drip_interval_ms)) return false;
+        const size_t len = std::min(action.drip_bytes, body.size() - off);
+        if (!conn_write(conn, body.data() + off, len)) return false;
+    }
+    return keep_alive;
+}
+
+static void connection_thread(MockServer* server, int fd, uint64_t seed) {
+    MockConn conn;
+    conn.fd = fd;
+    std::mt19937_64 rng(seed);
+    bool ok = true;
+
+#ifdef MOCK_TLS
+    if (server->tls) {
+        conn.ssl = SSL_new(server->ssl_ctx);
+        ok = conn.ssl && SSL_set_fd(conn.ssl, fd) == 1 && SSL_accept(conn.ssl) == 1;
+    }
+#endif
+
+    std::string buffer;
+    char chunk[4096];
+    while (ok) {
+        const size_t end = buffer.find("\r\n\r\n");
+        if (end != std::string::npos) {
+            const std::string head = buffer.substr(0, end);
+            buffer.erase(0, end + 4);
+            if (!serve_request(server, &conn, head, rng)) break;
+            continue;
+        }
+        if (buffer.size() > kMockMaxRequestBytes) break;
+        const ssize_t got = conn_read(&conn, chunk, sizeof(chunk));
+        if (got <= 0) break;
+        buffer.append(chunk, static_cast<size_t>(got));
+    }
+
+#ifdef MOCK_TLS
+    if (conn.ssl) {
+        SSL_shutdown(conn.ssl);
+        SSL_free(conn.ssl);
+    }
+#endif
+    std::lock_guard<std::mutex> lock(server->mu);
+    server->conn_fds.erase(fd);
+    close(fd);
+    server->active--;
+    server->cv.notify_all();
+}
+
+static void accept_loop(MockServer* server) {
+    std::random_device seed_source;
+    const uint64_t seed = (static_cast<uint64_t>(seed_source()) << 32) ^ seed_source();
+
+    while (true) {
+        const int fd = accept4(server->listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        std::lock_guard<std::mutex> lock(server->mu);
+        if (server->stop) {
+            if (fd >= 0) close(fd);
+            return;
+        }
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EMFILE) continue;
+            return;
+        }
+        server->conn_fds.insert(fd);
+        server->active++;
+        server->stats.connections++;
+        std::thread(connection_thread, server, fd, seed + server->stats.connections).detach();
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool mock_tls_available() {
+#ifdef MOCK_TLS
+    return true;
+#else
+    return false;
+#endif
+}
+
+MockServer* mock_server_start(const MockScript& script, int port, const std::string& cert_file,
+                              const std::string& key_file, std::string* error_out) {
+    auto fail = [&](const std::string& what) -> MockServer* {
+        if (error_out) *error_out = what;
+        return nullptr;
+    };
+
+    const bool tls = !cert_file.empty() || !key_file.empty();
+#ifdef MOCK_TLS
+    SSL_CTX* ctx = nullptr;
+    if (tls) {
+        ctx = SSL_CTX_new(TLS_server_method());
+        if (!ctx || SSL_CTX_use_certificate_chain_file(ctx, cert_file.c_str()) != 1 ||
+            SSL_CTX_use_PrivateKey_file(ctx, key_file.c_str(), SSL_FILETYPE_PEM) != 1) {
+            char reason[256];
+            ERR_error_string_n(ERR_get_error(), reason, sizeof(reason));
+            if (ctx) SSL_CTX_free(ctx);
+            return fail(std::string("TLS setup: ") + reason);
+        }
+    }
+#else
+    if (tls) {
+        return fail("HTTPS needs a build with OpenSSL (libssl-dev)");
+    }
+#endif
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return fail(std::string("socket: ") + strerror(errno));
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    socklen_t addr_len = sizeof(addr);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 128) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+        const std::string reason = strerror(errno);
+        close(fd);
+        return fail("bind 127.0.0.1:" + std::to_string(port) + ": " + reason);
+    }
+
+    MockServer* server = new MockServer();
+    server->script = script;
+    server->listen_fd = fd;
+    server->port = ntohs(addr.sin_port);
+    server->tls = tls;
+    server->started_at = script.clock_start >= 0 ? static_cast<time_t>(script.clock_start) : time(nullptr);
+    server->started = std::chrono::steady_clock::now();
+#ifdef MOCK_TLS
+    server->ssl_ctx = ctx;
+#endif
+    server->accept_thread = std::thread(accept_loop, server);
+    return server;
+}
+
+int mock_server_port(const MockServer* server) {
+    return server->port;
+}
+
+std::string mock_server_url(const MockServer* server) {
+    return std::string(server->tls ? "https" : "http") + "://127.0.0.1:" + std::to_string(server->port) +
+           "/api/v1/quota";
+}
+
+MockStats mock_server_stats(MockServer* server) {
+    std::lock_guard<std::mutex> lock(server->mu);
+    return server->stats;
+}
+
+void mock_server_stop(MockServer* server) {
+    if (!server) return;
+    {
+        std::lock_guard<std::mutex> lock(server->mu);
+        server->stop = true;
+        shutdown(server->listen_fd, SHUT_RDWR);
+        for (int fd : server->conn_fds) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        server->cv.notify_all();
+    }
+    server->accept_thread.join();
+    {
+        std::unique_lock<std::mutex> lock(server->mu);
+        server->cv.wait(lock, [server] { return server->active == 0; });
+    }
+    close(server->listen_fd);
+#ifdef MOCK_TLS
+    if (server->ssl_ctx) SSL_CTX_free(server->ssl_ctx);
+#endif
+    delete server;
+}
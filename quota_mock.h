@@ -0,0 +1,137 @@
+#ifndef QUOTA_MOCK_H
+#define QUOTA_MOCK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Mock Quota Server
+// ============================================================================
+//
+// A loopback stand-in for GET /api/v1/quota, for benchmarks and soak tests
+// that must not touch production (quota_mock and quota_bench). One thread
+// per connection, keep-alive, HTTPS when built with OpenSSL and given a
+// certificate. Behaviour comes from a small line-based script:
+//
+//   # comment
+//   latency fixed 20                 every response waits 20 ms
+//   latency uniform 10 80            ... or uniform / normal (mean sd) /
+//   latency lognormal 40 0.6         lognormal (median sigma), in ms
+//   auth x-api-key bearer-token      only these methods succeed; the others
+//                                    get 401 (bearer-key, bearer-token,
+//                                    x-api-key, raw; default: any)
+//   usage linear 0.05 0.95 600       used ramps over 600 s of each window
+//   usage constant 0.42
+//   reset every 3600                 the window resets every hour ...
+//   reset at 300                     ... or once, 300 s after start
+//   clock 720 1767225600             script time (usage curve, resets, Date)
+//                                    runs 720x real time from that unix
+//                                    second (default: now), to pair with a
+//                                    frontend's --time-scale/--time-start
+//   at 10-12 status 429 retry-after 5
+//   every 100+5 status 503           requests 1-5, 101-105, ... fail
+//   at 40 drip 8 250                 body in 8-byte chunks, 250 ms apart
+//   at 60-61 malformed               200 with the body cut in half
+//   at 50- latency fixed 2000        open-ended range
+//
+// Requests are numbered from 1 in arrival order; the last matching rule of
+// each kind wins, so later lines override earlier ones.
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+enum class MockLatencyKind {
+    None,
+    Fixed,          // a ms
+    Uniform,        // a..b ms
+    Normal,         // mean a, sd b (ms, clamped at 0)
+    LogNormal,      // median a ms, sigma b
+};
+
+struct MockLatency {
+    MockLatencyKind kind = MockLatencyKind::None;
+    double a = 0.0;
+    double b = 0.0;
+};
+
+// What a rule does to the requests it matches
+struct MockAction {
+    int status = 0;                 // 0: serve the quota normally
+    long retry_after_s = -1;        // Retry-After header with status
+    size_t drip_bytes = 0;          // 0: send the body at once
+    int drip_interval_ms = 0;
+    bool malformed = false;         // truncate the quota body (still 200)
+    bool has_latency = false;
+    MockLatency latency;
+};
+
+// Requests from..to (1-based, to = 0: open-ended), or with period > 0 the
+// first `burst` requests of every `period`
+struct MockRule {
+    uint64_t from = 1;
+    uint64_t to = 0;
+    uint64_t period = 0;
+    uint64_t burst = 1;
+    MockAction action;
+};
+
+enum class MockUsageKind {
+    Constant,
+    Linear,
+};
+
+struct MockScript {
+    MockLatency latency;
+    unsigned auth_methods = 0;      // bits: bearer-key, bearer-token, x-api-key, raw; 0 = any
+    MockUsageKind usage = MockUsageKind::Constant;
+    double usage_from = 0.25;
+    double usage_to = 0.25;
+    long usage_seconds = 0;
+    long reset_every_s = 0;         // 0: no periodic reset
+    long reset_at_s = -1;           // -1: no one-off reset
+    double clock_rate = 1.0;        // script time per real second
+    long long clock_start = -1;     // unix seconds at start, -1: now
+    std::vector<MockRule> rules;
+};
+
+// Counts since start (thread-safe snapshot)
+struct MockStats {
+    uint64_t requests = 0;
+    uint64_t ok = 0;
+    uint64_t unauthorized = 0;
+    uint64_t rate_limited = 0;
+    uint64_t server_errors = 0;
+    uint64_t other = 0;
+    uint64_t connections = 0;
+};
+
+struct MockServer;
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Parse a script; on error names the line and returns false
+bool mock_script_parse(const std::string& text, MockScript* out, std::string* error_out);
+bool mock_script_load(const std::string& path, MockScript* out, std::string* error_out);
+
+// True if this build can serve HTTPS
+bool mock_tls_available();
+
+// Bind 127.0.0.1:<port> (0 picks a free port) and start serving. With
+// cert_file/key_file (PEM) the server speaks HTTPS. nullptr on failure.
+MockServer* mock_server_start(const MockScript& script, int port, const std::string& cert_file,
+                              const std::string& key_file, std::string* error_out);
+
+// Bound port and base URL (http(s)://127.0.0.1:<port>/api/v1/quota)
+int mock_server_port(const MockServer* server);
+std::string mock_server_url(const MockServer* server);
+
+MockStats mock_server_stats(MockServer* server);
+
+// Close the listener and every connection, join the threads, free
+void mock_server_stop(MockServer* server);
+
+#endif // QUOTA_MOCK_H
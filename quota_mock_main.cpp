@@ -0,0 +1,108 @@
+// Loopback mock of the quota API: run it, then point a frontend at it with
+// --url http://127.0.0.1:8787/api/v1/quota (see quota_mock.h for scripts).
+
+#include "quota_mock.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <pthread.h>
+
+// ============================================================================
+// Usage
+// ============================================================================
+
+static void print_usage(const char* program_name) {
+    std::cerr << "Usage: " << program_name << " [OPTIONS]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Serves GET /api/v1/quota on 127.0.0.1 until interrupted." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --port <n>          Port to listen on (default: 8787, 0 = any free port)" << std::endl;
+    std::cerr << "  --script <file>     Latency, auth, errors and usage curve (see below)" << std::endl;
+    std::cerr << "  --cert <pem>        Serve HTTPS with this certificate (chain) ..." << std::endl;
+    std::cerr << "  --key <pem>         ... and private key" << std::endl;
+    std::cerr << "  --help              Show this help message" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Script (one directive per line, # comments):" << std::endl;
+    std::cerr << "  latency fixed <ms> | uniform <lo> <hi> | normal <mean> <sd> | lognormal <median> <sigma>" << std::endl;
+    std::cerr << "  auth <bearer-key|bearer-token|x-api-key|raw>...   other methods get 401" << std::endl;
+    std::cerr << "  usage constant <used> | linear <from> <to> <seconds>" << std::endl;
+    std::cerr << "  reset every <seconds> | reset at <seconds>" << std::endl;
+    std::cerr << "  clock <rate> [<unix-seconds>]   script time runs <rate>x real time" << std::endl;
+    std::cerr << "  at <n>[-[<m>]] <action>   /   every <period>[+<burst>] <action>" << std::endl;
+    std::cerr << "    action: status <code> [retry-after <s>]  drip <bytes> <ms>  latency ..." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Example:" << std::endl;
+    std::cerr << "  " << program_name << " --script soak.mock &" << std::endl;
+    std::cerr << "  show_quota_text --url http://127.0.0.1:8787/api/v1/quota fw_api_test" << std::endl;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    int port = 8787;
+    std::string script_file;
+    std::string cert_file;
+    std::string key_file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--port" && has_value) {
+            port = std::atoi(argv[++i]);
+        } else if (arg == "--script" && has_value) {
+            script_file = argv[++i];
+        } else if (arg == "--cert" && has_value) {
+            cert_file = argv[++i];
+        } else if (arg == "--key" && has_value) {
+            key_file = argv[++i];
+        } else {
+            std::cerr << "Unknown option or missing value: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cert_file.empty() != key_file.empty()) {
+        std::cerr << "Error: --cert and --key go together" << std::endl;
+        return 1;
+    }
+
+    MockScript script;
+    std::string error;
+    if (!script_file.empty() && !mock_script_load(script_file, &script, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    // Block before starting threads so only sigwait sees them
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    MockServer* server = mock_server_start(script, port, cert_file, key_file, &error);
+    if (!server) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "Serving " << mock_server_url(server) << std::endl;
+
+    int sig = 0;
+    sigwait(&mask, &sig);
+
+    const MockStats stats = mock_server_stats(server);
+    mock_server_stop(server);
+    std::cout << "Requests: " << stats.requests << " (200: " << stats.ok << ", 401: " << stats.unauthorized
+              << ", 429: " << stats.rate_limited << ", 5xx: " << stats.server_errors
+              << ", other: " << stats.other << ") on " << stats.connections << " connections" << std::endl;
+    return 0;
+}
@@ -0,0 +1,449 @@
+#include "quota_push.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Internal Types
+// ============================================================================
+
+enum class PushFormat {
+    Sse,
+    Ndjson,
+};
+
+struct PushClient {
+    int fd = -1;
+    bool streaming = false;     // false while the request is still being read
+    bool close_after_flush = false;
+    PushFormat format = PushFormat::Sse;
+    std::string request;
+    std::string out;
+    size_t out_off = 0;
+    time_t accepted_at = 0;
+};
+
+struct PushServer {
+    int listen_fd = -1;
+    int wake_rd = -1;
+    int wake_wr = -1;
+    std::thread thread;
+
+    std::mutex mu;
+    std::vector<std::string> pending;
+    std::string latest;
+    bool stop = false;
+
+    // Owned by the writer thread only.
+    std::vector<PushClient> clients;
+};
+
+static constexpr size_t kPushMaxRequestBytes = 4096;
+static constexpr int kPushRequestTimeoutSeconds = 5;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static bool set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return false;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static size_t pending_bytes(const PushClient& c) {
+    return c.out.size() - c.out_off;
+}
+
+// Append to a client's buffer; returns false if the client is too far behind.
+static bool enqueue(PushClient* c, const std::string& data) {
+    if (pending_bytes(*c) + data.size() > kPushClientBufferBytes) {
+        return false;
+    }
+    if (c->out_off > 0 && c->out_off == c->out.size()) {
+        c->out.clear();
+        c->out_off = 0;
+    }
+    c->out += data;
+    return true;
+}
+
+static std::string frame_for(PushFormat format, const std::string& json_line) {
+    if (format == PushFormat::Sse) {
+        return "data: " + json_line + "\n\n";
+    }
+    return json_line + "\n";
+}
+
+// Write as much as the socket accepts. Returns false if the client is gone.
+static bool flush_client(PushClient* c) {
+    while (c->out_off < c->out.size()) {
+        ssize_t n = send(c->fd, c->out.data() + c->out_off, c->out.size() - c->out_off, MSG_NOSIGNAL);
+        if (n > 0) {
+            c->out_off += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return false;
+    }
+    c->out.clear();
+    c->out_off = 0;
+    return !c->close_after_flush;
+}
+
+static void respond_and_close(PushClient* c, const char* status, const std::string& content_type, const std::string& body) {
+    std::string resp = std::string("HTTP/1.1 ") + status + "\r\n";
+    resp += "Content-Type: " + content_type + "\r\n";
+    resp += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    resp += "Access-Control-Allow-Origin: *\r\n";
+    resp += "Connection: close\r\n\r\n";
+    resp += body;
+    c->out = resp;
+    c->out_off = 0;
+    c->streaming = true;
+    c->close_after_flush = true;
+}
+
+// Parse the request line once the header block is complete. Returns false if
+// the request is malformed and the client should be dropped.
+static bool handle_request(PushServer* server, PushClient* c) {
+    size_t line_end = c->request.find("\r\n");
+    std::string line = c->request.substr(0, line_end);
+
+    size_t sp1 = line.find(' ');
+    size_t sp2 = (sp1 == std::string::npos) ? std::string::npos : line.find(' ', sp1 + 1);
+    if (sp1 == std::string::npos || sp2 == std::string::npos) {
+        return false;
+    }
+    std::string method = line.substr(0, sp1);
+    std::string path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    size_t q = path.find('?');
+    if (q != std::string::npos) {
+        path.resize(q);
+    }
+    c->request.clear();
+    c->request.shrink_to_fit();
+
+    if (method != "GET") {
+        respond_and_close(c, "405 Method Not Allowed", "text/plain", "GET only\n");
+        return true;
+    }
+
+    std::string latest;
+    {
+        std::lock_guard<std::mutex> lock(server->mu);
+        latest = server->latest;
+    }
+
+    if (path == "/latest") {
+        if (latest.empty()) {
+            respond_and_close(c, "503 Service Unavailable", "text/plain", "no snapshot yet\n");
+        } else {
+            respond_and_close(c, "200 OK", "application/json", latest + "\n");
+        }
+        return true;
+    }
+
+    std::string content_type;
+    if (path == "/events" || path == "/") {
+        c->format = PushFormat::Sse;
+        content_type = "text/event-stream";
+    } else if (path == "/ndjson") {
+        c->format = PushFormat::Ndjson;
+        content_type = "application/x-ndjson";
+    } else {
+        respond_and_close(c, "404 Not Found", "text/plain", "try /events, /ndjson or /latest\n");
+        return true;
+    }
+
+    c->out = "HTTP/1.1 200 OK\r\n"
+             "Content-Type: " + content_type + "\r\n"
+             "Cache-Control: no-cache\r\n"
+             "Access-Control-Allow-Origin: *\r\n"
+             "Connection: close\r\n\r\n";
+    c->out_off = 0;
+    c->streaming = true;
+    if (!latest.empty()) {
+        c->out += frame_for(c->format, latest);
+    }
+    return true;
+}
+
+static void close_client(PushClient* c) {
+    if (c->fd >= 0) {
+        close(c->fd);
+        c->fd = -1;
+    }
+}
+
+static void accept_clients(PushServer* server) {
+    while (true) {
+        int fd = accept(server->listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        if ((int)server->clients.size() >= kPushMaxClients || !set_nonblocking(fd)) {
+            close(fd);
+            continue;
+        }
+        PushClient c;
+        c.fd = fd;
+        c.accepted_at = time(nullptr);
+        server->clients.push_back(std::move(c));
+    }
+}
+
+// Read request bytes from a client that has not started streaming yet.
+// Streaming clients are only read to detect hangups.
+static bool read_client(PushServer* server, PushClient* c) {
+    char buf[1024];
+    while (true) {
+        ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (c->streaming) {
+            continue;
+        }
+        c->request.append(buf, static_cast<size_t>(n));
+        if (c->request.size() > kPushMaxRequestBytes) {
+            return false;
+        }
+    }
+    if (!c->streaming && c->request.find("\r\n\r\n") != std::string::npos) {
+        return handle_request(server, c);
+    }
+    return true;
+}
+
+static void drain_wake_pipe(int fd) {
+    char buf[64];
+    while (read(fd, buf, sizeof(buf)) > 0) {
+    }
+}
+
+// ============================================================================
+// Writer Thread
+// ============================================================================
+
+static void push_server_loop(PushServer* server) {
+    std::vector<pollfd> fds;
+    time_t last_keepalive = time(nullptr);
+
+    while (true) {
+        // Fan out newly published snapshots.
+        std::vector<std::string> batch;
+        bool stop = false;
+        {
+            std::lock_guard<std::mutex> lock(server->mu);
+            batch.swap(server->pending);
+            stop = server->stop;
+        }
+        if (stop) {
+            break;
+        }
+
+        time_t now = time(nullptr);
+        const bool keepalive_due = difftime(now, last_keepalive) >= kPushKeepaliveSeconds;
+        if (keepalive_due) {
+            last_keepalive = now;
+        }
+
+        for (PushClient& c : server->clients) {
+            if (!c.streaming) {
+                if (difftime(now, c.accepted_at) > kPushRequestTimeoutSeconds) {
+                    close_client(&c);
+                }
+                continue;
+            }
+            if (c.close_after_flush) {
+                continue;
+            }
+            bool ok = true;
+            for (const std::string& line : batch) {
+                if (!enqueue(&c, frame_for(c.format, line))) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (ok && keepalive_due && c.format == PushFormat::Sse && pending_bytes(c) == 0) {
+                ok = enqueue(&c, ": keepalive\n\n");
+            }
+            // Slow consumer: drop it rather than buffering without bound.
+            if (!ok || !flush_client(&c)) {
+                close_client(&c);
+            }
+        }
+
+        server->clients.erase(
+            std::remove_if(server->clients.begin(), server->clients.end(),
+                           [](const PushClient& c) { return c.fd < 0; }),
+            server->clients.end());
+
+        fds.clear();
+        fds.push_back({server->wake_rd, POLLIN, 0});
+        fds.push_back({server->listen_fd, POLLIN, 0});
+        bool have_pending_request = false;
+        for (const PushClient& c : server->clients) {
+            short events = POLLIN;
+            if (pending_bytes(c) > 0) {
+                events |= POLLOUT;
+            }
+            if (!c.streaming) {
+                have_pending_request = true;
+            }
+            fds.push_back({c.fd, events, 0});
+        }
+
+        // Sleep indefinitely when idle; wake for keepalives only with subscribers.
+        int timeout_ms = -1;
+        if (have_pending_request) {
+            timeout_ms = 1000;
+        } else if (!server->clients.empty()) {
+            timeout_ms = kPushKeepaliveSeconds * 1000;
+        }
+
+        int rc = poll(fds.data(), fds.size(), timeout_ms);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            drain_wake_pipe(server->wake_rd);
+        }
+        if (fds[1].revents & POLLIN) {
+            accept_clients(server);
+        }
+
+        for (size_t i = 2; i < fds.size(); i++) {
+            PushClient& c = server->clients[i - 2];
+            const short re = fds[i].revents;
+            if (re & (POLLERR | POLLNVAL)) {
+                close_client(&c);
+                continue;
+            }
+            if ((re & (POLLIN | POLLHUP)) && !read_client(server, &c)) {
+                close_client(&c);
+                continue;
+            }
+            if (c.fd >= 0 && pending_bytes(c) > 0 && !flush_client(&c)) {
+                close_client(&c);
+            }
+        }
+    }
+
+    for (PushClient& c : server->clients) {
+        close_client(&c);
+    }
+    server->clients.clear();
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+PushServer* push_server_start(int port, std::string* error_out) {
+    auto fail = [&](const std::string& what) -> PushServer* {
+        if (error_out) {
+            *error_out = what + ": " + std::strerror(errno);
+        }
+        return nullptr;
+    };
+
+    if (port <= 0 || port > 65535) {
+        errno = EINVAL;
+        return fail("invalid port " + std::to_string(port));
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return fail("socket");
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return fail("bind 127.0.0.1:" + std::to_string(port));
+    }
+    if (listen(fd, 16) != 0 || !set_nonblocking(fd)) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return fail("listen");
+    }
+
+    int pipefd[2];
+    if (pipe2(pipefd, O_NONBLOCK | O_CLOEXEC) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return fail("pipe");
+    }
+
+    PushServer* server = new PushServer();
+    server->listen_fd = fd;
+    server->wake_rd = pipefd[0];
+    server->wake_wr = pipefd[1];
+    server->thread = std::thread(push_server_loop, server);
+    return server;
+}
+
+void push_server_publish(PushServer* server, const std::string& json_line) {
+    if (!server) return;
+    {
+        std::lock_guard<std::mutex> lock(server->mu);
+        server->latest = json_line;
+        server->pending.push_back(json_line);
+    }
+    const char b = 1;
+    (void)!write(server->wake_wr, &b, 1);
+}
+
+void push_server_stop(PushServer* server) {
+    if (!server) return;
+    {
+        std::lock_guard<std::mutex> lock(server->mu);
+        server->stop = true;
+    }
+    const char b = 1;
+    (void)!write(server->wake_wr, &b, 1);
+    if (server->thread.joinable()) {
+        server->thread.join();
+    }
+    close(server->listen_fd);
+    close(server->wake_rd);
+    close(server->wake_wr);
+    delete server;
+}
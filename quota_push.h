@@ -0,0 +1,45 @@
+#ifndef QUOTA_PUSH_H
+#define QUOTA_PUSH_H
+
+#include <cstddef>
+#include <string>
+
+// ============================================================================
+// Localhost Push Endpoint (Server-Sent Events / NDJSON)
+// ============================================================================
+//
+// A small single-threaded HTTP server bound to 127.0.0.1. Every snapshot handed
+// to push_server_publish() is streamed to all connected subscribers:
+//
+//   GET /events   text/event-stream   ("data: <json>\n\n" per snapshot)
+//   GET /ndjson   application/x-ndjson ("<json>\n" per snapshot)
+//   GET /latest   application/json    (most recent snapshot, then close)
+//
+// New subscribers immediately receive the most recent snapshot. Each client has
+// a bounded output buffer; a client that falls behind is disconnected instead of
+// stalling the writer or growing memory.
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+static constexpr int kPushMaxClients = 64;
+static constexpr size_t kPushClientBufferBytes = 64 * 1024;
+static constexpr int kPushKeepaliveSeconds = 15;
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+struct PushServer;
+
+// Bind 127.0.0.1:<port> and start the writer thread. Returns nullptr on failure.
+PushServer* push_server_start(int port, std::string* error_out);
+
+// Queue one JSON object (no trailing newline) for all subscribers. Thread-safe.
+void push_server_publish(PushServer* server, const std::string& json_line);
+
+// Disconnect all subscribers, stop the writer thread and free the server.
+void push_server_stop(PushServer* server);
+
+#endif // QUOTA_PUSH_H
@@ -0,0 +1,188 @@
+#include "quota_retry.h"
+#include "quota_common.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// splitmix64: cheap, and good enough to spread retries
+static uint64_t next_random(RetryState* state) {
+    uint64_t z = (state->rng += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [lo, hi]
+static int random_between(RetryState* state, int lo, int hi) {
+    if (hi <= lo) return lo;
+    return lo + static_cast<int>(next_random(state) % static_cast<uint64_t>(hi - lo + 1));
+}
+
+// ============================================================================
+// Retry Policy
+// ============================================================================
+
+void retry_init(RetryState* state) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    *state = RetryState();
+    state->rng = (static_cast<uint64_t>(now.tv_sec) << 32) ^ static_cast<uint64_t>(now.tv_nsec) ^
+                 (static_cast<uint64_t>(getpid()) << 16) ^ reinterpret_cast<uintptr_t>(state);
+}
+
+void retry_attempt_started(RetryState* state) {
+    if (state->breaker == BreakerState::Open) {
+        state->breaker = BreakerState::HalfOpen;
+    }
+}
+
+void retry_on_success(RetryState* state) {
+    state->failures = 0;
+    state->breaker = BreakerState::Closed;
+    state->delay_s = 0;
+    state->rate_limited = false;
+}
+
+int retry_on_failure(RetryState* state, int refresh_interval_s) {
+    state->failures++;
+    state->rate_limited = false;
+
+    if (state->breaker == BreakerState::HalfOpen || state->failures >= kRetryBreakerThreshold) {
+        // Open (again): one probe after the cool-down, spread over its second half
+        state->breaker = BreakerState::Open;
+        state->delay_s = random_between(state, kRetryBreakerCooldownSeconds / 2, kRetryBreakerCooldownSeconds);
+        return state->delay_s;
+    }
+
+    // Full jitter over an exponentially growing window
+    const int base = std::max(refresh_interval_s, 1);
+    const int cap = std::max(kRetryBackoffCapSeconds, base);
+    int64_t window = base;
+    for (int i = 1; i < state->failures && window < cap; i++) {
+        window *= 2;
+    }
+    state->delay_s = random_between(state, 1, static_cast<int>(std::min<int64_t>(window, cap)));
+    return state->delay_s;
+}
+
+int retry_on_rate_limit(RetryState* state, long server_delay_s, int refresh_interval_s) {
+    if (server_delay_s <= 0) {
+        const int delay = retry_on_failure(state, refresh_interval_s);
+        state->rate_limited = true;
+        return delay;
+    }
+
+    // The server was explicit: a throttle is not a fault, so the breaker
+    // and failure count stay where they are (a half-open probe that got
+    // throttled still reached the server: close the circuit)
+    if (state->breaker == BreakerState::HalfOpen) {
+        state->breaker = BreakerState::Closed;
+    }
+    const int wait = static_cast<int>(std::min<long>(server_delay_s, kRetryMaxServerDelaySeconds));
+    state->delay_s = wait + random_between(state, 0, std::max(wait / 10, 1));
+    state->rate_limited = true;
+    return state->delay_s;
+}
+
+bool retry_waiting(const RetryState* state) {
+    return state->failures > 0 || state->rate_limited;
+}
+
+bool retry_on_connectivity(RetryState* state) {
+    // An open circuit keeps its cool-down and a probe in flight answers the
+    // question; a throttled instance waits regardless of the network
+    return state->failures > 0 && !state->rate_limited && state->breaker == BreakerState::Closed;
+}
+
+std::string retry_describe(const RetryState* state, int seconds_left) {
+    const std::string in = format_duration_compact(std::max(seconds_left, 0));
+    if (state->rate_limited) {
+        return "Rate limited, next try in " + in;
+    }
+    if (state->failures == 0) {
+        return std::string();
+    }
+    switch (state->breaker) {
+        case BreakerState::Open:
+            return "Circuit open, probe in " + in;
+        case BreakerState::HalfOpen:
+            return "Probing...";
+        case BreakerState::Closed:
+            break;
+    }
+    return "Retry " + std::to_string(state->failures) + " in " + in;
+}
+
+// ============================================================================
+// Connectivity Watch
+// ============================================================================
+
+int net_watch_open() {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool net_watch_read(int fd) {
+    bool came_up = false;
+    alignas(struct nlmsghdr) char buf[8192];
+
+    while (true) {
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            // EAGAIN: drained. ENOBUFS: notifications were lost, assume a change.
+            if (n < 0 && errno == ENOBUFS) {
+                came_up = true;
+                continue;
+            }
+            break;
+        }
+
+        int len = static_cast<int>(n);
+        for (struct nlmsghdr* nh = reinterpret_cast<struct nlmsghdr*>(buf); NLMSG_OK(nh, len);
+             nh = NLMSG_NEXT(nh, len)) {
+            switch (nh->nlmsg_type) {
+                case RTM_NEWADDR:
+                    came_up = true;
+                    break;
+                case RTM_NEWLINK: {
+                    const struct ifinfomsg* ifi = static_cast<const struct ifinfomsg*>(NLMSG_DATA(nh));
+                    // Link messages repeat for any change on a running
+                    // interface; only the transition to running counts
+                    if ((ifi->ifi_change & IFF_RUNNING) && (ifi->ifi_flags & IFF_RUNNING)) {
+                        came_up = true;
+                    }
+                    break;
+                }
+                case RTM_NEWROUTE: {
+                    // New default route
+                    const struct rtmsg* rt = static_cast<const struct rtmsg*>(NLMSG_DATA(nh));
+                    if (rt->rtm_dst_len == 0) {
+                        came_up = true;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+    return came_up;
+}
@@ -0,0 +1,100 @@
+#ifndef QUOTA_RETRY_H
+#define QUOTA_RETRY_H
+
+#include <cstdint>
+#include <string>
+
+// ============================================================================
+// Retry Policy
+// ============================================================================
+//
+// Shared schedule for failed fetches, used by every frontend:
+//
+//   - backoff: after the n-th consecutive failure the next attempt waits a
+//     uniformly random 1 s .. min(cap, interval * 2^(n-1)) ("full jitter"),
+//     so instances that failed together do not retry together
+//   - circuit breaker: after kRetryBreakerThreshold consecutive failures the
+//     circuit opens and nothing is sent for a jittered cool-down; then a
+//     single probe runs (half-open). Success closes the circuit, failure
+//     opens it again
+//   - connectivity: when a network interface or address comes up, a failing
+//     instance retries at once instead of waiting out its backoff. An open
+//     circuit still waits out its cool-down
+//   - rate limits: when the server throttles (429, Retry-After, an exhausted
+//     RateLimit window) the next attempt waits what the server asked for
+//     plus up to 10% jitter. Throttling is not a failure: it neither counts
+//     toward the breaker nor is cut short by connectivity changes
+//
+// A success returns to the normal refresh interval. Manual refreshes are
+// always allowed and count as an attempt.
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+static constexpr int kRetryBackoffCapSeconds = 300;
+static constexpr int kRetryBreakerThreshold = 5;
+static constexpr int kRetryBreakerCooldownSeconds = 600;
+static constexpr int kRetryMaxServerDelaySeconds = 3600;   // cap on Retry-After
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+enum class BreakerState {
+    Closed,         // normal operation (possibly backing off)
+    Open,           // cooling down, no requests
+    HalfOpen,       // the single probe is in flight
+};
+
+struct RetryState {
+    int failures = 0;                   // consecutive failed attempts
+    BreakerState breaker = BreakerState::Closed;
+    int delay_s = 0;                    // delay chosen after the last failure
+    bool rate_limited = false;          // delay_s was requested by the server
+    uint64_t rng = 0;                   // per-process jitter stream
+};
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Seed the jitter from time, pid and address (distinct per instance)
+void retry_init(RetryState* state);
+
+// An attempt is starting (an open circuit turns half-open: this is the probe)
+void retry_attempt_started(RetryState* state);
+
+// Record the outcome. retry_on_failure returns the seconds to wait before
+// the next attempt; after a success the caller resumes its interval.
+void retry_on_success(RetryState* state);
+int retry_on_failure(RetryState* state, int refresh_interval_s);
+
+// The server throttled the attempt (see request_rate_limited). Returns the
+// seconds to wait; with no server delay (0) this backs off like a failure.
+int retry_on_rate_limit(RetryState* state, long server_delay_s, int refresh_interval_s);
+
+// A failure backoff or a server-requested delay is pending (the normal
+// interval is suspended)
+bool retry_waiting(const RetryState* state);
+
+// Connectivity came back: true if a failing instance with a closed circuit
+// should retry now
+bool retry_on_connectivity(RetryState* state);
+
+// "Retry 2 in 42s" / "Circuit open, probe in 9m 30s" / "Probing..." while
+// failing, "Rate limited, next try in 30s" while throttled, "" when healthy
+std::string retry_describe(const RetryState* state, int seconds_left);
+
+// ----------------------------------------------------------------------------
+// Connectivity watch (terminal frontends; the GUI uses GNetworkMonitor)
+// ----------------------------------------------------------------------------
+
+// rtnetlink socket reporting link and address changes; -1 if unavailable
+int net_watch_open();
+
+// Drain pending notifications; true if a link went to running or an
+// address or default route was added
+bool net_watch_read(int fd);
+
+#endif // QUOTA_RETRY_H
@@ -0,0 +1,218 @@
+#include "quota_screen.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Skipping over this many unchanged cells costs about as much as a cursor move,
+// so shorter gaps are simply rewritten.
+static constexpr int kMaxRewriteGap = 4;
+
+// Length of the UTF-8 sequence introduced by lead byte c
+static size_t utf8_length(unsigned char c) {
+    if (c < 0x80) return 1;
+    if ((c & 0xE0) == 0xC0) return 2;
+    if ((c & 0xF0) == 0xE0) return 3;
+    if ((c & 0xF8) == 0xF0) return 4;
+    return 1; // Stray continuation byte: treat as one cell
+}
+
+// Split a rendered frame into rows of styled cells (clipped to the screen)
+static void parse_frame(const std::string& frame, int width, int height,
+                        std::vector<std::vector<ScreenCell>>* rows) {
+    for (auto& row : *rows) {
+        row.clear();
+    }
+    size_t row_count = 0;
+    auto current_row = [&]() -> std::vector<ScreenCell>& {
+        if (rows->size() <= row_count) {
+            rows->resize(row_count + 1);
+        }
+        return (*rows)[row_count];
+    };
+
+    std::string style;
+    const size_t n = frame.size();
+    size_t i = 0;
+    while (i < n && static_cast<int>(row_count) < height) {
+        const unsigned char c = static_cast<unsigned char>(frame[i]);
+
+        if (c == '\n') {
+            current_row();
+            row_count++;
+            i++;
+            continue;
+        }
+
+        if (c == 0x1B && i + 1 < n && frame[i + 1] == '[') {
+            // CSI: parameters up to a final byte in 0x40-0x7E
+            size_t j = i + 2;
+            while (j < n && (static_cast<unsigned char>(frame[j]) < 0x40 ||
+                             static_cast<unsigned char>(frame[j]) > 0x7E)) {
+                j++;
+            }
+            if (j < n && frame[j] == 'm') {
+                const size_t len = j + 1 - i;
+                if (len == 3 || frame.compare(i, len, "\033[0m") == 0) {
+                    style.clear();
+                } else {
+                    style.append(frame, i, len);
+                }
+            }
+            // Other sequences (cursor moves, clears) are not part of a frame.
+            i = j + 1;
+            continue;
+        }
+
+        if (c < 0x20 && c != '\t') {
+            i++; // \r and other controls
+            continue;
+        }
+
+        const size_t len = std::min(utf8_length(c), n - i);
+        std::vector<ScreenCell>& row = current_row();
+        if (static_cast<int>(row.size()) < width) {
+            ScreenCell cell;
+            if (c == '\t') {
+                cell.glyph.assign(1, ' ');
+            } else {
+                cell.glyph.assign(frame, i, len);
+            }
+            cell.style = style;
+            row.push_back(std::move(cell));
+        }
+        i += len;
+    }
+    // A last line without '\n' still counts.
+    if (i >= n && row_count < rows->size() && !(*rows)[row_count].empty()) {
+        row_count++;
+    }
+    rows->resize(row_count);
+}
+
+static void append_cursor_move(std::string* out, int row, int col) {
+    out->append("\033[");
+    out->append(std::to_string(row + 1));
+    out->push_back(';');
+    out->append(std::to_string(col + 1));
+    out->push_back('H');
+}
+
+static void write_all(int fd, const std::string& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = write(fd, data.data() + off, data.size() - off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        off += static_cast<size_t>(n);
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void screen_resize(TermScreen* screen, int width, int height) {
+    if (width != screen->width || height != screen->height) {
+        screen->width = width;
+        screen->height = height;
+        screen->valid = false;
+    }
+}
+
+void screen_invalidate(TermScreen* screen) {
+    screen->valid = false;
+}
+
+size_t screen_present(TermScreen* screen, const std::string& frame, int fd) {
+    const int width = std::max(screen->width, 1);
+    const int height = std::max(screen->height, 1);
+    parse_frame(frame, width, height, &screen->next);
+
+    std::string& out = screen->out;
+    out.clear();
+
+    if (!screen->valid) {
+        out.append("\033[0m\033[H\033[2J");
+        screen->rows.clear();
+        screen->valid = true;
+    }
+
+    const std::vector<std::vector<ScreenCell>>& old_rows = screen->rows;
+    const std::vector<std::vector<ScreenCell>>& new_rows = screen->next;
+    static const std::vector<ScreenCell> kEmptyRow;
+
+    std::string term_style;         // style the terminal is currently in
+    int cur_row = -1;
+    int cur_col = -1;
+
+    auto put_cell = [&](const ScreenCell& cell) {
+        if (cell.style != term_style) {
+            out.append("\033[0m");
+            out.append(cell.style);
+            term_style = cell.style;
+        }
+        out.append(cell.glyph);
+        cur_col++;
+    };
+
+    const size_t row_total = std::max(old_rows.size(), new_rows.size());
+    for (size_t r = 0; r < row_total; r++) {
+        const std::vector<ScreenCell>& nr = r < new_rows.size() ? new_rows[r] : kEmptyRow;
+        const std::vector<ScreenCell>& orow = r < old_rows.size() ? old_rows[r] : kEmptyRow;
+        const int row = static_cast<int>(r);
+
+        for (size_t c = 0; c < nr.size(); c++) {
+            if (c < orow.size() && nr[c] == orow[c]) {
+                continue;
+            }
+            const int col = static_cast<int>(c);
+            if (cur_row == row && cur_col <= col && col - cur_col <= kMaxRewriteGap) {
+                // Cheaper to repeat the unchanged cells than to move.
+                while (cur_col < col) {
+                    put_cell(nr[cur_col]);
+                }
+            } else {
+                append_cursor_move(&out, row, col);
+                cur_row = row;
+                cur_col = col;
+            }
+            put_cell(nr[c]);
+        }
+
+        if (orow.size() > nr.size()) {
+            // Erase what is left of a longer previous line.
+            const int col = static_cast<int>(nr.size());
+            if (cur_row != row || cur_col != col) {
+                append_cursor_move(&out, row, col);
+                cur_row = row;
+                cur_col = col;
+            }
+            if (!term_style.empty()) {
+                out.append("\033[0m");
+                term_style.clear();
+            }
+            out.append("\033[K");
+        }
+    }
+
+    if (!out.empty()) {
+        if (!term_style.empty()) {
+            out.append("\033[0m");
+        }
+        // Leave the cursor below the frame, where a plain print would have.
+        append_cursor_move(&out, std::min(static_cast<int>(new_rows.size()), height - 1), 0);
+        write_all(fd, out);
+    }
+
+    screen->rows.swap(screen->next);
+    screen->last_bytes = out.size();
+    return out.size();
+}
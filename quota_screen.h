@@ -0,0 +1,61 @@
+#ifndef QUOTA_SCREEN_H
+#define QUOTA_SCREEN_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Differential Terminal Renderer
+// ============================================================================
+//
+// The refresh loops render a whole frame as plain text with embedded SGR color
+// sequences. Instead of clearing the screen and resending all of it, the frame
+// is parsed into a grid of cells and compared with the previous one; only the
+// cursor moves, style changes and changed spans are written, in a single
+// write(). The first frame (and the first one after a resize) clears the screen
+// and is drawn in full.
+//
+// Assumptions that hold for this program's renderers: every code point is one
+// column wide and the only escape sequences in a frame are SGR (ESC [ ... m).
+// Anything past the screen width or height is clipped.
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+struct ScreenCell {
+    std::string glyph;          // one UTF-8 encoded code point
+    std::string style;          // SGR sequences in effect ("" = default)
+
+    bool operator==(const ScreenCell& other) const {
+        return glyph == other.glyph && style == other.style;
+    }
+    bool operator!=(const ScreenCell& other) const { return !(*this == other); }
+};
+
+struct TermScreen {
+    int width = 0;
+    int height = 0;
+    bool valid = false;                         // rows match the terminal
+    std::vector<std::vector<ScreenCell>> rows;  // frame currently on screen
+    std::vector<std::vector<ScreenCell>> next;  // scratch for the new frame
+    std::string out;                            // reused output buffer
+    size_t last_bytes = 0;                      // bytes written by the last present
+};
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// Set the terminal size; a change forces a full redraw on the next present
+void screen_resize(TermScreen* screen, int width, int height);
+
+// Forget what is on screen (something else wrote to the terminal)
+void screen_invalidate(TermScreen* screen);
+
+// Draw frame (lines separated by '\n') on fd, sending only what changed since
+// the previous call. Returns the number of bytes written.
+size_t screen_present(TermScreen* screen, const std::string& frame, int fd);
+
+#endif // QUOTA_SCREEN_H
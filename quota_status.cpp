@@ -0,0 +1,170 @@
+#include "quota_status.h"
+
+#include <cstdio>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+enum class StatusLevel {
+    Normal,         // below 50%
+    Warning,        // below 80%
+    Critical,
+    Error,          // fetch failed
+};
+
+// Same thresholds as the terminal bars
+static StatusLevel level_for(const QuotaData* data) {
+    if (!data) return StatusLevel::Error;
+    if (data->percentage < 50.0) return StatusLevel::Normal;
+    if (data->percentage < 80.0) return StatusLevel::Warning;
+    return StatusLevel::Critical;
+}
+
+static const char* level_hex(StatusLevel level) {
+    switch (level) {
+        case StatusLevel::Normal: return "#4caf50";
+        case StatusLevel::Warning: return "#ffc107";
+        case StatusLevel::Critical: return "#f44336";
+        case StatusLevel::Error: return "#f44336";
+    }
+    return "#ffffff";
+}
+
+static const char* level_tmux(StatusLevel level) {
+    switch (level) {
+        case StatusLevel::Normal: return "green";
+        case StatusLevel::Warning: return "yellow";
+        default: return "red";
+    }
+}
+
+static const char* level_class(StatusLevel level) {
+    switch (level) {
+        case StatusLevel::Normal: return "normal";
+        case StatusLevel::Warning: return "warning";
+        case StatusLevel::Critical: return "critical";
+        case StatusLevel::Error: return "error";
+    }
+    return "normal";
+}
+
+// "Q 63% 2h10m" (countdown only with an active window), "Q ERR" on failure
+static void append_text(std::string* out, const QuotaData* data, time_t now, bool with_label) {
+    if (with_label) {
+        out->append("Q ");
+    }
+    if (!data) {
+        out->append("ERR");
+        return;
+    }
+
+    char pct[16];
+    std::snprintf(pct, sizeof(pct), "%.0f%%", data->percentage);
+    out->append(pct);
+
+    time_t reset_utc = 0;
+    if (parse_iso8601_utc_to_time_t(data->reset_time, &reset_utc)) {
+        out->push_back(' ');
+        out->append(format_duration_tight(static_cast<int64_t>(difftime(reset_utc, now))));
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool parse_status_format(const std::string& name, StatusFormat* out) {
+    if (name == "i3bar" || name == "swaybar") {
+        *out = StatusFormat::I3bar;
+    } else if (name == "waybar") {
+        *out = StatusFormat::Waybar;
+    } else if (name == "polybar" || name == "lemonbar") {
+        *out = StatusFormat::Polybar;
+    } else if (name == "tmux") {
+        *out = StatusFormat::Tmux;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const std::string& status_format_line(StatusWriter* w, const QuotaData* data, const char* error, time_t now) {
+    const StatusLevel level = level_for(data);
+    std::string& line = w->line;
+    line.clear();
+
+    switch (w->format) {
+        case StatusFormat::I3bar: {
+            // Header and the opening bracket of the infinite array come first;
+            // every later block array is comma-prefixed.
+            if (!w->started) {
+                line.append("{\"version\":1}\n[\n");
+            } else {
+                line.push_back(',');
+            }
+
+            std::string text;
+            append_text(&text, data, now, true);
+            std::string short_text;
+            append_text(&short_text, data, now, false);
+
+            jsonl_begin(&w->json);
+            jsonl_field_string(&w->json, "name", "firmware_quota");
+            jsonl_field_string(&w->json, "full_text", text.c_str());
+            jsonl_field_string(&w->json, "short_text", short_text.c_str());
+            jsonl_field_string(&w->json, "color", level_hex(level));
+            if (level == StatusLevel::Critical || level == StatusLevel::Error) {
+                jsonl_field_bool(&w->json, "urgent", true);
+            }
+            jsonl_end(&w->json);
+            line.push_back('[');
+            line.append(w->json.buf);
+            line.push_back(']');
+            break;
+        }
+
+        case StatusFormat::Waybar: {
+            std::string text;
+            append_text(&text, data, now, false);
+
+            std::string tooltip;
+            if (data) {
+                char pct[64];
+                std::snprintf(pct, sizeof(pct), "Firmware quota: %.2f%% used", data->percentage);
+                tooltip = pct;
+                if (data->reset_time != "N/A") {
+                    tooltip += "\nResets at " + format_timestamp(data->reset_time);
+                }
+            } else {
+                tooltip = std::string("Firmware quota: ") + (error ? error : "fetch failed");
+            }
+
+            jsonl_begin(&w->json);
+            jsonl_field_string(&w->json, "text", text.c_str());
+            jsonl_field_string(&w->json, "tooltip", tooltip.c_str());
+            jsonl_field_string(&w->json, "class", level_class(level));
+            if (data) {
+                jsonl_field_int(&w->json, "percentage", static_cast<int64_t>(data->percentage + 0.5));
+            }
+            jsonl_end(&w->json);
+            line.append(w->json.buf);
+            break;
+        }
+
+        case StatusFormat::Polybar:
+            line.append("%{F").append(level_hex(level)).append("}");
+            append_text(&line, data, now, true);
+            line.append("%{F-}");
+            break;
+
+        case StatusFormat::Tmux:
+            line.append("#[fg=").append(level_tmux(level)).append("]");
+            append_text(&line, data, now, true);
+            line.append("#[default]");
+            break;
+    }
+
+    w->started = true;
+    return line;
+}
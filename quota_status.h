@@ -0,0 +1,52 @@
+#ifndef QUOTA_STATUS_H
+#define QUOTA_STATUS_H
+
+#include "quota_common.h"
+#include "quota_jsonl.h"
+
+// ============================================================================
+// Status Bar Output
+// ============================================================================
+//
+// Formatters for --status: the refresh loop writes one preformatted line per
+// update to stdout for a status bar to read from a long-lived process:
+//
+//   i3bar    i3bar/swaybar JSON protocol: header, then an infinite array
+//            with one block array per update
+//   waybar   waybar custom module, return-type json: one object per line
+//   polybar  polybar/lemonbar %{F#rrggbb} format string (tail = true)
+//   tmux     #[fg=...] string (e.g. piped into `tmux set -g @quota`)
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+enum class StatusFormat {
+    I3bar,
+    Waybar,
+    Polybar,
+    Tmux,
+};
+
+struct StatusWriter {
+    StatusFormat format = StatusFormat::Waybar;
+    bool started = false;       // first line written (i3bar header sent)
+    JsonlWriter json;
+    std::string line;
+
+    StatusWriter() { line.reserve(256); }
+};
+
+// ============================================================================
+// Function Declarations
+// ============================================================================
+
+// "i3bar" (or "swaybar"), "waybar", "polybar" (or "lemonbar"), "tmux"
+bool parse_status_format(const std::string& name, StatusFormat* out);
+
+// Format one update (no trailing newline); data == nullptr reports error.
+// The first i3bar line carries the protocol header. The returned reference
+// stays valid until the next call on the same writer.
+const std::string& status_format_line(StatusWriter* w, const QuotaData* data, const char* error, time_t now);
+
+#endif // QUOTA_STATUS_H
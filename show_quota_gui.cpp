@@ -7,6 +7,11 @@
 // =============================================================================
 
 #include "quota_common.h"
+#include "quota_push.h"
+#include "quota_dbus.h"
+#include "quota_ticker.h"
+#include "quota_retry.h"
+#include "quota_capture.h"
 #include <algorithm>
 #include <libgen.h>
 #include <linux/limits.h>
@@ -17,6 +22,10 @@ extern "C" {
 #include <libnotify/notify.h>
 }
 #include <pthread.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 // ============================================================================
 // GUI Types and Structures
@@ -24,7 +33,23 @@ extern "C" {
 
 // Single resizable window mode with 150px default width (140px minimum).
 
+// Optional localhost push endpoint (--serve)
+static PushServer* g_push_server = nullptr;
+
 // Structure to hold GUI state
+// One monitored key in --key-file mode
+struct GUIAccount {
+    std::string name;
+    std::string api_key;
+    std::string token;
+    std::string log_file;
+    std::optional<AuthMethod> preferred_auth_method;
+    bool ok = false;
+    QuotaData quota = {0.0, 0.0, "", 0};
+    std::string event;
+    std::string error;
+};
+
 struct GUIState {
     // GTK Widgets
     GtkWidget* window;
@@ -63,6 +88,11 @@ struct GUIState {
     int refresh_interval;
     int bar_height_multiplier;  // Progress bar height multiplier (1x, 2x, 3x, 4x)
     std::optional<AuthMethod> preferred_auth_method;
+    RequestTimeouts timeouts;   // saved budgets; FIRMWARE_*TIMEOUT / --timeout win
+    RequestTransport transport; // saved endpoint/proxy/...; FIRMWARE_* / --url etc. win
+
+    // Multi-account mode (--key-file); empty when monitoring a single key
+    std::vector<GUIAccount> accounts;
 
     // Current Data
     QuotaData current_quota;
@@ -70,10 +100,19 @@ struct GUIState {
     bool have_prev_percentage;
     std::string event_type;
 
+    // Rendered usage bar, repainted on new data, resize or theme change
+    cairo_surface_t* usage_bar_cache;
+    int usage_bar_cache_w;
+    int usage_bar_cache_h;
+    bool usage_bar_cache_dark;
+    bool usage_bar_cache_valid;
+
     // Update Timer
     guint timer_id;
-    guint countdown_timer_id;
+    UiTicker* countdown_ticker;     // refresh countdown label, paused while hidden
     gint64 next_refresh_us;
+    RetryState retry;               // backoff / circuit breaker after failed fetches
+    gulong network_handler;         // GNetworkMonitor::network-changed
 
     // Window State
     int window_x;
@@ -104,7 +143,9 @@ struct GUIState {
                   barwidth_1x_item(nullptr), barwidth_2x_item(nullptr),
                   barwidth_3x_item(nullptr), barwidth_4x_item(nullptr),
                   logging_enabled(true), refresh_interval(15), bar_height_multiplier(1),
-                  timer_id(0), countdown_timer_id(0), next_refresh_us(0), window_x(-1), window_y(-1), window_w(-1), window_visible(true),
+                  usage_bar_cache(nullptr), usage_bar_cache_w(0), usage_bar_cache_h(0),
+                  usage_bar_cache_dark(false), usage_bar_cache_valid(false),
+                  timer_id(0), countdown_ticker(nullptr), next_refresh_us(0), network_handler(0), window_x(-1), window_y(-1), window_w(-1), window_visible(true),
                   always_on_top(false), window_decorated(true), dark_mode(false),
                   restore_x(-1), restore_y(-1), restore_w(-1),
                   have_restore_pos(false), have_restore_size(false), restoring(false) {
@@ -118,24 +159,46 @@ struct GUIState {
     }
 };
 
+// Session bus export (org.firmware.Quota); nullptr with --no-dbus
+static QuotaDbusService* g_dbus_service = nullptr;
+
+// --timings: print the transport and each fetch's phase timings on stderr
+static bool g_timings = false;
+
+// Timer for a delay in clock seconds: whole seconds batched by GLib on the
+// real clock, a precise real-time equivalent on a simulated one
+static guint add_clock_timeout(int seconds, GSourceFunc fn, gpointer data) {
+    if (!clock_simulated()) {
+        return g_timeout_add_seconds(seconds, fn, data);
+    }
+    return g_timeout_add((guint)clock_real_ms(seconds), fn, data);
+}
+
 static void update_refresh_countdown_label(GUIState* state) {
     if (!state || !state->refresh_countdown_label) return;
 
-    const gint64 now = g_get_monotonic_time();
+    const gint64 now = clock_monotonic_us();
     gint64 remaining_us = state->next_refresh_us - now;
     if (remaining_us < 0) remaining_us = 0;
     int remaining_s = (int)((remaining_us + 999999) / 1000000);
 
+    if (retry_waiting(&state->retry)) {
+        gtk_label_set_text(GTK_LABEL(state->refresh_countdown_label),
+                           retry_describe(&state->retry, remaining_s).c_str());
+        return;
+    }
+    if (capture_replaying() && capture_replay_delay_ms() < 0) {
+        gtk_label_set_text(GTK_LABEL(state->refresh_countdown_label), "Replay done");
+        return;
+    }
+
     char buf[32];
     snprintf(buf, sizeof(buf), "%ds", remaining_s);
     gtk_label_set_text(GTK_LABEL(state->refresh_countdown_label), buf);
 }
 
-static gboolean on_countdown_tick(gpointer user_data) {
-    GUIState* state = (GUIState*)user_data;
-    if (!state) return G_SOURCE_REMOVE;
-    update_refresh_countdown_label(state);
-    return G_SOURCE_CONTINUE;
+static void on_countdown_tick(void* user_data) {
+    update_refresh_countdown_label((GUIState*)user_data);
 }
 
 static double clamp_pct(double v) {
@@ -166,15 +229,67 @@ static void color_for_usage_pct(double pct, double* r, double* g, double* b) {
     *b = 0x36 / 255.0;
 }
 
-static gboolean on_usage_bar_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
-    GUIState* state = (GUIState*)user_data;
-    if (!state) return FALSE;
+// Multi-account variant: one thin labelled bar per account, stacked.
+static void draw_account_bars(GUIState* state, cairo_t* cr, int w, int h) {
+    const int n = (int)state->accounts.size();
+    const double gap = 2.0;
+    const double row_h = std::max(1.0, ((double)h - gap * (n - 1)) / n);
 
-    GtkAllocation a;
-    gtk_widget_get_allocation(widget, &a);
-    const int w = a.width;
-    const int h = a.height;
-    if (w <= 0 || h <= 0) return FALSE;
+    cairo_set_source_rgba(cr, 0, 0, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    for (int i = 0; i < n; i++) {
+        const GUIAccount& acct = state->accounts[i];
+        const double y = i * (row_h + gap);
+        const double pct = clamp_pct(acct.quota.percentage);
+
+        // Trough
+        if (state->dark_mode) {
+            cairo_set_source_rgb(cr, 0x2b / 255.0, 0x2d / 255.0, 0x31 / 255.0);
+        } else {
+            cairo_set_source_rgb(cr, 0xe5 / 255.0, 0xe7 / 255.0, 0xeb / 255.0);
+        }
+        cairo_rectangle(cr, 0, y, w, row_h);
+        cairo_fill(cr);
+
+        // Fill (faded when the last fetch for this account failed)
+        double r = 0.0, g = 0.0, b = 0.0;
+        color_for_usage_pct(pct, &r, &g, &b);
+        cairo_set_source_rgba(cr, r, g, b, acct.ok ? 1.0 : 0.4);
+        cairo_rectangle(cr, 0, y, w * (pct / 100.0), row_h);
+        cairo_fill(cr);
+
+        // Label, only when the row is tall enough to read
+        if (row_h >= 9.0) {
+            char label[128];
+            if (acct.ok || acct.quota.timestamp > 0) {
+                snprintf(label, sizeof(label), "%s %.0f%%%s", acct.name.c_str(), acct.quota.percentage,
+                         acct.ok ? "" : " (stale)");
+            } else {
+                snprintf(label, sizeof(label), "%s error", acct.name.c_str());
+            }
+            cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+            cairo_set_font_size(cr, std::min(12.0, row_h * 0.75));
+            cairo_font_extents_t fe;
+            cairo_font_extents(cr, &fe);
+            if (state->dark_mode) {
+                cairo_set_source_rgb(cr, 0.95, 0.95, 0.95);
+            } else {
+                cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
+            }
+            cairo_move_to(cr, 4.0, y + (row_h + fe.ascent - fe.descent) / 2.0);
+            cairo_show_text(cr, label);
+        }
+    }
+}
+
+static void paint_usage_bar(GUIState* state, cairo_t* cr, int w, int h) {
+    if (state->accounts.size() > 1) {
+        draw_account_bars(state, cr, w, h);
+        return;
+    }
 
     const double pct = clamp_pct(state->current_quota.percentage);
     const double prev = state->have_prev_percentage ? clamp_pct(state->prev_percentage) : pct;
@@ -279,7 +394,43 @@ static gboolean on_usage_bar_draw(GtkWidget* widget, cairo_t* cr, gpointer user_
     cairo_set_line_width(cr, 1.0);
     cairo_rectangle(cr, x0 + 0.5, y0 + 0.5, std::max(0.0, bw - 1.0), std::max(0.0, bh - 1.0));
     cairo_stroke(cr);
+}
+
+// The bar is only repainted into its cache when the data, the size or the
+// theme changed; other expose events (window moves, countdown label updates,
+// overlapping windows) just blit the cached surface.
+static gboolean on_usage_bar_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    if (!state) return FALSE;
+
+    GtkAllocation a;
+    gtk_widget_get_allocation(widget, &a);
+    const int w = a.width;
+    const int h = a.height;
+    if (w <= 0 || h <= 0) return FALSE;
+
+    if (state->usage_bar_cache && (state->usage_bar_cache_w != w || state->usage_bar_cache_h != h)) {
+        cairo_surface_destroy(state->usage_bar_cache);
+        state->usage_bar_cache = nullptr;
+    }
+    if (!state->usage_bar_cache) {
+        state->usage_bar_cache = gdk_window_create_similar_surface(gtk_widget_get_window(widget),
+                                                                   CAIRO_CONTENT_COLOR_ALPHA, w, h);
+        state->usage_bar_cache_w = w;
+        state->usage_bar_cache_h = h;
+        state->usage_bar_cache_valid = false;
+    }
+    if (!state->usage_bar_cache_valid || state->usage_bar_cache_dark != state->dark_mode) {
+        cairo_t* bar_cr = cairo_create(state->usage_bar_cache);
+        paint_usage_bar(state, bar_cr, w, h);
+        cairo_destroy(bar_cr);
+        state->usage_bar_cache_dark = state->dark_mode;
+        state->usage_bar_cache_valid = true;
+    }
 
+    cairo_set_source_surface(cr, state->usage_bar_cache, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
     return FALSE;
 }
 
@@ -288,11 +439,14 @@ static gboolean on_usage_bar_draw(GtkWidget* widget, cairo_t* cr, gpointer user_
 // ============================================================================
 
 static GtkWidget* create_main_window(GUIState* state);
-static void update_gui_widgets(GUIState* state, const QuotaData* data);
+static void update_gui_widgets(GUIState* state, const QuotaData* data, bool redraw_bar);
 static void update_tray_display(GUIState* state, const QuotaData* data);
 static void show_desktop_notification(const std::string& event, double percentage);
 static void save_gui_state(const GUIState* state);
 static gboolean on_timer_update(gpointer user_data);
+static void schedule_retry(GUIState* state, int delay_s);
+static void schedule_replay(GUIState* state);
+static void refresh_now(GUIState* state);
 static void on_tray_reset_position(GtkMenuItem* item, gpointer user_data);
 static gboolean on_window_map(GtkWidget* widget, GdkEvent* event, gpointer user_data);
 static void on_toggle_autostart(GtkCheckMenuItem* item, gpointer user_data);
@@ -435,6 +589,23 @@ static gboolean on_window_delete(GtkWidget* widget, GdkEvent* event, gpointer us
     return TRUE;  // Prevent default destroy
 }
 
+// Pause the countdown tick while the window is unmapped (hidden to tray) or
+// minimized; it catches up as soon as the window is shown again.
+static gboolean on_window_visibility_event(GtkWidget* widget, GdkEvent* event, gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    if (!state || !event) return FALSE;
+
+    bool visible = gtk_widget_get_mapped(widget);
+    if (event->type == GDK_UNMAP) {
+        visible = false;
+    } else if (event->type == GDK_WINDOW_STATE) {
+        const GdkWindowState ws = event->window_state.new_window_state;
+        visible = visible && !(ws & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN));
+    }
+    ui_ticker_set_visible(state->countdown_ticker, visible);
+    return FALSE;
+}
+
 // Window configure event handler - track position
 static gboolean on_window_configure(GtkWidget* widget, GdkEventConfigure* event, gpointer user_data) {
     (void)widget;
@@ -950,13 +1121,13 @@ static void change_refresh_rate(GUIState* state, int new_interval) {
     }
 
     // Create new timer with new interval
-    state->timer_id = g_timeout_add(
-        new_interval * 1000,
+    state->timer_id = add_clock_timeout(
+        new_interval,
         on_timer_update,
         state
     );
 
-    state->next_refresh_us = g_get_monotonic_time() + (gint64)new_interval * 1000000;
+    state->next_refresh_us = clock_monotonic_us() + (gint64)new_interval * 1000000;
     update_refresh_countdown_label(state);
 
     // Save preference
@@ -1064,7 +1235,7 @@ static void change_bar_height(GUIState* state, int multiplier) {
 
     // Update with current data
     if (state->current_quota.timestamp > 0) {
-        update_gui_widgets(state, &state->current_quota);
+        update_gui_widgets(state, &state->current_quota, true);
         update_tray_display(state, &state->current_quota);
     }
 
@@ -1227,6 +1398,9 @@ static GtkWidget* create_main_window(GUIState* state) {
     g_signal_connect(window, "delete-event", G_CALLBACK(on_window_delete), state);
     g_signal_connect(window, "configure-event", G_CALLBACK(on_window_configure), state);
     g_signal_connect(window, "map-event", G_CALLBACK(on_window_map), state);
+    g_signal_connect(window, "map-event", G_CALLBACK(on_window_visibility_event), state);
+    g_signal_connect(window, "unmap-event", G_CALLBACK(on_window_visibility_event), state);
+    g_signal_connect(window, "window-state-event", G_CALLBACK(on_window_visibility_event), state);
     g_signal_connect(window, "button-press-event", G_CALLBACK(on_window_button_press), state);
     gtk_widget_add_events(window, GDK_BUTTON_PRESS_MASK);
 
@@ -1474,7 +1648,8 @@ static void show_desktop_notification(const std::string& event, double percentag
 // ============================================================================
 
 // Update GUI widgets with quota data
-static void update_gui_widgets(GUIState* state, const QuotaData* data) {
+// redraw_bar is false when only the fetch time changed (the bar is current)
+static void update_gui_widgets(GUIState* state, const QuotaData* data, bool redraw_bar) {
     // Usage bar is a custom drawn widget; redraw after updating state below.
 
     // Update usage label with time remaining
@@ -1482,7 +1657,7 @@ static void update_gui_widgets(GUIState* state, const QuotaData* data) {
     if (data->reset_time != "N/A" && !data->reset_time.empty()) {
         time_t reset_utc;
         if (parse_iso8601_utc_to_time_t(data->reset_time, &reset_utc)) {
-            time_t now = time(nullptr);
+            time_t now = clock_now();
             int64_t remaining = static_cast<int64_t>(difftime(reset_utc, now));
             if (remaining < 0) remaining = 0;
 
@@ -1513,10 +1688,34 @@ static void update_gui_widgets(GUIState* state, const QuotaData* data) {
         gtk_label_set_text(GTK_LABEL(state->timestamp_label), timestamp_text);
     }
 
+    // Multi-account: one summary line per account instead.
+    if (!state->accounts.empty()) {
+        std::string summary;
+        for (const GUIAccount& acct : state->accounts) {
+            char line[256];
+            if (!acct.ok) {
+                snprintf(line, sizeof(line), "%s: error", acct.name.c_str());
+            } else {
+                time_t reset_utc;
+                if (parse_iso8601_utc_to_time_t(acct.quota.reset_time, &reset_utc)) {
+                    int64_t remaining = static_cast<int64_t>(difftime(reset_utc, clock_now()));
+                    snprintf(line, sizeof(line), "%s: %.2f%% - Reset in %s", acct.name.c_str(),
+                             acct.quota.percentage, format_duration_compact(remaining).c_str());
+                } else {
+                    snprintf(line, sizeof(line), "%s: %.2f%%", acct.name.c_str(), acct.quota.percentage);
+                }
+            }
+            if (!summary.empty()) summary += "\n";
+            summary += line;
+        }
+        gtk_label_set_text(GTK_LABEL(state->usage_label), summary.c_str());
+    }
+
     // Store current data
     state->current_quota = *data;
 
-    if (state->usage_progress) {
+    if (state->usage_progress && redraw_bar) {
+        state->usage_bar_cache_valid = false;
         gtk_widget_queue_draw(state->usage_progress);
     }
 }
@@ -1531,7 +1730,7 @@ static void update_tray_display(GUIState* state, const QuotaData* data) {
     if (data->reset_time != "N/A" && !data->reset_time.empty()) {
         time_t reset_utc;
         if (parse_iso8601_utc_to_time_t(data->reset_time, &reset_utc)) {
-            time_t now = time(nullptr);
+            time_t now = clock_now();
             int64_t remaining = static_cast<int64_t>(difftime(reset_utc, now));
             std::string duration_str = format_duration_compact(remaining);
             snprintf(tooltip, sizeof(tooltip),
@@ -1552,6 +1751,23 @@ static void update_tray_display(GUIState* state, const QuotaData* data) {
                  state->refresh_interval);
     }
 
+    // Multi-account: aggregated view (highest usage first line, then all).
+    if (!state->accounts.empty()) {
+        std::string agg = "Firmware Quota: " + std::to_string((int)std::lround(data->percentage)) + "% max";
+        for (const GUIAccount& acct : state->accounts) {
+            char line[160];
+            if (acct.ok) {
+                snprintf(line, sizeof(line), "\n%s: %.1f%%", acct.name.c_str(), acct.quota.percentage);
+            } else {
+                snprintf(line, sizeof(line), "\n%s: error", acct.name.c_str());
+            }
+            agg += line;
+        }
+        agg += "\nRefresh: " + std::to_string(state->refresh_interval) + "s";
+        app_indicator_set_title(state->indicator, agg.c_str());
+        return;
+    }
+
     app_indicator_set_title(state->indicator, tooltip);
 }
 
@@ -1576,44 +1792,156 @@ static void show_error_in_gui(GUIState* state, const char* message) {
 }
 
 // ============================================================================
-// Background Fetch Thread
+// Background Fetch Worker
 // ============================================================================
+//
+// One long-lived thread serves every refresh. Requests go through a single
+// slot: asking again while a fetch is in flight replaces the pending request
+// (at most one follow-up fetch), so a stalled network cannot pile up threads.
+// The worker never reads GUIState; everything it needs travels in the request
+// or in the atomically published auth snapshot.
 
 // Structure for passing data between threads
 struct FetchThreadData {
-    GUIState* state;
+    GUIState* state;        // only dereferenced on the main thread
     RequestResult result;
     bool success;
     QuotaData quota_data;
     std::string event;
     std::optional<AuthMethod> used_method;
     std::string error_message;
+    std::string log_file;   // empty when logging is disabled
+    long rate_limit_s = -1; // server-requested delay, -1 when not throttled
+    QuotaData previous;     // state->current_quota when the fetch was queued
+    bool unchanged = false; // same response as before: previous reused, nothing parsed
+
+    // Multi-account mode: snapshot of state->accounts, updated by the thread
+    std::vector<GUIAccount> accounts;
 };
 
+// Credentials for the single-key fetch, replaced as a whole whenever the
+// preferred method changes
+struct FetchAuth {
+    std::string api_key;
+    std::string token;
+    std::optional<AuthMethod> preferred_method;
+};
+
+struct FetchWorker {
+    pthread_t thread;
+    bool running = false;
+    std::mutex mu;
+    std::condition_variable cv;
+    FetchThreadData* pending = nullptr;     // single slot, newest request wins
+    std::atomic<bool> quit{false};
+    std::shared_ptr<const FetchAuth> auth;  // std::atomic_load/atomic_store only
+};
+
+static FetchWorker g_fetch_worker;
+
 // Forward declaration
 static gboolean on_fetch_complete(gpointer user_data);
 
-// Background thread for fetching quota data
-static void* fetch_quota_thread(void* arg) {
-    FetchThreadData* data = (FetchThreadData*)arg;
-    GUIState* state = data->state;
+// Fetch every account concurrently. The headline sample (quota_data/event)
+// is the account closest to its limit.
+static void fetch_accounts(FetchThreadData* data) {
+    std::vector<AuthJob> jobs(data->accounts.size());
+    for (size_t i = 0; i < data->accounts.size(); i++) {
+        jobs[i].api_key = data->accounts[i].api_key;
+        jobs[i].token = data->accounts[i].token;
+        jobs[i].preferred_method = data->accounts[i].preferred_auth_method;
+    }
+
+    try_auth_methods_concurrent(jobs);
+
+    data->success = false;
+    bool all_unchanged = true;
+    for (size_t i = 0; i < data->accounts.size(); i++) {
+        GUIAccount& acct = data->accounts[i];
+        acct.preferred_auth_method = jobs[i].preferred_method;
+        acct.event.clear();
+
+        if (g_timings) {
+            std::cerr << "Timings: " << acct.name << "  " << format_request_timings(jobs[i].result.timings)
+                      << std::endl;
+        }
+
+        long throttle_s = 0;
+        if (request_rate_limited(jobs[i].result, &throttle_s)) {
+            data->rate_limit_s = std::max(data->rate_limit_s, throttle_s);
+            if (!acct.log_file.empty()) {
+                write_log_rate_limited(acct.log_file, jobs[i].result, throttle_s);
+            }
+        }
+
+        // Unchanged body: keep the account's sample (no parse, no event)
+        const bool reuse = jobs[i].result.unchanged && acct.ok && acct.quota.timestamp > 0;
+        if (reuse) {
+            acct.quota.timestamp = clock_now();
+        } else {
+            acct.ok = parse_quota_result(jobs[i].result, &acct.quota, &acct.error);
+            all_unchanged = false;
+        }
+        if (!acct.ok) {
+            if (data->error_message.empty()) {
+                data->error_message = acct.name + ": " + acct.error;
+            }
+            continue;
+        }
+
+        if (reuse) {
+            if (!acct.log_file.empty() && log_heartbeat_due(acct.log_file, acct.quota.timestamp)) {
+                write_log_entry(acct.log_file, acct.quota, "UPDATE");
+            }
+        } else if (!acct.log_file.empty()) {
+            QuotaData previous = read_last_log_entry(acct.log_file);
+            acct.event = detect_event(acct.quota, previous);
+            write_log_entry(acct.log_file, acct.quota, acct.event);
+        }
+
+        if (!data->success || acct.quota.percentage > data->quota_data.percentage) {
+            data->quota_data = acct.quota;
+            data->event = acct.event;
+        }
+        data->success = true;
+    }
+    data->unchanged = data->success && all_unchanged;
+}
+
+// Fetch one request on the worker thread and hand it to the main loop
+static void run_fetch(FetchThreadData* data) {
+    if (!data->accounts.empty()) {
+        fetch_accounts(data);
+        g_idle_add(on_fetch_complete, data);
+        return;
+    }
 
     // Perform HTTP request (reuse existing code)
+    const std::shared_ptr<const FetchAuth> auth = std::atomic_load(&g_fetch_worker.auth);
+    std::optional<AuthMethod> preferred = auth->preferred_method;
     data->result = try_auth_methods(
-        state->api_key,
-        state->token,
-        state->preferred_auth_method,
+        auth->api_key,
+        auth->token,
+        preferred,
         &data->used_method
     );
+    if (g_timings) {
+        std::cerr << "Timings: " << format_request_timings(data->result.timings) << std::endl;
+    }
+
+    long throttle_s = 0;
+    if (request_rate_limited(data->result, &throttle_s)) {
+        data->rate_limit_s = throttle_s;
+        if (!data->log_file.empty()) {
+            write_log_rate_limited(data->log_file, data->result, throttle_s);
+        }
+    }
 
     if (data->result.curl_code != CURLE_OK) {
         data->success = false;
-        data->error_message = std::string("Request failed: ") + curl_easy_strerror(data->result.curl_code);
-        if (!data->result.curl_error.empty()) {
-            data->error_message += " (" + data->result.curl_error + ")";
-        }
+        data->error_message = describe_request_failure(data->result);
         g_idle_add(on_fetch_complete, data);
-        return nullptr;
+        return;
     }
 
     if (!is_http_success(data->result.http_code)) {
@@ -1623,7 +1951,21 @@ static void* fetch_quota_thread(void* arg) {
             data->error_message += "\n" + truncate_for_display(data->result.body, 300);
         }
         g_idle_add(on_fetch_complete, data);
-        return nullptr;
+        return;
+    }
+
+    // Unchanged body: the previous sample stands (no parse, no event); the
+    // log only gets a heartbeat row now and then
+    if (data->result.unchanged && data->previous.timestamp > 0) {
+        data->quota_data = data->previous;
+        data->quota_data.timestamp = clock_now();
+        if (!data->log_file.empty() && log_heartbeat_due(data->log_file, data->quota_data.timestamp)) {
+            write_log_entry(data->log_file, data->quota_data, "UPDATE");
+        }
+        data->unchanged = true;
+        data->success = true;
+        g_idle_add(on_fetch_complete, data);
+        return;
     }
 
     // Parse JSON (reuse existing code)
@@ -1634,7 +1976,7 @@ static void* fetch_quota_thread(void* arg) {
             data->success = false;
             data->error_message = "Failed to parse response (missing 'used').\n" + truncate_for_display(data->result.body, 300);
             g_idle_add(on_fetch_complete, data);
-            return nullptr;
+            return;
         }
 
         double used = j["used"].get<double>();
@@ -1643,13 +1985,13 @@ static void* fetch_quota_thread(void* arg) {
         data->quota_data.used = used;
         data->quota_data.percentage = used * 100.0;
         data->quota_data.reset_time = reset.empty() ? "N/A" : reset;
-        data->quota_data.timestamp = time(nullptr);
+        data->quota_data.timestamp = clock_now();
 
         // Detect event (reuse existing code)
-        if (state->logging_enabled && !state->log_file.empty()) {
-            QuotaData previous = read_last_log_entry(state->log_file);
+        if (!data->log_file.empty()) {
+            QuotaData previous = read_last_log_entry(data->log_file);
             data->event = detect_event(data->quota_data, previous);
-            write_log_entry(state->log_file, data->quota_data, data->event);
+            write_log_entry(data->log_file, data->quota_data, data->event);
         }
 
         data->success = true;
@@ -1666,31 +2008,133 @@ static void* fetch_quota_thread(void* arg) {
 
     // Schedule callback on main thread
     g_idle_add(on_fetch_complete, data);
+}
+
+static void* fetch_worker_main(void*) {
+    FetchWorker& w = g_fetch_worker;
+    for (;;) {
+        FetchThreadData* data = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(w.mu);
+            w.cv.wait(lock, [&w] { return w.pending != nullptr || w.quit.load(); });
+            if (w.quit.load()) break;
+            data = w.pending;
+            w.pending = nullptr;
+        }
+        run_fetch(data);
+    }
     return nullptr;
 }
 
+// Polled by libcurl during transfers: quitting cancels an in-flight fetch
+static bool fetch_worker_quitting() {
+    return g_fetch_worker.quit.load(std::memory_order_relaxed);
+}
+
+static void fetch_worker_publish_auth(const GUIState* state) {
+    auto auth = std::make_shared<FetchAuth>();
+    auth->api_key = state->api_key;
+    auth->token = state->token;
+    auth->preferred_method = state->preferred_auth_method;
+    std::atomic_store(&g_fetch_worker.auth, std::shared_ptr<const FetchAuth>(std::move(auth)));
+}
+
+static void fetch_worker_start(const GUIState* state) {
+    FetchWorker& w = g_fetch_worker;
+    fetch_worker_publish_auth(state);
+    set_request_abort_check(fetch_worker_quitting);
+    w.running = pthread_create(&w.thread, nullptr, fetch_worker_main, nullptr) == 0;
+    if (!w.running) {
+        std::cerr << "Error: Failed to start the fetch thread" << std::endl;
+    }
+}
+
+// Queue a fetch. A request still waiting in the slot is replaced.
+static void fetch_worker_request(FetchThreadData* data) {
+    FetchWorker& w = g_fetch_worker;
+    if (!w.running) {
+        delete data;
+        return;
+    }
+    FetchThreadData* replaced = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(w.mu);
+        replaced = w.pending;
+        w.pending = data;
+    }
+    delete replaced;
+    w.cv.notify_one();
+}
+
+// Cancel the in-flight transfer (if any) and join the worker. Results that
+// were still queued for the main loop are dropped with it.
+static void fetch_worker_stop() {
+    FetchWorker& w = g_fetch_worker;
+    if (!w.running) return;
+    {
+        std::lock_guard<std::mutex> lock(w.mu);
+        w.quit.store(true);
+    }
+    w.cv.notify_one();
+    pthread_join(w.thread, nullptr);
+    w.running = false;
+
+    delete w.pending;
+    w.pending = nullptr;
+}
+
 // GTK main thread callback after fetch completes
 static gboolean on_fetch_complete(gpointer user_data) {
     FetchThreadData* data = (FetchThreadData*)user_data;
 
+    // Copy back per-account results (auth cache, samples, errors).
+    if (!data->accounts.empty() && data->accounts.size() == data->state->accounts.size()) {
+        data->state->accounts = data->accounts;
+    }
+
     if (data->success) {
+        retry_on_success(&data->state->retry);
+
         // Update preferred auth method if changed
-        if (data->used_method.has_value()) {
+        if (data->used_method.has_value() && data->used_method != data->state->preferred_auth_method) {
             data->state->preferred_auth_method = data->used_method;
+            fetch_worker_publish_auth(data->state);
         }
 
-        // Capture previous value so the bar can highlight the increase.
-        if (data->state->current_quota.timestamp > 0) {
+        // Capture previous value so the bar can highlight the increase
+        // (an unchanged sample keeps the last highlight).
+        if (!data->unchanged && data->state->current_quota.timestamp > 0) {
             data->state->prev_percentage = data->state->current_quota.percentage;
             data->state->have_prev_percentage = true;
-        } else {
+        } else if (!data->unchanged) {
             data->state->prev_percentage = data->quota_data.percentage;
             data->state->have_prev_percentage = false;
         }
 
-        update_gui_widgets(data->state, &data->quota_data);
+        update_gui_widgets(data->state, &data->quota_data, !data->unchanged);
         update_tray_display(data->state, &data->quota_data);
 
+        if (g_dbus_service) {
+            time_t reset_utc = 0;
+            const int64_t reset_epoch =
+                parse_iso8601_utc_to_time_t(data->quota_data.reset_time, &reset_utc) ? (int64_t)reset_utc : -1;
+            quota_dbus_update(g_dbus_service, data->quota_data.percentage, reset_epoch,
+                              forecast_usage_at_reset(data->quota_data, clock_now()),
+                              (int64_t)data->quota_data.timestamp);
+        }
+
+        if (g_push_server && !data->accounts.empty()) {
+            JsonlWriter writer;
+            for (const GUIAccount& acct : data->accounts) {
+                if (!acct.ok) continue;
+                JsonlRecord rec = make_snapshot_record(acct.quota, acct.event.empty() ? "UPDATE" : acct.event);
+                rec.account = acct.name.c_str();
+                push_server_publish(g_push_server, jsonl_format_record(&writer, rec));
+            }
+        } else if (g_push_server) {
+            push_server_publish(g_push_server, format_snapshot_json(data->quota_data, data->event.empty() ? "UPDATE" : data->event));
+        }
+
         // Show notification for important events
         if (!data->event.empty() &&
             (data->event == "QUOTA_RESET" || data->event == "HIGH_USAGE")) {
@@ -1701,6 +2145,21 @@ static gboolean on_fetch_complete(gpointer user_data) {
     } else {
         const char* msg = data->error_message.empty() ? "Failed to fetch quota data" : data->error_message.c_str();
         show_error_in_gui(data->state, msg);
+        quota_dbus_set_error(g_dbus_service, msg);
+        if (data->rate_limit_s < 0) {
+            schedule_retry(data->state, retry_on_failure(&data->state->retry, data->state->refresh_interval));
+        }
+    }
+
+    // Throttled: wait what the server asked for, even after a usable answer
+    if (data->rate_limit_s >= 0) {
+        schedule_retry(data->state,
+                       retry_on_rate_limit(&data->state->retry, data->rate_limit_s, data->state->refresh_interval));
+    }
+
+    // --replay: the capture sets the pace instead of the interval and retries
+    if (capture_replaying()) {
+        schedule_replay(data->state);
     }
 
     delete data;
@@ -1712,25 +2171,86 @@ static gboolean on_timer_update(gpointer user_data) {
     GUIState* state = (GUIState*)user_data;
 
     // Track next refresh time for countdown display.
-    state->next_refresh_us = g_get_monotonic_time() + (gint64)state->refresh_interval * 1000000;
+    state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval * 1000000;
+    retry_attempt_started(&state->retry);
     update_refresh_countdown_label(state);
 
-    // Start fetch in background thread
+    // Hand the fetch to the worker (coalesced with one still waiting)
     FetchThreadData* data = new FetchThreadData();
     data->state = state;
     data->success = false;
-
-    pthread_t thread;
-    if (pthread_create(&thread, nullptr, fetch_quota_thread, data) == 0) {
-        pthread_detach(thread);
-        // Thread will call g_idle_add when done
-    } else {
-        delete data;
+    data->accounts = state->accounts;
+    data->previous = state->current_quota;
+    if (state->logging_enabled) {
+        data->log_file = state->log_file;
     }
+    fetch_worker_request(data);
 
     return G_SOURCE_CONTINUE;  // Keep timer running
 }
 
+// Fetch now and restart the periodic timer so the countdown stays accurate
+static void refresh_now(GUIState* state) {
+    if (state->timer_id > 0) {
+        g_source_remove(state->timer_id);
+    }
+    state->timer_id = add_clock_timeout(state->refresh_interval, on_timer_update, state);
+    on_timer_update(state);
+}
+
+static gboolean on_retry_timer(gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    state->timer_id = 0;
+    refresh_now(state);
+    return G_SOURCE_REMOVE;
+}
+
+// After a failed or throttled fetch: replace the periodic timer by one delay
+static void schedule_retry(GUIState* state, int delay_s) {
+    if (state->timer_id > 0) {
+        g_source_remove(state->timer_id);
+    }
+    state->timer_id = add_clock_timeout(delay_s, on_retry_timer, state);
+    state->next_refresh_us = clock_monotonic_us() + (gint64)delay_s * 1000000;
+    update_refresh_countdown_label(state);
+}
+
+static gboolean on_replay_timer(gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    state->timer_id = 0;
+    on_timer_update(state);
+    return G_SOURCE_REMOVE;
+}
+
+// --replay: one timer for the next recorded fetch; none after the last. The
+// recording already holds the retries, so the retry state stays clear.
+static void schedule_replay(GUIState* state) {
+    if (state->timer_id > 0) {
+        g_source_remove(state->timer_id);
+        state->timer_id = 0;
+    }
+    retry_on_success(&state->retry);
+    const long delay_ms = capture_replay_delay_ms();
+    if (delay_ms >= 0) {
+        state->timer_id = g_timeout_add((guint)delay_ms, on_replay_timer, state);
+        state->next_refresh_us = clock_monotonic_us() + (gint64)(clock_seconds(delay_ms) * 1000000);
+    }
+    update_refresh_countdown_label(state);
+}
+
+// Network back: a failing instance retries without waiting out the backoff
+static void on_network_changed(GNetworkMonitor*, gboolean available, gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    if (available && retry_on_connectivity(&state->retry)) {
+        refresh_now(state);
+    }
+}
+
+// D-Bus Refresh(): fetch now
+static void on_dbus_refresh(void* user_data) {
+    refresh_now((GUIState*)user_data);
+}
+
 // ============================================================================
 // State Persistence
 // ============================================================================
@@ -1791,6 +2311,18 @@ static void load_gui_state(GUIState* state) {
             if (state->bar_height_multiplier < 1 || state->bar_height_multiplier > 4) {
                 state->bar_height_multiplier = 2;  // Sanity check
             }
+        } else if (key == "connect_timeout") {
+            parse_timeout_seconds(value, &state->timeouts.connect_ms);
+        } else if (key == "first_byte_timeout") {
+            parse_timeout_seconds(value, &state->timeouts.first_byte_ms);
+        } else if (key == "timeout") {
+            parse_timeout_seconds(value, &state->timeouts.total_ms);
+        } else {
+            for (const TransportSetting& setting : kTransportSettings) {
+                if (key == setting.key) {
+                    set_transport_value(&state->transport, setting.key, value);
+                }
+            }
         }
         // Note: legacy gui_mode and mode_* keys are ignored for backwards compatibility
     }
@@ -1827,6 +2359,16 @@ static void save_gui_state(const GUIState* state) {
     file << "dark_mode=" << (state->dark_mode ? "1" : "0") << "\n";
     file << "refresh_interval=" << state->refresh_interval << "\n";
     file << "bar_height_multiplier=" << state->bar_height_multiplier << "\n";
+    file << "connect_timeout=" << state->timeouts.connect_ms / 1000.0 << "\n";
+    file << "first_byte_timeout=" << state->timeouts.first_byte_ms / 1000.0 << "\n";
+    file << "timeout=" << state->timeouts.total_ms / 1000.0 << "\n";
+    const RequestTransport default_transport;
+    for (const TransportSetting& setting : kTransportSettings) {
+        const std::string value = get_transport_value(state->transport, setting.key);
+        if (value != get_transport_value(default_transport, setting.key)) {
+            file << setting.key << "=" << value << "\n";
+        }
+    }
 
     file.close();
 }
@@ -1864,11 +2406,41 @@ static void print_usage(const char* program_name) {
     std::cerr << "  --refresh <seconds>  Initial refresh interval (default: 15)" << std::endl;
     std::cerr << "  --log <file>         Log quota changes to CSV file (default: ./show_quota.log)" << std::endl;
     std::cerr << "  --no-log             Disable logging" << std::endl;
+    std::cerr << "  --key-file <file>    Monitor several accounts (name=key per line), one bar each" << std::endl;
+    std::cerr << "  --no-dbus            Do not export org.firmware.Quota on the session bus" << std::endl;
+    std::cerr << "  --serve <port>       Stream snapshots on http://127.0.0.1:<port>/events (SSE) and /ndjson" << std::endl;
+    std::cerr << "  --hedge              Resend a fetch still pending at the recent p95 (at most 5% of fetches)" << std::endl;
+    std::cerr << "  --timeout <sec>      Give up on a refresh after N seconds (default: 15, 0 = no limit)" << std::endl;
+    std::cerr << "  --connect-timeout <sec>     Connection budget per attempt (default: 5)" << std::endl;
+    std::cerr << "  --first-byte-timeout <sec>  Budget for the first response byte per attempt (default: 10)" << std::endl;
+    std::cerr << "  --url <url>          API endpoint (default: " << kDefaultQuotaUrl << ")" << std::endl;
+    std::cerr << "  --proxy <url>        Proxy for API requests (default: https_proxy / no_proxy)" << std::endl;
+    std::cerr << "  --unix-socket <path> Connect through a Unix domain socket (e.g. a local sidecar)" << std::endl;
+    std::cerr << "  --cacert <file>      CA bundle for verifying the endpoint" << std::endl;
+    std::cerr << "  --http <1.1|2|3>     HTTP version (3 needs a libcurl built with HTTP/3)" << std::endl;
+    std::cerr << "  --resolve <host:port:addr>  Pin a host to an address (repeatable)" << std::endl;
+    std::cerr << "  --timings            Print the transport and each fetch's phase timings on stderr" << std::endl;
+    std::cerr << "  --record <file>      Save every API response to a capture file" << std::endl;
+    std::cerr << "  --replay <file>      Replay a capture instead of calling the API (no key needed)" << std::endl;
+    std::cerr << "  --replay-speed <x>   Replay pace: 1 = as recorded (default), N = N times faster, 0 = no waits" << std::endl;
+    std::cerr << "  --time-scale <x>     Simulated clock x times faster than real time (720: 5 h in 25 s)" << std::endl;
+    std::cerr << "  --time-start <t>     Simulated clock start, unix seconds or ISO 8601 UTC (default: now)" << std::endl;
     std::cerr << "  --help               Show this help message" << std::endl;
     std::cerr << std::endl;
     std::cerr << "API Key:" << std::endl;
     std::cerr << "  Can be passed as argument or set FIRMWARE_API_KEY environment variable" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "Timeouts:" << std::endl;
+    std::cerr << "  FIRMWARE_TIMEOUT, FIRMWARE_CONNECT_TIMEOUT and FIRMWARE_FIRST_BYTE_TIMEOUT (seconds)" << std::endl;
+    std::cerr << "  set the same budgets. Without either, the timeout, connect_timeout and" << std::endl;
+    std::cerr << "  first_byte_timeout keys of ~/.firmware_quota_gui.conf are used" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Transport:" << std::endl;
+    std::cerr << "  FIRMWARE_API_URL, FIRMWARE_PROXY, FIRMWARE_UNIX_SOCKET, FIRMWARE_CA_BUNDLE," << std::endl;
+    std::cerr << "  FIRMWARE_HTTP_VERSION and FIRMWARE_RESOLVE (comma-separated) set the same." << std::endl;
+    std::cerr << "  Without either, the api_url, proxy, unix_socket, ca_bundle, http_version and" << std::endl;
+    std::cerr << "  resolve keys of ~/.firmware_quota_gui.conf are used" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "Examples:" << std::endl;
     std::cerr << "  " << program_name << " fw_api_xxx" << std::endl;
     std::cerr << "  " << program_name << " --refresh 60 --log quota.csv" << std::endl;
@@ -1883,6 +2455,21 @@ int main(int argc, char* argv[]) {
     int refresh_interval = 15;
     std::string log_file = "show_quota.log";
     bool logging_enabled = true;
+    bool log_given = false;     // --log: also used on a simulated clock
+    bool dbus_enabled = true;
+    int serve_port = 0;
+    std::string key_file;
+    RequestTimeouts timeouts;
+    bool timeouts_overridden = apply_timeout_env(&timeouts);   // env or CLI (beats the config file)
+    RequestTransport transport;
+    bool transport_overridden = apply_transport_env(&transport);   // env or CLI (beats the config file)
+    std::string record_file;
+    std::string replay_file;
+    double replay_speed = 1.0;
+    apply_clock_env();
+    double time_scale = 0.0;    // --time-scale / --time-start: 0 / -1 = not given
+    time_t time_start = -1;
+    bool hedge = false;
 
     // Parse command-line arguments
     for (int i = 1; i < argc; i++) {
@@ -1903,6 +2490,7 @@ int main(int argc, char* argv[]) {
             if (i + 1 < argc) {
                 log_file = argv[++i];
                 logging_enabled = true;
+                log_given = true;
             } else {
                 std::cerr << "Error: --log requires a file path" << std::endl;
                 print_usage(argv[0]);
@@ -1910,6 +2498,83 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "--no-log") {
             logging_enabled = false;
+        } else if (arg == "--no-dbus") {
+            dbus_enabled = false;
+        } else if (arg == "--key-file") {
+            if (i + 1 < argc) {
+                key_file = argv[++i];
+            } else {
+                std::cerr << "Error: --key-file requires a file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--serve") {
+            char* end = nullptr;
+            const long port = (i + 1 < argc) ? std::strtol(argv[i + 1], &end, 10) : 0;
+            if (!end || end == argv[i + 1] || *end != '\0' || port < 1 || port > 65535) {
+                std::cerr << "Error: --serve requires a port 1-65535" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            serve_port = static_cast<int>(port);
+            i++;
+        } else if (arg == "--hedge") {
+            hedge = true;
+        } else if (arg == "--timeout" || arg == "--connect-timeout" || arg == "--first-byte-timeout") {
+            long* budget = (arg == "--timeout") ? &timeouts.total_ms
+                         : (arg == "--connect-timeout") ? &timeouts.connect_ms : &timeouts.first_byte_ms;
+            if (i + 1 < argc && parse_timeout_seconds(argv[i + 1], budget)) {
+                timeouts_overridden = true;
+                i++;
+            } else {
+                std::cerr << "Error: " << arg << " requires a number of seconds (0 = no limit)" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--record" || arg == "--replay") {
+            if (i + 1 < argc) {
+                (arg == "--record" ? record_file : replay_file) = argv[++i];
+            } else {
+                std::cerr << "Error: " << arg << " requires a file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--replay-speed") {
+            char* end = nullptr;
+            replay_speed = (i + 1 < argc) ? std::strtod(argv[i + 1], &end) : -1.0;
+            if (!end || end == argv[i + 1] || *end != '\0' || !(replay_speed >= 0.0)) {
+                std::cerr << "Error: --replay-speed requires a factor (1 = as recorded, 0 = no waits)" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (arg == "--time-scale") {
+            if (i + 1 < argc && parse_clock_rate(argv[i + 1], &time_scale)) {
+                i++;
+            } else {
+                std::cerr << "Error: --time-scale requires a factor > 0" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--time-start") {
+            if (i + 1 < argc && parse_clock_start(argv[i + 1], &time_start)) {
+                i++;
+            } else {
+                std::cerr << "Error: --time-start requires unix seconds or an ISO 8601 UTC time" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--timings") {
+            g_timings = true;
+        } else if (const TransportSetting* setting = find_transport_option(arg)) {
+            if (i + 1 < argc && set_transport_value(&transport, setting->key, argv[i + 1])) {
+                transport_overridden = true;
+                i++;
+            } else {
+                std::cerr << "Error: missing or invalid value for " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
         } else if (arg[0] != '-') {
             // Assume it's the API key
             api_key = arg;
@@ -1920,16 +2585,56 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    set_request_hedging(hedge);
+
+    if (!record_file.empty() && !replay_file.empty()) {
+        std::cerr << "Error: --record and --replay cannot be combined" << std::endl;
+        return 1;
+    }
+    if (time_scale > 0.0 || time_start >= 0) {
+        if (!replay_file.empty()) {
+            std::cerr << "Error: --replay runs the clock at the capture's pace; drop --time-scale/--time-start" << std::endl;
+            return 1;
+        }
+        clock_simulate(time_start >= 0 ? time_start : time(nullptr), time_scale > 0.0 ? time_scale : 1.0);
+    }
+    std::string capture_error;
+    if ((!record_file.empty() && !capture_record_open(record_file, &capture_error)) ||
+        (!replay_file.empty() && !capture_replay_open(replay_file, replay_speed, &capture_error))) {
+        std::cerr << "Error: " << capture_error << std::endl;
+        return 1;
+    }
+    // Simulated timestamps stay out of the live log (and so out of --follow
+    // readers and the history seed): log only to an explicit --log file
+    if (clock_simulated() && !log_given) {
+        logging_enabled = false;
+    }
+
+    // Load named keys for multi-account monitoring
+    std::vector<AccountKey> account_keys;
+    if (!key_file.empty()) {
+        std::string key_error;
+        if (!load_key_file(key_file, &account_keys, &key_error)) {
+            std::cerr << "Error: --key-file: " << key_error << std::endl;
+            return 1;
+        }
+    }
+
     // Get API key from environment variable if not provided
-    if (api_key.empty()) {
+    if (api_key.empty() && account_keys.empty()) {
         const char* env_key = std::getenv("FIRMWARE_API_KEY");
         if (env_key) {
             api_key = env_key;
         }
     }
 
+    // A replay never reaches the API
+    if (api_key.empty() && account_keys.empty() && capture_replaying()) {
+        api_key = "replay";
+    }
+
     // Check if API key is provided
-    if (api_key.empty()) {
+    if (api_key.empty() && account_keys.empty()) {
         std::cerr << "Error: API key not provided." << std::endl;
         std::cerr << std::endl;
         print_usage(argv[0]);
@@ -1939,9 +2644,20 @@ int main(int argc, char* argv[]) {
     // Initialize curl globally
     curl_global_init(CURL_GLOBAL_DEFAULT);
 
+    if (serve_port > 0) {
+        std::string serve_error;
+        g_push_server = push_server_start(serve_port, &serve_error);
+        if (!g_push_server) {
+            std::cerr << "Error: --serve: " << serve_error << std::endl;
+            curl_global_cleanup();
+            return 1;
+        }
+    }
+
     // Initialize GTK
     if (!gtk_init_check(&argc, &argv)) {
         std::cerr << "Failed to initialize GTK. Install libgtk-3-dev." << std::endl;
+        push_server_stop(g_push_server);
         curl_global_cleanup();
         return 1;
     }
@@ -1956,9 +2672,22 @@ int main(int argc, char* argv[]) {
     state->log_file = log_file;
     state->logging_enabled = logging_enabled;
     state->refresh_interval = refresh_interval;
+    for (const AccountKey& key : account_keys) {
+        GUIAccount acct;
+        acct.name = key.name;
+        acct.api_key = key.api_key;
+        acct.token = extract_token(key.api_key);
+        acct.log_file = logging_enabled ? account_log_path(log_file, key.name) : std::string();
+        state->accounts.push_back(std::move(acct));
+    }
 
     // Load saved state
     load_gui_state(state);
+    set_request_timeouts(timeouts_overridden ? timeouts : state->timeouts);
+    set_request_transport(transport_overridden ? transport : state->transport);
+    if (g_timings) {
+        std::cerr << "Transport: " << describe_request_transport(get_request_transport()) << std::endl;
+    }
 
     // Preserve the loaded position for restore; some WMs will emit a configure
     // event at 0,0 while mapping which would otherwise clobber state->window_x/y.
@@ -1983,33 +2712,50 @@ int main(int argc, char* argv[]) {
     // Restore window position and visibility
     restore_window_position(state);
 
+    // Export quota state on the session bus for panel applets and widgets
+    if (dbus_enabled) {
+        g_dbus_service = quota_dbus_start(on_dbus_refresh, state);
+    }
+
     // Initial fetch
+    retry_init(&state->retry);
+    state->network_handler = g_signal_connect(g_network_monitor_get_default(), "network-changed",
+                                              G_CALLBACK(on_network_changed), state);
+    fetch_worker_start(state);
     on_timer_update(state);
 
-    // Start update timer (convert seconds to milliseconds)
-    state->timer_id = g_timeout_add(
-        state->refresh_interval * 1000,
+    // Start update timer (second granularity, batched with the UI tick)
+    state->timer_id = add_clock_timeout(
+        state->refresh_interval,
         on_timer_update,
         state
     );
 
-    // Update countdown label once per second.
-    state->countdown_timer_id = g_timeout_add_seconds(1, on_countdown_tick, state);
+    // Update countdown label once per second while the window is on screen.
+    state->countdown_ticker = ui_ticker_add(on_countdown_tick, state);
+    ui_ticker_set_visible(state->countdown_ticker, gtk_widget_get_mapped(state->window));
 
     // Run GTK main loop
     gtk_main();
 
     // Cleanup
+    fetch_worker_stop();
     save_gui_state(state);
     if (state->timer_id > 0) {
         g_source_remove(state->timer_id);
     }
-    if (state->countdown_timer_id > 0) {
-        g_source_remove(state->countdown_timer_id);
-    }
+    ui_ticker_remove(state->countdown_ticker);
+    g_signal_handler_disconnect(g_network_monitor_get_default(), state->network_handler);
+    quota_dbus_stop(g_dbus_service);
+    g_dbus_service = nullptr;
     notify_uninit();
+    if (state->usage_bar_cache) {
+        cairo_surface_destroy(state->usage_bar_cache);
+    }
     delete state;
 
+    push_server_stop(g_push_server);
+    capture_close();
     curl_global_cleanup();
 
     return 0;
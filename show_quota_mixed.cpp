@@ -1,21 +1,23 @@
-#include <iostream>
-#include <string>
-#include <cstring>
-#include <cstdlib>
-#include <curl/curl.h>
-#include <nlohmann/json.hpp>
-#include <iomanip>
-#include <sstream>
-#include <ctime>
+#include "quota_common.h"
+#include "quota_push.h"
+#include "quota_jsonl.h"
+#include "quota_follow.h"
+#include "quota_screen.h"
+#include "quota_history.h"
+#include "quota_dashboard.h"
+#include "quota_glyphs.h"
+#include "quota_status.h"
+#include "quota_retry.h"
+#include "quota_capture.h"
 #include <sys/ioctl.h>
-#include <unistd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <poll.h>
 #include <clocale>
-#include <fstream>
-#include <sys/stat.h>
-#include <optional>
-#include <cmath>
 #include <signal.h>
 #include <algorithm>
+#include <chrono>
 #include <libgen.h>
 #include <linux/limits.h>
 
@@ -26,13 +28,34 @@ extern "C" {
 #include <libnotify/notify.h>
 }
 #include <pthread.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "quota_dbus.h"
+#include "quota_ticker.h"
 #endif
 
-using json = nlohmann::json;
+static volatile sig_atomic_t g_cursor_hidden = 0;
 
-static constexpr int kQuotaWindowSeconds = 5 * 60 * 60;
+// Optional localhost push endpoint (--serve), shared by terminal and GUI modes
+static PushServer* g_push_server = nullptr;
 
-static volatile sig_atomic_t g_cursor_hidden = 0;
+// Reused serializer for --jsonl and push snapshots
+static JsonlWriter g_jsonl_writer;
+
+// Status bar line per update instead of the terminal view (--status)
+static StatusWriter g_status_writer;
+static bool g_status_mode = false;
+
+// Recent samples behind the sparkline and --chart (single-account modes)
+static QuotaHistory g_history;
+static bool g_history_enabled = false;
+static bool g_chart_mode = false;
+
+// --timings: phase timings of the last fetch, printed with the transport
+static bool g_timings = false;
+static std::string g_last_timings;
 
 static void cursor_hide_raw() {
     static const char kHide[] = "\033[?25l";
@@ -61,130 +84,190 @@ static void hide_cursor_if_tty() {
     }
 }
 
-static void handle_term_signal(int sig) {
-    if (g_cursor_hidden) {
-        cursor_show_raw();
-        g_cursor_hidden = 0;
-    }
-    _exit(128 + sig);
-}
 
-// Structure to hold quota data
-struct QuotaData {
-    double used;
-    double percentage;
-    std::string reset_time;
-    time_t timestamp;
-};
+// Terminal modes receive SIGINT/SIGTERM/SIGWINCH on a signalfd instead of in a
+// handler, so they can restore the terminal and return from main() normally.
+static int g_signal_fd = -1;
 
-// Callback function to write curl response to string
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    size_t total_size = size * nmemb;
-    userp->append((char*)contents, total_size);
-    return total_size;
+// True while SIGINT or SIGTERM is waiting to be read. Installed as the request
+// abort check so Ctrl+C does not wait for a slow request to finish.
+static bool termination_pending() {
+    sigset_t pending;
+    sigemptyset(&pending);
+    if (sigpending(&pending) != 0) {
+        return false;
+    }
+    return sigismember(&pending, SIGINT) == 1 || sigismember(&pending, SIGTERM) == 1;
 }
 
-// Get terminal width
-int get_terminal_width() {
-    struct winsize w;
-    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_col > 0) {
-        return w.ws_col;
+// Block the terminal signals and route them to g_signal_fd
+static void block_terminal_signals() {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGWINCH);
+    if (sigprocmask(SIG_BLOCK, &mask, nullptr) != 0) {
+        return;
     }
-    return 80; // Default fallback
+    g_signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (g_signal_fd < 0) {
+        // Fall back to the default dispositions.
+        sigprocmask(SIG_UNBLOCK, &mask, nullptr);
+        return;
+    }
+    set_request_abort_check(termination_pending);
 }
 
-// Check if terminal supports UTF-8
-bool is_utf8_locale() {
-    // Initialize locale from environment
-    std::setlocale(LC_CTYPE, "");
-    
-    const char* locale = std::setlocale(LC_CTYPE, nullptr);
-    if (locale) {
-        std::string loc(locale);
-        return loc.find("UTF-8") != std::string::npos || 
-               loc.find("utf8") != std::string::npos;
+// Drain g_signal_fd. Returns SIGINT/SIGTERM if termination was requested
+// (0 otherwise) and sets *resized on SIGWINCH.
+static int read_terminal_signals(bool* resized) {
+    if (g_signal_fd < 0) {
+        return 0;
     }
-    
-    // Also check LANG environment variable as fallback
-    const char* lang = std::getenv("LANG");
-    if (lang) {
-        std::string lang_str(lang);
-        return lang_str.find("UTF-8") != std::string::npos || 
-               lang_str.find("utf8") != std::string::npos;
+    int term_signal = 0;
+    struct signalfd_siginfo info;
+    while (read(g_signal_fd, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+        if (info.ssi_signo == SIGWINCH) {
+            *resized = true;
+        } else {
+            term_signal = static_cast<int>(info.ssi_signo);
+        }
     }
-    
-    return false;
+    return term_signal;
 }
 
-static bool parse_iso8601_utc_to_time_t(const std::string& iso_timestamp, time_t* out) {
-    if (!out) {
-        return false;
-    }
-    if (iso_timestamp.length() < 19) {
-        return false;
+// Live view keys: unbuffered, no echo. ISIG stays on, so Ctrl+C still arrives
+// through the signalfd.
+static struct termios g_saved_termios;
+static bool g_termios_saved = false;
+
+static void restore_key_input() {
+    if (g_termios_saved) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &g_saved_termios);
+        g_termios_saved = false;
     }
+}
 
-    struct tm tm_info = {};
-    std::istringstream ss(iso_timestamp);
-    ss >> std::get_time(&tm_info, "%Y-%m-%dT%H:%M:%S");
-    if (ss.fail()) {
+// Switch stdin to non-canonical, non-blocking reads (VMIN = VTIME = 0, so the
+// descriptor flags shared with the shell are left alone)
+static bool enable_key_input() {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &g_saved_termios) != 0) {
         return false;
     }
-
-    time_t utc_time = timegm(&tm_info);
-    if (utc_time == -1) {
+    struct termios raw = g_saved_termios;
+    raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0) {
         return false;
     }
-
-    *out = utc_time;
+    g_termios_saved = true;
+    std::atexit(restore_key_input);
     return true;
 }
 
-static std::string format_duration_compact(int64_t seconds) {
-    if (seconds < 0) {
-        seconds = 0;
+// Commands collected from the keys typed since the last read
+struct KeyCommands {
+    bool refresh = false;       // r
+    bool quit = false;          // q
+    int interval_steps = 0;     // + / -
+    bool toggle_compact = false;
+    bool toggle_tiny = false;
+};
+
+static KeyCommands read_key_commands() {
+    KeyCommands cmd;
+    char buf[64];
+    ssize_t n;
+    while ((n = read(STDIN_FILENO, buf, sizeof(buf))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            switch (buf[i]) {
+                case 'r': case 'R': cmd.refresh = true; break;
+                case 'q': case 'Q': cmd.quit = true; break;
+                case '+': case '=': cmd.interval_steps++; break;
+                case '-': case '_': cmd.interval_steps--; break;
+                case 'c': case 'C': cmd.toggle_compact = !cmd.toggle_compact; break;
+                case 't': case 'T': cmd.toggle_tiny = !cmd.toggle_tiny; break;
+                default: break;
+            }
+        }
     }
+    return cmd;
+}
 
-    int64_t hours = seconds / 3600;
-    int64_t minutes = (seconds % 3600) / 60;
-    int64_t secs = seconds % 60;
+// Refresh intervals offered by +/- (seconds)
+static const int kRefreshSteps[] = {5, 10, 15, 30, 60, 120, 300, 600};
 
-    std::ostringstream out;
-    if (hours > 0) {
-        out << hours << "h " << minutes << "m";
-        return out.str();
+static int step_refresh_interval(int interval, int steps) {
+    const int count = static_cast<int>(sizeof(kRefreshSteps) / sizeof(kRefreshSteps[0]));
+    for (; steps > 0; steps--) {
+        int i = 0;
+        while (i < count && kRefreshSteps[i] <= interval) i++;
+        interval = (i < count) ? kRefreshSteps[i] : kRefreshSteps[count - 1];
     }
-    if (minutes > 0) {
-        out << minutes << "m " << secs << "s";
-        return out.str();
+    for (; steps < 0; steps++) {
+        int i = count - 1;
+        while (i >= 0 && kRefreshSteps[i] >= interval) i--;
+        interval = (i >= 0) ? kRefreshSteps[i] : kRefreshSteps[0];
     }
-    out << secs << "s";
-    return out.str();
+    return interval;
+}
+
+// Get terminal width
+int get_terminal_width() {
+    struct winsize w;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_col > 0) {
+        return w.ws_col;
+    }
+    return 80; // Default fallback
 }
 
-static std::string format_duration_tight(int64_t seconds) {
-    if (seconds < 0) {
-        seconds = 0;
+// Get terminal height
+static int get_terminal_height() {
+    struct winsize w;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_row > 0) {
+        return w.ws_row;
     }
+    return 24; // Default fallback
+}
 
-    int64_t hours = seconds / 3600;
-    int64_t minutes = (seconds % 3600) / 60;
-    int64_t secs = seconds % 60;
+// Check if terminal supports UTF-8
+bool is_utf8_locale() {
+    // Detected once (locale, then LANG); see quota_glyphs.h
+    return term_caps().utf8;
+}
 
-    std::ostringstream out;
-    if (hours > 99) {
-        return "99h+";
+// Refresh loops render into g_frame and hand it to the differential renderer
+// (quota_screen.h) instead of clearing the screen and reprinting everything.
+static TermScreen g_screen;
+static std::ostringstream g_frame;
+static std::streambuf* g_saved_cout = nullptr;
+static std::streambuf* g_saved_cerr = nullptr;
+
+// Redirect std::cout (and std::cerr when it is the same terminal) into g_frame
+static void frame_begin() {
+    std::cout.flush();
+    g_frame.str(std::string());
+    g_frame.clear();
+    g_saved_cout = std::cout.rdbuf(g_frame.rdbuf());
+    if (isatty(STDERR_FILENO)) {
+        g_saved_cerr = std::cerr.rdbuf(g_frame.rdbuf());
     }
-    if (hours > 0) {
-        out << hours << "h" << minutes << "m";
-        return out.str();
+}
+
+// Restore the streams and draw only what changed since the previous frame
+// (present = false drops the frame, e.g. when exiting)
+static void frame_end(bool present = true) {
+    std::cout.rdbuf(g_saved_cout);
+    if (g_saved_cerr) {
+        std::cerr.rdbuf(g_saved_cerr);
+        g_saved_cerr = nullptr;
     }
-    if (minutes > 0) {
-        out << minutes << "m" << secs << "s";
-        return out.str();
+    if (present) {
+        screen_resize(&g_screen, get_terminal_width(), get_terminal_height());
+        screen_present(&g_screen, g_frame.str(), STDOUT_FILENO);
     }
-    out << secs << "s";
-    return out.str();
 }
 
 // Get ANSI color code based on usage percentage
@@ -192,14 +275,7 @@ std::string get_color_for_percentage(double percentage, bool use_colors) {
     if (!use_colors) {
         return "";
     }
-    
-    if (percentage < 50.0) {
-        return "\033[32m"; // Green
-    } else if (percentage < 80.0) {
-        return "\033[33m"; // Yellow
-    } else {
-        return "\033[31m"; // Red
-    }
+    return usage_color_sgr(percentage);
 }
 
 static std::string get_color_for_percentage_tiny(double percentage, bool use_colors) {
@@ -216,8 +292,8 @@ static std::string get_color_for_percentage_tiny(double percentage, bool use_col
     return "\033[31m"; // Red
 }
 
-// Render progress bar
-std::string render_progress_bar(double percentage, int terminal_width, bool use_colors) {
+// Width of the usage bar between the brackets
+static int progress_bar_width(int terminal_width) {
     // Calculate bar width (leave space for "Usage: [] XX.XX%")
     int fixed_width = 17; // "Usage: [] " + "XX.XX%" approximately
     int bar_width = terminal_width - fixed_width;
@@ -229,38 +305,28 @@ std::string render_progress_bar(double percentage, int terminal_width, bool use_
     if (bar_width > 50) {
         bar_width = 50; // Maximum reasonable width
     }
-    
-    // Calculate filled and empty blocks
-    int filled = static_cast<int>((percentage / 100.0) * bar_width);
-    int empty = bar_width - filled;
-    
-    // Ensure bounds
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
-    
-    // Choose characters based on locale
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
-    
-    // Get color
-    std::string color = get_color_for_percentage(percentage, use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
-    
-    // Build the bar
-    std::ostringstream bar;
-    bar << "Usage: [" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
+    return bar_width;
+}
+
+// Render progress bar (into a buffer reused across frames)
+const std::string& render_progress_bar(double percentage, int terminal_width, bool use_colors) {
+    static std::string bar;
+    const int bar_width = progress_bar_width(terminal_width);
+
+    char value[32];
+    snprintf(value, sizeof(value), "%.2f%%", percentage);
+
+    bar.clear();
+    bar.append("Usage: [");
+    if (use_colors) {
+        bar.append(usage_color_sgr(percentage));
     }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
+    append_bar(&bar, percentage / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
     }
-    bar << reset << "] ";
-    bar << std::fixed << std::setprecision(2) << percentage << "%";
-    
-    return bar.str();
+    bar.append("] ").append(value);
+    return bar;
 }
 
 static std::string truncate_right(const std::string& s, size_t max_len) {
@@ -270,7 +336,7 @@ static std::string truncate_right(const std::string& s, size_t max_len) {
     return s.substr(0, max_len);
 }
 
-static std::string render_progress_bar_compact(double percentage, int terminal_width, bool use_colors) {
+static const std::string& render_progress_bar_compact(double percentage, int terminal_width, bool use_colors) {
     int pct_i = static_cast<int>(std::llround(percentage));
     if (pct_i < 0) pct_i = 0;
     if (pct_i > 100) pct_i = 100;
@@ -289,30 +355,72 @@ static std::string render_progress_bar_compact(double percentage, int terminal_w
         suffix_len = static_cast<int>(suffix.size());
     }
 
-    int filled = static_cast<int>((static_cast<double>(pct_i) / 100.0) * bar_width);
-    int empty = bar_width - filled;
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
+    static std::string bar;
+    bar.clear();
+    bar.append(label).append("[");
+    if (use_colors) {
+        bar.append(usage_color_sgr(static_cast<double>(pct_i)));
+    }
+    append_bar(&bar, pct_i / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
+    }
+    bar.append("] ").append(suffix);
+    return bar;
+}
+
+// Sparkline of recent samples, aligned under the usage bar (one column per
+// sample, newest on the right)
+static std::string render_history_sparkline(QuotaHistory* history, int terminal_width, bool compact_mode) {
+    const bool use_utf8 = is_utf8_locale();
+    if (compact_mode) {
+        // Lines up with "U:[" ... "] NN%"
+        const int width = std::max(terminal_width - 8, 1);
+        return "T:[" + history_render(history, &history->sparkline, width, 1, use_utf8)[0] + "]";
+    }
+    const int width = progress_bar_width(terminal_width);
+    return "Trend: [" + history_render(history, &history->sparkline, width, 1, use_utf8)[0] + "]";
+}
 
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
+// Full-width chart of recent samples (--chart, dashboard): 0-100% axis on the
+// left, time of the oldest and newest plotted sample underneath
+static void print_history_chart(std::ostream& out, QuotaHistory* history, int terminal_width, int height) {
+    const bool use_utf8 = is_utf8_locale();
+    const int width = std::max(terminal_width - 6, 10); // "100% |"
+    const std::vector<std::string>& rows = history_render(history, &history->chart, width, height, use_utf8);
 
-    std::string color = get_color_for_percentage(static_cast<double>(pct_i), use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
+    for (int r = 0; r < height; r++) {
+        const char* label = (r == 0) ? "100% " : (r == height / 2) ? " 50% " : (r == height - 1) ? "  0% " : "     ";
+        out << label << (use_utf8 ? "│" : "|") << rows[static_cast<size_t>(r)] << '\n';
+    }
 
-    std::ostringstream bar;
-    bar << label << "[" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
+    out << "     " << (use_utf8 ? "└" : "+");
+    for (int i = 0; i < width; i++) {
+        out << (use_utf8 ? "─" : "-");
     }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
+    out << '\n';
+
+    if (history->count == 0) {
+        return;
     }
-    bar << reset << "] ";
-    bar << suffix;
-    return bar.str();
+    const size_t shown = std::min(history->count, static_cast<size_t>(width));
+    char first[16];
+    char last[16];
+    const time_t first_ts = history_at(history, history->count - shown).timestamp;
+    const time_t last_ts = history_at(history, history->count - 1).timestamp;
+    const struct tm first_tm = clock_localtime(first_ts);
+    const struct tm last_tm = clock_localtime(last_ts);
+    strftime(first, sizeof(first), "%H:%M", &first_tm);
+    strftime(last, sizeof(last), "%H:%M", &last_tm);
+
+    // Oldest time under the first plotted column, newest flush right.
+    const int first_col = 6 + width - static_cast<int>(shown);
+    std::string axis(static_cast<size_t>(6 + width), ' ');
+    axis.replace(static_cast<size_t>(std::min(first_col, 6 + width - 5)), 5, first);
+    if (shown > 11) {
+        axis.replace(axis.size() - 5, 5, last);
+    }
+    out << axis << '\n';
 }
 
 static std::string render_tiny_usage_line(double percentage, bool use_colors) {
@@ -328,8 +436,8 @@ static std::string render_tiny_usage_line(double percentage, bool use_colors) {
     return out.str();
 }
 
-static std::string render_reset_time_bar(time_t reset_utc, int terminal_width, bool use_colors) {
-    time_t now = time(nullptr);
+static const std::string& render_reset_time_bar(time_t reset_utc, int terminal_width, bool use_colors) {
+    time_t now = clock_now();
     int64_t remaining_seconds = static_cast<int64_t>(difftime(reset_utc, now));
     if (remaining_seconds < 0) {
         remaining_seconds = 0;
@@ -359,36 +467,22 @@ static std::string render_reset_time_bar(time_t reset_utc, int terminal_width, b
         bar_width = 50;
     }
 
-    int filled = static_cast<int>((remaining_pct / 100.0) * bar_width);
-    int empty = bar_width - filled;
-
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
-
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
-
-    std::string color = get_color_for_percentage(approaching_pct, use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
-
-    std::ostringstream bar;
-    bar << "Reset: [" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
+    static std::string bar;
+    bar.clear();
+    bar.append("Reset: [");
+    if (use_colors) {
+        bar.append(usage_color_sgr(approaching_pct));
     }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
+    append_bar(&bar, remaining_pct / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
     }
-    bar << reset << "] ";
-    bar << format_duration_compact(remaining_seconds) << " left (of 5h)";
-
-    return bar.str();
+    bar.append("] ").append(format_duration_compact(remaining_seconds)).append(" left (of 5h)");
+    return bar;
 }
 
-static std::string render_reset_time_bar_compact(time_t reset_utc, int terminal_width, bool use_colors) {
-    time_t now = time(nullptr);
+static const std::string& render_reset_time_bar_compact(time_t reset_utc, int terminal_width, bool use_colors) {
+    time_t now = clock_now();
     int64_t remaining_seconds = static_cast<int64_t>(difftime(reset_utc, now));
     if (remaining_seconds < 0) {
         remaining_seconds = 0;
@@ -421,109 +515,37 @@ static std::string render_reset_time_bar_compact(time_t reset_utc, int terminal_
         suffix_len = static_cast<int>(suffix.size());
     }
 
-    int filled = static_cast<int>((remaining_pct / 100.0) * bar_width);
-    int empty = bar_width - filled;
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
-
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
-
-    std::string color = get_color_for_percentage(approaching_pct, use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
-
-    std::ostringstream bar;
-    bar << label << "[" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
-    }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
-    }
-    bar << reset << "] ";
-    bar << suffix;
-    return bar.str();
-}
-
-// Function to make HTTP request with given auth header
-struct RequestResult {
-    CURLcode curl_code = CURLE_OK;
-    long http_code = 0;
-    std::string body;
-    std::string curl_error;
-};
-
-static RequestResult make_request(const std::string& auth_header) {
-    RequestResult out;
-
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        out.curl_code = CURLE_FAILED_INIT;
-        out.curl_error = "curl_easy_init failed";
-        return out;
-    }
-
-    std::string response;
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, auth_header.c_str());
-
-    char errbuf[CURL_ERROR_SIZE];
-    errbuf[0] = '\0';
-
-    curl_easy_setopt(curl, CURLOPT_URL, "https://app.firmware.ai/api/v1/quota");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
-    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
-
-    out.curl_code = curl_easy_perform(curl);
-    out.body = std::move(response);
-
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    out.http_code = http_code;
-    if (errbuf[0] != '\0') {
-        out.curl_error = errbuf;
+    static std::string bar;
+    bar.clear();
+    bar.append(label).append("[");
+    if (use_colors) {
+        bar.append(usage_color_sgr(approaching_pct));
     }
-
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    return out;
-}
-
-// Check if response contains unauthorized error
-bool is_unauthorized(const std::string& response) {
-    return response.find("Unauthorized") != std::string::npos || 
-           response.find("unauthorized") != std::string::npos;
-}
-
-// Extract token from API key (remove fw_api_ prefix if present)
-std::string extract_token(const std::string& api_key) {
-    if (api_key.substr(0, 7) == "fw_api_") {
-        return api_key.substr(7);
+    append_bar(&bar, remaining_pct / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
     }
-    return api_key;
+    bar.append("] ").append(suffix);
+    return bar;
 }
 
-// Try different authentication methods
-enum class AuthMethod {
-    BearerFullKey,
-    BearerToken,
-    XApiKey,
-    AuthorizationRaw,
-};
-
 #ifdef GUI_MODE_ENABLED
 // Single resizable window mode with 150px default width (140px minimum).
 
 // Structure to hold GUI state (defined here after AuthMethod)
+// One monitored key in --key-file mode
+struct GUIAccount {
+    std::string name;
+    std::string api_key;
+    std::string token;
+    std::string log_file;
+    std::optional<AuthMethod> preferred_auth_method;
+    bool ok = false;
+    QuotaData quota = {0.0, 0.0, "", 0};
+    std::string event;
+    std::string error;
+};
+
 struct GUIState {
     // GTK Widgets
     GtkWidget* window;
@@ -562,6 +584,11 @@ struct GUIState {
     int refresh_interval;
     int bar_height_multiplier;  // Progress bar height multiplier (1x, 2x, 3x, 4x)
     std::optional<AuthMethod> preferred_auth_method;
+    RequestTimeouts timeouts;   // saved budgets; FIRMWARE_*TIMEOUT / --timeout win
+    RequestTransport transport; // saved endpoint/proxy/...; FIRMWARE_* / --url etc. win
+
+    // Multi-account mode (--key-file); empty when monitoring a single key
+    std::vector<GUIAccount> accounts;
 
     // Current Data
     QuotaData current_quota;
@@ -569,10 +596,19 @@ struct GUIState {
     bool have_prev_percentage;
     std::string event_type;
 
+    // Rendered usage bar, repainted on new data, resize or theme change
+    cairo_surface_t* usage_bar_cache;
+    int usage_bar_cache_w;
+    int usage_bar_cache_h;
+    bool usage_bar_cache_dark;
+    bool usage_bar_cache_valid;
+
     // Update Timer
     guint timer_id;
-    guint countdown_timer_id;
+    UiTicker* countdown_ticker;     // refresh countdown label, paused while hidden
     gint64 next_refresh_us;
+    RetryState retry;               // backoff / circuit breaker after failed fetches
+    gulong network_handler;         // GNetworkMonitor::network-changed
 
     // Window State
     int window_x;
@@ -603,7 +639,9 @@ struct GUIState {
                  barwidth_1x_item(nullptr), barwidth_2x_item(nullptr),
                  barwidth_3x_item(nullptr), barwidth_4x_item(nullptr),
                  logging_enabled(true), refresh_interval(15), bar_height_multiplier(1),
-                 timer_id(0), countdown_timer_id(0), next_refresh_us(0), window_x(-1), window_y(-1), window_w(-1), window_visible(true),
+                 usage_bar_cache(nullptr), usage_bar_cache_w(0), usage_bar_cache_h(0),
+                 usage_bar_cache_dark(false), usage_bar_cache_valid(false),
+                 timer_id(0), countdown_ticker(nullptr), next_refresh_us(0), network_handler(0), window_x(-1), window_y(-1), window_w(-1), window_visible(true),
                  always_on_top(false), window_decorated(true), dark_mode(false),
                  restore_x(-1), restore_y(-1), restore_w(-1),
                  have_restore_pos(false), have_restore_size(false), restoring(false) {
@@ -617,24 +655,43 @@ struct GUIState {
     }
 };
 
+// Session bus export (org.firmware.Quota); nullptr with --no-dbus
+static QuotaDbusService* g_dbus_service = nullptr;
+
+// Timer for a delay in clock seconds: whole seconds batched by GLib on the
+// real clock, a precise real-time equivalent on a simulated one
+static guint add_clock_timeout(int seconds, GSourceFunc fn, gpointer data) {
+    if (!clock_simulated()) {
+        return g_timeout_add_seconds(seconds, fn, data);
+    }
+    return g_timeout_add((guint)clock_real_ms(seconds), fn, data);
+}
+
 static void update_refresh_countdown_label(GUIState* state) {
     if (!state || !state->refresh_countdown_label) return;
 
-    const gint64 now = g_get_monotonic_time();
+    const gint64 now = clock_monotonic_us();
     gint64 remaining_us = state->next_refresh_us - now;
     if (remaining_us < 0) remaining_us = 0;
     int remaining_s = (int)((remaining_us + 999999) / 1000000);
 
+    if (retry_waiting(&state->retry)) {
+        gtk_label_set_text(GTK_LABEL(state->refresh_countdown_label),
+                           retry_describe(&state->retry, remaining_s).c_str());
+        return;
+    }
+    if (capture_replaying() && capture_replay_delay_ms() < 0) {
+        gtk_label_set_text(GTK_LABEL(state->refresh_countdown_label), "Replay done");
+        return;
+    }
+
     char buf[32];
     snprintf(buf, sizeof(buf), "%ds", remaining_s);
     gtk_label_set_text(GTK_LABEL(state->refresh_countdown_label), buf);
 }
 
-static gboolean on_countdown_tick(gpointer user_data) {
-    GUIState* state = (GUIState*)user_data;
-    if (!state) return G_SOURCE_REMOVE;
-    update_refresh_countdown_label(state);
-    return G_SOURCE_CONTINUE;
+static void on_countdown_tick(void* user_data) {
+    update_refresh_countdown_label((GUIState*)user_data);
 }
 
 static double clamp_pct(double v) {
@@ -665,15 +722,67 @@ static void color_for_usage_pct(double pct, double* r, double* g, double* b) {
     *b = 0x36 / 255.0;
 }
 
-static gboolean on_usage_bar_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
-    GUIState* state = (GUIState*)user_data;
-    if (!state) return FALSE;
+// Multi-account variant: one thin labelled bar per account, stacked.
+static void draw_account_bars(GUIState* state, cairo_t* cr, int w, int h) {
+    const int n = (int)state->accounts.size();
+    const double gap = 2.0;
+    const double row_h = std::max(1.0, ((double)h - gap * (n - 1)) / n);
 
-    GtkAllocation a;
-    gtk_widget_get_allocation(widget, &a);
-    const int w = a.width;
-    const int h = a.height;
-    if (w <= 0 || h <= 0) return FALSE;
+    cairo_set_source_rgba(cr, 0, 0, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    for (int i = 0; i < n; i++) {
+        const GUIAccount& acct = state->accounts[i];
+        const double y = i * (row_h + gap);
+        const double pct = clamp_pct(acct.quota.percentage);
+
+        // Trough
+        if (state->dark_mode) {
+            cairo_set_source_rgb(cr, 0x2b / 255.0, 0x2d / 255.0, 0x31 / 255.0);
+        } else {
+            cairo_set_source_rgb(cr, 0xe5 / 255.0, 0xe7 / 255.0, 0xeb / 255.0);
+        }
+        cairo_rectangle(cr, 0, y, w, row_h);
+        cairo_fill(cr);
+
+        // Fill (faded when the last fetch for this account failed)
+        double r = 0.0, g = 0.0, b = 0.0;
+        color_for_usage_pct(pct, &r, &g, &b);
+        cairo_set_source_rgba(cr, r, g, b, acct.ok ? 1.0 : 0.4);
+        cairo_rectangle(cr, 0, y, w * (pct / 100.0), row_h);
+        cairo_fill(cr);
+
+        // Label, only when the row is tall enough to read
+        if (row_h >= 9.0) {
+            char label[128];
+            if (acct.ok || acct.quota.timestamp > 0) {
+                snprintf(label, sizeof(label), "%s %.0f%%%s", acct.name.c_str(), acct.quota.percentage,
+                         acct.ok ? "" : " (stale)");
+            } else {
+                snprintf(label, sizeof(label), "%s error", acct.name.c_str());
+            }
+            cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+            cairo_set_font_size(cr, std::min(12.0, row_h * 0.75));
+            cairo_font_extents_t fe;
+            cairo_font_extents(cr, &fe);
+            if (state->dark_mode) {
+                cairo_set_source_rgb(cr, 0.95, 0.95, 0.95);
+            } else {
+                cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
+            }
+            cairo_move_to(cr, 4.0, y + (row_h + fe.ascent - fe.descent) / 2.0);
+            cairo_show_text(cr, label);
+        }
+    }
+}
+
+static void paint_usage_bar(GUIState* state, cairo_t* cr, int w, int h) {
+    if (state->accounts.size() > 1) {
+        draw_account_bars(state, cr, w, h);
+        return;
+    }
 
     const double pct = clamp_pct(state->current_quota.percentage);
     const double prev = state->have_prev_percentage ? clamp_pct(state->prev_percentage) : pct;
@@ -778,469 +887,1276 @@ static gboolean on_usage_bar_draw(GtkWidget* widget, cairo_t* cr, gpointer user_
     cairo_set_line_width(cr, 1.0);
     cairo_rectangle(cr, x0 + 0.5, y0 + 0.5, std::max(0.0, bw - 1.0), std::max(0.0, bh - 1.0));
     cairo_stroke(cr);
-
-    return FALSE;
 }
-#endif
 
-static std::string build_auth_header(AuthMethod method, const std::string& api_key, const std::string& token) {
-    switch (method) {
-        case AuthMethod::BearerFullKey:
-            return "Authorization: Bearer " + api_key;
-        case AuthMethod::BearerToken:
-            return "Authorization: Bearer " + token;
-        case AuthMethod::XApiKey:
-            return "X-API-Key: " + api_key;
-        case AuthMethod::AuthorizationRaw:
-            return "Authorization: " + api_key;
-    }
-    return "Authorization: Bearer " + api_key;
-}
+// The bar is only repainted into its cache when the data, the size or the
+// theme changed; other expose events (window moves, countdown label updates,
+// overlapping windows) just blit the cached surface.
+static gboolean on_usage_bar_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    if (!state) return FALSE;
 
-static bool is_http_success(long code) {
-    return code >= 200 && code < 300;
-}
+    GtkAllocation a;
+    gtk_widget_get_allocation(widget, &a);
+    const int w = a.width;
+    const int h = a.height;
+    if (w <= 0 || h <= 0) return FALSE;
 
-static bool is_auth_failure(const RequestResult& r) {
-    if (r.http_code == 401) {
-        return true;
+    if (state->usage_bar_cache && (state->usage_bar_cache_w != w || state->usage_bar_cache_h != h)) {
+        cairo_surface_destroy(state->usage_bar_cache);
+        state->usage_bar_cache = nullptr;
     }
-    return is_unauthorized(r.body);
-}
-
-static std::string truncate_for_display(const std::string& s, size_t max_len) {
-    if (s.size() <= max_len) {
-        return s;
+    if (!state->usage_bar_cache) {
+        state->usage_bar_cache = gdk_window_create_similar_surface(gtk_widget_get_window(widget),
+                                                                   CAIRO_CONTENT_COLOR_ALPHA, w, h);
+        state->usage_bar_cache_w = w;
+        state->usage_bar_cache_h = h;
+        state->usage_bar_cache_valid = false;
     }
-    return s.substr(0, max_len) + "...";
+    if (!state->usage_bar_cache_valid || state->usage_bar_cache_dark != state->dark_mode) {
+        cairo_t* bar_cr = cairo_create(state->usage_bar_cache);
+        paint_usage_bar(state, bar_cr, w, h);
+        cairo_destroy(bar_cr);
+        state->usage_bar_cache_dark = state->dark_mode;
+        state->usage_bar_cache_valid = true;
+    }
+
+    cairo_set_source_surface(cr, state->usage_bar_cache, 0, 0);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    return FALSE;
 }
+#endif
 
-static RequestResult try_auth_methods(const std::string& api_key,
-                                      const std::string& token,
-                                      std::optional<AuthMethod>& preferred_method,
-                                      std::optional<AuthMethod>* used_method_out) {
-    auto attempt = [&](AuthMethod m) -> RequestResult {
-        return make_request(build_auth_header(m, api_key, token));
-    };
+#ifdef GUI_MODE_ENABLED
+// Forward declaration for GUI mode
+static int run_gui_mode(const std::string& api_key,
+                       const std::vector<AccountKey>& account_keys, int refresh_interval,
+                       const std::string& log_file, bool logging_enabled, bool dbus_enabled,
+                       const RequestTimeouts* timeout_override,
+                       const RequestTransport* transport_override, int* argc, char*** argv);
+#endif
 
-    const AuthMethod all_methods[] = {
-        AuthMethod::BearerFullKey,
-        AuthMethod::BearerToken,
-        AuthMethod::XApiKey,
-        AuthMethod::AuthorizationRaw,
-    };
+// Print usage information
+void print_usage(const char* program_name) {
+    std::cerr << "Usage: " << program_name << " [OPTIONS] [API_KEY]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --gui, -g            Launch GUI mode" << std::endl;
+    std::cerr << "  --refresh <seconds>  Refresh continuously every N seconds (default: 15)" << std::endl;
+    std::cerr << "  -1                   Single run (no refresh loop)" << std::endl;
+    std::cerr << "  --text              Pure text output (no progress bar)" << std::endl;
+    std::cerr << "  --log <file>        Log quota changes to CSV file (default: ./show_quota.log)" << std::endl;
+    std::cerr << "  --no-log            Disable logging" << std::endl;
+    std::cerr << "  --compact           Compact bar layout for ~40-column terminals" << std::endl;
+    std::cerr << "  --tiny              Extra small single-line output: XX%" << std::endl;
+    std::cerr << "  --jsonl             One compact JSON object per refresh on stdout (no screen clearing)" << std::endl;
+    std::cerr << "  --chart             Full-width usage chart of recent samples instead of the sparkline" << std::endl;
+    std::cerr << "  --dashboard         Full-screen dashboard: usage, history, forecast, latency, events, errors" << std::endl;
+    std::cerr << "  --status <format>   One status bar line per refresh: i3bar|swaybar, waybar, polybar|lemonbar, tmux" << std::endl;
+    std::cerr << "  --key-file <file>   Monitor several accounts (name=key per line), fetched concurrently" << std::endl;
+    std::cerr << "  --no-dbus           GUI mode: do not export org.firmware.Quota on the session bus" << std::endl;
+    std::cerr << "  --follow <logfile>  Display another instance's log as it grows (no API key, no network)" << std::endl;
+    std::cerr << "  --serve <port>      Stream snapshots on http://127.0.0.1:<port>/events (SSE) and /ndjson" << std::endl;
+    std::cerr << "  --hedge             Resend a fetch still pending at the recent p95 (at most 5% of fetches)" << std::endl;
+    std::cerr << "  --timeout <sec>     Give up on a refresh after N seconds (default: 15, 0 = no limit)" << std::endl;
+    std::cerr << "  --connect-timeout <sec>     Connection budget per attempt (default: 5)" << std::endl;
+    std::cerr << "  --first-byte-timeout <sec>  Budget for the first response byte per attempt (default: 10)" << std::endl;
+    std::cerr << "  --url <url>         API endpoint (default: " << kDefaultQuotaUrl << ")" << std::endl;
+    std::cerr << "  --proxy <url>       Proxy for API requests (default: https_proxy / no_proxy)" << std::endl;
+    std::cerr << "  --unix-socket <path>  Connect through a Unix domain socket (e.g. a local sidecar)" << std::endl;
+    std::cerr << "  --cacert <file>     CA bundle for verifying the endpoint" << std::endl;
+    std::cerr << "  --http <1.1|2|3>    HTTP version (3 needs a libcurl built with HTTP/3)" << std::endl;
+    std::cerr << "  --resolve <host:port:addr>  Pin a host to an address (repeatable)" << std::endl;
+    std::cerr << "  --timings           Print the transport and each fetch's phase timings on stderr" << std::endl;
+    std::cerr << "  --record <file>     Save every API response to a capture file" << std::endl;
+    std::cerr << "  --replay <file>     Replay a capture instead of calling the API (no key needed)" << std::endl;
+    std::cerr << "  --replay-speed <x>  Replay pace: 1 = as recorded (default), N = N times faster, 0 = no waits" << std::endl;
+    std::cerr << "  --time-scale <x>    Simulated clock x times faster than real time (720: 5 h in 25 s)" << std::endl;
+    std::cerr << "  --time-start <t>    Simulated clock start, unix seconds or ISO 8601 UTC (default: now)" << std::endl;
+    std::cerr << "  --help              Show this help message" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "API Key:" << std::endl;
+    std::cerr << "  Can be passed as argument or set FIRMWARE_API_KEY environment variable" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Timeouts:" << std::endl;
+    std::cerr << "  FIRMWARE_TIMEOUT, FIRMWARE_CONNECT_TIMEOUT and FIRMWARE_FIRST_BYTE_TIMEOUT (seconds)" << std::endl;
+    std::cerr << "  set the same budgets; command-line options take precedence" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Transport:" << std::endl;
+    std::cerr << "  FIRMWARE_API_URL, FIRMWARE_PROXY, FIRMWARE_UNIX_SOCKET, FIRMWARE_CA_BUNDLE," << std::endl;
+    std::cerr << "  FIRMWARE_HTTP_VERSION and FIRMWARE_RESOLVE (comma-separated) set the same;" << std::endl;
+    std::cerr << "  command-line options take precedence" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Logging:" << std::endl;
+    std::cerr << "  Logs are written in CSV format with columns:" << std::endl;
+    std::cerr << "  Timestamp, Used, Percentage, Reset, Event" << std::endl;
+    std::cerr << "  Events: FIRST_RUN, UPDATE, QUOTA_RESET, POSSIBLE_RESET, HIGH_USAGE" << std::endl;
+    std::cerr << "  Throttling is logged as a row without usage: RATE_LIMITED http=429 wait=30s" << std::endl;
+    std::cerr << "  While the API answers unchanged, one row is written every 5 minutes" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Examples:" << std::endl;
+    std::cerr << "  " << program_name << " --gui fw_api_xxx" << std::endl;
+    std::cerr << "  " << program_name << " fw_api_xxx" << std::endl;
+    std::cerr << "  " << program_name << " --refresh 60 fw_api_xxx" << std::endl;
+    std::cerr << "  " << program_name << " -1 fw_api_xxx" << std::endl;
+    std::cerr << "  " << program_name << " --text --refresh 60 --log quota.csv" << std::endl;
+    std::cerr << "  " << program_name << " --no-log --refresh 60" << std::endl;
+    std::cerr << "  " << program_name << " --log /var/log/firmware_quota.csv" << std::endl;
+    std::cerr << "  " << program_name << " --compact --refresh 60" << std::endl;
+    std::cerr << "  " << program_name << " --tiny --refresh 60" << std::endl;
+    std::cerr << "  " << program_name << " --jsonl --refresh 30 | jq .percentage" << std::endl;
+    std::cerr << "  " << program_name << " --serve 8787 --refresh 60" << std::endl;
+    std::cerr << "  " << program_name << " --key-file ~/.config/firmware-quota/keys --compact" << std::endl;
+    std::cerr << "  " << program_name << " --follow show_quota.log --tiny" << std::endl;
+    std::cerr << "  " << program_name << " --dashboard --refresh 30" << std::endl;
+    std::cerr << "  " << program_name << " --status waybar --refresh 30" << std::endl;
+}
 
-    auto check_success = [&](const RequestResult& r) {
-        if (r.curl_code != CURLE_OK) {
-            return false;
+// Print usage and reset details for one sample (below the title line)
+static void print_quota_details(const QuotaData& data, bool text_mode, bool compact_mode,
+                                bool use_colors, int terminal_width, QuotaHistory* history) {
+    const double percentage = data.percentage;
+    const double used = data.used;
+    const std::string reset = (data.reset_time == "N/A") ? std::string() : data.reset_time;
+
+    if (text_mode) {
+        // Pure text output
+        std::cout << std::fixed << std::setprecision(2);
+        if (!compact_mode) {
+            std::cout << "Used: " << percentage << "% (" << used << ")" << std::endl;
+        } else {
+            std::cout << std::fixed << std::setprecision(0);
+            std::cout << "U: " << percentage << "%" << std::endl;
         }
-        if (!is_http_success(r.http_code)) {
-            return false;
+    } else {
+        // Progress bar output
+        if (compact_mode) {
+            std::cout << render_progress_bar_compact(percentage, terminal_width, use_colors) << std::endl;
+        } else {
+            std::cout << render_progress_bar(percentage, terminal_width, use_colors) << std::endl;
         }
-        if (is_auth_failure(r)) {
-            return false;
+        if (history && history->count > 0 && !g_chart_mode) {
+            std::cout << render_history_sparkline(history, terminal_width, compact_mode) << std::endl;
         }
-        return true;
-    };
-
-    RequestResult last;
+    }
 
-    // First try the cached method (if any).
-    if (preferred_method.has_value()) {
-        last = attempt(*preferred_method);
-        if (check_success(last)) {
-            if (used_method_out) {
-                *used_method_out = *preferred_method;
+    if (!reset.empty()) {
+        time_t reset_utc = 0;
+        bool parsed = parse_iso8601_utc_to_time_t(reset, &reset_utc);
+        if (parsed) {
+            if (!text_mode) {
+                if (compact_mode) {
+                    std::cout << render_reset_time_bar_compact(reset_utc, terminal_width, use_colors) << std::endl;
+                } else {
+                    std::cout << render_reset_time_bar(reset_utc, terminal_width, use_colors) << std::endl;
+                }
+            } else {
+                time_t now = clock_now();
+                int64_t remaining_seconds = static_cast<int64_t>(difftime(reset_utc, now));
+                if (remaining_seconds < 0) {
+                    remaining_seconds = 0;
+                }
+                if (!compact_mode) {
+                    std::cout << "Reset in: " << format_duration_compact(remaining_seconds) << " (of 5h)" << std::endl;
+                } else {
+                    std::cout << "R: " << format_duration_tight(remaining_seconds) << std::endl;
+                }
             }
-            return last;
-        }
 
-        // If it wasn't an auth failure, don't spam other auth methods.
-        if (last.curl_code != CURLE_OK || (!is_auth_failure(last) && !is_http_success(last.http_code))) {
-            return last;
+            std::string reset_readable = format_timestamp(reset);
+            if (!compact_mode) {
+                std::cout << "Resets at: " << reset_readable << std::endl;
+            }
+        } else {
+            std::string reset_readable = format_timestamp(reset);
+            if (!compact_mode) {
+                std::cout << "Reset: " << reset_readable << std::endl;
+            } else {
+                std::cout << "R: " << truncate_right(reset_readable, static_cast<size_t>(terminal_width)) << std::endl;
+            }
+        }
+    } else {
+        if (!compact_mode) {
+            std::cout << "Reset: No active window (quota not used recently)" << std::endl;
+        } else {
+            std::cout << "R: none" << std::endl;
         }
     }
 
-    // Fall back through all auth methods.
-    for (AuthMethod m : all_methods) {
-        if (preferred_method.has_value() && m == *preferred_method) {
-            continue;
+    if (history && g_chart_mode && !text_mode) {
+        print_history_chart(std::cout, history, terminal_width, 8);
+    }
+}
+
+// Draw one sample: reset banner (when events come from the log), title, details
+static void display_quota(const QuotaData& data, const std::string& event, bool show_event,
+                          bool text_mode, bool compact_mode, bool tiny_mode,
+                          bool use_colors, int terminal_width) {
+    if (show_event && !compact_mode && !tiny_mode && (event == "QUOTA_RESET" || event == "POSSIBLE_RESET")) {
+        if (use_colors) {
+            std::cout << "\033[33m"; // Yellow
+        }
+        std::cout << "*** " << event << " DETECTED ***" << std::endl;
+        if (use_colors) {
+            std::cout << "\033[0m"; // Reset
         }
+    }
+
+    if (tiny_mode) {
+        std::cout << render_tiny_usage_line(data.percentage, use_colors) << std::endl;
+        return;
+    }
 
-        last = attempt(m);
-        if (check_success(last)) {
-            preferred_method = m;
-            if (used_method_out) {
-                *used_method_out = m;
+    if (!compact_mode) {
+        std::cout << "Firmware API Quota Details:" << std::endl;
+        std::cout << "==========================" << std::endl;
+    }
+
+    print_quota_details(data, text_mode, compact_mode, use_colors, terminal_width,
+                        g_history_enabled ? &g_history : nullptr);
+}
+
+// Fetch and display quota information
+int fetch_and_display_quota(const std::string& api_key, const std::string& token, 
+                              bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode,
+                              bool use_colors, int terminal_width,
+                              const std::string& log_file,
+                              std::optional<AuthMethod>& preferred_auth_method,
+                              QuotaData* last_sample,
+                              std::string* last_event,
+                              bool truncate_error_body,
+                              long* rate_limit_out) {
+    // Try different auth methods
+    std::optional<AuthMethod> used_method;
+    const auto fetch_start = std::chrono::steady_clock::now();
+    RequestResult result = try_auth_methods(api_key, token, preferred_auth_method, &used_method);
+    const double latency_ms = capture_latency_ms(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fetch_start).count());
+
+    if (g_timings) {
+        g_last_timings = format_request_timings(result.timings);
+    }
+
+    // Server-requested delay for the next fetch (-1 when not throttled)
+    long rate_limit_s = -1;
+    if (request_rate_limited(result, &rate_limit_s) && !log_file.empty()) {
+        write_log_rate_limited(log_file, result, rate_limit_s);
+    }
+    if (rate_limit_out) {
+        *rate_limit_out = rate_limit_s;
+    }
+
+    // In --jsonl and --status mode failures are also reported on stdout so
+    // the stream stays one line per refresh; --serve subscribers get the
+    // same error record.
+    auto emit_jsonl_error = [&](const std::string& message) {
+        if (g_status_mode) {
+            // A transfer cut short by Ctrl+C/SIGTERM is not a quota error.
+            if (result.curl_code != CURLE_ABORTED_BY_CALLBACK) {
+                std::cout << status_format_line(&g_status_writer, nullptr, message.c_str(), clock_now()) << '\n'
+                          << std::flush;
             }
-            return last;
         }
-
-        // Stop early if the failure isn't auth-related.
-        if (last.curl_code != CURLE_OK || (!is_auth_failure(last) && !is_http_success(last.http_code))) {
-            break;
+        if (!jsonl_mode && !g_push_server) {
+            return;
+        }
+        JsonlRecord rec;
+        rec.timestamp = static_cast<int64_t>(clock_now());
+        rec.ok = false;
+        rec.error = message.c_str();
+        rec.http_code = result.http_code;
+        rec.latency_ms = latency_ms;
+        const std::string& line = jsonl_format_record(&g_jsonl_writer, rec);
+        if (g_push_server) {
+            push_server_publish(g_push_server, line);
         }
+        if (jsonl_mode) {
+            std::cout << line << '\n' << std::flush;
+        }
+    };
+
+    if (result.curl_code != CURLE_OK) {
+        const std::string message = describe_request_failure(result);
+        std::cerr << message << std::endl;
+        emit_jsonl_error(message);
+        return 1;
     }
 
-    return last;
-}
+    if (!is_http_success(result.http_code)) {
+        std::cerr << "HTTP error: " << result.http_code << std::endl;
+        if (!result.body.empty()) {
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+        }
+        emit_jsonl_error("HTTP error: " + std::to_string(result.http_code));
+        return 1;
+    }
 
-// Format ISO 8601 timestamp to readable format in local timezone
-std::string format_timestamp(const std::string& iso_timestamp) {
-    // Simple parsing for ISO 8601 format: YYYY-MM-DDTHH:MM:SS.sssZ
-    if (iso_timestamp.length() < 19) {
-        return iso_timestamp;
+    if (is_auth_failure(result)) {
+        std::cerr << "Error: Unauthorized after trying all auth methods." << std::endl;
+        if (!result.body.empty()) {
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+        }
+        emit_jsonl_error("Unauthorized after trying all auth methods");
+        return 1;
     }
     
-    struct tm tm_info = {};
-    std::istringstream ss(iso_timestamp);
+    QuotaData current_data;
+    std::string event = "UPDATE";
+    if (result.unchanged && last_sample && last_sample->timestamp != 0) {
+        // Same body as the previous fetch: same sample and no event; the log
+        // only gets a heartbeat row now and then
+        current_data = *last_sample;
+        current_data.timestamp = clock_now();
+        if (!log_file.empty() && log_heartbeat_due(log_file, current_data.timestamp)) {
+            write_log_entry(log_file, current_data, event);
+        }
+    } else {
+        // Parse JSON response
+        json j;
+        try {
+            j = json::parse(result.body);
+        } catch (const json::parse_error& e) {
+            std::cerr << "Failed to parse response. Raw response:" << std::endl;
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+            emit_jsonl_error("Failed to parse response");
+            return 1;
+        }
+    
+        // Extract used and reset fields
+        if (!j.contains("used") || j["used"].is_null()) {
+            std::cerr << "Failed to parse response. Raw response:" << std::endl;
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+            emit_jsonl_error("Failed to parse response (missing 'used')");
+            return 1;
+        }
     
-    // Parse: YYYY-MM-DDTHH:MM:SS (this is in UTC)
-    ss >> std::get_time(&tm_info, "%Y-%m-%dT%H:%M:%S");
+        double used = j["used"];
+        std::string reset = j.contains("reset") && !j["reset"].is_null() ? j["reset"].get<std::string>() : "";
     
-    if (ss.fail()) {
-        return iso_timestamp; // Return original if parsing fails
-    }
+        // Calculate percentage
+        double percentage = used * 100.0;
     
-    // Convert from UTC to time_t
-    time_t utc_time = timegm(&tm_info);
+        // Prepare current quota data
+        current_data.used = used;
+        current_data.percentage = percentage;
+        current_data.reset_time = reset.empty() ? "N/A" : reset;
+        current_data.timestamp = clock_now();
     
-    if (utc_time == -1) {
-        return iso_timestamp; // Return original if conversion fails
+        // Handle logging if enabled
+        if (!log_file.empty()) {
+            QuotaData previous_data = read_last_log_entry(log_file);
+            event = detect_event(current_data, previous_data);
+            write_log_entry(log_file, current_data, event);
+        } else if (last_sample) {
+            // No log to compare against: detect events against the previous refresh.
+            event = detect_event(current_data, *last_sample);
+        }
     }
-    
-    // Convert to local time
-    struct tm* local_tm = localtime(&utc_time);
-    if (!local_tm) {
-        return iso_timestamp; // Return original if conversion fails
+    if (last_sample) {
+        *last_sample = current_data;
     }
-    
-    char buffer[80];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S %Z", local_tm);
-    
-    return std::string(buffer);
+    if (last_event) {
+        *last_event = event;
+    }
+    if (g_history_enabled) {
+        history_push(&g_history, current_data.timestamp, current_data.percentage);
+    }
+
+    // Machine-readable outputs share one serialized line per refresh.
+    if (jsonl_mode || g_push_server) {
+        const std::string& line = jsonl_format_record(&g_jsonl_writer,
+                                                      make_snapshot_record(current_data, event, latency_ms));
+        if (g_push_server) {
+            push_server_publish(g_push_server, line);
+        }
+        if (jsonl_mode) {
+            std::cout << line << '\n' << std::flush;
+            return 0;
+        }
+    }
+    if (g_status_mode) {
+        std::cout << status_format_line(&g_status_writer, &current_data, nullptr, clock_now()) << '\n'
+                  << std::flush;
+        return 0;
+    }
+
+    // Display results (with the reset banner only when events come from the log)
+    display_quota(current_data, event, !log_file.empty(), text_mode, compact_mode, tiny_mode,
+                  use_colors, terminal_width);
+
+    return 0;
 }
 
-// Get current timestamp as string
-std::string get_timestamp_string() {
-    time_t now = time(nullptr);
-    struct tm* local_tm = localtime(&now);
-    char buffer[80];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", local_tm);
-    return std::string(buffer);
+// Per-account state for --key-file mode (auth method, log and history are
+// tracked separately for every key)
+struct AccountView {
+    std::string name;
+    std::string api_key;
+    std::string token;
+    std::string log_file;
+    std::optional<AuthMethod> preferred_auth_method;
+    QuotaData last_sample = {0.0, 0.0, "", 0};
+    bool ok = false;            // last fetch succeeded
+    std::string event;          // event of last_sample
+    std::string error;          // last fetch error (when !ok)
+};
+
+// Draw every account from its last fetch result. report_errors repeats the
+// fetch errors on stderr (they are part of the frame when stderr is the tty).
+static void display_accounts(const std::vector<AccountView>& accounts,
+                             bool text_mode, bool compact_mode, bool tiny_mode,
+                             bool use_colors, int terminal_width, bool report_errors) {
+    if (!compact_mode && !tiny_mode) {
+        std::cout << "Firmware API Quota Details:" << std::endl;
+        std::cout << "==========================" << std::endl;
+    }
+
+    std::string tiny_line;
+    for (const AccountView& acct : accounts) {
+        if (!acct.ok) {
+            if (report_errors) {
+                std::cerr << acct.name << ": " << acct.error << std::endl;
+            }
+            if (tiny_mode) {
+                tiny_line += (tiny_line.empty() ? "" : " ") + acct.name + ":ERR";
+            } else {
+                std::cout << (compact_mode ? "" : "\n") << acct.name << ": error" << std::endl;
+            }
+            continue;
+        }
+
+        if (tiny_mode) {
+            tiny_line += (tiny_line.empty() ? "" : " ") + acct.name + ":" +
+                         render_tiny_usage_line(acct.last_sample.percentage, use_colors);
+            continue;
+        }
+
+        if (compact_mode) {
+            std::cout << truncate_right(acct.name, static_cast<size_t>(terminal_width)) << std::endl;
+        } else {
+            std::cout << std::endl << "[" << acct.name << "]";
+            if (acct.event == "QUOTA_RESET" || acct.event == "POSSIBLE_RESET") {
+                std::cout << (use_colors ? " \033[33m*** " : " *** ") << acct.event << " ***"
+                          << (use_colors ? "\033[0m" : "");
+            }
+            std::cout << std::endl;
+        }
+        print_quota_details(acct.last_sample, text_mode, compact_mode, use_colors, terminal_width, nullptr);
+    }
+
+    if (tiny_mode) {
+        std::cout << tiny_line << std::endl;
+    }
 }
 
-// Read last quota entry from log file
-QuotaData read_last_log_entry(const std::string& log_file) {
-    QuotaData last_data = {0.0, 0.0, "", 0};
-    
-    std::ifstream file(log_file);
-    if (!file.is_open()) {
-        return last_data; // No previous log
+// Fetch all accounts concurrently and display them together. rate_limit_out
+// gets the longest server-requested delay (-1 when no account was throttled).
+static int fetch_and_display_accounts(std::vector<AccountView>& accounts,
+                                      bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode,
+                                      bool use_colors, int terminal_width, long* rate_limit_out) {
+    std::vector<AuthJob> jobs(accounts.size());
+    for (size_t i = 0; i < accounts.size(); i++) {
+        jobs[i].api_key = accounts[i].api_key;
+        jobs[i].token = accounts[i].token;
+        jobs[i].preferred_method = accounts[i].preferred_auth_method;
+    }
+
+    const auto fetch_start = std::chrono::steady_clock::now();
+    try_auth_methods_concurrent(jobs);
+    const double latency_ms = capture_latency_ms(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fetch_start).count());
+
+    size_t failures = 0;
+    long rate_limit_s = -1;
+    if (g_timings) {
+        g_last_timings.clear();
+    }
+    for (size_t i = 0; i < accounts.size(); i++) {
+        AccountView& acct = accounts[i];
+        acct.preferred_auth_method = jobs[i].preferred_method;
+        if (g_timings) {
+            g_last_timings += (i == 0 ? "" : "\n         ") + acct.name + "  " +
+                              format_request_timings(jobs[i].result.timings);
+        }
+
+        long throttle_s = 0;
+        if (request_rate_limited(jobs[i].result, &throttle_s)) {
+            rate_limit_s = std::max(rate_limit_s, throttle_s);
+            if (!acct.log_file.empty()) {
+                write_log_rate_limited(acct.log_file, jobs[i].result, throttle_s);
+            }
+        }
+
+        // Unchanged body: reuse the account's sample instead of parsing
+        QuotaData current_data;
+        std::string error;
+        const bool reuse = jobs[i].result.unchanged && acct.ok && acct.last_sample.timestamp != 0;
+        if (reuse) {
+            current_data = acct.last_sample;
+            current_data.timestamp = clock_now();
+        } else if (!parse_quota_result(jobs[i].result, &current_data, &error)) {
+            failures++;
+            acct.ok = false;
+            acct.error = error;
+            if (jsonl_mode) {
+                std::cerr << acct.name << ": " << error << std::endl;
+            }
+            if (jsonl_mode || g_push_server) {
+                JsonlRecord rec;
+                rec.account = acct.name.c_str();
+                rec.timestamp = static_cast<int64_t>(clock_now());
+                rec.ok = false;
+                rec.error = error.c_str();
+                rec.http_code = jobs[i].result.http_code;
+                rec.latency_ms = latency_ms;
+                const std::string& line = jsonl_format_record(&g_jsonl_writer, rec);
+                if (g_push_server) {
+                    push_server_publish(g_push_server, line);
+                }
+                if (jsonl_mode) {
+                    std::cout << line << '\n';
+                }
+            }
+            continue;
+        }
+
+        std::string event = "UPDATE";
+        if (reuse) {
+            if (!acct.log_file.empty() && log_heartbeat_due(acct.log_file, current_data.timestamp)) {
+                write_log_entry(acct.log_file, current_data, event);
+            }
+        } else if (!acct.log_file.empty()) {
+            QuotaData previous_data = read_last_log_entry(acct.log_file);
+            event = detect_event(current_data, previous_data);
+            write_log_entry(acct.log_file, current_data, event);
+        } else {
+            event = detect_event(current_data, acct.last_sample);
+        }
+        acct.last_sample = current_data;
+        acct.ok = true;
+        acct.event = event;
+        acct.error.clear();
+
+        if (jsonl_mode || g_push_server) {
+            JsonlRecord rec = make_snapshot_record(current_data, event, latency_ms);
+            rec.account = acct.name.c_str();
+            const std::string& line = jsonl_format_record(&g_jsonl_writer, rec);
+            if (g_push_server) {
+                push_server_publish(g_push_server, line);
+            }
+            if (jsonl_mode) {
+                std::cout << line << '\n';
+            }
+        }
     }
-    
-    std::string line;
-    std::string last_line;
-    
-    // Skip header if present
-    std::getline(file, line);
-    if (line.find("Timestamp") == std::string::npos) {
-        last_line = line; // First line is data, not header
+
+    if (!jsonl_mode) {
+        display_accounts(accounts, text_mode, compact_mode, tiny_mode, use_colors, terminal_width, true);
     }
-    
-    // Read to end to get last line
-    while (std::getline(file, line)) {
-        if (!line.empty()) {
-            last_line = line;
+    std::cout.flush();
+
+    if (rate_limit_out) {
+        *rate_limit_out = rate_limit_s;
+    }
+
+    // Keep refreshing while at least one account is healthy.
+    return (failures == accounts.size()) ? 1 : 0;
+}
+
+// --timings lines (stderr, so --jsonl and --status output stays clean)
+static void print_timings() {
+    if (!g_timings) {
+        return;
+    }
+    std::cerr << "Transport: " << describe_request_transport(get_request_transport()) << std::endl;
+    if (!g_last_timings.empty()) {
+        std::cerr << "Timings: " << g_last_timings << std::endl;
+    }
+}
+
+// Retry notice and refresh hint under each refreshed frame
+static void print_refresh_footer(const std::string& retry_status, int refresh_interval,
+                                 bool compact_mode, bool tiny_mode, bool jsonl_mode, bool interactive) {
+    if (!retry_status.empty()) {
+        // Error occurred, but continue trying (with backoff)
+        std::cerr << std::endl << retry_status << std::endl;
+    }
+    print_timings();
+
+    // Show next refresh time
+    if (!compact_mode && !tiny_mode && !jsonl_mode) {
+        std::cout << std::endl << "Refreshing every " << refresh_interval << " seconds";
+        if (interactive) {
+            std::cout << " (r refresh, +/- interval, c/t layout, q quit)" << std::endl;
+        } else {
+            std::cout << " (Ctrl+C to stop)..." << std::endl;
+        }
+    }
+}
+
+// Render the newest record of a followed log (--follow). Nothing is fetched:
+// the record is exactly what the writing instance logged. jsonl_mode covers
+// --status as well (one line per record).
+static void display_log_record(const QuotaData* data, const std::string& event,
+                               const std::string& follow_file,
+                               bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode,
+                               bool use_colors, int terminal_width) {
+    if (jsonl_mode) {
+        if (data && g_status_mode) {
+            std::cout << status_format_line(&g_status_writer, data, nullptr, clock_now()) << '\n' << std::flush;
+        } else if (data) {
+            std::cout << jsonl_format_record(&g_jsonl_writer, make_snapshot_record(*data, event)) << '\n'
+                      << std::flush;
         }
+        return;
+    }
+
+    if (!data) {
+        std::cout << (tiny_mode ? "--%" : "Waiting for " + follow_file + "...") << std::endl;
+        return;
+    }
+
+    if (tiny_mode) {
+        std::cout << render_tiny_usage_line(data->percentage, use_colors) << std::endl;
+        return;
+    }
+
+    if (!compact_mode) {
+        std::cout << "Firmware API Quota Details:" << std::endl;
+        std::cout << "==========================" << std::endl;
+        if (event == "QUOTA_RESET" || event == "POSSIBLE_RESET") {
+            std::cout << (use_colors ? "\033[33m" : "") << "*** " << event << " DETECTED ***"
+                      << (use_colors ? "\033[0m" : "") << std::endl;
+        }
+    }
+
+    print_quota_details(*data, text_mode, compact_mode, use_colors, terminal_width,
+                        g_history_enabled ? &g_history : nullptr);
+
+    if (!compact_mode) {
+        char when[32];
+        const struct tm local_tm = clock_localtime(data->timestamp);
+        strftime(when, sizeof(when), "%H:%M:%S", &local_tm);
+        std::cout << std::endl << "Following " << follow_file << " (last record " << when << ")" << std::endl;
+    }
+    std::cout.flush();
+}
+
+// --follow: block on inotify and redraw only when the log grows
+static int follow_and_display(const std::string& follow_file,
+                              bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode) {
+    std::string error;
+    LogFollower* follower = log_follower_open(follow_file, &error);
+    if (!follower) {
+        std::cerr << "Error: --follow: " << error << std::endl;
+        return 1;
+    }
+
+    // The history comes from the log itself; the follower's first batch (the
+    // same tail) is not added twice.
+    if (g_history_enabled) {
+        history_seed_from_log(&g_history, follow_file, clock_now() - kQuotaWindowSeconds);
+    }
+
+    QuotaData latest = {0.0, 0.0, "", 0};
+    std::string latest_event;
+    bool have_record = false;
+    bool first_batch = true;
+    bool redraw = true;
+    std::vector<std::string> lines;
+    int result = 0;
+
+    while (true) {
+        lines.clear();
+        if (!log_follower_read(follower, &lines, &error)) {
+            std::cerr << "Error: --follow: " << error << std::endl;
+            result = 1;
+            break;
+        }
+
+        // In jsonl mode every record is forwarded; otherwise only the newest
+        // one in the batch is drawn.
+        bool changed = false;
+        for (const std::string& line : lines) {
+            QuotaData data;
+            std::string event;
+            if (!parse_log_line(line, &data, &event)) {
+                continue; // Header or partial garbage
+            }
+            latest = data;
+            latest_event = event;
+            have_record = true;
+            changed = true;
+            if (g_history_enabled && !first_batch) {
+                history_push(&g_history, data.timestamp, data.percentage);
+            }
+            if (jsonl_mode && !g_status_mode) {
+                display_log_record(&latest, latest_event, follow_file, text_mode, compact_mode, tiny_mode,
+                                   true, false, 0);
+            }
+        }
+        if (g_status_mode && changed) {
+            // A status bar only needs the newest record of the batch.
+            display_log_record(&latest, latest_event, follow_file, text_mode, compact_mode, tiny_mode,
+                               true, false, 0);
+        }
+
+        if (!jsonl_mode && (changed || redraw)) {
+            const bool use_colors = isatty(STDOUT_FILENO);
+            if (use_colors) {
+                frame_begin();
+            }
+            display_log_record(have_record ? &latest : nullptr, latest_event, follow_file,
+                               text_mode, compact_mode, tiny_mode, false,
+                               use_colors, get_terminal_width());
+            if (use_colors) {
+                frame_end();
+            }
+        }
+        redraw = false;
+        first_batch = false;
+
+        struct pollfd fds[2];
+        fds[0].fd = log_follower_fd(follower);
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = g_signal_fd;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+            std::cerr << "Error: --follow: poll: " << std::strerror(errno) << std::endl;
+            result = 1;
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            const int term_signal = read_terminal_signals(&redraw);
+            if (term_signal != 0) {
+                result = 128 + term_signal;
+                break;
+            }
+        }
+    }
+
+    log_follower_close(follower);
+    return result;
+}
+
+// ============================================================================
+// Dashboard (--dashboard)
+// ============================================================================
+
+// Full-screen view on the alternate screen. Panes are re-rendered only when
+// their inputs change (the usage pane every second for the countdown, the
+// others after a fetch or a resize); the differential renderer then sends only
+// the cells that differ. Fetches run on their own timer, independent of the
+// 1 Hz redraw.
+struct DashboardView {
+    DashboardStats stats;
+    QuotaData sample = {0.0, 0.0, "", 0};
+    bool have_sample = false;
+    std::string event;
+    RetryState retry;
+
+    DashboardPane usage{"Usage", {}, true};
+    DashboardPane window{"Window", {}, true};
+    DashboardPane forecast{"Forecast", {}, true};
+    DashboardPane latency{"Fetch latency", {}, true};
+    DashboardPane events{"Events", {}, true};
+    DashboardPane errors{"Errors", {}, true};
+
+    int width = 0;
+    int height = 0;
+    std::string frame;          // reused frame buffer
+};
+
+static volatile sig_atomic_t g_dashboard_screen = 0;
+
+static void dashboard_leave_screen() {
+    if (g_dashboard_screen) {
+        static const char kLeave[] = "\033[0m\033[?25h\033[?1049l";
+        (void)!write(STDOUT_FILENO, kLeave, sizeof(kLeave) - 1);
+        g_dashboard_screen = 0;
+    }
+}
+
+static void dashboard_enter_screen() {
+    static const char kEnter[] = "\033[?1049h\033[?25l";
+    (void)!write(STDOUT_FILENO, kEnter, sizeof(kEnter) - 1);
+    g_dashboard_screen = 1;
+    screen_invalidate(&g_screen);
+}
+
+static std::string format_clock(time_t t, const char* format) {
+    char buf[32];
+    const struct tm local_tm = clock_localtime(t);
+    strftime(buf, sizeof(buf), format, &local_tm);
+    return buf;
+}
+
+static std::string format_ms(double ms) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(ms < 10.0 ? 1 : 0) << ms << " ms";
+    return out.str();
+}
+
+// Usage and reset bars; redrawn every second for the countdown
+static void render_usage_pane(DashboardView* v) {
+    DashboardPane& pane = v->usage;
+    pane.lines.clear();
+    if (!v->have_sample) {
+        pane.lines.push_back("Waiting for the first fetch...");
+        return;
+    }
+
+    pane.lines.push_back(render_progress_bar(v->sample.percentage, v->width, true));
+    time_t reset_utc = 0;
+    if (parse_iso8601_utc_to_time_t(v->sample.reset_time, &reset_utc)) {
+        pane.lines.push_back(render_reset_time_bar(reset_utc, v->width, true));
+        pane.lines.push_back("Resets at: " + format_timestamp(v->sample.reset_time));
+    } else {
+        pane.lines.push_back("Reset: No active window (quota not used recently)");
+    }
+}
+
+static void render_window_pane(DashboardView* v, int chart_height) {
+    DashboardPane& pane = v->window;
+    pane.lines.clear();
+
+    std::ostringstream out;
+    print_history_chart(out, &g_history, v->width, chart_height);
+    std::istringstream in(out.str());
+    std::string line;
+    while (std::getline(in, line)) {
+        pane.lines.push_back(line);
+    }
+}
+
+// Burn rate since the window opened and where it leads; all of it is as of
+// the sample, so the pane changes only after a fetch.
+static void render_forecast_pane(DashboardView* v) {
+    DashboardPane& pane = v->forecast;
+    pane.lines.clear();
+
+    time_t reset_utc = 0;
+    if (!v->have_sample || !parse_iso8601_utc_to_time_t(v->sample.reset_time, &reset_utc)) {
+        pane.lines.push_back(v->have_sample ? "No active window" : "No data yet");
+        return;
+    }
+
+    const time_t sampled = v->sample.timestamp;
+    const double elapsed_h = difftime(sampled, reset_utc - kQuotaWindowSeconds) / 3600.0;
+    const double projected = forecast_usage_at_reset(v->sample, sampled);
+    if (projected < 0.0 || elapsed_h <= 0.0) {
+        // Younger than a minute, or a reset time outside the 5 h window
+        pane.lines.push_back(elapsed_h >= 0.0 && elapsed_h < 1.0 / 60.0 ? "Window just opened" : "No forecast for this window");
+        return;
+    }
+
+    const double rate = v->sample.percentage / elapsed_h;
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1) << "Burn rate: " << rate << "%/h";
+    pane.lines.push_back(line.str());
+
+    line.str(std::string());
+    line << std::setprecision(0) << "At reset:  " << get_color_for_percentage(projected, true) << projected
+         << "%\033[0m projected";
+    pane.lines.push_back(line.str());
+
+    if (projected >= 100.0 && rate > 0.0) {
+        const time_t limit_at = sampled + static_cast<time_t>((100.0 - v->sample.percentage) / rate * 3600.0);
+        pane.lines.push_back("Limit at:  " + format_clock(limit_at, "%H:%M") + " (before reset)");
+    } else {
+        line.str(std::string());
+        line << "Headroom:  " << (100.0 - projected) << "% at reset";
+        pane.lines.push_back(line.str());
+    }
+    pane.lines.push_back("As of " + format_clock(sampled, "%H:%M:%S"));
+}
+
+static void render_latency_pane(DashboardView* v) {
+    DashboardPane& pane = v->latency;
+    pane.lines.clear();
+
+    const LatencySummary s = dashboard_latency_summary(&v->stats);
+    if (s.count == 0) {
+        pane.lines.push_back("No fetches yet");
+        return;
     }
-    file.close();
-    
-    if (last_line.empty()) {
-        return last_data;
+    pane.lines.push_back("Last: " + format_ms(s.last) + "  (" + std::to_string(s.count) + " samples)");
+    pane.lines.push_back("p50:  " + format_ms(s.p50) + "  p95: " + format_ms(s.p95));
+    pane.lines.push_back("Min:  " + format_ms(s.min) + "  Max: " + format_ms(s.max));
+
+    const HedgeStats h = get_hedge_stats();
+    if (h.enabled && h.requests > 0) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "Hedged: " << h.hedged << " ("
+             << 100.0 * h.hedged / h.requests << "%)  won " << h.hedge_wins;
+        pane.lines.push_back(line.str());
     }
-    
-    // Parse CSV: Timestamp,Used,Percentage,Reset,Event
-    std::istringstream ss(last_line);
-    std::string timestamp_str, used_str, percentage_str, reset_str, event;
-    
-    std::getline(ss, timestamp_str, ',');
-    std::getline(ss, used_str, ',');
-    std::getline(ss, percentage_str, ',');
-    std::getline(ss, reset_str, ',');
-    
-    try {
-        last_data.used = std::stod(used_str);
-        last_data.percentage = std::stod(percentage_str);
-        last_data.reset_time = reset_str;
-        
-        // Parse timestamp to time_t
-        struct tm tm_info = {};
-        strptime(timestamp_str.c_str(), "%Y-%m-%d %H:%M:%S", &tm_info);
-        last_data.timestamp = mktime(&tm_info);
-    } catch (...) {
-        // Parsing failed, return empty data
+    if (g_timings) {
+        pane.lines.push_back("Via:  " + describe_request_transport(get_request_transport()));
+        pane.lines.push_back("Phases: " + g_last_timings);
     }
-    
-    return last_data;
 }
 
-// Detect if quota was reset
-std::string detect_event(const QuotaData& current, const QuotaData& previous) {
-    if (previous.timestamp == 0) {
-        return "FIRST_RUN";
+static void render_events_pane(DashboardView* v) {
+    DashboardPane& pane = v->events;
+    pane.lines.clear();
+
+    if (v->stats.events.empty()) {
+        pane.lines.push_back("No events yet");
+        return;
     }
-    
-    // Calculate time difference in hours
-    double hours_diff = difftime(current.timestamp, previous.timestamp) / 3600.0;
-    
-    // If usage decreased significantly (more than 20%), it's likely a reset
-    if (current.percentage < previous.percentage - 20.0) {
-        return "QUOTA_RESET";
+    for (const DashboardEvent& ev : v->stats.events) {
+        std::ostringstream line;
+        line << format_clock(ev.timestamp, "%H:%M:%S") << "  ";
+        if (ev.name == "QUOTA_RESET" || ev.name == "POSSIBLE_RESET" || ev.name == "HIGH_USAGE") {
+            line << "\033[33m" << ev.name << "\033[0m";
+        } else {
+            line << ev.name;
+        }
+        line << std::fixed << std::setprecision(1) << "  " << ev.percentage << "%";
+        pane.lines.push_back(line.str());
     }
-    
-    // If more than 5 hours passed and usage is low, might be a reset
-    if (hours_diff >= 5.0 && current.percentage < 10.0) {
-        return "POSSIBLE_RESET";
+}
+
+static void render_errors_pane(DashboardView* v) {
+    DashboardPane& pane = v->errors;
+    pane.lines.clear();
+
+    const DashboardStats& s = v->stats;
+    std::ostringstream line;
+    line << "Fetches: " << s.fetches << "  failed: " << s.failures;
+    if (s.fetches > 0 && s.failures > 0) {
+        line << std::fixed << std::setprecision(1) << " (" << (100.0 * s.failures / s.fetches) << "%)";
     }
-    
-    // If usage increased significantly
-    if (current.percentage > previous.percentage + 10.0) {
-        return "HIGH_USAGE";
+    pane.lines.push_back(line.str());
+
+    line.str(std::string());
+    for (int k = 0; k < kFetchErrorKinds; k++) {
+        line << (k == 0 ? "" : "  ") << fetch_error_name(static_cast<FetchError>(k)) << ": " << s.errors[k];
+    }
+    pane.lines.push_back(line.str());
+
+    if (!s.last_error.empty()) {
+        pane.lines.push_back("\033[31m" + format_clock(s.last_error_time, "%H:%M:%S") + " " + s.last_error + "\033[0m");
     }
-    
-    // Normal update
-    return "UPDATE";
 }
 
-// Write log entry
-void write_log_entry(const std::string& log_file, const QuotaData& data, const std::string& event) {
-    bool file_exists = false;
-    struct stat buffer;
-    if (stat(log_file.c_str(), &buffer) == 0) {
-        file_exists = true;
+// Compose the frame from the cached panes (re-rendering the dirty ones) and
+// draw the difference
+static void dashboard_draw(DashboardView* v, int refresh_interval, int next_fetch_in, bool fetching) {
+    const int width = get_terminal_width();
+    const int height = get_terminal_height();
+    if (width != v->width || height != v->height) {
+        v->width = width;
+        v->height = height;
+        for (DashboardPane* pane : {&v->usage, &v->window, &v->forecast, &v->latency, &v->events, &v->errors}) {
+            pane->dirty = true;
+        }
     }
-    
-    std::ofstream file(log_file, std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Warning: Could not open log file: " << log_file << std::endl;
-        return;
+
+    // Rows: header, usage (1+3), window (1+chart+2), forecast|latency (1+4),
+    // events|errors (1+n), footer. The chart and the event list share what
+    // is left of the height.
+    const int chart_height = std::min(std::max(height - 20, 3), 10);
+    const int event_rows = std::min(std::max(height - 15 - chart_height, 3), static_cast<int>(kDashboardEventCapacity));
+    const bool side_by_side = width >= 70;
+    const bool utf8 = is_utf8_locale();
+
+    // Only the countdown changes between fetches.
+    v->usage.dirty = true;
+    struct PaneRenderer {
+        DashboardPane* pane;
+        void (*render)(DashboardView*);
+    };
+    for (const PaneRenderer& r : {PaneRenderer{&v->usage, render_usage_pane},
+                                  PaneRenderer{&v->forecast, render_forecast_pane},
+                                  PaneRenderer{&v->latency, render_latency_pane},
+                                  PaneRenderer{&v->events, render_events_pane},
+                                  PaneRenderer{&v->errors, render_errors_pane}}) {
+        if (r.pane->dirty) {
+            r.render(v);
+            r.pane->dirty = false;
+        }
     }
-    
-    // Write header if new file
-    if (!file_exists) {
-        file << "Timestamp,Used,Percentage,Reset,Event" << std::endl;
+    if (v->window.dirty) {
+        render_window_pane(v, chart_height);
+        v->window.dirty = false;
     }
-    
-    // Write data
-    file << get_timestamp_string() << ","
-         << std::fixed << std::setprecision(4) << data.used << ","
-         << std::fixed << std::setprecision(2) << data.percentage << ","
-         << data.reset_time << ","
-         << event << std::endl;
-    
-    file.close();
-}
 
-#ifdef GUI_MODE_ENABLED
-// Forward declaration for GUI mode
-static int run_gui_mode(const std::string& api_key, int refresh_interval,
-                       const std::string& log_file, bool logging_enabled,
-                       int* argc, char*** argv);
-#endif
+    std::string& frame = v->frame;
+    frame.clear();
 
-// Print usage information
-void print_usage(const char* program_name) {
-    std::cerr << "Usage: " << program_name << " [OPTIONS] [API_KEY]" << std::endl;
-    std::cerr << std::endl;
-    std::cerr << "Options:" << std::endl;
-    std::cerr << "  --gui, -g            Launch GUI mode" << std::endl;
-    std::cerr << "  --refresh <seconds>  Refresh continuously every N seconds (default: 15)" << std::endl;
-    std::cerr << "  -1                   Single run (no refresh loop)" << std::endl;
-    std::cerr << "  --text              Pure text output (no progress bar)" << std::endl;
-    std::cerr << "  --log <file>        Log quota changes to CSV file (default: ./show_quota.log)" << std::endl;
-    std::cerr << "  --no-log            Disable logging" << std::endl;
-    std::cerr << "  --compact           Compact bar layout for ~40-column terminals" << std::endl;
-    std::cerr << "  --tiny              Extra small single-line output: XX%" << std::endl;
-    std::cerr << "  --help              Show this help message" << std::endl;
-    std::cerr << std::endl;
-    std::cerr << "API Key:" << std::endl;
-    std::cerr << "  Can be passed as argument or set FIRMWARE_API_KEY environment variable" << std::endl;
-    std::cerr << std::endl;
-    std::cerr << "Logging:" << std::endl;
-    std::cerr << "  Logs are written in CSV format with columns:" << std::endl;
-    std::cerr << "  Timestamp, Used, Percentage, Reset, Event" << std::endl;
-    std::cerr << "  Events: FIRST_RUN, UPDATE, QUOTA_RESET, POSSIBLE_RESET, HIGH_USAGE" << std::endl;
-    std::cerr << std::endl;
-    std::cerr << "Examples:" << std::endl;
-    std::cerr << "  " << program_name << " --gui fw_api_xxx" << std::endl;
-    std::cerr << "  " << program_name << " fw_api_xxx" << std::endl;
-    std::cerr << "  " << program_name << " --refresh 60 fw_api_xxx" << std::endl;
-    std::cerr << "  " << program_name << " -1 fw_api_xxx" << std::endl;
-    std::cerr << "  " << program_name << " --text --refresh 60 --log quota.csv" << std::endl;
-    std::cerr << "  " << program_name << " --no-log --refresh 60" << std::endl;
-    std::cerr << "  " << program_name << " --log /var/log/firmware_quota.csv" << std::endl;
-    std::cerr << "  " << program_name << " --compact --refresh 60" << std::endl;
-    std::cerr << "  " << program_name << " --tiny --refresh 60" << std::endl;
+    std::string status = fetching ? "fetching..." : "next fetch in " + std::to_string(next_fetch_in) + "s";
+    if (!fetching && retry_waiting(&v->retry)) {
+        status = retry_describe(&v->retry, next_fetch_in);
+    }
+    status += " (every " + std::to_string(refresh_interval) + "s)  " + format_clock(clock_now(), "%H:%M:%S");
+    const std::string title = "\033[1mFirmware API Quota\033[0m";
+    const int gap = width - static_cast<int>(dashboard_visible_width(title) + status.size());
+    frame.append(title).append(static_cast<size_t>(std::max(gap, 1)), ' ').append(status).push_back('\n');
+
+    dashboard_append_row(&frame, v->usage, nullptr, width, 3, utf8);
+    dashboard_append_row(&frame, v->window, nullptr, width, chart_height + 2, utf8);
+    if (side_by_side) {
+        dashboard_append_row(&frame, v->forecast, &v->latency, width, 4, utf8);
+        dashboard_append_row(&frame, v->events, &v->errors, width, event_rows, utf8);
+    } else {
+        dashboard_append_row(&frame, v->forecast, nullptr, width, 4, utf8);
+        dashboard_append_row(&frame, v->latency, nullptr, width, static_cast<int>(std::max<size_t>(v->latency.lines.size(), 3)), utf8);
+        dashboard_append_row(&frame, v->events, nullptr, width, event_rows, utf8);
+        dashboard_append_row(&frame, v->errors, nullptr, width, 3, utf8);
+    }
+    frame.append("q quit  r refresh  +/- interval");
+
+    screen_resize(&g_screen, width, height);
+    screen_present(&g_screen, frame, STDOUT_FILENO);
 }
 
-// Fetch and display quota information
-int fetch_and_display_quota(const std::string& api_key, const std::string& token, 
-                              bool text_mode, bool compact_mode, bool tiny_mode, bool use_colors, int terminal_width,
-                              const std::string& log_file,
-                              std::optional<AuthMethod>& preferred_auth_method,
-                              bool truncate_error_body) {
-    // Try different auth methods
+// One fetch: update the sample, log, history and statistics (no output).
+// Returns the retry (or rate-limit) delay, 0 to keep the interval.
+static int dashboard_fetch(DashboardView* v, const std::string& api_key, const std::string& token,
+                           const std::string& log_file, std::optional<AuthMethod>& preferred_auth_method,
+                           int refresh_interval) {
     std::optional<AuthMethod> used_method;
+    retry_attempt_started(&v->retry);
+    const auto fetch_start = std::chrono::steady_clock::now();
     RequestResult result = try_auth_methods(api_key, token, preferred_auth_method, &used_method);
-
-    if (result.curl_code != CURLE_OK) {
-        std::cerr << "Request failed: " << curl_easy_strerror(result.curl_code);
-        if (!result.curl_error.empty()) {
-            std::cerr << " (" << result.curl_error << ")";
+    const double latency_ms = capture_latency_ms(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fetch_start).count());
+
+    if (result.curl_code == CURLE_ABORTED_BY_CALLBACK) {
+        return 0; // Interrupted by Ctrl+C: not a failure of the API
+    }
+    if (g_timings) {
+        g_last_timings = format_request_timings(result.timings);
+    }
+
+    long rate_limit_s = 0;
+    const bool rate_limited = request_rate_limited(result, &rate_limit_s);
+    if (rate_limited && !log_file.empty()) {
+        write_log_rate_limited(log_file, result, rate_limit_s);
+    }
+
+    // Unchanged body: the previous sample stands (no parse, no event)
+    QuotaData data;
+    std::string error;
+    const bool reuse = result.unchanged && v->have_sample;
+    if (reuse) {
+        data = v->sample;
+        data.timestamp = clock_now();
+    } else if (!parse_quota_result(result, &data, &error)) {
+        dashboard_record_failure(&v->stats, latency_ms, result, error);
+        if (g_push_server) {
+            JsonlRecord rec;
+            rec.timestamp = static_cast<int64_t>(clock_now());
+            rec.ok = false;
+            rec.error = error.c_str();
+            rec.http_code = result.http_code;
+            rec.latency_ms = latency_ms;
+            push_server_publish(g_push_server, jsonl_format_record(&g_jsonl_writer, rec));
         }
-        std::cerr << std::endl;
-        return 1;
+        v->latency.dirty = true;
+        v->errors.dirty = true;
+        return rate_limited ? retry_on_rate_limit(&v->retry, rate_limit_s, refresh_interval)
+                            : retry_on_failure(&v->retry, refresh_interval);
     }
+    retry_on_success(&v->retry);
 
-    if (!is_http_success(result.http_code)) {
-        std::cerr << "HTTP error: " << result.http_code << std::endl;
-        if (!result.body.empty()) {
-            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+    std::string event = "UPDATE";
+    if (reuse) {
+        if (!log_file.empty() && log_heartbeat_due(log_file, data.timestamp)) {
+            write_log_entry(log_file, data, event);
         }
-        return 1;
+    } else if (!log_file.empty()) {
+        QuotaData previous_data = read_last_log_entry(log_file);
+        event = detect_event(data, previous_data);
+        write_log_entry(log_file, data, event);
+    } else {
+        event = detect_event(data, v->have_sample ? v->sample : QuotaData{0.0, 0.0, "", 0});
     }
+    v->sample = data;
+    v->have_sample = true;
+    v->event = event;
+    history_push(&g_history, data.timestamp, data.percentage);
 
-    if (is_auth_failure(result)) {
-        std::cerr << "Error: Unauthorized after trying all auth methods." << std::endl;
-        if (!result.body.empty()) {
-            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
-        }
-        return 1;
+    if (g_push_server) {
+        push_server_publish(g_push_server,
+                            jsonl_format_record(&g_jsonl_writer, make_snapshot_record(data, event, latency_ms)));
     }
-    
-    // Parse JSON response
-    json j;
-    try {
-        j = json::parse(result.body);
-    } catch (const json::parse_error& e) {
-        std::cerr << "Failed to parse response. Raw response:" << std::endl;
-        std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+
+    dashboard_record_success(&v->stats, latency_ms, data, event);
+    v->window.dirty = true;
+    v->forecast.dirty = true;
+    v->latency.dirty = true;
+    v->errors.dirty = true;
+    if (event != "UPDATE") {
+        v->events.dirty = true;
+    }
+    return rate_limited ? retry_on_rate_limit(&v->retry, rate_limit_s, refresh_interval) : 0;
+}
+
+// timerfd deadlines count real time: advance one by `seconds` on the clock
+static void add_clock_seconds(struct timespec* t, int seconds) {
+    const struct timespec span = clock_real_span(seconds);
+    t->tv_sec += span.tv_sec;
+    t->tv_nsec += span.tv_nsec;
+    if (t->tv_nsec >= 1000000000) {
+        t->tv_sec++;
+        t->tv_nsec -= 1000000000;
+    }
+}
+
+// Clock seconds (rounded up) until a timerfd expires
+static int clock_seconds_until(int timer_fd) {
+    struct itimerspec spec = {};
+    timerfd_gettime(timer_fd, &spec);
+    const long real_ms = static_cast<long>(spec.it_value.tv_sec) * 1000 + (spec.it_value.tv_nsec + 999999) / 1000000;
+    return static_cast<int>(std::ceil(clock_seconds(real_ms)));
+}
+
+// --replay: arm the (one-shot) fetch timer for the next recorded fetch at
+// the replay pace. False once the capture is exhausted.
+static bool arm_replay_fetch(int fetch_timer) {
+    const long delay_ms = capture_replay_delay_ms();
+    if (delay_ms < 0) {
+        return false;
+    }
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = delay_ms / 1000;
+    spec.it_value.tv_nsec = (delay_ms % 1000) * 1000000 + 1;   // all zero would disarm
+    timerfd_settime(fetch_timer, 0, &spec, nullptr);
+    return true;
+}
+
+// --dashboard: poll loop over signals, keys, the 1 Hz redraw tick, the
+// fetch timer and connectivity changes
+static int dashboard_and_fetch(const std::string& api_key, const std::string& token, int refresh_interval,
+                               const std::string& log_file, std::optional<AuthMethod>& preferred_auth_method) {
+    if (!isatty(STDOUT_FILENO)) {
+        std::cerr << "Error: --dashboard needs a terminal" << std::endl;
         return 1;
     }
-    
-    // Extract used and reset fields
-    if (!j.contains("used") || j["used"].is_null()) {
-        std::cerr << "Failed to parse response. Raw response:" << std::endl;
-        std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+
+    const bool interactive = enable_key_input();
+    const int fetch_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    const int tick_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fetch_timer < 0 || tick_timer < 0) {
+        std::cerr << "Error: timerfd_create: " << std::strerror(errno) << std::endl;
         return 1;
     }
-    
-    double used = j["used"];
-    std::string reset = j.contains("reset") && !j["reset"].is_null() ? j["reset"].get<std::string>() : "";
-    
-    // Calculate percentage
-    double percentage = used * 100.0;
-    
-    // Prepare current quota data
-    QuotaData current_data;
-    current_data.used = used;
-    current_data.percentage = percentage;
-    current_data.reset_time = reset.empty() ? "N/A" : reset;
-    current_data.timestamp = time(nullptr);
-    
-    // Handle logging if enabled
-    std::string event = "UPDATE";
-    if (!log_file.empty()) {
-        QuotaData previous_data = read_last_log_entry(log_file);
-        event = detect_event(current_data, previous_data);
-        write_log_entry(log_file, current_data, event);
-        
-        // Show event notification for important changes
-        if (!compact_mode && !tiny_mode && (event == "QUOTA_RESET" || event == "POSSIBLE_RESET")) {
-            if (use_colors) {
-                std::cout << "\033[33m"; // Yellow
+
+    // Periodic timers: the fetch schedule does not drift by the fetch
+    // duration, and re-arming restarts it ('r', +/-). After a failure the
+    // first expiry is the retry delay instead.
+    auto arm_fetch = [&](int first_s) {
+        struct itimerspec spec = {};
+        spec.it_value = clock_real_span(first_s > 0 ? first_s : refresh_interval);
+        spec.it_interval = clock_real_span(refresh_interval);
+        timerfd_settime(fetch_timer, 0, &spec, nullptr);
+    };
+    auto next_fetch_in = [&]() {
+        return clock_seconds_until(fetch_timer);
+    };
+    struct itimerspec tick = {};
+    tick.it_value.tv_sec = 1;
+    tick.it_interval.tv_sec = 1;
+    timerfd_settime(tick_timer, 0, &tick, nullptr);
+
+    std::atexit(dashboard_leave_screen);
+    dashboard_enter_screen();
+
+    DashboardView view;
+    retry_init(&view.retry);
+    const int net_fd = net_watch_open();
+    bool fetch_due = true;
+    int result = 0;
+
+    while (true) {
+        if (fetch_due) {
+            // Show that a fetch is in flight; the request blocks the loop.
+            dashboard_draw(&view, refresh_interval, 0, true);
+            const int retry_s = dashboard_fetch(&view, api_key, token, log_file, preferred_auth_method,
+                                                refresh_interval);
+            // A replay follows the capture's pace and stops at its end
+            if (capture_replaying()) {
+                arm_replay_fetch(fetch_timer);
+            } else {
+                arm_fetch(retry_s);
             }
-            std::cout << "*** " << event << " DETECTED ***" << std::endl;
-            if (use_colors) {
-                std::cout << "\033[0m"; // Reset
+            fetch_due = false;
+            if (termination_pending()) {
+                bool resized = false;
+                result = 128 + read_terminal_signals(&resized);
+                break;
             }
         }
-    }
-
-    if (tiny_mode) {
-        std::cout << render_tiny_usage_line(percentage, use_colors) << std::endl;
-        return 0;
-    }
-    
-    // Display results
-    if (!compact_mode) {
-        std::cout << "Firmware API Quota Details:" << std::endl;
-        std::cout << "==========================" << std::endl;
-    }
-    
-    if (text_mode) {
-        // Pure text output
-        std::cout << std::fixed << std::setprecision(2);
-        if (!compact_mode) {
-            std::cout << "Used: " << percentage << "% (" << used << ")" << std::endl;
-        } else {
-            std::cout << std::fixed << std::setprecision(0);
-            std::cout << "U: " << percentage << "%" << std::endl;
+        dashboard_draw(&view, refresh_interval, next_fetch_in(), false);
+
+        struct pollfd fds[5];
+        fds[0].fd = g_signal_fd;
+        fds[1].fd = fetch_timer;
+        fds[2].fd = tick_timer;
+        fds[3].fd = interactive ? STDIN_FILENO : -1;
+        fds[4].fd = net_fd;
+        for (struct pollfd& pfd : fds) {
+            pfd.events = POLLIN;
+            pfd.revents = 0;
         }
-    } else {
-        // Progress bar output
-        if (compact_mode) {
-            std::cout << render_progress_bar_compact(percentage, terminal_width, use_colors) << std::endl;
-        } else {
-            std::cout << render_progress_bar(percentage, terminal_width, use_colors) << std::endl;
+        if (poll(fds, 5, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result = 1;
+            break;
         }
-    }
 
-    if (!reset.empty()) {
-        time_t reset_utc = 0;
-        bool parsed = parse_iso8601_utc_to_time_t(reset, &reset_utc);
-        if (parsed) {
-            if (!text_mode) {
-                if (compact_mode) {
-                    std::cout << render_reset_time_bar_compact(reset_utc, terminal_width, use_colors) << std::endl;
-                } else {
-                    std::cout << render_reset_time_bar(reset_utc, terminal_width, use_colors) << std::endl;
-                }
-            } else {
-                time_t now = time(nullptr);
-                int64_t remaining_seconds = static_cast<int64_t>(difftime(reset_utc, now));
-                if (remaining_seconds < 0) {
-                    remaining_seconds = 0;
-                }
-                if (!compact_mode) {
-                    std::cout << "Reset in: " << format_duration_compact(remaining_seconds) << " (of 5h)" << std::endl;
-                } else {
-                    std::cout << "R: " << format_duration_tight(remaining_seconds) << std::endl;
-                }
+        uint64_t expirations = 0;
+        if (fds[0].revents & POLLIN) {
+            bool resized = false;
+            const int term_signal = read_terminal_signals(&resized);
+            if (term_signal != 0) {
+                result = 128 + term_signal;
+                break;
             }
-
-            std::string reset_readable = format_timestamp(reset);
-            if (!compact_mode) {
-                std::cout << "Resets at: " << reset_readable << std::endl;
+        }
+        if (fds[1].revents & POLLIN) {
+            (void)!read(fetch_timer, &expirations, sizeof(expirations));
+            fetch_due = true;
+        }
+        if (fds[2].revents & POLLIN) {
+            (void)!read(tick_timer, &expirations, sizeof(expirations));
+        }
+        if (fds[3].revents & POLLIN) {
+            const KeyCommands keys = read_key_commands();
+            if (keys.quit) {
+                break;
             }
-        } else {
-            std::string reset_readable = format_timestamp(reset);
-            if (!compact_mode) {
-                std::cout << "Reset: " << reset_readable << std::endl;
-            } else {
-                std::cout << "R: " << truncate_right(reset_readable, static_cast<size_t>(terminal_width)) << std::endl;
+            if (keys.refresh) {
+                fetch_due = true;
+            }
+            if (keys.interval_steps != 0) {
+                refresh_interval = step_refresh_interval(refresh_interval, keys.interval_steps);
+                if (!retry_waiting(&view.retry) && !capture_replaying()) {
+                    arm_fetch(0);
+                }
             }
         }
-    } else {
-        if (!compact_mode) {
-            std::cout << "Reset: No active window (quota not used recently)" << std::endl;
-        } else {
-            std::cout << "R: none" << std::endl;
+        if ((fds[4].revents & POLLIN) && net_watch_read(net_fd) && retry_on_connectivity(&view.retry)) {
+            fetch_due = true;   // back online: retry without waiting out the backoff
         }
     }
-    
-    return 0;
+
+    restore_key_input();
+    dashboard_leave_screen();
+    close(fetch_timer);
+    close(tick_timer);
+    if (net_fd >= 0) {
+        close(net_fd);
+    }
+    return result;
 }
 
 int main(int argc, char* argv[]) {
@@ -1249,9 +2165,27 @@ int main(int argc, char* argv[]) {
     bool text_mode = false;
     bool compact_mode = false;
     bool tiny_mode = false;
+    bool jsonl_mode = false;
     bool gui_mode = false;
     std::string log_file = "show_quota.log";
     bool logging_enabled = true;
+    bool log_given = false;     // --log: also used on a simulated clock
+    bool dbus_enabled = true;
+    int serve_port = 0;
+    RequestTimeouts timeouts;
+    bool timeouts_overridden = apply_timeout_env(&timeouts);   // env or CLI (beats the GUI config)
+    bool hedge = false;
+    RequestTransport transport;
+    bool transport_overridden = apply_transport_env(&transport);  // env or CLI (beats the GUI config)
+    std::string record_file;
+    std::string replay_file;
+    double replay_speed = 1.0;
+    apply_clock_env();
+    double time_scale = 0.0;    // --time-scale / --time-start: 0 / -1 = not given
+    time_t time_start = -1;
+    std::string key_file;
+    std::string follow_file;
+    bool dashboard_mode = false;
 
     // Parse command-line arguments
     for (int i = 1; i < argc; i++) {
@@ -1279,10 +2213,26 @@ int main(int argc, char* argv[]) {
         } else if (arg == "--tiny") {
             tiny_mode = true;
             compact_mode = false;
+        } else if (arg == "--jsonl") {
+            jsonl_mode = true;
+        } else if (arg == "--chart") {
+            g_chart_mode = true;
+        } else if (arg == "--dashboard") {
+            dashboard_mode = true;
+        } else if (arg == "--status") {
+            if (i + 1 < argc && parse_status_format(argv[i + 1], &g_status_writer.format)) {
+                g_status_mode = true;
+                i++;
+            } else {
+                std::cerr << "Error: --status requires a format: i3bar, swaybar, waybar, polybar, lemonbar or tmux" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
         } else if (arg == "--log" || arg == "-l") {
             if (i + 1 < argc) {
                 log_file = argv[++i];
                 logging_enabled = true;
+                log_given = true;
             } else {
                 std::cerr << "Error: --log requires a file path" << std::endl;
                 print_usage(argv[0]);
@@ -1290,6 +2240,91 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "--no-log") {
             logging_enabled = false;
+        } else if (arg == "--no-dbus") {
+            dbus_enabled = false;
+        } else if (arg == "--key-file") {
+            if (i + 1 < argc) {
+                key_file = argv[++i];
+            } else {
+                std::cerr << "Error: --key-file requires a file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--follow") {
+            if (i + 1 < argc) {
+                follow_file = argv[++i];
+            } else {
+                std::cerr << "Error: --follow requires a log file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--serve") {
+            char* end = nullptr;
+            const long port = (i + 1 < argc) ? std::strtol(argv[i + 1], &end, 10) : 0;
+            if (!end || end == argv[i + 1] || *end != '\0' || port < 1 || port > 65535) {
+                std::cerr << "Error: --serve requires a port 1-65535" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            serve_port = static_cast<int>(port);
+            i++;
+        } else if (arg == "--hedge") {
+            hedge = true;
+        } else if (arg == "--timeout" || arg == "--connect-timeout" || arg == "--first-byte-timeout") {
+            long* budget = (arg == "--timeout") ? &timeouts.total_ms
+                         : (arg == "--connect-timeout") ? &timeouts.connect_ms : &timeouts.first_byte_ms;
+            if (i + 1 < argc && parse_timeout_seconds(argv[i + 1], budget)) {
+                timeouts_overridden = true;
+                i++;
+            } else {
+                std::cerr << "Error: " << arg << " requires a number of seconds (0 = no limit)" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--record" || arg == "--replay") {
+            if (i + 1 < argc) {
+                (arg == "--record" ? record_file : replay_file) = argv[++i];
+            } else {
+                std::cerr << "Error: " << arg << " requires a file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--replay-speed") {
+            char* end = nullptr;
+            replay_speed = (i + 1 < argc) ? std::strtod(argv[i + 1], &end) : -1.0;
+            if (!end || end == argv[i + 1] || *end != '\0' || !(replay_speed >= 0.0)) {
+                std::cerr << "Error: --replay-speed requires a factor (1 = as recorded, 0 = no waits)" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (arg == "--time-scale") {
+            if (i + 1 < argc && parse_clock_rate(argv[i + 1], &time_scale)) {
+                i++;
+            } else {
+                std::cerr << "Error: --time-scale requires a factor > 0" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--time-start") {
+            if (i + 1 < argc && parse_clock_start(argv[i + 1], &time_start)) {
+                i++;
+            } else {
+                std::cerr << "Error: --time-start requires unix seconds or an ISO 8601 UTC time" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--timings") {
+            g_timings = true;
+        } else if (const TransportSetting* setting = find_transport_option(arg)) {
+            if (i + 1 < argc && set_transport_value(&transport, setting->key, argv[i + 1])) {
+                transport_overridden = true;
+                i++;
+            } else {
+                std::cerr << "Error: missing or invalid value for " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
         } else if (arg[0] != '-') {
             // Assume it's the API key
             api_key = arg;
@@ -1300,27 +2335,97 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (compact_mode || tiny_mode) {
+    if (dashboard_mode && gui_mode) {
+        std::cerr << "Error: --dashboard is a terminal mode and cannot be combined with --gui" << std::endl;
+        return 1;
+    }
+    if (g_status_mode && gui_mode) {
+        std::cerr << "Error: --status is a terminal mode and cannot be combined with --gui" << std::endl;
+        return 1;
+    }
+    if (g_status_mode && (jsonl_mode || dashboard_mode || !key_file.empty())) {
+        std::cerr << "Error: --status cannot be combined with --jsonl, --dashboard or --key-file" << std::endl;
+        return 1;
+    }
+    if (dashboard_mode && (jsonl_mode || !follow_file.empty() || !key_file.empty() || refresh_interval <= 0)) {
+        std::cerr << "Error: --dashboard shows one account live; it cannot be combined with "
+                  << "--jsonl, --follow, --key-file or -1" << std::endl;
+        return 1;
+    }
+
+    set_request_timeouts(timeouts);
+    set_request_transport(transport);
+    set_request_hedging(hedge);
+
+    if (!record_file.empty() && !replay_file.empty()) {
+        std::cerr << "Error: --record and --replay cannot be combined" << std::endl;
+        return 1;
+    }
+    if (time_scale > 0.0 || time_start >= 0) {
+        if (!replay_file.empty()) {
+            std::cerr << "Error: --replay runs the clock at the capture's pace; drop --time-scale/--time-start" << std::endl;
+            return 1;
+        }
+        clock_simulate(time_start >= 0 ? time_start : time(nullptr), time_scale > 0.0 ? time_scale : 1.0);
+    }
+    std::string capture_error;
+    if ((!record_file.empty() && !capture_record_open(record_file, &capture_error)) ||
+        (!replay_file.empty() && !capture_replay_open(replay_file, replay_speed, &capture_error))) {
+        std::cerr << "Error: " << capture_error << std::endl;
+        return 1;
+    }
+    // Simulated timestamps stay out of the live log (and so out of --follow
+    // readers and the history seed): log only to an explicit --log file
+    if (clock_simulated() && !log_given) {
+        logging_enabled = false;
+    }
+
+    // Terminal modes read SIGINT/SIGTERM/SIGWINCH from a signalfd (the GTK main
+    // loop keeps the default dispositions)
+    if (!gui_mode) {
+        block_terminal_signals();
+    }
+
+    if ((compact_mode || tiny_mode) && !jsonl_mode && !g_status_mode) {
         std::atexit(show_cursor_if_hidden);
-        struct sigaction sa;
-        std::memset(&sa, 0, sizeof(sa));
-        sa.sa_handler = handle_term_signal;
-        sigemptyset(&sa.sa_mask);
-        sigaction(SIGINT, &sa, nullptr);
-        sigaction(SIGTERM, &sa, nullptr);
         hide_cursor_if_tty();
     }
     
+    // Render another instance's log: no API key, no network
+    if (!follow_file.empty() && gui_mode) {
+        std::cerr << "Error: --follow is a terminal mode and cannot be combined with --gui" << std::endl;
+        return 1;
+    }
+    if (!follow_file.empty()) {
+        g_history_enabled = !jsonl_mode && !g_status_mode;
+        return follow_and_display(follow_file, text_mode, compact_mode, tiny_mode, jsonl_mode || g_status_mode);
+    }
+
+    // Load named keys for multi-account monitoring
+    std::vector<AccountKey> account_keys;
+    if (!key_file.empty()) {
+        std::string key_error;
+        if (!load_key_file(key_file, &account_keys, &key_error)) {
+            std::cerr << "Error: --key-file: " << key_error << std::endl;
+            return 1;
+        }
+    }
+
     // Get API key from environment variable if not provided
-    if (api_key.empty()) {
+    if (api_key.empty() && account_keys.empty()) {
         const char* env_key = std::getenv("FIRMWARE_API_KEY");
         if (env_key) {
             api_key = env_key;
         }
     }
     
+    // A replay never reaches the API
+    if (api_key.empty() && account_keys.empty() && capture_replaying()) {
+        api_key = "replay";
+    }
+
     // Check if API key is provided
-    if (api_key.empty()) {
+    if (api_key.empty() && account_keys.empty()) {
         std::cerr << "Error: API key not provided." << std::endl;
         std::cerr << std::endl;
         print_usage(argv[0]);
@@ -1335,13 +2440,34 @@ int main(int argc, char* argv[]) {
 
     int result = 0;
 
+    if (serve_port > 0) {
+        if (gui_mode || refresh_interval > 0) {
+            std::string serve_error;
+            g_push_server = push_server_start(serve_port, &serve_error);
+            if (!g_push_server) {
+                std::cerr << "Error: --serve: " << serve_error << std::endl;
+                curl_global_cleanup();
+                return 1;
+            }
+        } else {
+            std::cerr << "Warning: --serve ignored in single run mode (-1)" << std::endl;
+        }
+    }
+
     // GUI mode dispatcher
     if (gui_mode) {
 #ifdef GUI_MODE_ENABLED
-        result = run_gui_mode(api_key, refresh_interval, log_file, logging_enabled, &argc, &argv);
+        result = run_gui_mode(api_key, account_keys, refresh_interval, log_file, logging_enabled, dbus_enabled,
+                              timeouts_overridden ? &timeouts : nullptr,
+                              transport_overridden ? &transport : nullptr, &argc, &argv);
+        push_server_stop(g_push_server);
+        capture_close();
         curl_global_cleanup();
         return result;
 #else
+        (void)dbus_enabled;
+        (void)timeouts_overridden;
+        (void)transport_overridden;
         std::cerr << "Error: GUI mode not compiled. Rebuild with GTK3 support." << std::endl;
         std::cerr << "Install dependencies: sudo apt-get install libgtk-3-dev libayatana-appindicator3-dev libnotify-dev" << std::endl;
         std::cerr << "Then run: make clean && make" << std::endl;
@@ -1352,60 +2478,343 @@ int main(int argc, char* argv[]) {
 
     // Terminal mode (existing code)
     std::optional<AuthMethod> preferred_auth_method;
+    QuotaData last_sample = {0.0, 0.0, "", 0};
+
+    std::vector<AccountView> accounts;
+    for (const AccountKey& key : account_keys) {
+        AccountView acct;
+        acct.name = key.name;
+        acct.api_key = key.api_key;
+        acct.token = extract_token(key.api_key);
+        acct.log_file = logging_enabled ? account_log_path(log_file, key.name) : std::string();
+        accounts.push_back(std::move(acct));
+    }
+
+    std::string last_event;
+
+    // Sparkline/chart history for the single-account view, seeded with the
+    // current window from the log
+    if (accounts.empty() && !jsonl_mode && !g_status_mode) {
+        g_history_enabled = true;
+        if (logging_enabled) {
+            history_seed_from_log(&g_history, log_file, clock_now() - kQuotaWindowSeconds);
+        }
+    }
+
+    if (dashboard_mode) {
+        result = dashboard_and_fetch(api_key, token, refresh_interval,
+                                     logging_enabled ? log_file : std::string(), preferred_auth_method);
+    } else if (refresh_interval > 0) {
+        // Continuous refresh mode: a single poll() loop. Fetches run on
+        // absolute CLOCK_MONOTONIC deadlines (the schedule does not drift by
+        // the fetch duration; intervals are converted to real time, see
+        // add_clock_seconds), a 1 s tick redraws the countdown from the last
+        // sample without network I/O, SIGWINCH redraws at once and
+        // SIGINT/SIGTERM end the loop. On a terminal, keys are read from
+        // stdin in the same loop (r, +/-, c/t, q).
+        const bool diff_render = isatty(STDOUT_FILENO) && !jsonl_mode && !g_status_mode;
+        const bool interactive = diff_render && enable_key_input();
+        const int fetch_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        const int tick_timer = diff_render ? timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC) : -1;
+        auto arm_tick = [&]() {
+            // --tiny has no countdown to update
+            struct itimerspec tick = {};
+            if (!tiny_mode) {
+                tick.it_value.tv_sec = 1;
+                tick.it_interval.tv_sec = 1;
+            }
+            if (tick_timer >= 0) {
+                timerfd_settime(tick_timer, 0, &tick, nullptr);
+            }
+        };
+        arm_tick();
+        if (interactive) {
+            std::atexit(show_cursor_if_hidden);
+        }
+        if (fetch_timer < 0) {
+            std::cerr << "Error: timerfd_create: " << std::strerror(errno) << std::endl;
+            push_server_stop(g_push_server);
+            curl_global_cleanup();
+            return 1;
+        }
+
+        struct itimerspec deadline = {};
+        clock_gettime(CLOCK_MONOTONIC, &deadline.it_value);
+        struct timespec fetch_anchor = deadline.it_value;  // schedule slot of the last fetch
+        std::string last_frame;     // redrawn as-is while the last fetch failed (without footer)
+        RetryState retry;
+        retry_init(&retry);
+        const int net_fd = net_watch_open();
+        bool fetch_due = true;
+        bool manual_fetch = false;  // requested with 'r' (restarts the interval)
+        bool redraw = false;
+        int term_signal = 0;
+        bool replay_done = false;   // --replay: the capture is exhausted
+
+        // Arm the fetch timer one interval after the anchor, skipping slots
+        // that already passed (slow fetch, suspend). Returns false if even
+        // the first slot is due already.
+        auto schedule_next_fetch = [&](bool skip_missed) -> bool {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            auto passed = [&]() {
+                return deadline.it_value.tv_sec < now.tv_sec ||
+                       (deadline.it_value.tv_sec == now.tv_sec && deadline.it_value.tv_nsec <= now.tv_nsec);
+            };
+            deadline.it_value = fetch_anchor;
+            add_clock_seconds(&deadline.it_value, refresh_interval);
+            if (passed() && !skip_missed) {
+                return false;
+            }
+            while (passed()) {
+                add_clock_seconds(&deadline.it_value, refresh_interval);
+            }
+            timerfd_settime(fetch_timer, TFD_TIMER_ABSTIME, &deadline, nullptr);
+            return true;
+        };
+
+        // After a failure: next attempt after the backoff delay, from now
+        auto schedule_retry = [&](int delay_s) {
+            clock_gettime(CLOCK_MONOTONIC, &deadline.it_value);
+            add_clock_seconds(&deadline.it_value, delay_s);
+            timerfd_settime(fetch_timer, TFD_TIMER_ABSTIME, &deadline, nullptr);
+        };
+        auto seconds_until_fetch = [&]() {
+            return clock_seconds_until(fetch_timer);
+        };
+
+        auto apply_keys = [&](const KeyCommands& keys) {
+            if (keys.refresh) {
+                fetch_due = true;
+                manual_fetch = true;
+            }
+            if (keys.interval_steps != 0) {
+                refresh_interval = step_refresh_interval(refresh_interval, keys.interval_steps);
+                // A pending retry keeps its backoff delay
+                if (!fetch_due && !retry_waiting(&retry) && !capture_replaying() && !schedule_next_fetch(false)) {
+                    fetch_due = true;   // the shorter interval has already elapsed
+                }
+                redraw = true;
+            }
+            if (keys.toggle_compact || keys.toggle_tiny) {
+                if (keys.toggle_tiny) {
+                    tiny_mode = !tiny_mode;
+                    compact_mode = false;
+                } else {
+                    compact_mode = !compact_mode;
+                    tiny_mode = false;
+                }
+                if (compact_mode || tiny_mode) {
+                    hide_cursor_if_tty();
+                } else {
+                    show_cursor_if_hidden();
+                }
+                arm_tick();
+                redraw = true;
+            }
+        };
 
-    if (refresh_interval > 0) {
-        // Continuous refresh mode
         while (true) {
-            int terminal_width = get_terminal_width();
-            bool use_colors = isatty(STDOUT_FILENO);
+            if (fetch_due || (redraw && diff_render)) {
+                long rate_limit_s = -1;
+                int terminal_width = get_terminal_width();
+                bool use_colors = isatty(STDOUT_FILENO);
+
+                // Render into a frame; only the difference reaches the terminal
+                if (diff_render) {
+                    frame_begin();
+                }
 
-            // Clear screen (ANSI escape code)
-            if (use_colors) {
-                std::cout << "\033[2J\033[H"; // Clear screen and move cursor to home
+                if (fetch_due) {
+                    if (manual_fetch) {
+                        clock_gettime(CLOCK_MONOTONIC, &fetch_anchor);
+                    } else {
+                        fetch_anchor = deadline.it_value;
+                    }
+                    retry_attempt_started(&retry);
+                    if (!accounts.empty()) {
+                        result = fetch_and_display_accounts(accounts, text_mode, compact_mode, tiny_mode, jsonl_mode,
+                                                            use_colors, terminal_width, &rate_limit_s);
+                    } else {
+                        result = fetch_and_display_quota(api_key,
+                                                         token,
+                                                         text_mode,
+                                                         compact_mode,
+                                                         tiny_mode,
+                                                         jsonl_mode,
+                                                         use_colors,
+                                                         terminal_width,
+                                                         logging_enabled ? log_file : std::string(),
+                                                         preferred_auth_method,
+                                                         &last_sample,
+                                                         &last_event,
+                                                         true,
+                                                         &rate_limit_s);
+                    }
+                } else if (!accounts.empty()) {
+                    display_accounts(accounts, text_mode, compact_mode, tiny_mode, use_colors, terminal_width,
+                                     isatty(STDERR_FILENO));
+                } else if (result == 0) {
+                    display_quota(last_sample, last_event, logging_enabled, text_mode, compact_mode, tiny_mode,
+                                  use_colors, terminal_width);
+                } else {
+                    // The failed fetch's frame (the error) is redrawn unchanged;
+                    // the footer below carries the current retry countdown.
+                    std::cout << last_frame;
+                }
+
+                const bool fetched = fetch_due;
+                if (fetched) {
+                    if (diff_render) {
+                        std::cout.flush();
+                        last_frame = g_frame.str();
+                    }
+                    if (capture_replaying()) {
+                        // The capture sets the pace; its gaps already hold the
+                        // recorded interval, backoff and server delays
+                        replay_done = !arm_replay_fetch(fetch_timer);
+                    } else if (rate_limit_s >= 0 && !termination_pending()) {
+                        // Throttled: the server's delay replaces the interval
+                        // (and the backoff), even after a usable answer
+                        if (result == 0) {
+                            retry_on_success(&retry);
+                        }
+                        schedule_retry(retry_on_rate_limit(&retry, rate_limit_s, refresh_interval));
+                    } else if (result != 0 && !termination_pending()) {
+                        schedule_retry(retry_on_failure(&retry, refresh_interval));
+                    } else {
+                        if (result == 0) {
+                            retry_on_success(&retry);
+                        }
+                        // Next deadline is one interval after this fetch's slot,
+                        // so the schedule does not drift by the fetch duration.
+                        schedule_next_fetch(true);
+                    }
+                }
+
+                print_refresh_footer(retry_describe(&retry, seconds_until_fetch()), refresh_interval,
+                                     compact_mode, tiny_mode, jsonl_mode || g_status_mode, interactive);
                 std::cout.flush();
+
+                if (diff_render) {
+                    // A fetch cut short by Ctrl+C is not worth drawing.
+                    frame_end(!termination_pending());
+                }
+                fetch_due = false;
+                manual_fetch = false;
+                redraw = false;
+
+                if (replay_done) {
+                    break;      // the last frame stays on screen
+                }
+
+                if (fetched && interactive) {
+                    // Keys typed while the fetch was in flight: 'r' is
+                    // satisfied by the fetch that just finished.
+                    KeyCommands keys = read_key_commands();
+                    keys.refresh = false;
+                    if (keys.quit) {
+                        result = 0;
+                        break;
+                    }
+                    apply_keys(keys);
+                    continue;
+                }
             }
-            
+
+            struct pollfd fds[5];
+            fds[0].fd = g_signal_fd;
+            fds[1].fd = fetch_timer;
+            fds[2].fd = tick_timer;
+            fds[3].fd = interactive ? STDIN_FILENO : -1;
+            fds[4].fd = net_fd;
+            for (struct pollfd& pfd : fds) {
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+            }
+            if (poll(fds, 5, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Error: poll: " << std::strerror(errno) << std::endl;
+                result = 1;
+                break;
+            }
+
+            uint64_t expirations = 0;
+            if (fds[0].revents & POLLIN) {
+                term_signal = read_terminal_signals(&redraw);
+                if (term_signal != 0) {
+                    result = 128 + term_signal;
+                    break;
+                }
+            }
+            if (fds[1].revents & POLLIN) {
+                (void)!read(fetch_timer, &expirations, sizeof(expirations));
+                fetch_due = true;
+            }
+            if (fds[2].revents & POLLIN) {
+                (void)!read(tick_timer, &expirations, sizeof(expirations));
+                redraw = true;
+            }
+            if (fds[3].revents & POLLIN) {
+                const KeyCommands keys = read_key_commands();
+                if (keys.quit) {
+                    result = 0;
+                    break;
+                }
+                apply_keys(keys);
+            }
+            if ((fds[4].revents & POLLIN) && net_watch_read(net_fd) && retry_on_connectivity(&retry)) {
+                // Back online: retry without waiting out the backoff
+                fetch_due = true;
+                manual_fetch = true;
+            }
+        }
+
+        restore_key_input();
+
+        close(fetch_timer);
+        if (net_fd >= 0) {
+            close(net_fd);
+        }
+        if (tick_timer >= 0) {
+            close(tick_timer);
+        }
+    } else {
+        // Single run mode
+        int terminal_width = get_terminal_width();
+        bool use_colors = isatty(STDOUT_FILENO);
+        if (!accounts.empty()) {
+            result = fetch_and_display_accounts(accounts, text_mode, compact_mode, tiny_mode, jsonl_mode,
+                                                use_colors, terminal_width, nullptr);
+        } else {
             result = fetch_and_display_quota(api_key,
                                              token,
                                              text_mode,
                                              compact_mode,
                                              tiny_mode,
+                                             jsonl_mode,
                                              use_colors,
                                              terminal_width,
                                              logging_enabled ? log_file : std::string(),
                                              preferred_auth_method,
-                                             true);
-            
-            if (result != 0) {
-                // Error occurred, but continue trying
-                std::cerr << std::endl << "Will retry in " << refresh_interval << " seconds..." << std::endl;
-            }
-            
-            // Show next refresh time
-            if (!compact_mode && !tiny_mode) {
-                std::cout << std::endl << "Refreshing every " << refresh_interval << " seconds (Ctrl+C to stop)..." << std::endl;
-            }
-            std::cout.flush();
-            
-            // Sleep for specified interval
-            sleep(refresh_interval);
+                                             &last_sample,
+                                             &last_event,
+                                             false,
+                                             nullptr);
+        }
+        print_timings();
+        bool resized = false;
+        const int term_signal = read_terminal_signals(&resized);
+        if (term_signal != 0) {
+            result = 128 + term_signal;
         }
-    } else {
-        // Single run mode
-        int terminal_width = get_terminal_width();
-        bool use_colors = isatty(STDOUT_FILENO);
-        result = fetch_and_display_quota(api_key,
-                                         token,
-                                         text_mode,
-                                         compact_mode,
-                                         tiny_mode,
-                                         use_colors,
-                                         terminal_width,
-                                         logging_enabled ? log_file : std::string(),
-                                         preferred_auth_method,
-                                         false);
     }
 
+    push_server_stop(g_push_server);
+    capture_close();
+
     // Cleanup curl
     curl_global_cleanup();
 
@@ -1419,11 +2828,14 @@ int main(int argc, char* argv[]) {
 
 // Forward declarations
 static GtkWidget* create_main_window(GUIState* state);
-static void update_gui_widgets(GUIState* state, const QuotaData* data);
+static void update_gui_widgets(GUIState* state, const QuotaData* data, bool redraw_bar);
 static void update_tray_display(GUIState* state, const QuotaData* data);
 static void show_desktop_notification(const std::string& event, double percentage);
 static void save_gui_state(const GUIState* state);
 static gboolean on_timer_update(gpointer user_data);
+static void schedule_retry(GUIState* state, int delay_s);
+static void schedule_replay(GUIState* state);
+static void refresh_now(GUIState* state);
 static void on_tray_reset_position(GtkMenuItem* item, gpointer user_data);
 static gboolean on_window_map(GtkWidget* widget, GdkEvent* event, gpointer user_data);
 static void on_toggle_autostart(GtkCheckMenuItem* item, gpointer user_data);
@@ -1554,6 +2966,23 @@ static gboolean on_window_delete(GtkWidget* widget, GdkEvent* event, gpointer us
     return TRUE;  // Prevent default destroy
 }
 
+// Pause the countdown tick while the window is unmapped (hidden to tray) or
+// minimized; it catches up as soon as the window is shown again.
+static gboolean on_window_visibility_event(GtkWidget* widget, GdkEvent* event, gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    if (!state || !event) return FALSE;
+
+    bool visible = gtk_widget_get_mapped(widget);
+    if (event->type == GDK_UNMAP) {
+        visible = false;
+    } else if (event->type == GDK_WINDOW_STATE) {
+        const GdkWindowState ws = event->window_state.new_window_state;
+        visible = visible && !(ws & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN));
+    }
+    ui_ticker_set_visible(state->countdown_ticker, visible);
+    return FALSE;
+}
+
 // Window configure event handler - track position
 static gboolean on_window_configure(GtkWidget* widget, GdkEventConfigure* event, gpointer user_data) {
     (void)widget;
@@ -2062,14 +3491,14 @@ static void change_refresh_rate(GUIState* state, int new_interval) {
     }
 
     // Create new timer with new interval
-    state->timer_id = g_timeout_add(
-        new_interval * 1000,
+    state->timer_id = add_clock_timeout(
+        new_interval,
         on_timer_update,
         state
     );
 
     // Update countdown display immediately.
-    state->next_refresh_us = g_get_monotonic_time() + (gint64)new_interval * 1000000;
+    state->next_refresh_us = clock_monotonic_us() + (gint64)new_interval * 1000000;
     update_refresh_countdown_label(state);
 
     // Save preference
@@ -2173,7 +3602,7 @@ static void change_bar_height(GUIState* state, int multiplier) {
 
     // Update with current data
     if (state->current_quota.timestamp > 0) {
-        update_gui_widgets(state, &state->current_quota);
+        update_gui_widgets(state, &state->current_quota, true);
         update_tray_display(state, &state->current_quota);
     }
 
@@ -2332,6 +3761,9 @@ static GtkWidget* create_main_window(GUIState* state) {
     g_signal_connect(window, "delete-event", G_CALLBACK(on_window_delete), state);
     g_signal_connect(window, "configure-event", G_CALLBACK(on_window_configure), state);
     g_signal_connect(window, "map-event", G_CALLBACK(on_window_map), state);
+    g_signal_connect(window, "map-event", G_CALLBACK(on_window_visibility_event), state);
+    g_signal_connect(window, "unmap-event", G_CALLBACK(on_window_visibility_event), state);
+    g_signal_connect(window, "window-state-event", G_CALLBACK(on_window_visibility_event), state);
     g_signal_connect(window, "button-press-event", G_CALLBACK(on_window_button_press), state);
     gtk_widget_add_events(window, GDK_BUTTON_PRESS_MASK);
 
@@ -2567,7 +3999,8 @@ static void show_desktop_notification(const std::string& event, double percentag
 }
 
 // Update GUI widgets with quota data
-static void update_gui_widgets(GUIState* state, const QuotaData* data) {
+// redraw_bar is false when only the fetch time changed (the bar is current)
+static void update_gui_widgets(GUIState* state, const QuotaData* data, bool redraw_bar) {
     // Usage bar is a custom drawn widget; redraw after updating state below.
 
     // Update usage label with time remaining
@@ -2575,7 +4008,7 @@ static void update_gui_widgets(GUIState* state, const QuotaData* data) {
     if (data->reset_time != "N/A" && !data->reset_time.empty()) {
         time_t reset_utc;
         if (parse_iso8601_utc_to_time_t(data->reset_time, &reset_utc)) {
-            time_t now = time(nullptr);
+            time_t now = clock_now();
             int64_t remaining = static_cast<int64_t>(difftime(reset_utc, now));
             if (remaining < 0) remaining = 0;
 
@@ -2606,10 +4039,34 @@ static void update_gui_widgets(GUIState* state, const QuotaData* data) {
         gtk_label_set_text(GTK_LABEL(state->timestamp_label), timestamp_text);
     }
 
+    // Multi-account: one summary line per account instead.
+    if (!state->accounts.empty()) {
+        std::string summary;
+        for (const GUIAccount& acct : state->accounts) {
+            char line[256];
+            if (!acct.ok) {
+                snprintf(line, sizeof(line), "%s: error", acct.name.c_str());
+            } else {
+                time_t reset_utc;
+                if (parse_iso8601_utc_to_time_t(acct.quota.reset_time, &reset_utc)) {
+                    int64_t remaining = static_cast<int64_t>(difftime(reset_utc, clock_now()));
+                    snprintf(line, sizeof(line), "%s: %.2f%% - Reset in %s", acct.name.c_str(),
+                             acct.quota.percentage, format_duration_compact(remaining).c_str());
+                } else {
+                    snprintf(line, sizeof(line), "%s: %.2f%%", acct.name.c_str(), acct.quota.percentage);
+                }
+            }
+            if (!summary.empty()) summary += "\n";
+            summary += line;
+        }
+        gtk_label_set_text(GTK_LABEL(state->usage_label), summary.c_str());
+    }
+
     // Store current data
     state->current_quota = *data;
 
-    if (state->usage_progress) {
+    if (state->usage_progress && redraw_bar) {
+        state->usage_bar_cache_valid = false;
         gtk_widget_queue_draw(state->usage_progress);
     }
 }
@@ -2624,7 +4081,7 @@ static void update_tray_display(GUIState* state, const QuotaData* data) {
     if (data->reset_time != "N/A" && !data->reset_time.empty()) {
         time_t reset_utc;
         if (parse_iso8601_utc_to_time_t(data->reset_time, &reset_utc)) {
-            time_t now = time(nullptr);
+            time_t now = clock_now();
             int64_t remaining = static_cast<int64_t>(difftime(reset_utc, now));
             std::string duration_str = format_duration_compact(remaining);
             snprintf(tooltip, sizeof(tooltip),
@@ -2645,6 +4102,23 @@ static void update_tray_display(GUIState* state, const QuotaData* data) {
                  state->refresh_interval);
     }
 
+    // Multi-account: aggregated view (highest usage first line, then all).
+    if (!state->accounts.empty()) {
+        std::string agg = "Firmware Quota: " + std::to_string((int)std::lround(data->percentage)) + "% max";
+        for (const GUIAccount& acct : state->accounts) {
+            char line[160];
+            if (acct.ok) {
+                snprintf(line, sizeof(line), "\n%s: %.1f%%", acct.name.c_str(), acct.quota.percentage);
+            } else {
+                snprintf(line, sizeof(line), "\n%s: error", acct.name.c_str());
+            }
+            agg += line;
+        }
+        agg += "\nRefresh: " + std::to_string(state->refresh_interval) + "s";
+        app_indicator_set_title(state->indicator, agg.c_str());
+        return;
+    }
+
     app_indicator_set_title(state->indicator, tooltip);
 }
 
@@ -2668,41 +4142,153 @@ static void show_error_in_gui(GUIState* state, const char* message) {
     g_object_unref(notification);
 }
 
+// Background fetch worker: one long-lived thread serves every refresh.
+// Requests go through a single slot: asking again while a fetch is in flight replaces the pending request
+// (at most one follow-up fetch), so a stalled network cannot pile up threads.
+// The worker never reads GUIState; everything it needs travels in the request
+// or in the atomically published auth snapshot.
+
 // Structure for passing data between threads
 struct FetchThreadData {
-    GUIState* state;
+    GUIState* state;        // only dereferenced on the main thread
     RequestResult result;
     bool success;
     QuotaData quota_data;
     std::string event;
     std::optional<AuthMethod> used_method;
     std::string error_message;
+    std::string log_file;   // empty when logging is disabled
+    long rate_limit_s = -1; // server-requested delay, -1 when not throttled
+    QuotaData previous;     // state->current_quota when the fetch was queued
+    bool unchanged = false; // same response as before: previous reused, nothing parsed
+
+    // Multi-account mode: snapshot of state->accounts, updated by the thread
+    std::vector<GUIAccount> accounts;
+};
+
+// Credentials for the single-key fetch, replaced as a whole whenever the
+// preferred method changes
+struct FetchAuth {
+    std::string api_key;
+    std::string token;
+    std::optional<AuthMethod> preferred_method;
+};
+
+struct FetchWorker {
+    pthread_t thread;
+    bool running = false;
+    std::mutex mu;
+    std::condition_variable cv;
+    FetchThreadData* pending = nullptr;     // single slot, newest request wins
+    std::atomic<bool> quit{false};
+    std::shared_ptr<const FetchAuth> auth;  // std::atomic_load/atomic_store only
 };
 
+static FetchWorker g_fetch_worker;
+
 // Forward declaration
 static gboolean on_fetch_complete(gpointer user_data);
 
-// Background thread for fetching quota data
-static void* fetch_quota_thread(void* arg) {
-    FetchThreadData* data = (FetchThreadData*)arg;
-    GUIState* state = data->state;
+// Fetch every account concurrently. The headline sample (quota_data/event)
+// is the account closest to its limit.
+static void fetch_accounts(FetchThreadData* data) {
+    std::vector<AuthJob> jobs(data->accounts.size());
+    for (size_t i = 0; i < data->accounts.size(); i++) {
+        jobs[i].api_key = data->accounts[i].api_key;
+        jobs[i].token = data->accounts[i].token;
+        jobs[i].preferred_method = data->accounts[i].preferred_auth_method;
+    }
+
+    try_auth_methods_concurrent(jobs);
+
+    data->success = false;
+    bool all_unchanged = true;
+    for (size_t i = 0; i < data->accounts.size(); i++) {
+        GUIAccount& acct = data->accounts[i];
+        acct.preferred_auth_method = jobs[i].preferred_method;
+        acct.event.clear();
+
+        if (g_timings) {
+            std::cerr << "Timings: " << acct.name << "  " << format_request_timings(jobs[i].result.timings)
+                      << std::endl;
+        }
+
+        long throttle_s = 0;
+        if (request_rate_limited(jobs[i].result, &throttle_s)) {
+            data->rate_limit_s = std::max(data->rate_limit_s, throttle_s);
+            if (!acct.log_file.empty()) {
+                write_log_rate_limited(acct.log_file, jobs[i].result, throttle_s);
+            }
+        }
+
+        // Unchanged body: keep the account's sample (no parse, no event)
+        const bool reuse = jobs[i].result.unchanged && acct.ok && acct.quota.timestamp > 0;
+        if (reuse) {
+            acct.quota.timestamp = clock_now();
+        } else {
+            acct.ok = parse_quota_result(jobs[i].result, &acct.quota, &acct.error);
+            all_unchanged = false;
+        }
+        if (!acct.ok) {
+            if (data->error_message.empty()) {
+                data->error_message = acct.name + ": " + acct.error;
+            }
+            continue;
+        }
+
+        if (reuse) {
+            if (!acct.log_file.empty() && log_heartbeat_due(acct.log_file, acct.quota.timestamp)) {
+                write_log_entry(acct.log_file, acct.quota, "UPDATE");
+            }
+        } else if (!acct.log_file.empty()) {
+            QuotaData previous = read_last_log_entry(acct.log_file);
+            acct.event = detect_event(acct.quota, previous);
+            write_log_entry(acct.log_file, acct.quota, acct.event);
+        }
+
+        if (!data->success || acct.quota.percentage > data->quota_data.percentage) {
+            data->quota_data = acct.quota;
+            data->event = acct.event;
+        }
+        data->success = true;
+    }
+    data->unchanged = data->success && all_unchanged;
+}
+
+// Fetch one request on the worker thread and hand it to the main loop
+static void run_fetch(FetchThreadData* data) {
+    if (!data->accounts.empty()) {
+        fetch_accounts(data);
+        g_idle_add(on_fetch_complete, data);
+        return;
+    }
 
     // Perform HTTP request (reuse existing code)
+    const std::shared_ptr<const FetchAuth> auth = std::atomic_load(&g_fetch_worker.auth);
+    std::optional<AuthMethod> preferred = auth->preferred_method;
     data->result = try_auth_methods(
-        state->api_key,
-        state->token,
-        state->preferred_auth_method,
+        auth->api_key,
+        auth->token,
+        preferred,
         &data->used_method
     );
+    if (g_timings) {
+        std::cerr << "Timings: " << format_request_timings(data->result.timings) << std::endl;
+    }
+
+    long throttle_s = 0;
+    if (request_rate_limited(data->result, &throttle_s)) {
+        data->rate_limit_s = throttle_s;
+        if (!data->log_file.empty()) {
+            write_log_rate_limited(data->log_file, data->result, throttle_s);
+        }
+    }
 
     if (data->result.curl_code != CURLE_OK) {
         data->success = false;
-        data->error_message = std::string("Request failed: ") + curl_easy_strerror(data->result.curl_code);
-        if (!data->result.curl_error.empty()) {
-            data->error_message += " (" + data->result.curl_error + ")";
-        }
+        data->error_message = describe_request_failure(data->result);
         g_idle_add(on_fetch_complete, data);
-        return nullptr;
+        return;
     }
 
     if (!is_http_success(data->result.http_code)) {
@@ -2712,7 +4298,21 @@ static void* fetch_quota_thread(void* arg) {
             data->error_message += "\n" + truncate_for_display(data->result.body, 300);
         }
         g_idle_add(on_fetch_complete, data);
-        return nullptr;
+        return;
+    }
+
+    // Unchanged body: the previous sample stands (no parse, no event); the
+    // log only gets a heartbeat row now and then
+    if (data->result.unchanged && data->previous.timestamp > 0) {
+        data->quota_data = data->previous;
+        data->quota_data.timestamp = clock_now();
+        if (!data->log_file.empty() && log_heartbeat_due(data->log_file, data->quota_data.timestamp)) {
+            write_log_entry(data->log_file, data->quota_data, "UPDATE");
+        }
+        data->unchanged = true;
+        data->success = true;
+        g_idle_add(on_fetch_complete, data);
+        return;
     }
 
     // Parse JSON (reuse existing code)
@@ -2723,7 +4323,7 @@ static void* fetch_quota_thread(void* arg) {
             data->success = false;
             data->error_message = "Failed to parse response (missing 'used').\n" + truncate_for_display(data->result.body, 300);
             g_idle_add(on_fetch_complete, data);
-            return nullptr;
+            return;
         }
 
         double used = j["used"].get<double>();
@@ -2732,13 +4332,13 @@ static void* fetch_quota_thread(void* arg) {
         data->quota_data.used = used;
         data->quota_data.percentage = used * 100.0;
         data->quota_data.reset_time = reset.empty() ? "N/A" : reset;
-        data->quota_data.timestamp = time(nullptr);
+        data->quota_data.timestamp = clock_now();
 
         // Detect event (reuse existing code)
-        if (state->logging_enabled && !state->log_file.empty()) {
-            QuotaData previous = read_last_log_entry(state->log_file);
+        if (!data->log_file.empty()) {
+            QuotaData previous = read_last_log_entry(data->log_file);
             data->event = detect_event(data->quota_data, previous);
-            write_log_entry(state->log_file, data->quota_data, data->event);
+            write_log_entry(data->log_file, data->quota_data, data->event);
         }
 
         data->success = true;
@@ -2755,31 +4355,133 @@ static void* fetch_quota_thread(void* arg) {
 
     // Schedule callback on main thread
     g_idle_add(on_fetch_complete, data);
+}
+
+static void* fetch_worker_main(void*) {
+    FetchWorker& w = g_fetch_worker;
+    for (;;) {
+        FetchThreadData* data = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(w.mu);
+            w.cv.wait(lock, [&w] { return w.pending != nullptr || w.quit.load(); });
+            if (w.quit.load()) break;
+            data = w.pending;
+            w.pending = nullptr;
+        }
+        run_fetch(data);
+    }
     return nullptr;
 }
 
+// Polled by libcurl during transfers: quitting cancels an in-flight fetch
+static bool fetch_worker_quitting() {
+    return g_fetch_worker.quit.load(std::memory_order_relaxed);
+}
+
+static void fetch_worker_publish_auth(const GUIState* state) {
+    auto auth = std::make_shared<FetchAuth>();
+    auth->api_key = state->api_key;
+    auth->token = state->token;
+    auth->preferred_method = state->preferred_auth_method;
+    std::atomic_store(&g_fetch_worker.auth, std::shared_ptr<const FetchAuth>(std::move(auth)));
+}
+
+static void fetch_worker_start(const GUIState* state) {
+    FetchWorker& w = g_fetch_worker;
+    fetch_worker_publish_auth(state);
+    set_request_abort_check(fetch_worker_quitting);
+    w.running = pthread_create(&w.thread, nullptr, fetch_worker_main, nullptr) == 0;
+    if (!w.running) {
+        std::cerr << "Error: Failed to start the fetch thread" << std::endl;
+    }
+}
+
+// Queue a fetch. A request still waiting in the slot is replaced.
+static void fetch_worker_request(FetchThreadData* data) {
+    FetchWorker& w = g_fetch_worker;
+    if (!w.running) {
+        delete data;
+        return;
+    }
+    FetchThreadData* replaced = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(w.mu);
+        replaced = w.pending;
+        w.pending = data;
+    }
+    delete replaced;
+    w.cv.notify_one();
+}
+
+// Cancel the in-flight transfer (if any) and join the worker. Results that
+// were still queued for the main loop are dropped with it.
+static void fetch_worker_stop() {
+    FetchWorker& w = g_fetch_worker;
+    if (!w.running) return;
+    {
+        std::lock_guard<std::mutex> lock(w.mu);
+        w.quit.store(true);
+    }
+    w.cv.notify_one();
+    pthread_join(w.thread, nullptr);
+    w.running = false;
+
+    delete w.pending;
+    w.pending = nullptr;
+}
+
 // GTK main thread callback after fetch completes
 static gboolean on_fetch_complete(gpointer user_data) {
     FetchThreadData* data = (FetchThreadData*)user_data;
 
+    // Copy back per-account results (auth cache, samples, errors).
+    if (!data->accounts.empty() && data->accounts.size() == data->state->accounts.size()) {
+        data->state->accounts = data->accounts;
+    }
+
     if (data->success) {
+        retry_on_success(&data->state->retry);
+
         // Update preferred auth method if changed
-        if (data->used_method.has_value()) {
+        if (data->used_method.has_value() && data->used_method != data->state->preferred_auth_method) {
             data->state->preferred_auth_method = data->used_method;
+            fetch_worker_publish_auth(data->state);
         }
 
-        // Capture previous value so the bar can highlight the increase.
-        if (data->state->current_quota.timestamp > 0) {
+        // Capture previous value so the bar can highlight the increase
+        // (an unchanged sample keeps the last highlight).
+        if (!data->unchanged && data->state->current_quota.timestamp > 0) {
             data->state->prev_percentage = data->state->current_quota.percentage;
             data->state->have_prev_percentage = true;
-        } else {
+        } else if (!data->unchanged) {
             data->state->prev_percentage = data->quota_data.percentage;
             data->state->have_prev_percentage = false;
         }
 
-        update_gui_widgets(data->state, &data->quota_data);
+        update_gui_widgets(data->state, &data->quota_data, !data->unchanged);
         update_tray_display(data->state, &data->quota_data);
 
+        if (g_dbus_service) {
+            time_t reset_utc = 0;
+            const int64_t reset_epoch =
+                parse_iso8601_utc_to_time_t(data->quota_data.reset_time, &reset_utc) ? (int64_t)reset_utc : -1;
+            quota_dbus_update(g_dbus_service, data->quota_data.percentage, reset_epoch,
+                              forecast_usage_at_reset(data->quota_data, clock_now()),
+                              (int64_t)data->quota_data.timestamp);
+        }
+
+        if (g_push_server && !data->accounts.empty()) {
+            JsonlWriter writer;
+            for (const GUIAccount& acct : data->accounts) {
+                if (!acct.ok) continue;
+                JsonlRecord rec = make_snapshot_record(acct.quota, acct.event.empty() ? "UPDATE" : acct.event);
+                rec.account = acct.name.c_str();
+                push_server_publish(g_push_server, jsonl_format_record(&writer, rec));
+            }
+        } else if (g_push_server) {
+            push_server_publish(g_push_server, format_snapshot_json(data->quota_data, data->event.empty() ? "UPDATE" : data->event));
+        }
+
         // Show notification for important events
         if (!data->event.empty() &&
             (data->event == "QUOTA_RESET" || data->event == "HIGH_USAGE")) {
@@ -2790,6 +4492,21 @@ static gboolean on_fetch_complete(gpointer user_data) {
     } else {
         const char* msg = data->error_message.empty() ? "Failed to fetch quota data" : data->error_message.c_str();
         show_error_in_gui(data->state, msg);
+        quota_dbus_set_error(g_dbus_service, msg);
+        if (data->rate_limit_s < 0) {
+            schedule_retry(data->state, retry_on_failure(&data->state->retry, data->state->refresh_interval));
+        }
+    }
+
+    // Throttled: wait what the server asked for, even after a usable answer
+    if (data->rate_limit_s >= 0) {
+        schedule_retry(data->state,
+                       retry_on_rate_limit(&data->state->retry, data->rate_limit_s, data->state->refresh_interval));
+    }
+
+    // --replay: the capture sets the pace instead of the interval and retries
+    if (capture_replaying()) {
+        schedule_replay(data->state);
     }
 
     delete data;
@@ -2801,25 +4518,86 @@ static gboolean on_timer_update(gpointer user_data) {
     GUIState* state = (GUIState*)user_data;
 
     // Track next refresh time for countdown display.
-    state->next_refresh_us = g_get_monotonic_time() + (gint64)state->refresh_interval * 1000000;
+    state->next_refresh_us = clock_monotonic_us() + (gint64)state->refresh_interval * 1000000;
+    retry_attempt_started(&state->retry);
     update_refresh_countdown_label(state);
 
-    // Start fetch in background thread
+    // Hand the fetch to the worker (coalesced with one still waiting)
     FetchThreadData* data = new FetchThreadData();
     data->state = state;
     data->success = false;
-
-    pthread_t thread;
-    if (pthread_create(&thread, nullptr, fetch_quota_thread, data) == 0) {
-        pthread_detach(thread);
-        // Thread will call g_idle_add when done
-    } else {
-        delete data;
+    data->accounts = state->accounts;
+    data->previous = state->current_quota;
+    if (state->logging_enabled) {
+        data->log_file = state->log_file;
     }
+    fetch_worker_request(data);
 
     return G_SOURCE_CONTINUE;  // Keep timer running
 }
 
+// Fetch now and restart the periodic timer so the countdown stays accurate
+static void refresh_now(GUIState* state) {
+    if (state->timer_id > 0) {
+        g_source_remove(state->timer_id);
+    }
+    state->timer_id = add_clock_timeout(state->refresh_interval, on_timer_update, state);
+    on_timer_update(state);
+}
+
+static gboolean on_retry_timer(gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    state->timer_id = 0;
+    refresh_now(state);
+    return G_SOURCE_REMOVE;
+}
+
+// After a failed or throttled fetch: replace the periodic timer by one delay
+static void schedule_retry(GUIState* state, int delay_s) {
+    if (state->timer_id > 0) {
+        g_source_remove(state->timer_id);
+    }
+    state->timer_id = add_clock_timeout(delay_s, on_retry_timer, state);
+    state->next_refresh_us = clock_monotonic_us() + (gint64)delay_s * 1000000;
+    update_refresh_countdown_label(state);
+}
+
+static gboolean on_replay_timer(gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    state->timer_id = 0;
+    on_timer_update(state);
+    return G_SOURCE_REMOVE;
+}
+
+// --replay: one timer for the next recorded fetch; none after the last. The
+// recording already holds the retries, so the retry state stays clear.
+static void schedule_replay(GUIState* state) {
+    if (state->timer_id > 0) {
+        g_source_remove(state->timer_id);
+        state->timer_id = 0;
+    }
+    retry_on_success(&state->retry);
+    const long delay_ms = capture_replay_delay_ms();
+    if (delay_ms >= 0) {
+        state->timer_id = g_timeout_add((guint)delay_ms, on_replay_timer, state);
+        state->next_refresh_us = clock_monotonic_us() + (gint64)(clock_seconds(delay_ms) * 1000000);
+    }
+    update_refresh_countdown_label(state);
+}
+
+// Network back: a failing instance retries without waiting out the backoff
+static void on_network_changed(GNetworkMonitor*, gboolean available, gpointer user_data) {
+    GUIState* state = (GUIState*)user_data;
+    if (available && retry_on_connectivity(&state->retry)) {
+        refresh_now(state);
+    }
+}
+
+// D-Bus Refresh(): fetch now
+static void on_dbus_refresh(void* user_data) {
+    refresh_now((GUIState*)user_data);
+}
+
 // Load GUI state from config file
 static void load_gui_state(GUIState* state) {
     const char* home = getenv("HOME");
@@ -2876,6 +4654,18 @@ static void load_gui_state(GUIState* state) {
             if (state->bar_height_multiplier < 1 || state->bar_height_multiplier > 4) {
                 state->bar_height_multiplier = 2;  // Sanity check
             }
+        } else if (key == "connect_timeout") {
+            parse_timeout_seconds(value, &state->timeouts.connect_ms);
+        } else if (key == "first_byte_timeout") {
+            parse_timeout_seconds(value, &state->timeouts.first_byte_ms);
+        } else if (key == "timeout") {
+            parse_timeout_seconds(value, &state->timeouts.total_ms);
+        } else {
+            for (const TransportSetting& setting : kTransportSettings) {
+                if (key == setting.key) {
+                    set_transport_value(&state->transport, setting.key, value);
+                }
+            }
         }
         // Note: legacy gui_mode and mode_* keys are ignored for backwards compatibility
     }
@@ -2912,6 +4702,16 @@ static void save_gui_state(const GUIState* state) {
     file << "dark_mode=" << (state->dark_mode ? "1" : "0") << "\n";
     file << "refresh_interval=" << state->refresh_interval << "\n";
     file << "bar_height_multiplier=" << state->bar_height_multiplier << "\n";
+    file << "connect_timeout=" << state->timeouts.connect_ms / 1000.0 << "\n";
+    file << "first_byte_timeout=" << state->timeouts.first_byte_ms / 1000.0 << "\n";
+    file << "timeout=" << state->timeouts.total_ms / 1000.0 << "\n";
+    const RequestTransport default_transport;
+    for (const TransportSetting& setting : kTransportSettings) {
+        const std::string value = get_transport_value(state->transport, setting.key);
+        if (value != get_transport_value(default_transport, setting.key)) {
+            file << setting.key << "=" << value << "\n";
+        }
+    }
 
     file.close();
 }
@@ -2938,9 +4738,13 @@ static void restore_window_position(GUIState* state) {
 
 // GUI main function
 static int run_gui_mode(const std::string& api_key,
+                       const std::vector<AccountKey>& account_keys,
                        int refresh_interval,
                        const std::string& log_file,
                        bool logging_enabled,
+                       bool dbus_enabled,
+                       const RequestTimeouts* timeout_override,
+                       const RequestTransport* transport_override,
                        int* argc, char*** argv) {
 
     // Initialize GTK
@@ -2959,9 +4763,22 @@ static int run_gui_mode(const std::string& api_key,
     state->log_file = log_file;
     state->logging_enabled = logging_enabled;
     state->refresh_interval = refresh_interval;
+    for (const AccountKey& key : account_keys) {
+        GUIAccount acct;
+        acct.name = key.name;
+        acct.api_key = key.api_key;
+        acct.token = extract_token(key.api_key);
+        acct.log_file = logging_enabled ? account_log_path(log_file, key.name) : std::string();
+        state->accounts.push_back(std::move(acct));
+    }
 
     // Load saved state
     load_gui_state(state);
+    set_request_timeouts(timeout_override ? *timeout_override : state->timeouts);
+    set_request_transport(transport_override ? *transport_override : state->transport);
+    if (g_timings) {
+        std::cerr << "Transport: " << describe_request_transport(get_request_transport()) << std::endl;
+    }
 
     // Preserve the loaded position for restore; some WMs will emit a configure
     // event at 0,0 while mapping which would otherwise clobber state->window_x/y.
@@ -2986,31 +4803,46 @@ static int run_gui_mode(const std::string& api_key,
     // Restore window position and visibility
     restore_window_position(state);
 
+    // Export quota state on the session bus for panel applets and widgets
+    if (dbus_enabled) {
+        g_dbus_service = quota_dbus_start(on_dbus_refresh, state);
+    }
+
     // Initial fetch
+    retry_init(&state->retry);
+    state->network_handler = g_signal_connect(g_network_monitor_get_default(), "network-changed",
+                                              G_CALLBACK(on_network_changed), state);
+    fetch_worker_start(state);
     on_timer_update(state);
 
-    // Start update timer (convert seconds to milliseconds)
-    state->timer_id = g_timeout_add(
-        state->refresh_interval * 1000,
+    // Start update timer (second granularity, batched with the UI tick)
+    state->timer_id = add_clock_timeout(
+        state->refresh_interval,
         on_timer_update,
         state
     );
 
-    // Update countdown label once per second.
-    state->countdown_timer_id = g_timeout_add_seconds(1, on_countdown_tick, state);
+    // Update countdown label once per second while the window is on screen.
+    state->countdown_ticker = ui_ticker_add(on_countdown_tick, state);
+    ui_ticker_set_visible(state->countdown_ticker, gtk_widget_get_mapped(state->window));
 
     // Run GTK main loop
     gtk_main();
 
     // Cleanup
+    fetch_worker_stop();
     save_gui_state(state);
     if (state->timer_id > 0) {
         g_source_remove(state->timer_id);
     }
-    if (state->countdown_timer_id > 0) {
-        g_source_remove(state->countdown_timer_id);
-    }
+    ui_ticker_remove(state->countdown_ticker);
+    g_signal_handler_disconnect(g_network_monitor_get_default(), state->network_handler);
+    quota_dbus_stop(g_dbus_service);
+    g_dbus_service = nullptr;
     notify_uninit();
+    if (state->usage_bar_cache) {
+        cairo_surface_destroy(state->usage_bar_cache);
+    }
     delete state;
 
     return 0;
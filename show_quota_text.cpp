@@ -6,10 +6,25 @@
 // =============================================================================
 
 #include "quota_common.h"
+#include "quota_push.h"
+#include "quota_jsonl.h"
+#include "quota_follow.h"
+#include "quota_screen.h"
+#include "quota_history.h"
+#include "quota_dashboard.h"
+#include "quota_glyphs.h"
+#include "quota_status.h"
+#include "quota_retry.h"
+#include "quota_capture.h"
 #include <sys/ioctl.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <poll.h>
 #include <clocale>
 #include <signal.h>
 #include <algorithm>
+#include <chrono>
 
 // ============================================================================
 // Terminal UI - Cursor Control
@@ -17,6 +32,25 @@
 
 static volatile sig_atomic_t g_cursor_hidden = 0;
 
+// Optional localhost push endpoint (--serve)
+static PushServer* g_push_server = nullptr;
+
+// Reused serializer for --jsonl and push snapshots
+static JsonlWriter g_jsonl_writer;
+
+// Status bar line per update instead of the terminal view (--status)
+static StatusWriter g_status_writer;
+static bool g_status_mode = false;
+
+// Recent samples behind the sparkline and --chart (single-account modes)
+static QuotaHistory g_history;
+static bool g_history_enabled = false;
+static bool g_chart_mode = false;
+
+// --timings: phase timings of the last fetch, printed with the transport
+static bool g_timings = false;
+static std::string g_last_timings;
+
 static void cursor_hide_raw() {
     static const char kHide[] = "\033[?25l";
     (void)!write(STDOUT_FILENO, kHide, sizeof(kHide) - 1);
@@ -44,12 +78,142 @@ static void hide_cursor_if_tty() {
     }
 }
 
-static void handle_term_signal(int sig) {
-    if (g_cursor_hidden) {
-        cursor_show_raw();
-        g_cursor_hidden = 0;
+
+// ============================================================================
+// Terminal UI - Signals
+// ============================================================================
+
+// Terminal modes receive SIGINT/SIGTERM/SIGWINCH on a signalfd instead of in a
+// handler, so they can restore the terminal and return from main() normally.
+static int g_signal_fd = -1;
+
+// True while SIGINT or SIGTERM is waiting to be read. Installed as the request
+// abort check so Ctrl+C does not wait for a slow request to finish.
+static bool termination_pending() {
+    sigset_t pending;
+    sigemptyset(&pending);
+    if (sigpending(&pending) != 0) {
+        return false;
+    }
+    return sigismember(&pending, SIGINT) == 1 || sigismember(&pending, SIGTERM) == 1;
+}
+
+// Block the terminal signals and route them to g_signal_fd
+static void block_terminal_signals() {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGWINCH);
+    if (sigprocmask(SIG_BLOCK, &mask, nullptr) != 0) {
+        return;
+    }
+    g_signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (g_signal_fd < 0) {
+        // Fall back to the default dispositions.
+        sigprocmask(SIG_UNBLOCK, &mask, nullptr);
+        return;
+    }
+    set_request_abort_check(termination_pending);
+}
+
+// Drain g_signal_fd. Returns SIGINT/SIGTERM if termination was requested
+// (0 otherwise) and sets *resized on SIGWINCH.
+static int read_terminal_signals(bool* resized) {
+    if (g_signal_fd < 0) {
+        return 0;
+    }
+    int term_signal = 0;
+    struct signalfd_siginfo info;
+    while (read(g_signal_fd, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+        if (info.ssi_signo == SIGWINCH) {
+            *resized = true;
+        } else {
+            term_signal = static_cast<int>(info.ssi_signo);
+        }
+    }
+    return term_signal;
+}
+
+// ============================================================================
+// Terminal UI - Keyboard
+// ============================================================================
+
+// Live view keys: unbuffered, no echo. ISIG stays on, so Ctrl+C still arrives
+// through the signalfd.
+static struct termios g_saved_termios;
+static bool g_termios_saved = false;
+
+static void restore_key_input() {
+    if (g_termios_saved) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &g_saved_termios);
+        g_termios_saved = false;
     }
-    _exit(128 + sig);
+}
+
+// Switch stdin to non-canonical, non-blocking reads (VMIN = VTIME = 0, so the
+// descriptor flags shared with the shell are left alone)
+static bool enable_key_input() {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &g_saved_termios) != 0) {
+        return false;
+    }
+    struct termios raw = g_saved_termios;
+    raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0) {
+        return false;
+    }
+    g_termios_saved = true;
+    std::atexit(restore_key_input);
+    return true;
+}
+
+// Commands collected from the keys typed since the last read
+struct KeyCommands {
+    bool refresh = false;       // r
+    bool quit = false;          // q
+    int interval_steps = 0;     // + / -
+    bool toggle_compact = false;
+    bool toggle_tiny = false;
+};
+
+static KeyCommands read_key_commands() {
+    KeyCommands cmd;
+    char buf[64];
+    ssize_t n;
+    while ((n = read(STDIN_FILENO, buf, sizeof(buf))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            switch (buf[i]) {
+                case 'r': case 'R': cmd.refresh = true; break;
+                case 'q': case 'Q': cmd.quit = true; break;
+                case '+': case '=': cmd.interval_steps++; break;
+                case '-': case '_': cmd.interval_steps--; break;
+                case 'c': case 'C': cmd.toggle_compact = !cmd.toggle_compact; break;
+                case 't': case 'T': cmd.toggle_tiny = !cmd.toggle_tiny; break;
+                default: break;
+            }
+        }
+    }
+    return cmd;
+}
+
+// Refresh intervals offered by +/- (seconds)
+static const int kRefreshSteps[] = {5, 10, 15, 30, 60, 120, 300, 600};
+
+static int step_refresh_interval(int interval, int steps) {
+    const int count = static_cast<int>(sizeof(kRefreshSteps) / sizeof(kRefreshSteps[0]));
+    for (; steps > 0; steps--) {
+        int i = 0;
+        while (i < count && kRefreshSteps[i] <= interval) i++;
+        interval = (i < count) ? kRefreshSteps[i] : kRefreshSteps[count - 1];
+    }
+    for (; steps < 0; steps++) {
+        int i = count - 1;
+        while (i >= 0 && kRefreshSteps[i] >= interval) i--;
+        interval = (i >= 0) ? kRefreshSteps[i] : kRefreshSteps[0];
+    }
+    return interval;
 }
 
 // ============================================================================
@@ -65,27 +229,19 @@ static int get_terminal_width() {
     return 80; // Default fallback
 }
 
+// Get terminal height
+static int get_terminal_height() {
+    struct winsize w;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_row > 0) {
+        return w.ws_row;
+    }
+    return 24; // Default fallback
+}
+
 // Check if terminal supports UTF-8
 static bool is_utf8_locale() {
-    // Initialize locale from environment
-    std::setlocale(LC_CTYPE, "");
-    
-    const char* locale = std::setlocale(LC_CTYPE, nullptr);
-    if (locale) {
-        std::string loc(locale);
-        return loc.find("UTF-8") != std::string::npos || 
-               loc.find("utf8") != std::string::npos;
-    }
-    
-    // Also check LANG environment variable as fallback
-    const char* lang = std::getenv("LANG");
-    if (lang) {
-        std::string lang_str(lang);
-        return lang_str.find("UTF-8") != std::string::npos || 
-               lang_str.find("utf8") != std::string::npos;
-    }
-    
-    return false;
+    // Detected once (locale, then LANG); see quota_glyphs.h
+    return term_caps().utf8;
 }
 
 // Truncate string from right
@@ -96,6 +252,42 @@ static std::string truncate_right(const std::string& s, size_t max_len) {
     return s.substr(0, max_len);
 }
 
+// ============================================================================
+// Terminal UI - Frame Output
+// ============================================================================
+
+// Refresh loops render into g_frame and hand it to the differential renderer
+// (quota_screen.h) instead of clearing the screen and reprinting everything.
+static TermScreen g_screen;
+static std::ostringstream g_frame;
+static std::streambuf* g_saved_cout = nullptr;
+static std::streambuf* g_saved_cerr = nullptr;
+
+// Redirect std::cout (and std::cerr when it is the same terminal) into g_frame
+static void frame_begin() {
+    std::cout.flush();
+    g_frame.str(std::string());
+    g_frame.clear();
+    g_saved_cout = std::cout.rdbuf(g_frame.rdbuf());
+    if (isatty(STDERR_FILENO)) {
+        g_saved_cerr = std::cerr.rdbuf(g_frame.rdbuf());
+    }
+}
+
+// Restore the streams and draw only what changed since the previous frame
+// (present = false drops the frame, e.g. when exiting)
+static void frame_end(bool present = true) {
+    std::cout.rdbuf(g_saved_cout);
+    if (g_saved_cerr) {
+        std::cerr.rdbuf(g_saved_cerr);
+        g_saved_cerr = nullptr;
+    }
+    if (present) {
+        screen_resize(&g_screen, get_terminal_width(), get_terminal_height());
+        screen_present(&g_screen, g_frame.str(), STDOUT_FILENO);
+    }
+}
+
 // ============================================================================
 // Terminal UI - Color Functions
 // ============================================================================
@@ -105,14 +297,7 @@ static std::string get_color_for_percentage(double percentage, bool use_colors)
     if (!use_colors) {
         return "";
     }
-    
-    if (percentage < 50.0) {
-        return "\033[32m"; // Green
-    } else if (percentage < 80.0) {
-        return "\033[33m"; // Yellow
-    } else {
-        return "\033[31m"; // Red
-    }
+    return usage_color_sgr(percentage);
 }
 
 static std::string get_color_for_percentage_tiny(double percentage, bool use_colors) {
@@ -133,8 +318,8 @@ static std::string get_color_for_percentage_tiny(double percentage, bool use_col
 // Terminal UI - Progress Bar Rendering
 // ============================================================================
 
-// Render progress bar
-static std::string render_progress_bar(double percentage, int terminal_width, bool use_colors) {
+// Width of the usage bar between the brackets
+static int progress_bar_width(int terminal_width) {
     // Calculate bar width (leave space for "Usage: [] XX.XX%")
     int fixed_width = 17; // "Usage: [] " + "XX.XX%" approximately
     int bar_width = terminal_width - fixed_width;
@@ -146,41 +331,31 @@ static std::string render_progress_bar(double percentage, int terminal_width, bo
     if (bar_width > 50) {
         bar_width = 50; // Maximum reasonable width
     }
-    
-    // Calculate filled and empty blocks
-    int filled = static_cast<int>((percentage / 100.0) * bar_width);
-    int empty = bar_width - filled;
-    
-    // Ensure bounds
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
-    
-    // Choose characters based on locale
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
-    
-    // Get color
-    std::string color = get_color_for_percentage(percentage, use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
-    
-    // Build the bar
-    std::ostringstream bar;
-    bar << "Usage: [" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
+    return bar_width;
+}
+
+// Render progress bar (into a buffer reused across frames)
+static const std::string& render_progress_bar(double percentage, int terminal_width, bool use_colors) {
+    static std::string bar;
+    const int bar_width = progress_bar_width(terminal_width);
+
+    char value[32];
+    snprintf(value, sizeof(value), "%.2f%%", percentage);
+
+    bar.clear();
+    bar.append("Usage: [");
+    if (use_colors) {
+        bar.append(usage_color_sgr(percentage));
     }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
+    append_bar(&bar, percentage / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
     }
-    bar << reset << "] ";
-    bar << std::fixed << std::setprecision(2) << percentage << "%";
-    
-    return bar.str();
+    bar.append("] ").append(value);
+    return bar;
 }
 
-static std::string render_progress_bar_compact(double percentage, int terminal_width, bool use_colors) {
+static const std::string& render_progress_bar_compact(double percentage, int terminal_width, bool use_colors) {
     int pct_i = static_cast<int>(std::llround(percentage));
     if (pct_i < 0) pct_i = 0;
     if (pct_i > 100) pct_i = 100;
@@ -199,30 +374,72 @@ static std::string render_progress_bar_compact(double percentage, int terminal_w
         suffix_len = static_cast<int>(suffix.size());
     }
 
-    int filled = static_cast<int>((static_cast<double>(pct_i) / 100.0) * bar_width);
-    int empty = bar_width - filled;
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
+    static std::string bar;
+    bar.clear();
+    bar.append(label).append("[");
+    if (use_colors) {
+        bar.append(usage_color_sgr(static_cast<double>(pct_i)));
+    }
+    append_bar(&bar, pct_i / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
+    }
+    bar.append("] ").append(suffix);
+    return bar;
+}
+
+// Sparkline of recent samples, aligned under the usage bar (one column per
+// sample, newest on the right)
+static std::string render_history_sparkline(QuotaHistory* history, int terminal_width, bool compact_mode) {
+    const bool use_utf8 = is_utf8_locale();
+    if (compact_mode) {
+        // Lines up with "U:[" ... "] NN%"
+        const int width = std::max(terminal_width - 8, 1);
+        return "T:[" + history_render(history, &history->sparkline, width, 1, use_utf8)[0] + "]";
+    }
+    const int width = progress_bar_width(terminal_width);
+    return "Trend: [" + history_render(history, &history->sparkline, width, 1, use_utf8)[0] + "]";
+}
 
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
+// Full-width chart of recent samples (--chart, dashboard): 0-100% axis on the
+// left, time of the oldest and newest plotted sample underneath
+static void print_history_chart(std::ostream& out, QuotaHistory* history, int terminal_width, int height) {
+    const bool use_utf8 = is_utf8_locale();
+    const int width = std::max(terminal_width - 6, 10); // "100% |"
+    const std::vector<std::string>& rows = history_render(history, &history->chart, width, height, use_utf8);
 
-    std::string color = get_color_for_percentage(static_cast<double>(pct_i), use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
+    for (int r = 0; r < height; r++) {
+        const char* label = (r == 0) ? "100% " : (r == height / 2) ? " 50% " : (r == height - 1) ? "  0% " : "     ";
+        out << label << (use_utf8 ? "│" : "|") << rows[static_cast<size_t>(r)] << '\n';
+    }
+
+    out << "     " << (use_utf8 ? "└" : "+");
+    for (int i = 0; i < width; i++) {
+        out << (use_utf8 ? "─" : "-");
+    }
+    out << '\n';
 
-    std::ostringstream bar;
-    bar << label << "[" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
+    if (history->count == 0) {
+        return;
     }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
+    const size_t shown = std::min(history->count, static_cast<size_t>(width));
+    char first[16];
+    char last[16];
+    const time_t first_ts = history_at(history, history->count - shown).timestamp;
+    const time_t last_ts = history_at(history, history->count - 1).timestamp;
+    const struct tm first_tm = clock_localtime(first_ts);
+    const struct tm last_tm = clock_localtime(last_ts);
+    strftime(first, sizeof(first), "%H:%M", &first_tm);
+    strftime(last, sizeof(last), "%H:%M", &last_tm);
+
+    // Oldest time under the first plotted column, newest flush right.
+    const int first_col = 6 + width - static_cast<int>(shown);
+    std::string axis(static_cast<size_t>(6 + width), ' ');
+    axis.replace(static_cast<size_t>(std::min(first_col, 6 + width - 5)), 5, first);
+    if (shown > 11) {
+        axis.replace(axis.size() - 5, 5, last);
     }
-    bar << reset << "] ";
-    bar << suffix;
-    return bar.str();
+    out << axis << '\n';
 }
 
 static std::string render_tiny_usage_line(double percentage, bool use_colors) {
@@ -242,8 +459,8 @@ static std::string render_tiny_usage_line(double percentage, bool use_colors) {
 // Terminal UI - Reset Time Bar Rendering
 // ============================================================================
 
-static std::string render_reset_time_bar(time_t reset_utc, int terminal_width, bool use_colors) {
-    time_t now = time(nullptr);
+static const std::string& render_reset_time_bar(time_t reset_utc, int terminal_width, bool use_colors) {
+    time_t now = clock_now();
     int64_t remaining_seconds = static_cast<int64_t>(difftime(reset_utc, now));
     if (remaining_seconds < 0) {
         remaining_seconds = 0;
@@ -273,36 +490,22 @@ static std::string render_reset_time_bar(time_t reset_utc, int terminal_width, b
         bar_width = 50;
     }
 
-    int filled = static_cast<int>((remaining_pct / 100.0) * bar_width);
-    int empty = bar_width - filled;
-
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
-
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
-
-    std::string color = get_color_for_percentage(approaching_pct, use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
-
-    std::ostringstream bar;
-    bar << "Reset: [" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
+    static std::string bar;
+    bar.clear();
+    bar.append("Reset: [");
+    if (use_colors) {
+        bar.append(usage_color_sgr(approaching_pct));
     }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
+    append_bar(&bar, remaining_pct / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
     }
-    bar << reset << "] ";
-    bar << format_duration_compact(remaining_seconds) << " left (of 5h)";
-
-    return bar.str();
+    bar.append("] ").append(format_duration_compact(remaining_seconds)).append(" left (of 5h)");
+    return bar;
 }
 
-static std::string render_reset_time_bar_compact(time_t reset_utc, int terminal_width, bool use_colors) {
-    time_t now = time(nullptr);
+static const std::string& render_reset_time_bar_compact(time_t reset_utc, int terminal_width, bool use_colors) {
+    time_t now = clock_now();
     int64_t remaining_seconds = static_cast<int64_t>(difftime(reset_utc, now));
     if (remaining_seconds < 0) {
         remaining_seconds = 0;
@@ -335,30 +538,18 @@ static std::string render_reset_time_bar_compact(time_t reset_utc, int terminal_
         suffix_len = static_cast<int>(suffix.size());
     }
 
-    int filled = static_cast<int>((remaining_pct / 100.0) * bar_width);
-    int empty = bar_width - filled;
-    if (filled < 0) filled = 0;
-    if (filled > bar_width) filled = bar_width;
-    if (empty < 0) empty = 0;
-
-    bool use_utf8 = is_utf8_locale();
-    std::string filled_char = use_utf8 ? "█" : "#";
-    std::string empty_char = use_utf8 ? "░" : "-";
-
-    std::string color = get_color_for_percentage(approaching_pct, use_colors);
-    std::string reset = use_colors ? "\033[0m" : "";
-
-    std::ostringstream bar;
-    bar << label << "[" << color;
-    for (int i = 0; i < filled; i++) {
-        bar << filled_char;
+    static std::string bar;
+    bar.clear();
+    bar.append(label).append("[");
+    if (use_colors) {
+        bar.append(usage_color_sgr(approaching_pct));
     }
-    for (int i = 0; i < empty; i++) {
-        bar << empty_char;
+    append_bar(&bar, remaining_pct / 100.0, bar_width, is_utf8_locale());
+    if (use_colors) {
+        bar.append("\033[0m");
     }
-    bar << reset << "] ";
-    bar << suffix;
-    return bar.str();
+    bar.append("] ").append(suffix);
+    return bar;
 }
 
 // ============================================================================
@@ -379,15 +570,49 @@ static void print_usage(const char* program_name) {
     std::cerr << "  --no-log            Disable logging" << std::endl;
     std::cerr << "  --compact           Compact bar layout for ~40-column terminals" << std::endl;
     std::cerr << "  --tiny              Extra small single-line output: XX%" << std::endl;
+    std::cerr << "  --jsonl             One compact JSON object per refresh on stdout (no screen clearing)" << std::endl;
+    std::cerr << "  --chart             Full-width usage chart of recent samples instead of the sparkline" << std::endl;
+    std::cerr << "  --dashboard         Full-screen dashboard: usage, history, forecast, latency, events, errors" << std::endl;
+    std::cerr << "  --status <format>   One status bar line per refresh: i3bar|swaybar, waybar, polybar|lemonbar, tmux" << std::endl;
+    std::cerr << "  --key-file <file>   Monitor several accounts (name=key per line), fetched concurrently" << std::endl;
+    std::cerr << "  --follow <logfile>  Display another instance's log as it grows (no API key, no network)" << std::endl;
+    std::cerr << "  --serve <port>      Stream snapshots on http://127.0.0.1:<port>/events (SSE) and /ndjson" << std::endl;
+    std::cerr << "  --hedge             Resend a fetch still pending at the recent p95 (at most 5% of fetches)" << std::endl;
+    std::cerr << "  --timeout <sec>     Give up on a refresh after N seconds (default: 15, 0 = no limit)" << std::endl;
+    std::cerr << "  --connect-timeout <sec>     Connection budget per attempt (default: 5)" << std::endl;
+    std::cerr << "  --first-byte-timeout <sec>  Budget for the first response byte per attempt (default: 10)" << std::endl;
+    std::cerr << "  --url <url>         API endpoint (default: " << kDefaultQuotaUrl << ")" << std::endl;
+    std::cerr << "  --proxy <url>       Proxy for API requests (default: https_proxy / no_proxy)" << std::endl;
+    std::cerr << "  --unix-socket <path>  Connect through a Unix domain socket (e.g. a local sidecar)" << std::endl;
+    std::cerr << "  --cacert <file>     CA bundle for verifying the endpoint" << std::endl;
+    std::cerr << "  --http <1.1|2|3>    HTTP version (3 needs a libcurl built with HTTP/3)" << std::endl;
+    std::cerr << "  --resolve <host:port:addr>  Pin a host to an address (repeatable)" << std::endl;
+    std::cerr << "  --timings           Print the transport and each fetch's phase timings on stderr" << std::endl;
+    std::cerr << "  --record <file>     Save every API response to a capture file" << std::endl;
+    std::cerr << "  --replay <file>     Replay a capture instead of calling the API (no key needed)" << std::endl;
+    std::cerr << "  --replay-speed <x>  Replay pace: 1 = as recorded (default), N = N times faster, 0 = no waits" << std::endl;
+    std::cerr << "  --time-scale <x>    Simulated clock x times faster than real time (720: 5 h in 25 s)" << std::endl;
+    std::cerr << "  --time-start <t>    Simulated clock start, unix seconds or ISO 8601 UTC (default: now)" << std::endl;
     std::cerr << "  --help              Show this help message" << std::endl;
     std::cerr << std::endl;
     std::cerr << "API Key:" << std::endl;
     std::cerr << "  Can be passed as argument or set FIRMWARE_API_KEY environment variable" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "Timeouts:" << std::endl;
+    std::cerr << "  FIRMWARE_TIMEOUT, FIRMWARE_CONNECT_TIMEOUT and FIRMWARE_FIRST_BYTE_TIMEOUT (seconds)" << std::endl;
+    std::cerr << "  set the same budgets; command-line options take precedence" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Transport:" << std::endl;
+    std::cerr << "  FIRMWARE_API_URL, FIRMWARE_PROXY, FIRMWARE_UNIX_SOCKET, FIRMWARE_CA_BUNDLE," << std::endl;
+    std::cerr << "  FIRMWARE_HTTP_VERSION and FIRMWARE_RESOLVE (comma-separated) set the same;" << std::endl;
+    std::cerr << "  command-line options take precedence" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "Logging:" << std::endl;
     std::cerr << "  Logs are written in CSV format with columns:" << std::endl;
     std::cerr << "  Timestamp, Used, Percentage, Reset, Event" << std::endl;
     std::cerr << "  Events: FIRST_RUN, UPDATE, QUOTA_RESET, POSSIBLE_RESET, HIGH_USAGE" << std::endl;
+    std::cerr << "  Throttling is logged as a row without usage: RATE_LIMITED http=429 wait=30s" << std::endl;
+    std::cerr << "  While the API answers unchanged, one row is written every 5 minutes" << std::endl;
     std::cerr << std::endl;
     std::cerr << "Examples:" << std::endl;
     std::cerr << "  " << program_name << " fw_api_xxx" << std::endl;
@@ -397,103 +622,21 @@ static void print_usage(const char* program_name) {
     std::cerr << "  " << program_name << " --no-log --refresh 60" << std::endl;
     std::cerr << "  " << program_name << " --compact --refresh 60" << std::endl;
     std::cerr << "  " << program_name << " --tiny --refresh 60" << std::endl;
+    std::cerr << "  " << program_name << " --jsonl --refresh 30 | jq .percentage" << std::endl;
+    std::cerr << "  " << program_name << " --serve 8787 --refresh 60" << std::endl;
+    std::cerr << "  " << program_name << " --key-file ~/.config/firmware-quota/keys --compact" << std::endl;
+    std::cerr << "  " << program_name << " --follow show_quota.log --tiny" << std::endl;
+    std::cerr << "  " << program_name << " --dashboard --refresh 30" << std::endl;
+    std::cerr << "  " << program_name << " --status waybar --refresh 30" << std::endl;
 }
 
-// Fetch and display quota information
-static int fetch_and_display_quota(const std::string& api_key, const std::string& token, 
-                              bool text_mode, bool compact_mode, bool tiny_mode, bool use_colors, int terminal_width,
-                              const std::string& log_file,
-                              std::optional<AuthMethod>& preferred_auth_method,
-                              bool truncate_error_body) {
-    // Try different auth methods
-    std::optional<AuthMethod> used_method;
-    RequestResult result = try_auth_methods(api_key, token, preferred_auth_method, &used_method);
-
-    if (result.curl_code != CURLE_OK) {
-        std::cerr << "Request failed: " << curl_easy_strerror(result.curl_code);
-        if (!result.curl_error.empty()) {
-            std::cerr << " (" << result.curl_error << ")";
-        }
-        std::cerr << std::endl;
-        return 1;
-    }
-
-    if (!is_http_success(result.http_code)) {
-        std::cerr << "HTTP error: " << result.http_code << std::endl;
-        if (!result.body.empty()) {
-            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
-        }
-        return 1;
-    }
-
-    if (is_auth_failure(result)) {
-        std::cerr << "Error: Unauthorized after trying all auth methods." << std::endl;
-        if (!result.body.empty()) {
-            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
-        }
-        return 1;
-    }
-    
-    // Parse JSON response
-    json j;
-    try {
-        j = json::parse(result.body);
-    } catch (const json::parse_error& e) {
-        std::cerr << "Failed to parse response. Raw response:" << std::endl;
-        std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
-        return 1;
-    }
-    
-    // Extract used and reset fields
-    if (!j.contains("used") || j["used"].is_null()) {
-        std::cerr << "Failed to parse response. Raw response:" << std::endl;
-        std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
-        return 1;
-    }
-    
-    double used = j["used"];
-    std::string reset = j.contains("reset") && !j["reset"].is_null() ? j["reset"].get<std::string>() : "";
-    
-    // Calculate percentage
-    double percentage = used * 100.0;
-    
-    // Prepare current quota data
-    QuotaData current_data;
-    current_data.used = used;
-    current_data.percentage = percentage;
-    current_data.reset_time = reset.empty() ? "N/A" : reset;
-    current_data.timestamp = time(nullptr);
-    
-    // Handle logging if enabled
-    std::string event = "UPDATE";
-    if (!log_file.empty()) {
-        QuotaData previous_data = read_last_log_entry(log_file);
-        event = detect_event(current_data, previous_data);
-        write_log_entry(log_file, current_data, event);
-        
-        // Show event notification for important changes
-        if (!compact_mode && !tiny_mode && (event == "QUOTA_RESET" || event == "POSSIBLE_RESET")) {
-            if (use_colors) {
-                std::cout << "\033[33m"; // Yellow
-            }
-            std::cout << "*** " << event << " DETECTED ***" << std::endl;
-            if (use_colors) {
-                std::cout << "\033[0m"; // Reset
-            }
-        }
-    }
+// Print usage and reset details for one sample (below the title line)
+static void print_quota_details(const QuotaData& data, bool text_mode, bool compact_mode,
+                                bool use_colors, int terminal_width, QuotaHistory* history) {
+    const double percentage = data.percentage;
+    const double used = data.used;
+    const std::string reset = (data.reset_time == "N/A") ? std::string() : data.reset_time;
 
-    if (tiny_mode) {
-        std::cout << render_tiny_usage_line(percentage, use_colors) << std::endl;
-        return 0;
-    }
-    
-    // Display results
-    if (!compact_mode) {
-        std::cout << "Firmware API Quota Details:" << std::endl;
-        std::cout << "==========================" << std::endl;
-    }
-    
     if (text_mode) {
         // Pure text output
         std::cout << std::fixed << std::setprecision(2);
@@ -510,6 +653,9 @@ static int fetch_and_display_quota(const std::string& api_key, const std::string
         } else {
             std::cout << render_progress_bar(percentage, terminal_width, use_colors) << std::endl;
         }
+        if (history && history->count > 0 && !g_chart_mode) {
+            std::cout << render_history_sparkline(history, terminal_width, compact_mode) << std::endl;
+        }
     }
 
     if (!reset.empty()) {
@@ -523,7 +669,7 @@ static int fetch_and_display_quota(const std::string& api_key, const std::string
                     std::cout << render_reset_time_bar(reset_utc, terminal_width, use_colors) << std::endl;
                 }
             } else {
-                time_t now = time(nullptr);
+                time_t now = clock_now();
                 int64_t remaining_seconds = static_cast<int64_t>(difftime(reset_utc, now));
                 if (remaining_seconds < 0) {
                     remaining_seconds = 0;
@@ -554,152 +700,1690 @@ static int fetch_and_display_quota(const std::string& api_key, const std::string
             std::cout << "R: none" << std::endl;
         }
     }
-    
-    return 0;
-}
-
-int main(int argc, char* argv[]) {
-    std::string api_key;
-    int refresh_interval = 15;
-    bool text_mode = false;
-    bool compact_mode = false;
-    bool tiny_mode = false;
-    std::string log_file = "show_quota.log";
-    bool logging_enabled = true;
 
-    // Parse command-line arguments
-    for (int i = 1; i < argc; i++) {
-        std::string arg = argv[i];
+    if (history && g_chart_mode && !text_mode) {
+        print_history_chart(std::cout, history, terminal_width, 8);
+    }
+}
 
-        if (arg == "--help" || arg == "-h") {
-            print_usage(argv[0]);
-            return 0;
-        } else if (arg == "-1") {
-            refresh_interval = 0;
-        } else if (arg == "--refresh" || arg == "-r") {
-            if (i + 1 < argc) {
-                refresh_interval = std::atoi(argv[++i]);
-            } else {
-                refresh_interval = 15; // Default to 15 seconds
-            }
-        } else if (arg == "--text" || arg == "-t") {
-            text_mode = true;
-        } else if (arg == "--compact") {
-            compact_mode = true;
-            tiny_mode = false;
-        } else if (arg == "--tiny") {
-            tiny_mode = true;
-            compact_mode = false;
-        } else if (arg == "--log" || arg == "-l") {
-            if (i + 1 < argc) {
-                log_file = argv[++i];
-                logging_enabled = true;
-            } else {
-                std::cerr << "Error: --log requires a file path" << std::endl;
-                print_usage(argv[0]);
-                return 1;
-            }
-        } else if (arg == "--no-log") {
-            logging_enabled = false;
-        } else if (arg[0] != '-') {
-            // Assume it's the API key
-            api_key = arg;
-        } else {
-            std::cerr << "Unknown option: " << arg << std::endl;
-            print_usage(argv[0]);
-            return 1;
+// Draw one sample: reset banner (when events come from the log), title, details
+static void display_quota(const QuotaData& data, const std::string& event, bool show_event,
+                          bool text_mode, bool compact_mode, bool tiny_mode,
+                          bool use_colors, int terminal_width) {
+    if (show_event && !compact_mode && !tiny_mode && (event == "QUOTA_RESET" || event == "POSSIBLE_RESET")) {
+        if (use_colors) {
+            std::cout << "\033[33m"; // Yellow
+        }
+        std::cout << "*** " << event << " DETECTED ***" << std::endl;
+        if (use_colors) {
+            std::cout << "\033[0m"; // Reset
         }
     }
 
-    if (compact_mode || tiny_mode) {
-        std::atexit(show_cursor_if_hidden);
-        struct sigaction sa;
-        std::memset(&sa, 0, sizeof(sa));
-        sa.sa_handler = handle_term_signal;
-        sigemptyset(&sa.sa_mask);
-        sigaction(SIGINT, &sa, nullptr);
-        sigaction(SIGTERM, &sa, nullptr);
-        hide_cursor_if_tty();
-    }
-    
-    // Get API key from environment variable if not provided
-    if (api_key.empty()) {
-        const char* env_key = std::getenv("FIRMWARE_API_KEY");
-        if (env_key) {
-            api_key = env_key;
-        }
+    if (tiny_mode) {
+        std::cout << render_tiny_usage_line(data.percentage, use_colors) << std::endl;
+        return;
     }
-    
-    // Check if API key is provided
-    if (api_key.empty()) {
-        std::cerr << "Error: API key not provided." << std::endl;
-        std::cerr << std::endl;
-        print_usage(argv[0]);
-        return 1;
+
+    if (!compact_mode) {
+        std::cout << "Firmware API Quota Details:" << std::endl;
+        std::cout << "==========================" << std::endl;
     }
-    
-    // Extract token
-    std::string token = extract_token(api_key);
 
-    // Initialize curl globally
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    print_quota_details(data, text_mode, compact_mode, use_colors, terminal_width,
+                        g_history_enabled ? &g_history : nullptr);
+}
 
-    int result = 0;
-    std::optional<AuthMethod> preferred_auth_method;
+// Fetch and display quota information
+static int fetch_and_display_quota(const std::string& api_key, const std::string& token, 
+                              bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode,
+                              bool use_colors, int terminal_width,
+                              const std::string& log_file,
+                              std::optional<AuthMethod>& preferred_auth_method,
+                              QuotaData* last_sample,
+                              std::string* last_event,
+                              bool truncate_error_body,
+                              long* rate_limit_out) {
+    // Try different auth methods
+    std::optional<AuthMethod> used_method;
+    const auto fetch_start = std::chrono::steady_clock::now();
+    RequestResult result = try_auth_methods(api_key, token, preferred_auth_method, &used_method);
+    const double latency_ms = capture_latency_ms(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fetch_start).count());
 
-    if (refresh_interval > 0) {
-        // Continuous refresh mode
-        while (true) {
-            int terminal_width = get_terminal_width();
-            bool use_colors = isatty(STDOUT_FILENO);
+    if (g_timings) {
+        g_last_timings = format_request_timings(result.timings);
+    }
 
-            // Clear screen (ANSI escape code)
-            if (use_colors) {
-                std::cout << "\033[2J\033[H"; // Clear screen and move cursor to home
+    // Server-requested delay for the next fetch (-1 when not throttled)
+    long rate_limit_s = -1;
+    if (request_rate_limited(result, &rate_limit_s) && !log_file.empty()) {
+        write_log_rate_limited(log_file, result, rate_limit_s);
+    }
+    if (rate_limit_out) {
+        *rate_limit_out = rate_limit_s;
+    }
+
+    // In --jsonl and --status mode failures are also reported on stdout so
+    // the stream stays one line per refresh; --serve subscribers get the
+    // same error record.
+    auto emit_jsonl_error = [&](const std::string& message) {
+        if (g_status_mode) {
+            // A transfer cut short by Ctrl+C/SIGTERM is not a quota error.
+            if (result.curl_code != CURLE_ABORTED_BY_CALLBACK) {
+                std::cout << status_format_line(&g_status_writer, nullptr, message.c_str(), clock_now()) << '\n'
+                          << std::flush;
+            }
+        }
+        if (!jsonl_mode && !g_push_server) {
+            return;
+        }
+        JsonlRecord rec;
+        rec.timestamp = static_cast<int64_t>(clock_now());
+        rec.ok = false;
+        rec.error = message.c_str();
+        rec.http_code = result.http_code;
+        rec.latency_ms = latency_ms;
+        const std::string& line = jsonl_format_record(&g_jsonl_writer, rec);
+        if (g_push_server) {
+            push_server_publish(g_push_server, line);
+        }
+        if (jsonl_mode) {
+            std::cout << line << '\n' << std::flush;
+        }
+    };
+
+    if (result.curl_code != CURLE_OK) {
+        const std::string message = describe_request_failure(result);
+        std::cerr << message << std::endl;
+        emit_jsonl_error(message);
+        return 1;
+    }
+
+    if (!is_http_success(result.http_code)) {
+        std::cerr << "HTTP error: " << result.http_code << std::endl;
+        if (!result.body.empty()) {
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+        }
+        emit_jsonl_error("HTTP error: " + std::to_string(result.http_code));
+        return 1;
+    }
+
+    if (is_auth_failure(result)) {
+        std::cerr << "Error: Unauthorized after trying all auth methods." << std::endl;
+        if (!result.body.empty()) {
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+        }
+        emit_jsonl_error("Unauthorized after trying all auth methods");
+        return 1;
+    }
+    
+    QuotaData current_data;
+    std::string event = "UPDATE";
+    if (result.unchanged && last_sample && last_sample->timestamp != 0) {
+        // Same body as the previous fetch: same sample and no event; the log
+        // only gets a heartbeat row now and then
+        current_data = *last_sample;
+        current_data.timestamp = clock_now();
+        if (!log_file.empty() && log_heartbeat_due(log_file, current_data.timestamp)) {
+            write_log_entry(log_file, current_data, event);
+        }
+    } else {
+        // Parse JSON response
+        json j;
+        try {
+            j = json::parse(result.body);
+        } catch (const json::parse_error& e) {
+            std::cerr << "Failed to parse response. Raw response:" << std::endl;
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+            emit_jsonl_error("Failed to parse response");
+            return 1;
+        }
+    
+        // Extract used and reset fields
+        if (!j.contains("used") || j["used"].is_null()) {
+            std::cerr << "Failed to parse response. Raw response:" << std::endl;
+            std::cerr << (truncate_error_body ? truncate_for_display(result.body, 300) : result.body) << std::endl;
+            emit_jsonl_error("Failed to parse response (missing 'used')");
+            return 1;
+        }
+    
+        double used = j["used"];
+        std::string reset = j.contains("reset") && !j["reset"].is_null() ? j["reset"].get<std::string>() : "";
+    
+        // Calculate percentage
+        double percentage = used * 100.0;
+    
+        // Prepare current quota data
+        current_data.used = used;
+        current_data.percentage = percentage;
+        current_data.reset_time = reset.empty() ? "N/A" : reset;
+        current_data.timestamp = clock_now();
+    
+        // Handle logging if enabled
+        if (!log_file.empty()) {
+            QuotaData previous_data = read_last_log_entry(log_file);
+            event = detect_event(current_data, previous_data);
+            write_log_entry(log_file, current_data, event);
+        } else if (last_sample) {
+            // No log to compare against: detect events against the previous refresh.
+            event = detect_event(current_data, *last_sample);
+        }
+    }
+    if (last_sample) {
+        *last_sample = current_data;
+    }
+    if (last_event) {
+        *last_event = event;
+    }
+    if (g_history_enabled) {
+        history_push(&g_history, current_data.timestamp, current_data.percentage);
+    }
+
+    // Machine-readable outputs share one serialized line per refresh.
+    if (jsonl_mode || g_push_server) {
+        const std::string& line = jsonl_format_record(&g_jsonl_writer,
+                                                      make_snapshot_record(current_data, event, latency_ms));
+        if (g_push_server) {
+            push_server_publish(g_push_server, line);
+        }
+        if (jsonl_mode) {
+            std::cout << line << '\n' << std::flush;
+            return 0;
+        }
+    }
+    if (g_status_mode) {
+        std::cout << status_format_line(&g_status_writer, &current_data, nullptr, clock_now()) << '\n'
+                  << std::flush;
+        return 0;
+    }
+
+    // Display results (with the reset banner only when events come from the log)
+    display_quota(current_data, event, !log_file.empty(), text_mode, compact_mode, tiny_mode,
+                  use_colors, terminal_width);
+
+    return 0;
+}
+
+// Per-account state for --key-file mode (auth method, log and history are
+// tracked separately for every key)
+struct AccountView {
+    std::string name;
+    std::string api_key;
+    std::string token;
+    std::string log_file;
+    std::optional<AuthMethod> preferred_auth_method;
+    QuotaData last_sample = {0.0, 0.0, "", 0};
+    bool ok = false;            // last fetch succeeded
+    std::string event;          // event of last_sample
+    std::string error;          // last fetch error (when !ok)
+};
+
+// Draw every account from its last fetch result. report_errors repeats the
+// fetch errors on stderr (they are part of the frame when stderr is the tty).
+static void display_accounts(const std::vector<AccountView>& accounts,
+                             bool text_mode, bool compact_mode, bool tiny_mode,
+                             bool use_colors, int terminal_width, bool report_errors) {
+    if (!compact_mode && !tiny_mode) {
+        std::cout << "Firmware API Quota Details:" << std::endl;
+        std::cout << "==========================" << std::endl;
+    }
+
+    std::string tiny_line;
+    for (const AccountView& acct : accounts) {
+        if (!acct.ok) {
+            if (report_errors) {
+                std::cerr << acct.name << ": " << acct.error << std::endl;
+            }
+            if (tiny_mode) {
+                tiny_line += (tiny_line.empty() ? "" : " ") + acct.name + ":ERR";
+            } else {
+                std::cout << (compact_mode ? "" : "\n") << acct.name << ": error" << std::endl;
+            }
+            continue;
+        }
+
+        if (tiny_mode) {
+            tiny_line += (tiny_line.empty() ? "" : " ") + acct.name + ":" +
+                         render_tiny_usage_line(acct.last_sample.percentage, use_colors);
+            continue;
+        }
+
+        if (compact_mode) {
+            std::cout << truncate_right(acct.name, static_cast<size_t>(terminal_width)) << std::endl;
+        } else {
+            std::cout << std::endl << "[" << acct.name << "]";
+            if (acct.event == "QUOTA_RESET" || acct.event == "POSSIBLE_RESET") {
+                std::cout << (use_colors ? " \033[33m*** " : " *** ") << acct.event << " ***"
+                          << (use_colors ? "\033[0m" : "");
+            }
+            std::cout << std::endl;
+        }
+        print_quota_details(acct.last_sample, text_mode, compact_mode, use_colors, terminal_width, nullptr);
+    }
+
+    if (tiny_mode) {
+        std::cout << tiny_line << std::endl;
+    }
+}
+
+// Fetch all accounts concurrently and display them together. rate_limit_out
+// gets the longest server-requested delay (-1 when no account was throttled).
+static int fetch_and_display_accounts(std::vector<AccountView>& accounts,
+                                      bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode,
+                                      bool use_colors, int terminal_width, long* rate_limit_out) {
+    std::vector<AuthJob> jobs(accounts.size());
+    for (size_t i = 0; i < accounts.size(); i++) {
+        jobs[i].api_key = accounts[i].api_key;
+        jobs[i].token = accounts[i].token;
+        jobs[i].preferred_method = accounts[i].preferred_auth_method;
+    }
+
+    const auto fetch_start = std::chrono::steady_clock::now();
+    try_auth_methods_concurrent(jobs);
+    const double latency_ms = capture_latency_ms(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fetch_start).count());
+
+    size_t failures = 0;
+    long rate_limit_s = -1;
+    if (g_timings) {
+        g_last_timings.clear();
+    }
+    for (size_t i = 0; i < accounts.size(); i++) {
+        AccountView& acct = accounts[i];
+        acct.preferred_auth_method = jobs[i].preferred_method;
+        if (g_timings) {
+            g_last_timings += (i == 0 ? "" : "\n         ") + acct.name + "  " +
+                              format_request_timings(jobs[i].result.timings);
+        }
+
+        long throttle_s = 0;
+        if (request_rate_limited(jobs[i].result, &throttle_s)) {
+            rate_limit_s = std::max(rate_limit_s, throttle_s);
+            if (!acct.log_file.empty()) {
+                write_log_rate_limited(acct.log_file, jobs[i].result, throttle_s);
+            }
+        }
+
+        // Unchanged body: reuse the account's sample instead of parsing
+        QuotaData current_data;
+        std::string error;
+        const bool reuse = jobs[i].result.unchanged && acct.ok && acct.last_sample.timestamp != 0;
+        if (reuse) {
+            current_data = acct.last_sample;
+            current_data.timestamp = clock_now();
+        } else if (!parse_quota_result(jobs[i].result, &current_data, &error)) {
+            failures++;
+            acct.ok = false;
+            acct.error = error;
+            if (jsonl_mode) {
+                std::cerr << acct.name << ": " << error << std::endl;
+            }
+            if (jsonl_mode || g_push_server) {
+                JsonlRecord rec;
+                rec.account = acct.name.c_str();
+                rec.timestamp = static_cast<int64_t>(clock_now());
+                rec.ok = false;
+                rec.error = error.c_str();
+                rec.http_code = jobs[i].result.http_code;
+                rec.latency_ms = latency_ms;
+                const std::string& line = jsonl_format_record(&g_jsonl_writer, rec);
+                if (g_push_server) {
+                    push_server_publish(g_push_server, line);
+                }
+                if (jsonl_mode) {
+                    std::cout << line << '\n';
+                }
+            }
+            continue;
+        }
+
+        std::string event = "UPDATE";
+        if (reuse) {
+            if (!acct.log_file.empty() && log_heartbeat_due(acct.log_file, current_data.timestamp)) {
+                write_log_entry(acct.log_file, current_data, event);
+            }
+        } else if (!acct.log_file.empty()) {
+            QuotaData previous_data = read_last_log_entry(acct.log_file);
+            event = detect_event(current_data, previous_data);
+            write_log_entry(acct.log_file, current_data, event);
+        } else {
+            event = detect_event(current_data, acct.last_sample);
+        }
+        acct.last_sample = current_data;
+        acct.ok = true;
+        acct.event = event;
+        acct.error.clear();
+
+        if (jsonl_mode || g_push_server) {
+            JsonlRecord rec = make_snapshot_record(current_data, event, latency_ms);
+            rec.account = acct.name.c_str();
+            const std::string& line = jsonl_format_record(&g_jsonl_writer, rec);
+            if (g_push_server) {
+                push_server_publish(g_push_server, line);
+            }
+            if (jsonl_mode) {
+                std::cout << line << '\n';
+            }
+        }
+    }
+
+    if (!jsonl_mode) {
+        display_accounts(accounts, text_mode, compact_mode, tiny_mode, use_colors, terminal_width, true);
+    }
+    std::cout.flush();
+
+    if (rate_limit_out) {
+        *rate_limit_out = rate_limit_s;
+    }
+
+    // Keep refreshing while at least one account is healthy.
+    return (failures == accounts.size()) ? 1 : 0;
+}
+
+// --timings lines (stderr, so --jsonl and --status output stays clean)
+static void print_timings() {
+    if (!g_timings) {
+        return;
+    }
+    std::cerr << "Transport: " << describe_request_transport(get_request_transport()) << std::endl;
+    if (!g_last_timings.empty()) {
+        std::cerr << "Timings: " << g_last_timings << std::endl;
+    }
+}
+
+// Retry notice and refresh hint under each refreshed frame
+static void print_refresh_footer(const std::string& retry_status, int refresh_interval,
+                                 bool compact_mode, bool tiny_mode, bool jsonl_mode, bool interactive) {
+    if (!retry_status.empty()) {
+        // Error occurred, but continue trying (with backoff)
+        std::cerr << std::endl << retry_status << std::endl;
+    }
+    print_timings();
+
+    // Show next refresh time
+    if (!compact_mode && !tiny_mode && !jsonl_mode) {
+        std::cout << std::endl << "Refreshing every " << refresh_interval << " seconds";
+        if (interactive) {
+            std::cout << " (r refresh, +/- interval, c/t layout, q quit)" << std::endl;
+        } else {
+            std::cout << " (Ctrl+C to stop)..." << std::endl;
+        }
+    }
+}
+
+// Render the newest record of a followed log (--follow). Nothing is fetched:
+// the record is exactly what the writing instance logged. jsonl_mode covers
+// --status as well (one line per record).
+static void display_log_record(const QuotaData* data, const std::string& event,
+                               const std::string& follow_file,
+                               bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode,
+                               bool use_colors, int terminal_width) {
+    if (jsonl_mode) {
+        if (data && g_status_mode) {
+            std::cout << status_format_line(&g_status_writer, data, nullptr, clock_now()) << '\n' << std::flush;
+        } else if (data) {
+            std::cout << jsonl_format_record(&g_jsonl_writer, make_snapshot_record(*data, event)) << '\n'
+                      << std::flush;
+        }
+        return;
+    }
+
+    if (!data) {
+        std::cout << (tiny_mode ? "--%" : "Waiting for " + follow_file + "...") << std::endl;
+        return;
+    }
+
+    if (tiny_mode) {
+        std::cout << render_tiny_usage_line(data->percentage, use_colors) << std::endl;
+        return;
+    }
+
+    if (!compact_mode) {
+        std::cout << "Firmware API Quota Details:" << std::endl;
+        std::cout << "==========================" << std::endl;
+        if (event == "QUOTA_RESET" || event == "POSSIBLE_RESET") {
+            std::cout << (use_colors ? "\033[33m" : "") << "*** " << event << " DETECTED ***"
+                      << (use_colors ? "\033[0m" : "") << std::endl;
+        }
+    }
+
+    print_quota_details(*data, text_mode, compact_mode, use_colors, terminal_width,
+                        g_history_enabled ? &g_history : nullptr);
+
+    if (!compact_mode) {
+        char when[32];
+        const struct tm local_tm = clock_localtime(data->timestamp);
+        strftime(when, sizeof(when), "%H:%M:%S", &local_tm);
+        std::cout << std::endl << "Following " << follow_file << " (last record " << when << ")" << std::endl;
+    }
+    std::cout.flush();
+}
+
+// --follow: block on inotify and redraw only when the log grows
+static int follow_and_display(const std::string& follow_file,
+                              bool text_mode, bool compact_mode, bool tiny_mode, bool jsonl_mode) {
+    std::string error;
+    LogFollower* follower = log_follower_open(follow_file, &error);
+    if (!follower) {
+        std::cerr << "Error: --follow: " << error << std::endl;
+        return 1;
+    }
+
+    // The history comes from the log itself; the follower's first batch (the
+    // same tail) is not added twice.
+    if (g_history_enabled) {
+        history_seed_from_log(&g_history, follow_file, clock_now() - kQuotaWindowSeconds);
+    }
+
+    QuotaData latest = {0.0, 0.0, "", 0};
+    std::string latest_event;
+    bool have_record = false;
+    bool first_batch = true;
+    bool redraw = true;
+    std::vector<std::string> lines;
+    int result = 0;
+
+    while (true) {
+        lines.clear();
+        if (!log_follower_read(follower, &lines, &error)) {
+            std::cerr << "Error: --follow: " << error << std::endl;
+            result = 1;
+            break;
+        }
+
+        // In jsonl mode every record is forwarded; otherwise only the newest
+        // one in the batch is drawn.
+        bool changed = false;
+        for (const std::string& line : lines) {
+            QuotaData data;
+            std::string event;
+            if (!parse_log_line(line, &data, &event)) {
+                continue; // Header or partial garbage
+            }
+            latest = data;
+            latest_event = event;
+            have_record = true;
+            changed = true;
+            if (g_history_enabled && !first_batch) {
+                history_push(&g_history, data.timestamp, data.percentage);
+            }
+            if (jsonl_mode && !g_status_mode) {
+                display_log_record(&latest, latest_event, follow_file, text_mode, compact_mode, tiny_mode,
+                                   true, false, 0);
+            }
+        }
+        if (g_status_mode && changed) {
+            // A status bar only needs the newest record of the batch.
+            display_log_record(&latest, latest_event, follow_file, text_mode, compact_mode, tiny_mode,
+                               true, false, 0);
+        }
+
+        if (!jsonl_mode && (changed || redraw)) {
+            const bool use_colors = isatty(STDOUT_FILENO);
+            if (use_colors) {
+                frame_begin();
+            }
+            display_log_record(have_record ? &latest : nullptr, latest_event, follow_file,
+                               text_mode, compact_mode, tiny_mode, false,
+                               use_colors, get_terminal_width());
+            if (use_colors) {
+                frame_end();
+            }
+        }
+        redraw = false;
+        first_batch = false;
+
+        struct pollfd fds[2];
+        fds[0].fd = log_follower_fd(follower);
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = g_signal_fd;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+            std::cerr << "Error: --follow: poll: " << std::strerror(errno) << std::endl;
+            result = 1;
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            const int term_signal = read_terminal_signals(&redraw);
+            if (term_signal != 0) {
+                result = 128 + term_signal;
+                break;
+            }
+        }
+    }
+
+    log_follower_close(follower);
+    return result;
+}
+
+// ============================================================================
+// Dashboard (--dashboard)
+// ============================================================================
+
+// Full-screen view on the alternate screen. Panes are re-rendered only when
+// their inputs change (the usage pane every second for the countdown, the
+// others after a fetch or a resize); the differential renderer then sends only
+// the cells that differ. Fetches run on their own timer, independent of the
+// 1 Hz redraw.
+struct DashboardView {
+    DashboardStats stats;
+    QuotaData sample = {0.0, 0.0, "", 0};
+    bool have_sample = false;
+    std::string event;
+    RetryState retry;
+
+    DashboardPane usage{"Usage", {}, true};
+    DashboardPane window{"Window", {}, true};
+    DashboardPane forecast{"Forecast", {}, true};
+    DashboardPane latency{"Fetch latency", {}, true};
+    DashboardPane events{"Events", {}, true};
+    DashboardPane errors{"Errors", {}, true};
+
+    int width = 0;
+    int height = 0;
+    std::string frame;          // reused frame buffer
+};
+
+static volatile sig_atomic_t g_dashboard_screen = 0;
+
+static void dashboard_leave_screen() {
+    if (g_dashboard_screen) {
+        static const char kLeave[] = "\033[0m\033[?25h\033[?1049l";
+        (void)!write(STDOUT_FILENO, kLeave, sizeof(kLeave) - 1);
+        g_dashboard_screen = 0;
+    }
+}
+
+static void dashboard_enter_screen() {
+    static const char kEnter[] = "\033[?1049h\033[?25l";
+    (void)!write(STDOUT_FILENO, kEnter, sizeof(kEnter) - 1);
+    g_dashboard_screen = 1;
+    screen_invalidate(&g_screen);
+}
+
+static std::string format_clock(time_t t, const char* format) {
+    char buf[32];
+    const struct tm local_tm = clock_localtime(t);
+    strftime(buf, sizeof(buf), format, &local_tm);
+    return buf;
+}
+
+static std::string format_ms(double ms) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(ms < 10.0 ? 1 : 0) << ms << " ms";
+    return out.str();
+}
+
+// Usage and reset bars; redrawn every second for the countdown
+static void render_usage_pane(DashboardView* v) {
+    DashboardPane& pane = v->usage;
+    pane.lines.clear();
+    if (!v->have_sample) {
+        pane.lines.push_back("Waiting for the first fetch...");
+        return;
+    }
+
+    pane.lines.push_back(render_progress_bar(v->sample.percentage, v->width, true));
+    time_t reset_utc = 0;
+    if (parse_iso8601_utc_to_time_t(v->sample.reset_time, &reset_utc)) {
+        pane.lines.push_back(render_reset_time_bar(reset_utc, v->width, true));
+        pane.lines.push_back("Resets at: " + format_timestamp(v->sample.reset_time));
+    } else {
+        pane.lines.push_back("Reset: No active window (quota not used recently)");
+    }
+}
+
+static void render_window_pane(DashboardView* v, int chart_height) {
+    DashboardPane& pane = v->window;
+    pane.lines.clear();
+
+    std::ostringstream out;
+    print_history_chart(out, &g_history, v->width, chart_height);
+    std::istringstream in(out.str());
+    std::string line;
+    while (std::getline(in, line)) {
+        pane.lines.push_back(line);
+    }
+}
+
+// Burn rate since the window opened and where it leads; all of it is as of
+// the sample, so the pane changes only after a fetch.
+static void render_forecast_pane(DashboardView* v) {
+    DashboardPane& pane = v->forecast;
+    pane.lines.clear();
+
+    time_t reset_utc = 0;
+    if (!v->have_sample || !parse_iso8601_utc_to_time_t(v->sample.reset_time, &reset_utc)) {
+        pane.lines.push_back(v->have_sample ? "No active window" : "No data yet");
+        return;
+    }
+
+    const time_t sampled = v->sample.timestamp;
+    const double elapsed_h = difftime(sampled, reset_utc - kQuotaWindowSeconds) / 3600.0;
+    const double projected = forecast_usage_at_reset(v->sample, sampled);
+    if (projected < 0.0 || elapsed_h <= 0.0) {
+        // Younger than a minute, or a reset time outside the 5 h window
+        pane.lines.push_back(elapsed_h >= 0.0 && elapsed_h < 1.0 / 60.0 ? "Window just opened" : "No forecast for this window");
+        return;
+    }
+
+    const double rate = v->sample.percentage / elapsed_h;
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1) << "Burn rate: " << rate << "%/h";
+    pane.lines.push_back(line.str());
+
+    line.str(std::string());
+    line << std::setprecision(0) << "At reset:  " << get_color_for_percentage(projected, true) << projected
+         << "%\033[0m projected";
+    pane.lines.push_back(line.str());
+
+    if (projected >= 100.0 && rate > 0.0) {
+        const time_t limit_at = sampled + static_cast<time_t>((100.0 - v->sample.percentage) / rate * 3600.0);
+        pane.lines.push_back("Limit at:  " + format_clock(limit_at, "%H:%M") + " (before reset)");
+    } else {
+        line.str(std::string());
+        line << "Headroom:  " << (100.0 - projected) << "% at reset";
+        pane.lines.push_back(line.str());
+    }
+    pane.lines.push_back("As of " + format_clock(sampled, "%H:%M:%S"));
+}
+
+static void render_latency_pane(DashboardView* v) {
+    DashboardPane& pane = v->latency;
+    pane.lines.clear();
+
+    const LatencySummary s = dashboard_latency_summary(&v->stats);
+    if (s.count == 0) {
+        pane.lines.push_back("No fetches yet");
+        return;
+    }
+    pane.lines.push_back("Last: " + format_ms(s.last) + "  (" + std::to_string(s.count) + " samples)");
+    pane.lines.push_back("p50:  " + format_ms(s.p50) + "  p95: " + format_ms(s.p95));
+    pane.lines.push_back("Min:  " + format_ms(s.min) + "  Max: " + format_ms(s.max));
+
+    const HedgeStats h = get_hedge_stats();
+    if (h.enabled && h.requests > 0) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "Hedged: " << h.hedged << " ("
+             << 100.0 * h.hedged / h.requests << "%)  won " << h.hedge_wins;
+        pane.lines.push_back(line.str());
+    }
+    if (g_timings) {
+        pane.lines.push_back("Via:  " + describe_request_transport(get_request_transport()));
+        pane.lines.push_back("Phases: " + g_last_timings);
+    }
+}
+
+static void render_events_pane(DashboardView* v) {
+    DashboardPane& pane = v->events;
+    pane.lines.clear();
+
+    if (v->stats.events.empty()) {
+        pane.lines.push_back("No events yet");
+        return;
+    }
+    for (const DashboardEvent& ev : v->stats.events) {
+        std::ostringstream line;
+        line << format_clock(ev.timestamp, "%H:%M:%S") << "  ";
+        if (ev.name == "QUOTA_RESET" || ev.name == "POSSIBLE_RESET" || ev.name == "HIGH_USAGE") {
+            line << "\033[33m" << ev.name << "\033[0m";
+        } else {
+            line << ev.name;
+        }
+        line << std::fixed << std::setprecision(1) << "  " << ev.percentage << "%";
+        pane.lines.push_back(line.str());
+    }
+}
+
+static void render_errors_pane(DashboardView* v) {
+    DashboardPane& pane = v->errors;
+    pane.lines.clear();
+
+    const DashboardStats& s = v->stats;
+    std::ostringstream line;
+    line << "Fetches: " << s.fetches << "  failed: " << s.failures;
+    if (s.fetches > 0 && s.failures > 0) {
+        line << std::fixed << std::setprecision(1) << " (" << (100.0 * s.failures / s.fetches) << "%)";
+    }
+    pane.lines.push_back(line.str());
+
+    line.str(std::string());
+    for (int k = 0; k < kFetchErrorKinds; k++) {
+        line << (k == 0 ? "" : "  ") << fetch_error_name(static_cast<FetchError>(k)) << ": " << s.errors[k];
+    }
+    pane.lines.push_back(line.str());
+
+    if (!s.last_error.empty()) {
+        pane.lines.push_back("\033[31m" + format_clock(s.last_error_time, "%H:%M:%S") + " " + s.last_error + "\033[0m");
+    }
+}
+
+// Compose the frame from the cached panes (re-rendering the dirty ones) and
+// draw the difference
+static void dashboard_draw(DashboardView* v, int refresh_interval, int next_fetch_in, bool fetching) {
+    const int width = get_terminal_width();
+    const int height = get_terminal_height();
+    if (width != v->width || height != v->height) {
+        v->width = width;
+        v->height = height;
+        for (DashboardPane* pane : {&v->usage, &v->window, &v->forecast, &v->latency, &v->events, &v->errors}) {
+            pane->dirty = true;
+        }
+    }
+
+    // Rows: header, usage (1+3), window (1+chart+2), forecast|latency (1+4),
+    // events|errors (1+n), footer. The chart and the event list share what
+    // is left of the height.
+    const int chart_height = std::min(std::max(height - 20, 3), 10);
+    const int event_rows = std::min(std::max(height - 15 - chart_height, 3), static_cast<int>(kDashboardEventCapacity));
+    const bool side_by_side = width >= 70;
+    const bool utf8 = is_utf8_locale();
+
+    // Only the countdown changes between fetches.
+    v->usage.dirty = true;
+    struct PaneRenderer {
+        DashboardPane* pane;
+        void (*render)(DashboardView*);
+    };
+    for (const PaneRenderer& r : {PaneRenderer{&v->usage, render_usage_pane},
+                                  PaneRenderer{&v->forecast, render_forecast_pane},
+                                  PaneRenderer{&v->latency, render_latency_pane},
+                                  PaneRenderer{&v->events, render_events_pane},
+                                  PaneRenderer{&v->errors, render_errors_pane}}) {
+        if (r.pane->dirty) {
+            r.render(v);
+            r.pane->dirty = false;
+        }
+    }
+    if (v->window.dirty) {
+        render_window_pane(v, chart_height);
+        v->window.dirty = false;
+    }
+
+    std::string& frame = v->frame;
+    frame.clear();
+
+    std::string status = fetching ? "fetching..." : "next fetch in " + std::to_string(next_fetch_in) + "s";
+    if (!fetching && retry_waiting(&v->retry)) {
+        status = retry_describe(&v->retry, next_fetch_in);
+    }
+    status += " (every " + std::to_string(refresh_interval) + "s)  " + format_clock(clock_now(), "%H:%M:%S");
+    const std::string title = "\033[1mFirmware API Quota\033[0m";
+    const int gap = width - static_cast<int>(dashboard_visible_width(title) + status.size());
+    frame.append(title).append(static_cast<size_t>(std::max(gap, 1)), ' ').append(status).push_back('\n');
+
+    dashboard_append_row(&frame, v->usage, nullptr, width, 3, utf8);
+    dashboard_append_row(&frame, v->window, nullptr, width, chart_height + 2, utf8);
+    if (side_by_side) {
+        dashboard_append_row(&frame, v->forecast, &v->latency, width, 4, utf8);
+        dashboard_append_row(&frame, v->events, &v->errors, width, event_rows, utf8);
+    } else {
+        dashboard_append_row(&frame, v->forecast, nullptr, width, 4, utf8);
+        dashboard_append_row(&frame, v->latency, nullptr, width, static_cast<int>(std::max<size_t>(v->latency.lines.size(), 3)), utf8);
+        dashboard_append_row(&frame, v->events, nullptr, width, event_rows, utf8);
+        dashboard_append_row(&frame, v->errors, nullptr, width, 3, utf8);
+    }
+    frame.append("q quit  r refresh  +/- interval");
+
+    screen_resize(&g_screen, width, height);
+    screen_present(&g_screen, frame, STDOUT_FILENO);
+}
+
+// One fetch: update the sample, log, history and statistics (no output).
+// Returns the retry (or rate-limit) delay, 0 to keep the interval.
+static int dashboard_fetch(DashboardView* v, const std::string& api_key, const std::string& token,
+                           const std::string& log_file, std::optional<AuthMethod>& preferred_auth_method,
+                           int refresh_interval) {
+    std::optional<AuthMethod> used_method;
+    retry_attempt_started(&v->retry);
+    const auto fetch_start = std::chrono::steady_clock::now();
+    RequestResult result = try_auth_methods(api_key, token, preferred_auth_method, &used_method);
+    const double latency_ms = capture_latency_ms(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fetch_start).count());
+
+    if (result.curl_code == CURLE_ABORTED_BY_CALLBACK) {
+        return 0; // Interrupted by Ctrl+C: not a failure of the API
+    }
+    if (g_timings) {
+        g_last_timings = format_request_timings(result.timings);
+    }
+
+    long rate_limit_s = 0;
+    const bool rate_limited = request_rate_limited(result, &rate_limit_s);
+    if (rate_limited && !log_file.empty()) {
+        write_log_rate_limited(log_file, result, rate_limit_s);
+    }
+
+    // Unchanged body: the previous sample stands (no parse, no event)
+    QuotaData data;
+    std::string error;
+    const bool reuse = result.unchanged && v->have_sample;
+    if (reuse) {
+        data = v->sample;
+        data.timestamp = clock_now();
+    } else if (!parse_quota_result(result, &data, &error)) {
+        dashboard_record_failure(&v->stats, latency_ms, result, error);
+        if (g_push_server) {
+            JsonlRecord rec;
+            rec.timestamp = static_cast<int64_t>(clock_now());
+            rec.ok = false;
+            rec.error = error.c_str();
+            rec.http_code = result.http_code;
+            rec.latency_ms = latency_ms;
+            push_server_publish(g_push_server, jsonl_format_record(&g_jsonl_writer, rec));
+        }
+        v->latency.dirty = true;
+        v->errors.dirty = true;
+        return rate_limited ? retry_on_rate_limit(&v->retry, rate_limit_s, refresh_interval)
+                            : retry_on_failure(&v->retry, refresh_interval);
+    }
+    retry_on_success(&v->retry);
+
+    std::string event = "UPDATE";
+    if (reuse) {
+        if (!log_file.empty() && log_heartbeat_due(log_file, data.timestamp)) {
+            write_log_entry(log_file, data, event);
+        }
+    } else if (!log_file.empty()) {
+        QuotaData previous_data = read_last_log_entry(log_file);
+        event = detect_event(data, previous_data);
+        write_log_entry(log_file, data, event);
+    } else {
+        event = detect_event(data, v->have_sample ? v->sample : QuotaData{0.0, 0.0, "", 0});
+    }
+    v->sample = data;
+    v->have_sample = true;
+    v->event = event;
+    history_push(&g_history, data.timestamp, data.percentage);
+
+    if (g_push_server) {
+        push_server_publish(g_push_server,
+                            jsonl_format_record(&g_jsonl_writer, make_snapshot_record(data, event, latency_ms)));
+    }
+
+    dashboard_record_success(&v->stats, latency_ms, data, event);
+    v->window.dirty = true;
+    v->forecast.dirty = true;
+    v->latency.dirty = true;
+    v->errors.dirty = true;
+    if (event != "UPDATE") {
+        v->events.dirty = true;
+    }
+    return rate_limited ? retry_on_rate_limit(&v->retry, rate_limit_s, refresh_interval) : 0;
+}
+
+// timerfd deadlines count real time: advance one by `seconds` on the clock
+static void add_clock_seconds(struct timespec* t, int seconds) {
+    const struct timespec span = clock_real_span(seconds);
+    t->tv_sec += span.tv_sec;
+    t->tv_nsec += span.tv_nsec;
+    if (t->tv_nsec >= 1000000000) {
+        t->tv_sec++;
+        t->tv_nsec -= 1000000000;
+    }
+}
+
+// Clock seconds (rounded up) until a timerfd expires
+static int clock_seconds_until(int timer_fd) {
+    struct itimerspec spec = {};
+    timerfd_gettime(timer_fd, &spec);
+    const long real_ms = static_cast<long>(spec.it_value.tv_sec) * 1000 + (spec.it_value.tv_nsec + 999999) / 1000000;
+    return static_cast<int>(std::ceil(clock_seconds(real_ms)));
+}
+
+// --replay: arm the (one-shot) fetch timer for the next recorded fetch at
+// the replay pace. False once the capture is exhausted.
+static bool arm_replay_fetch(int fetch_timer) {
+    const long delay_ms = capture_replay_delay_ms();
+    if (delay_ms < 0) {
+        return false;
+    }
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = delay_ms / 1000;
+    spec.it_value.tv_nsec = (delay_ms % 1000) * 1000000 + 1;   // all zero would disarm
+    timerfd_settime(fetch_timer, 0, &spec, nullptr);
+    return true;
+}
+
+// --dashboard: poll loop over signals, keys, the 1 Hz redraw tick, the
+// fetch timer and connectivity changes
+static int dashboard_and_fetch(const std::string& api_key, const std::string& token, int refresh_interval,
+                               const std::string& log_file, std::optional<AuthMethod>& preferred_auth_method) {
+    if (!isatty(STDOUT_FILENO)) {
+        std::cerr << "Error: --dashboard needs a terminal" << std::endl;
+        return 1;
+    }
+
+    const bool interactive = enable_key_input();
+    const int fetch_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    const int tick_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fetch_timer < 0 || tick_timer < 0) {
+        std::cerr << "Error: timerfd_create: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // Periodic timers: the fetch schedule does not drift by the fetch
+    // duration, and re-arming restarts it ('r', +/-). After a failure the
+    // first expiry is the retry delay instead.
+    auto arm_fetch = [&](int first_s) {
+        struct itimerspec spec = {};
+        spec.it_value = clock_real_span(first_s > 0 ? first_s : refresh_interval);
+        spec.it_interval = clock_real_span(refresh_interval);
+        timerfd_settime(fetch_timer, 0, &spec, nullptr);
+    };
+    auto next_fetch_in = [&]() {
+        return clock_seconds_until(fetch_timer);
+    };
+    struct itimerspec tick = {};
+    tick.it_value.tv_sec = 1;
+    tick.it_interval.tv_sec = 1;
+    timerfd_settime(tick_timer, 0, &tick, nullptr);
+
+    std::atexit(dashboard_leave_screen);
+    dashboard_enter_screen();
+
+    DashboardView view;
+    retry_init(&view.retry);
+    const int net_fd = net_watch_open();
+    bool fetch_due = true;
+    int result = 0;
+
+    while (true) {
+        if (fetch_due) {
+            // Show that a fetch is in flight; the request blocks the loop.
+            dashboard_draw(&view, refresh_interval, 0, true);
+            const int retry_s = dashboard_fetch(&view, api_key, token, log_file, preferred_auth_method,
+                                                refresh_interval);
+            // A replay follows the capture's pace and stops at its end
+            if (capture_replaying()) {
+                arm_replay_fetch(fetch_timer);
+            } else {
+                arm_fetch(retry_s);
+            }
+            fetch_due = false;
+            if (termination_pending()) {
+                bool resized = false;
+                result = 128 + read_terminal_signals(&resized);
+                break;
+            }
+        }
+        dashboard_draw(&view, refresh_interval, next_fetch_in(), false);
+
+        struct pollfd fds[5];
+        fds[0].fd = g_signal_fd;
+        fds[1].fd = fetch_timer;
+        fds[2].fd = tick_timer;
+        fds[3].fd = interactive ? STDIN_FILENO : -1;
+        fds[4].fd = net_fd;
+        for (struct pollfd& pfd : fds) {
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+        }
+        if (poll(fds, 5, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result = 1;
+            break;
+        }
+
+        uint64_t expirations = 0;
+        if (fds[0].revents & POLLIN) {
+            bool resized = false;
+            const int term_signal = read_terminal_signals(&resized);
+            if (term_signal != 0) {
+                result = 128 + term_signal;
+                break;
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            (void)!read(fetch_timer, &expirations, sizeof(expirations));
+            fetch_due = true;
+        }
+        if (fds[2].revents & POLLIN) {
+            (void)!read(tick_timer, &expirations, sizeof(expirations));
+        }
+        if (fds[3].revents & POLLIN) {
+            const KeyCommands keys = read_key_commands();
+            if (keys.quit) {
+                break;
+            }
+            if (keys.refresh) {
+                fetch_due = true;
+            }
+            if (keys.interval_steps != 0) {
+                refresh_interval = step_refresh_interval(refresh_interval, keys.interval_steps);
+                if (!retry_waiting(&view.retry) && !capture_replaying()) {
+                    arm_fetch(0);
+                }
+            }
+        }
+        if ((fds[4].revents & POLLIN) && net_watch_read(net_fd) && retry_on_connectivity(&view.retry)) {
+            fetch_due = true;   // back online: retry without waiting out the backoff
+        }
+    }
+
+    restore_key_input();
+    dashboard_leave_screen();
+    close(fetch_timer);
+    close(tick_timer);
+    if (net_fd >= 0) {
+        close(net_fd);
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    std::string api_key;
+    int refresh_interval = 15;
+    bool text_mode = false;
+    bool compact_mode = false;
+    bool tiny_mode = false;
+    bool jsonl_mode = false;
+    std::string log_file = "show_quota.log";
+    bool logging_enabled = true;
+    bool log_given = false;     // --log: also used on a simulated clock
+    int serve_port = 0;
+    RequestTimeouts timeouts;
+    apply_timeout_env(&timeouts);
+    RequestTransport transport;
+    apply_transport_env(&transport);
+    std::string record_file;
+    std::string replay_file;
+    double replay_speed = 1.0;
+    apply_clock_env();
+    double time_scale = 0.0;    // --time-scale / --time-start: 0 / -1 = not given
+    time_t time_start = -1;
+    bool hedge = false;
+    std::string key_file;
+    std::string follow_file;
+    bool dashboard_mode = false;
+
+    // Parse command-line arguments
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "-1") {
+            refresh_interval = 0;
+        } else if (arg == "--refresh" || arg == "-r") {
+            if (i + 1 < argc) {
+                refresh_interval = std::atoi(argv[++i]);
+            } else {
+                refresh_interval = 15; // Default to 15 seconds
+            }
+        } else if (arg == "--text" || arg == "-t") {
+            text_mode = true;
+        } else if (arg == "--compact") {
+            compact_mode = true;
+            tiny_mode = false;
+        } else if (arg == "--tiny") {
+            tiny_mode = true;
+            compact_mode = false;
+        } else if (arg == "--jsonl") {
+            jsonl_mode = true;
+        } else if (arg == "--chart") {
+            g_chart_mode = true;
+        } else if (arg == "--dashboard") {
+            dashboard_mode = true;
+        } else if (arg == "--status") {
+            if (i + 1 < argc && parse_status_format(argv[i + 1], &g_status_writer.format)) {
+                g_status_mode = true;
+                i++;
+            } else {
+                std::cerr << "Error: --status requires a format: i3bar, swaybar, waybar, polybar, lemonbar or tmux" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--log" || arg == "-l") {
+            if (i + 1 < argc) {
+                log_file = argv[++i];
+                logging_enabled = true;
+                log_given = true;
+            } else {
+                std::cerr << "Error: --log requires a file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--no-log") {
+            logging_enabled = false;
+        } else if (arg == "--key-file") {
+            if (i + 1 < argc) {
+                key_file = argv[++i];
+            } else {
+                std::cerr << "Error: --key-file requires a file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--follow") {
+            if (i + 1 < argc) {
+                follow_file = argv[++i];
+            } else {
+                std::cerr << "Error: --follow requires a log file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--serve") {
+            char* end = nullptr;
+            const long port = (i + 1 < argc) ? std::strtol(argv[i + 1], &end, 10) : 0;
+            if (!end || end == argv[i + 1] || *end != '\0' || port < 1 || port > 65535) {
+                std::cerr << "Error: --serve requires a port 1-65535" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            serve_port = static_cast<int>(port);
+            i++;
+        } else if (arg == "--hedge") {
+            hedge = true;
+        } else if (arg == "--timeout" || arg == "--connect-timeout" || arg == "--first-byte-timeout") {
+            long* budget = (arg == "--timeout") ? &timeouts.total_ms
+                         : (arg == "--connect-timeout") ? &timeouts.connect_ms : &timeouts.first_byte_ms;
+            if (i + 1 < argc && parse_timeout_seconds(argv[i + 1], budget)) {
+                i++;
+            } else {
+                std::cerr << "Error: " << arg << " requires a number of seconds (0 = no limit)" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--record" || arg == "--replay") {
+            if (i + 1 < argc) {
+                (arg == "--record" ? record_file : replay_file) = argv[++i];
+            } else {
+                std::cerr << "Error: " << arg << " requires a file path" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--replay-speed") {
+            char* end = nullptr;
+            replay_speed = (i + 1 < argc) ? std::strtod(argv[i + 1], &end) : -1.0;
+            if (!end || end == argv[i + 1] || *end != '\0' || !(replay_speed >= 0.0)) {
+                std::cerr << "Error: --replay-speed requires a factor (1 = as recorded, 0 = no waits)" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (arg == "--time-scale") {
+            if (i + 1 < argc && parse_clock_rate(argv[i + 1], &time_scale)) {
+                i++;
+            } else {
+                std::cerr << "Error: --time-scale requires a factor > 0" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--time-start") {
+            if (i + 1 < argc && parse_clock_start(argv[i + 1], &time_start)) {
+                i++;
+            } else {
+                std::cerr << "Error: --time-start requires unix seconds or an ISO 8601 UTC time" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--timings") {
+            g_timings = true;
+        } else if (const TransportSetting* setting = find_transport_option(arg)) {
+            if (i + 1 < argc && set_transport_value(&transport, setting->key, argv[i + 1])) {
+                i++;
+            } else {
+                std::cerr << "Error: missing or invalid value for " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg[0] != '-') {
+            // Assume it's the API key
+            api_key = arg;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (g_status_mode && (jsonl_mode || dashboard_mode || !key_file.empty())) {
+        std::cerr << "Error: --status cannot be combined with --jsonl, --dashboard or --key-file" << std::endl;
+        return 1;
+    }
+    if (dashboard_mode && (jsonl_mode || !follow_file.empty() || !key_file.empty() || refresh_interval <= 0)) {
+        std::cerr << "Error: --dashboard shows one account live; it cannot be combined with "
+                  << "--jsonl, --follow, --key-file or -1" << std::endl;
+        return 1;
+    }
+
+    set_request_timeouts(timeouts);
+    set_request_transport(transport);
+    set_request_hedging(hedge);
+
+    if (!record_file.empty() && !replay_file.empty()) {
+        std::cerr << "Error: --record and --replay cannot be combined" << std::endl;
+        return 1;
+    }
+    if (time_scale > 0.0 || time_start >= 0) {
+        if (!replay_file.empty()) {
+            std::cerr << "Error: --replay runs the clock at the capture's pace; drop --time-scale/--time-start" << std::endl;
+            return 1;
+        }
+        clock_simulate(time_start >= 0 ? time_start : time(nullptr), time_scale > 0.0 ? time_scale : 1.0);
+    }
+    std::string capture_error;
+    if ((!record_file.empty() && !capture_record_open(record_file, &capture_error)) ||
+        (!replay_file.empty() && !capture_replay_open(replay_file, replay_speed, &capture_error))) {
+        std::cerr << "Error: " << capture_error << std::endl;
+        return 1;
+    }
+    // Simulated timestamps stay out of the live log (and so out of --follow
+    // readers and the history seed): log only to an explicit --log file
+    if (clock_simulated() && !log_given) {
+        logging_enabled = false;
+    }
+
+    // SIGINT/SIGTERM/SIGWINCH are read from a signalfd by the loops below
+    block_terminal_signals();
+
+    if ((compact_mode || tiny_mode) && !jsonl_mode && !g_status_mode) {
+        std::atexit(show_cursor_if_hidden);
+        hide_cursor_if_tty();
+    }
+    
+    // Render another instance's log: no API key, no network
+    if (!follow_file.empty()) {
+        g_history_enabled = !jsonl_mode && !g_status_mode;
+        return follow_and_display(follow_file, text_mode, compact_mode, tiny_mode, jsonl_mode || g_status_mode);
+    }
+
+    // Load named keys for multi-account monitoring
+    std::vector<AccountKey> account_keys;
+    if (!key_file.empty()) {
+        std::string key_error;
+        if (!load_key_file(key_file, &account_keys, &key_error)) {
+            std::cerr << "Error: --key-file: " << key_error << std::endl;
+            return 1;
+        }
+    }
+
+    // Get API key from environment variable if not provided
+    if (api_key.empty() && account_keys.empty()) {
+        const char* env_key = std::getenv("FIRMWARE_API_KEY");
+        if (env_key) {
+            api_key = env_key;
+        }
+    }
+    
+    // A replay never reaches the API
+    if (api_key.empty() && account_keys.empty() && capture_replaying()) {
+        api_key = "replay";
+    }
+
+    // Check if API key is provided
+    if (api_key.empty() && account_keys.empty()) {
+        std::cerr << "Error: API key not provided." << std::endl;
+        std::cerr << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    // Extract token
+    std::string token = extract_token(api_key);
+
+    // Initialize curl globally
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    if (serve_port > 0) {
+        if (refresh_interval > 0) {
+            std::string serve_error;
+            g_push_server = push_server_start(serve_port, &serve_error);
+            if (!g_push_server) {
+                std::cerr << "Error: --serve: " << serve_error << std::endl;
+                curl_global_cleanup();
+                return 1;
+            }
+        } else {
+            std::cerr << "Warning: --serve ignored in single run mode (-1)" << std::endl;
+        }
+    }
+
+    int result = 0;
+    std::optional<AuthMethod> preferred_auth_method;
+    QuotaData last_sample = {0.0, 0.0, "", 0};
+
+    std::vector<AccountView> accounts;
+    for (const AccountKey& key : account_keys) {
+        AccountView acct;
+        acct.name = key.name;
+        acct.api_key = key.api_key;
+        acct.token = extract_token(key.api_key);
+        acct.log_file = logging_enabled ? account_log_path(log_file, key.name) : std::string();
+        accounts.push_back(std::move(acct));
+    }
+
+    std::string last_event;
+
+    // Sparkline/chart history for the single-account view, seeded with the
+    // current window from the log
+    if (accounts.empty() && !jsonl_mode && !g_status_mode) {
+        g_history_enabled = true;
+        if (logging_enabled) {
+            history_seed_from_log(&g_history, log_file, clock_now() - kQuotaWindowSeconds);
+        }
+    }
+
+    if (dashboard_mode) {
+        result = dashboard_and_fetch(api_key, token, refresh_interval,
+                                     logging_enabled ? log_file : std::string(), preferred_auth_method);
+    } else if (refresh_interval > 0) {
+        // Continuous refresh mode: a single poll() loop. Fetches run on
+        // absolute CLOCK_MONOTONIC deadlines (the schedule does not drift by
+        // the fetch duration; intervals are converted to real time, see
+        // add_clock_seconds), a 1 s tick redraws the countdown from the last
+        // sample without network I/O, SIGWINCH redraws at once and
+        // SIGINT/SIGTERM end the loop. On a terminal, keys are read from
+        // stdin in the same loop (r, +/-, c/t, q).
+        const bool diff_render = isatty(STDOUT_FILENO) && !jsonl_mode && !g_status_mode;
+        const bool interactive = diff_render && enable_key_input();
+        const int fetch_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        const int tick_timer = diff_render ? timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC) : -1;
+        auto arm_tick = [&]() {
+            // --tiny has no countdown to update
+            struct itimerspec tick = {};
+            if (!tiny_mode) {
+                tick.it_value.tv_sec = 1;
+                tick.it_interval.tv_sec = 1;
+            }
+            if (tick_timer >= 0) {
+                timerfd_settime(tick_timer, 0, &tick, nullptr);
+            }
+        };
+        arm_tick();
+        if (interactive) {
+            std::atexit(show_cursor_if_hidden);
+        }
+        if (fetch_timer < 0) {
+            std::cerr << "Error: timerfd_create: " << std::strerror(errno) << std::endl;
+            push_server_stop(g_push_server);
+            curl_global_cleanup();
+            return 1;
+        }
+
+        struct itimerspec deadline = {};
+        clock_gettime(CLOCK_MONOTONIC, &deadline.it_value);
+        struct timespec fetch_anchor = deadline.it_value;  // schedule slot of the last fetch
+        std::string last_frame;     // redrawn as-is while the last fetch failed (without footer)
+        RetryState retry;
+        retry_init(&retry);
+        const int net_fd = net_watch_open();
+        bool fetch_due = true;
+        bool manual_fetch = false;  // requested with 'r' (restarts the interval)
+        bool redraw = false;
+        int term_signal = 0;
+        bool replay_done = false;   // --replay: the capture is exhausted
+
+        // Arm the fetch timer one interval after the anchor, skipping slots
+        // that already passed (slow fetch, suspend). Returns false if even
+        // the first slot is due already.
+        auto schedule_next_fetch = [&](bool skip_missed) -> bool {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            auto passed = [&]() {
+                return deadline.it_value.tv_sec < now.tv_sec ||
+                       (deadline.it_value.tv_sec == now.tv_sec && deadline.it_value.tv_nsec <= now.tv_nsec);
+            };
+            deadline.it_value = fetch_anchor;
+            add_clock_seconds(&deadline.it_value, refresh_interval);
+            if (passed() && !skip_missed) {
+                return false;
+            }
+            while (passed()) {
+                add_clock_seconds(&deadline.it_value, refresh_interval);
+            }
+            timerfd_settime(fetch_timer, TFD_TIMER_ABSTIME, &deadline, nullptr);
+            return true;
+        };
+
+        // After a failure: next attempt after the backoff delay, from now
+        auto schedule_retry = [&](int delay_s) {
+            clock_gettime(CLOCK_MONOTONIC, &deadline.it_value);
+            add_clock_seconds(&deadline.it_value, delay_s);
+            timerfd_settime(fetch_timer, TFD_TIMER_ABSTIME, &deadline, nullptr);
+        };
+        auto seconds_until_fetch = [&]() {
+            return clock_seconds_until(fetch_timer);
+        };
+
+        auto apply_keys = [&](const KeyCommands& keys) {
+            if (keys.refresh) {
+                fetch_due = true;
+                manual_fetch = true;
+            }
+            if (keys.interval_steps != 0) {
+                refresh_interval = step_refresh_interval(refresh_interval, keys.interval_steps);
+                // A pending retry keeps its backoff delay
+                if (!fetch_due && !retry_waiting(&retry) && !capture_replaying() && !schedule_next_fetch(false)) {
+                    fetch_due = true;   // the shorter interval has already elapsed
+                }
+                redraw = true;
+            }
+            if (keys.toggle_compact || keys.toggle_tiny) {
+                if (keys.toggle_tiny) {
+                    tiny_mode = !tiny_mode;
+                    compact_mode = false;
+                } else {
+                    compact_mode = !compact_mode;
+                    tiny_mode = false;
+                }
+                if (compact_mode || tiny_mode) {
+                    hide_cursor_if_tty();
+                } else {
+                    show_cursor_if_hidden();
+                }
+                arm_tick();
+                redraw = true;
+            }
+        };
+
+        while (true) {
+            if (fetch_due || (redraw && diff_render)) {
+                long rate_limit_s = -1;
+                int terminal_width = get_terminal_width();
+                bool use_colors = isatty(STDOUT_FILENO);
+
+                // Render into a frame; only the difference reaches the terminal
+                if (diff_render) {
+                    frame_begin();
+                }
+
+                if (fetch_due) {
+                    if (manual_fetch) {
+                        clock_gettime(CLOCK_MONOTONIC, &fetch_anchor);
+                    } else {
+                        fetch_anchor = deadline.it_value;
+                    }
+                    retry_attempt_started(&retry);
+                    if (!accounts.empty()) {
+                        result = fetch_and_display_accounts(accounts, text_mode, compact_mode, tiny_mode, jsonl_mode,
+                                                            use_colors, terminal_width, &rate_limit_s);
+                    } else {
+                        result = fetch_and_display_quota(api_key,
+                                                         token,
+                                                         text_mode,
+                                                         compact_mode,
+                                                         tiny_mode,
+                                                         jsonl_mode,
+                                                         use_colors,
+                                                         terminal_width,
+                                                         logging_enabled ? log_file : std::string(),
+                                                         preferred_auth_method,
+                                                         &last_sample,
+                                                         &last_event,
+                                                         true,
+                                                         &rate_limit_s);
+                    }
+                } else if (!accounts.empty()) {
+                    display_accounts(accounts, text_mode, compact_mode, tiny_mode, use_colors, terminal_width,
+                                     isatty(STDERR_FILENO));
+                } else if (result == 0) {
+                    display_quota(last_sample, last_event, logging_enabled, text_mode, compact_mode, tiny_mode,
+                                  use_colors, terminal_width);
+                } else {
+                    // The failed fetch's frame (the error) is redrawn unchanged;
+                    // the footer below carries the current retry countdown.
+                    std::cout << last_frame;
+                }
+
+                const bool fetched = fetch_due;
+                if (fetched) {
+                    if (diff_render) {
+                        std::cout.flush();
+                        last_frame = g_frame.str();
+                    }
+                    if (capture_replaying()) {
+                        // The capture sets the pace; its gaps already hold the
+                        // recorded interval, backoff and server delays
+                        replay_done = !arm_replay_fetch(fetch_timer);
+                    } else if (rate_limit_s >= 0 && !termination_pending()) {
+                        // Throttled: the server's delay replaces the interval
+                        // (and the backoff), even after a usable answer
+                        if (result == 0) {
+                            retry_on_success(&retry);
+                        }
+                        schedule_retry(retry_on_rate_limit(&retry, rate_limit_s, refresh_interval));
+                    } else if (result != 0 && !termination_pending()) {
+                        schedule_retry(retry_on_failure(&retry, refresh_interval));
+                    } else {
+                        if (result == 0) {
+                            retry_on_success(&retry);
+                        }
+                        // Next deadline is one interval after this fetch's slot,
+                        // so the schedule does not drift by the fetch duration.
+                        schedule_next_fetch(true);
+                    }
+                }
+
+                print_refresh_footer(retry_describe(&retry, seconds_until_fetch()), refresh_interval,
+                                     compact_mode, tiny_mode, jsonl_mode || g_status_mode, interactive);
                 std::cout.flush();
+
+                if (diff_render) {
+                    // A fetch cut short by Ctrl+C is not worth drawing.
+                    frame_end(!termination_pending());
+                }
+                fetch_due = false;
+                manual_fetch = false;
+                redraw = false;
+
+                if (replay_done) {
+                    break;      // the last frame stays on screen
+                }
+
+                if (fetched && interactive) {
+                    // Keys typed while the fetch was in flight: 'r' is
+                    // satisfied by the fetch that just finished.
+                    KeyCommands keys = read_key_commands();
+                    keys.refresh = false;
+                    if (keys.quit) {
+                        result = 0;
+                        break;
+                    }
+                    apply_keys(keys);
+                    continue;
+                }
+            }
+
+            struct pollfd fds[5];
+            fds[0].fd = g_signal_fd;
+            fds[1].fd = fetch_timer;
+            fds[2].fd = tick_timer;
+            fds[3].fd = interactive ? STDIN_FILENO : -1;
+            fds[4].fd = net_fd;
+            for (struct pollfd& pfd : fds) {
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+            }
+            if (poll(fds, 5, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Error: poll: " << std::strerror(errno) << std::endl;
+                result = 1;
+                break;
+            }
+
+            uint64_t expirations = 0;
+            if (fds[0].revents & POLLIN) {
+                term_signal = read_terminal_signals(&redraw);
+                if (term_signal != 0) {
+                    result = 128 + term_signal;
+                    break;
+                }
+            }
+            if (fds[1].revents & POLLIN) {
+                (void)!read(fetch_timer, &expirations, sizeof(expirations));
+                fetch_due = true;
+            }
+            if (fds[2].revents & POLLIN) {
+                (void)!read(tick_timer, &expirations, sizeof(expirations));
+                redraw = true;
+            }
+            if (fds[3].revents & POLLIN) {
+                const KeyCommands keys = read_key_commands();
+                if (keys.quit) {
+                    result = 0;
+                    break;
+                }
+                apply_keys(keys);
+            }
+            if ((fds[4].revents & POLLIN) && net_watch_read(net_fd) && retry_on_connectivity(&retry)) {
+                // Back online: retry without waiting out the backoff
+                fetch_due = true;
+                manual_fetch = true;
             }
-            
+        }
+
+        restore_key_input();
+
+        close(fetch_timer);
+        if (net_fd >= 0) {
+            close(net_fd);
+        }
+        if (tick_timer >= 0) {
+            close(tick_timer);
+        }
+    } else {
+        // Single run mode
+        int terminal_width = get_terminal_width();
+        bool use_colors = isatty(STDOUT_FILENO);
+        if (!accounts.empty()) {
+            result = fetch_and_display_accounts(accounts, text_mode, compact_mode, tiny_mode, jsonl_mode,
+                                                use_colors, terminal_width, nullptr);
+        } else {
             result = fetch_and_display_quota(api_key,
                                              token,
                                              text_mode,
                                              compact_mode,
                                              tiny_mode,
+                                             jsonl_mode,
                                              use_colors,
                                              terminal_width,
                                              logging_enabled ? log_file : std::string(),
                                              preferred_auth_method,
-                                             true);
-            
-            if (result != 0) {
-                // Error occurred, but continue trying
-                std::cerr << std::endl << "Will retry in " << refresh_interval << " seconds..." << std::endl;
-            }
-            
-            // Show next refresh time
-            if (!compact_mode && !tiny_mode) {
-                std::cout << std::endl << "Refreshing every " << refresh_interval << " seconds (Ctrl+C to stop)..." << std::endl;
-            }
-            std::cout.flush();
-            
-            // Sleep for specified interval
-            sleep(refresh_interval);
+                                             &last_sample,
+                                             &last_event,
+                                             false,
+                                             nullptr);
+        }
+        print_timings();
+        bool resized = false;
+        const int term_signal = read_terminal_signals(&resized);
+        if (term_signal != 0) {
+            result = 128 + term_signal;
         }
-    } else {
-        // Single run mode
-        int terminal_width = get_terminal_width();
-        bool use_colors = isatty(STDOUT_FILENO);
-        result = fetch_and_display_quota(api_key,
-                                         token,
-                                         text_mode,
-                                         compact_mode,
-                                         tiny_mode,
-                                         use_colors,
-                                         terminal_width,
-                                         logging_enabled ? log_file : std::string(),
-                                         preferred_auth_method,
-                                         false);
     }
 
+    push_server_stop(g_push_server);
+    capture_close();
+
     // Cleanup curl
     curl_global_cleanup();
 